@@ -42,7 +42,7 @@ SSDegMinSec::SSDegMinSec ( SSAngle angle ) : SSDegMinSec ( angle.toDegrees() )
 // Constructs an angular value from a sexagesimal string in any format:
 // "DD MM SS.S", "DD MM.M", "DD.D". Assumes leading & trailing whitespace removed!
 
-SSDegMinSec::SSDegMinSec ( string str ) : SSDegMinSec ( strtodeg ( str ) )
+SSDegMinSec::SSDegMinSec ( string_view str ) : SSDegMinSec ( strtodeg ( str ) )
 {
     // you're putting me out of work!
 }
@@ -120,7 +120,7 @@ SSHourMinSec::SSHourMinSec ( SSAngle angle ) : SSHourMinSec ( angle.toHours() )
 // Constructs an angular value from a sexagesimal string in any format:
 // "HH MM SS.S", "HH MM.M", "HH.H". Assumes leading & trailing whitespace removed!
 
-SSHourMinSec::SSHourMinSec ( string str ) : SSHourMinSec ( strtodeg ( str ) )
+SSHourMinSec::SSHourMinSec ( string_view str ) : SSHourMinSec ( strtodeg ( str ) )
 {
     // it's too much!
 }
@@ -21,7 +21,7 @@ struct SSDegMinSec
     short min;        // minutes portion of angle, 0 - 59, always positive
     double sec;       // seconds portion of angle, 0 - 59.999..., always positive
     
-    SSDegMinSec ( string s );
+    SSDegMinSec ( string_view s );
     SSDegMinSec ( double degrees );
     SSDegMinSec ( char sign, short deg, short min, double sec );
     SSDegMinSec ( class SSAngle );
@@ -42,7 +42,7 @@ struct SSHourMinSec
     short min;        // minutes portion of angle, 0 - 59, always positive
     double sec;       // seconds portion of angle, 0 - 59.999..., always positive
 
-    SSHourMinSec ( string s );
+    SSHourMinSec ( string_view s );
     SSHourMinSec ( double hours );
     SSHourMinSec ( short hour, short min, double sec );
     SSHourMinSec ( class SSAngle );
@@ -0,0 +1,234 @@
+// SSChebyshevEphemeris.cpp
+// SSCore
+//
+// Created by Tim DeBenedictis on 10/16/26.
+// Copyright © 2026 Southern Stars. All rights reserved.
+
+#include "SSChebyshevEphemeris.hpp"
+#include "SSTime.hpp"
+
+// Evaluates Chebyshev series with kNumCoeffs coefficients (coeffs) at normalized time x (-1 <= x <= 1).
+
+static double chebyshev ( const double *coeffs, double x )
+{
+    double t0 = 1.0, t1 = x, twox = x + x;
+    double sum = coeffs[0] + coeffs[1] * x;
+
+    for ( int k = 2; k < SSChebyshevEphemeris::kNumCoeffs; k++ )
+    {
+        double t2 = twox * t1 - t0;
+        sum += coeffs[k] * t2;
+        t0 = t1;
+        t1 = t2;
+    }
+
+    return sum;
+}
+
+// Constructs a Chebyshev ephemeris cache for a source ephemeris function (source).
+// Object identifiers passed to the source range from zero to one less than the size
+// of the spans vector, which gives the initial length of cached windows in days for
+// each object. Windows are split in half, as needed, to meet the error tolerance.
+
+SSChebyshevEphemeris::SSChebyshevEphemeris ( Source source, const vector<double> &spans )
+{
+    _source = source;
+    _spans = spans;
+    _splits = vector<int> ( spans.size(), 0 );
+    _windows = vector<map<double,Window>> ( spans.size() );
+    _tolerance = kDefaultTolerance;
+    _maxWindows = kDefaultMaxWindows;
+    _hits = _misses = _evictions = 0;
+}
+
+// Sets maximum number of cached windows (maxWindows); discards oldest windows if needed.
+
+void SSChebyshevEphemeris::setMaxWindows ( size_t maxWindows )
+{
+    lock_guard<mutex> lock ( _mutex );
+    _maxWindows = maxWindows;
+
+    while ( _order.size() > _maxWindows )
+    {
+        _windows[ _order.front().first ].erase ( _order.front().second );
+        _order.pop_front();
+        _evictions++;
+    }
+}
+
+// Returns total number of windows currently cached for all objects.
+
+size_t SSChebyshevEphemeris::numWindows ( void )
+{
+    lock_guard<mutex> lock ( _mutex );
+    return _order.size();
+}
+
+// Returns number of cache hits, misses, and evicted windows since the cache was constructed or cleared.
+
+void SSChebyshevEphemeris::getStatistics ( size_t &hits, size_t &misses, size_t &evictions )
+{
+    lock_guard<mutex> lock ( _mutex );
+    hits = _hits;
+    misses = _misses;
+    evictions = _evictions;
+}
+
+// Discards all cached windows and resets statistics.
+
+void SSChebyshevEphemeris::clear ( void )
+{
+    lock_guard<mutex> lock ( _mutex );
+    for ( map<double,Window> &windows : _windows )
+        windows.clear();
+
+    _order.clear();
+    _splits = vector<int> ( _spans.size(), 0 );
+    _hits = _misses = _evictions = 0;
+}
+
+// Computes position (pos) and velocity (vel) from a window at normalized time x (-1 <= x <= 1).
+
+void SSChebyshevEphemeris::evalWindow ( const Window &window, double x, SSVector &pos, SSVector &vel )
+{
+    pos = SSVector ( chebyshev ( window.coeffs[0], x ), chebyshev ( window.coeffs[1], x ), chebyshev ( window.coeffs[2], x ) );
+    vel = SSVector ( chebyshev ( window.coeffs[3], x ), chebyshev ( window.coeffs[4], x ), chebyshev ( window.coeffs[5], x ) );
+}
+
+// Fits Chebyshev polynomials to source ephemeris for an object (id) over a time window
+// starting at a Julian Ephemeris Date (start) with a length in days (span), using values at
+// Chebyshev nodes. Then checks the fit against the source at both ends of the window and at every
+// midpoint between adjacent nodes, where fitting errors are largest. Returns true if the fitted window
+// meets the error tolerance at all of those points.
+
+bool SSChebyshevEphemeris::fitWindow ( int id, double start, double span, Window &window )
+{
+    const int n = kNumCoeffs;
+    double values[6][kNumCoeffs], cosines[kNumCoeffs][kNumCoeffs];
+    SSVector pos, vel;
+
+    for ( int j = 0; j < n; j++ )
+        for ( int k = 0; k < n; k++ )
+            cosines[j][k] = cos ( M_PI * j * ( k + 0.5 ) / n );
+
+    window.start = start;
+    window.span = span;
+
+    for ( int k = 0; k < n; k++ )
+    {
+        double x = cosines[1][k];
+        _source ( id, start + ( x + 1.0 ) * span / 2.0, pos, vel );
+        values[0][k] = pos.x;
+        values[1][k] = pos.y;
+        values[2][k] = pos.z;
+        values[3][k] = vel.x;
+        values[4][k] = vel.y;
+        values[5][k] = vel.z;
+    }
+
+    for ( int i = 0; i < 6; i++ )
+    {
+        for ( int j = 0; j < n; j++ )
+        {
+            double sum = 0.0;
+            for ( int k = 0; k < n; k++ )
+                sum += values[i][k] * cosines[j][k];
+            window.coeffs[i][j] = sum * 2.0 / n;
+        }
+
+        window.coeffs[i][0] /= 2.0;
+    }
+
+    // Nodes lie at x = cos ( pi * ( k + 0.5 ) / n ), so x = cos ( pi * k / n ) for k = 0 to n
+    // gives both ends of the window and the midpoints between nodes, including the center.
+
+    for ( int k = 0; k <= n; k++ )
+    {
+        double x = cos ( M_PI * k / n );
+        SSVector fpos, fvel;
+
+        _source ( id, start + ( x + 1.0 ) * span / 2.0, pos, vel );
+        evalWindow ( window, x, fpos, fvel );
+        if ( ( fpos - pos ).magnitude() > _tolerance * pos.magnitude() || ( fvel - vel ).magnitude() > _tolerance * vel.magnitude() )
+            return false;
+    }
+
+    return true;
+}
+
+// Computes position (pos) and velocity (vel) of an object (id) at a Julian Ephemeris Date (jed)
+// from the cached window containing that date. If there is none, fits a new window and caches it,
+// discarding the oldest cached window if the cache is full. If no window fits to within tolerance,
+// computes position and velocity from the source ephemeris directly. Returns false if object
+// identifier is out of range or JED is not finite. Safe to call from multiple threads at once:
+// the source ephemeris is evaluated without holding the cache lock.
+
+bool SSChebyshevEphemeris::compute ( int id, double jed, SSVector &pos, SSVector &vel )
+{
+    if ( id < 0 || id >= (int) _spans.size() || ! isfinite ( jed ) )
+        return false;
+
+    Window window = { 0.0 };
+    int splits = 0;
+    bool found = false;
+
+    // Look for a cached window containing the JED.
+
+    _mutex.lock();
+    map<double,Window> &windows = _windows[id];
+    auto it = windows.upper_bound ( jed );
+    if ( it != windows.begin() )
+    {
+        --it;
+        if ( jed < it->second.start + it->second.span )
+        {
+            window = it->second;
+            found = true;
+        }
+    }
+
+    if ( found )
+        _hits++;
+    else
+        _misses++;
+
+    splits = _splits[id];
+    _mutex.unlock();
+
+    // If not found, fit a new window at the current split level, splitting further as needed.
+    // Windows are aligned to a grid of their own length, counting from J2000, so windows at
+    // different split levels are either nested or don't overlap.
+
+    if ( ! found )
+    {
+        for ( ; splits <= kMaxSplits && ! found; splits++ )
+        {
+            double span = _spans[id] / ( 1 << splits );
+            double start = SSTime::kJ2000 + floor ( ( jed - SSTime::kJ2000 ) / span ) * span;
+            found = fitWindow ( id, start, span, window );
+        }
+
+        if ( ! found )
+        {
+            _source ( id, jed, pos, vel );
+            return true;
+        }
+
+        // Cache the new window, unless another thread beat us to it; then discard oldest windows.
+
+        lock_guard<mutex> lock ( _mutex );
+        _splits[id] = max ( _splits[id], splits - 1 );
+        if ( windows.insert ( { window.start, window } ).second )
+            _order.push_back ( { id, window.start } );
+
+        while ( _order.size() > _maxWindows )
+        {
+            _windows[ _order.front().first ].erase ( _order.front().second );
+            _order.pop_front();
+            _evictions++;
+        }
+    }
+
+    evalWindow ( window, 2.0 * ( jed - window.start ) / window.span - 1.0, pos, vel );
+    return true;
+}
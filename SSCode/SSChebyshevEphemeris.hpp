@@ -0,0 +1,80 @@
+// SSChebyshevEphemeris.hpp
+// SSCore
+//
+// Created by Tim DeBenedictis on 10/16/26.
+// Copyright © 2026 Southern Stars. All rights reserved.
+//
+// Caches a slow ephemeris (like VSOP2013/ELPMPP02) as piecewise Chebyshev polynomial
+// fits, built lazily over time windows as positions are requested. Effectively this is
+// an in-memory JPL DE-style ephemeris file, computed on demand. Each window is checked
+// against the source ephemeris when it is fit, and is split in half until the fit
+// agrees with the source to within a relative tolerance. Thread-safe, with a bounded
+// number of cached windows; the oldest windows are discarded when that limit is reached.
+// Position and velocity are fit independently, because the velocities returned by
+// VSOP2013 and ELPMPP02 are not exact derivatives of their positions.
+
+#ifndef SSChebyshevEphemeris_hpp
+#define SSChebyshevEphemeris_hpp
+
+#include <map>
+#include <deque>
+#include <mutex>
+
+#include "SSVector.hpp"
+
+class SSChebyshevEphemeris
+{
+public:
+
+    // Source ephemeris function: computes position and velocity of object (id) at Julian Ephemeris Date (jed).
+    // Must be safe to call from multiple threads simultaneously.
+
+    typedef void (*Source) ( int id, double jed, SSVector &pos, SSVector &vel );
+
+    static constexpr int kNumCoeffs = 14;               // number of Chebyshev coefficients per component
+    static constexpr int kMaxSplits = 6;                // maximum number of times a window is split in half
+    static constexpr double kDefaultTolerance = 1.0e-9; // default maximum position and velocity error, relative to their magnitudes
+    static constexpr size_t kDefaultMaxWindows = 65536; // default maximum number of cached windows (about 45 MB)
+
+protected:
+
+    // A single time window, with Chebyshev coefficients of position and velocity.
+
+    struct Window
+    {
+        double start;                       // starting Julian Ephemeris Date
+        double span;                        // length of window in days
+        double coeffs[6][kNumCoeffs];       // Chebyshev coefficients of x, y, z, vx, vy, vz
+    };
+
+    Source _source;                         // source ephemeris function
+    vector<double> _spans;                  // initial window length in days for each object identifier
+    vector<int> _splits;                    // number of times windows have been split for each object identifier
+    vector<map<double,Window>> _windows;    // cached windows for each object identifier, indexed by starting JED
+    deque<pair<int,double>> _order;         // object identifier and starting JED of cached windows, oldest first
+    double _tolerance;                      // maximum relative error of cached windows
+    size_t _maxWindows;                     // maximum number of cached windows
+    size_t _hits, _misses, _evictions;      // cache statistics
+    mutex _mutex;                           // guards all of the above
+
+    bool fitWindow ( int id, double start, double span, Window &window );
+    static void evalWindow ( const Window &window, double x, SSVector &pos, SSVector &vel );
+
+public:
+
+    SSChebyshevEphemeris ( Source source, const vector<double> &spans );
+
+    void setTolerance ( double tolerance ) { _tolerance = tolerance; }
+    double getTolerance ( void ) { return _tolerance; }
+
+    void setMaxWindows ( size_t maxWindows );
+    size_t getMaxWindows ( void ) { return _maxWindows; }
+
+    size_t numWindows ( void );
+    void getStatistics ( size_t &hits, size_t &misses, size_t &evictions );
+    void clear ( void );
+
+    bool compute ( int id, double jed, SSVector &pos, SSVector &vel );
+};
+
+#endif /* SSChebyshevEphemeris_hpp */
@@ -49,15 +49,26 @@ SSConstellationPtr SSGetConstellationPtr ( SSObjectPtr ptr )
 // Allocates a new SSConstellation and initializes it from a CSV-formatted string.
 // Returns nullptr on error (invalid CSV string, heap allocation failure, etc.)
 
-SSObjectPtr SSConstellation::fromCSV ( string csv )
+SSObjectPtr SSConstellation::fromCSV ( string_view csv )
 {
-    // split line into comma-delimited fields. Eliminate lines with insufficient fields or header lines.
+    // split line into comma-delimited fields, then parse them.
     
-    vector<string> fields = split ( csv, "," );
-    if ( fields.size() < 8 || strncmp ( fields[0].c_str(), "Type", 4) == 0 )
+    vector<string_view> fields;
+    split ( csv, ",", fields );
+    return fromCSV ( fields );
+}
+
+// Creates a constellation or asterism from fields split from a CSV-format text line
+// at every comma. Fields are not trimmed. Returns nullptr if the fields do not describe one.
+
+SSObjectPtr SSConstellation::fromCSV ( vector<string_view> &fields )
+{
+    // Eliminate lines with insufficient fields or header lines.
+    
+    if ( fields.size() < 8 || fields[0].substr ( 0, 4 ) == "Type" )
         return nullptr;
 
-    SSObjectType type = SSObject::codeToType ( fields[0] );
+    SSObjectType type = SSObject::codeToType ( string ( fields[0] ) );
     if ( type < kTypeConstellation || type > kTypeAsterism )
         return nullptr;
     
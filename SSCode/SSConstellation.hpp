@@ -48,9 +48,10 @@ public:
     static int abbreviationToIndex ( string abbrev );
     static string indexToAbbreviation ( int index );
     
-    // imports/exports from/to CSV-format text string
+    // imports/exports from/to CSV-format text string, or from fields already split from one
     
-    static SSObjectPtr fromCSV ( string csv );
+    static SSObjectPtr fromCSV ( string_view csv );
+    static SSObjectPtr fromCSV ( vector<string_view> &fields );
     string toCSV ( void );
     
     // identifies constellation from equatorial cooordinates (B1875 spherical or J2000 rectangular unit vector)
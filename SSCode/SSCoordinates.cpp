@@ -24,13 +24,15 @@ SSCoordinates::SSCoordinates ( SSTime time, SSSpherical loc )
     _lat = loc.lat;
     _alt = loc.rad;
     
-    setTime ( time );
-    
     _starParallax = true;
     _starMotion = true;
     _aberration = true;
     _lighttime = true;
     _dynamictime = true;
+
+    // Flags must be set first, since setTime() uses the dynamic time flag.
+
+    setTime ( time );
 }
 
 // Changes this coordinate transformation object's Julian Date (time) and recomputes
@@ -0,0 +1,230 @@
+// SSEphemerisEngine.cpp
+// SSCore
+//
+// Created by Tim DeBenedictis on 10/16/26.
+// Copyright © 2026 Southern Stars. All rights reserved.
+
+#include "SSEphemerisEngine.hpp"
+#include "SSStar.hpp"
+
+// Packs a range of chunk indices from next to end (exclusive) into a single 64-bit value, and unpacks it.
+
+static inline uint64_t packRange ( uint64_t next, uint64_t end ) { return ( next << 32 ) | end; }
+static inline size_t rangeNext ( uint64_t range ) { return (size_t) ( range >> 32 ); }
+static inline size_t rangeEnd ( uint64_t range ) { return (size_t) ( range & 0xffffffff ); }
+
+// Constructs an ephemeris engine with the given total number of threads (nthreads), including
+// the thread which calls computeEphemeris(). If nthreads is zero or negative, uses one thread
+// per hardware core. Worker threads are started here and wait until there is work to do.
+
+SSEphemerisEngine::SSEphemerisEngine ( int nthreads )
+{
+    if ( nthreads < 1 )
+        nthreads = max ( 1, (int) thread::hardware_concurrency() );
+
+    _nthreads = nthreads;
+    _chunkSize = kDefaultChunkSize;
+    _shares = vector<Share> ( nthreads );
+    _contexts = vector<SSEphemerisContext> ( nthreads );
+    _deferred = vector<vector<size_t>> ( nthreads );
+    _counts = vector<size_t> ( nthreads, 0 );
+    _steals = 0;
+    _pObjects = nullptr;
+    _pCoords = nullptr;
+    _generation = 0;
+    _running = 0;
+    _quit = false;
+
+    for ( int i = 0; i < nthreads; i++ )
+        _shares[i].range = 0;
+
+    for ( int i = 1; i < nthreads; i++ )
+        _workers.push_back ( thread ( &SSEphemerisEngine::workerLoop, this, i ) );
+}
+
+// Tells worker threads to exit and waits for them to finish.
+
+SSEphemerisEngine::~SSEphemerisEngine ( void )
+{
+    _mutex.lock();
+    _quit = true;
+    _mutex.unlock();
+    _startCond.notify_all();
+
+    for ( thread &worker : _workers )
+        worker.join();
+}
+
+// Worker thread (ithread) main loop. Waits for a new pass to start, works on it,
+// then reports when done. Returns when the engine is destroyed.
+
+void SSEphemerisEngine::workerLoop ( int ithread )
+{
+    uint64_t generation = 0;
+
+    while ( true )
+    {
+        unique_lock<mutex> lock ( _mutex );
+        _startCond.wait ( lock, [&] { return _quit || _generation != generation; } );
+        if ( _quit )
+            return;
+
+        generation = _generation;
+        lock.unlock();
+
+        work ( ithread );
+
+        lock.lock();
+        if ( --_running == 0 )
+            _doneCond.notify_one();
+    }
+}
+
+// Takes the next chunk from this thread's own share, from the front. If that is empty,
+// steals the last chunk from another thread's share. Returns false when no chunks remain.
+
+bool SSEphemerisEngine::takeChunk ( int ithread, size_t &chunk )
+{
+    atomic<uint64_t> &own = _shares[ithread].range;
+    uint64_t range = own.load();
+
+    while ( rangeNext ( range ) < rangeEnd ( range ) )
+    {
+        if ( own.compare_exchange_weak ( range, packRange ( rangeNext ( range ) + 1, rangeEnd ( range ) ) ) )
+        {
+            chunk = rangeNext ( range );
+            return true;
+        }
+    }
+
+    for ( int i = 1; i < _nthreads; i++ )
+    {
+        atomic<uint64_t> &other = _shares[ ( ithread + i ) % _nthreads ].range;
+        range = other.load();
+
+        while ( rangeNext ( range ) < rangeEnd ( range ) )
+        {
+            if ( other.compare_exchange_weak ( range, packRange ( rangeNext ( range ), rangeEnd ( range ) - 1 ) ) )
+            {
+                chunk = rangeEnd ( range ) - 1;
+                _steals++;
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+// Computes ephemerides of all objects in a chunk, using this thread's ephemeris context.
+// Solar system objects are computed with that context instead of the calling thread's own.
+// Double stars which depend on their primary are deferred, since another thread may be
+// computing the same primary.
+
+void SSEphemerisEngine::computeChunk ( int ithread, size_t chunk )
+{
+    SSEphemerisContext &context = _contexts[ithread];
+    SSCoordinates &coords = *_pCoords;
+    size_t end = min ( ( chunk + 1 ) * _chunkSize, _pObjects->size() );
+
+    for ( size_t i = chunk * _chunkSize; i < end; i++ )
+    {
+        SSObjectPtr pObj = _pObjects->get ( i );
+        if ( pObj == nullptr )
+            continue;
+
+        SSObjectType type = pObj->getType();
+        if ( type >= kTypePlanet && type <= kTypeSpacecraft )
+        {
+            static_cast<SSPlanet *> ( pObj )->computeEphemeris ( coords, context );
+        }
+        else if ( type == kTypeDoubleStar || type == kTypeDoubleVariableStar )
+        {
+            SSDoubleStarPtr pDouble = SSGetDoubleStarPtr ( pObj );
+            if ( pDouble && pDouble->hasOrbit() && pDouble->getPrimary() && pDouble->getPrimary() != pDouble )
+                _deferred[ithread].push_back ( i );
+            else
+                pObj->computeEphemeris ( coords );
+        }
+        else
+        {
+            pObj->computeEphemeris ( coords );
+        }
+    }
+
+    _counts[ithread]++;
+}
+
+// Computes chunks until none remain in any thread's share.
+
+void SSEphemerisEngine::work ( int ithread )
+{
+    size_t chunk = 0;
+
+    while ( takeChunk ( ithread, chunk ) )
+        computeChunk ( ithread, chunk );
+}
+
+// Computes apparent direction, distance, and magnitude of all objects in an array (objects)
+// as seen from observer coordinates (coords). Returns when all objects have been computed.
+// The objects and coordinates must not be modified by other threads until then. Objects
+// must not appear in the array more than once. Not reentrant: only one thread at a time
+// may call this method on a given engine.
+
+void SSEphemerisEngine::computeEphemeris ( SSObjectArray &objects, SSCoordinates &coords )
+{
+    size_t nchunks = ( objects.size() + _chunkSize - 1 ) / _chunkSize;
+    if ( nchunks == 0 )
+        return;
+
+    // Split chunks evenly among threads. If there are fewer chunks than threads,
+    // or too many chunks to index, just compute everything on this thread.
+
+    int nthreads = nchunks < (size_t) _nthreads || nchunks > 0xffffffff ? 1 : _nthreads;
+
+    _pObjects = &objects;
+    _pCoords = &coords;
+    _steals = 0;
+
+    for ( int i = 0; i < _nthreads; i++ )
+    {
+        _counts[i] = 0;
+        _deferred[i].clear();
+        _shares[i].range = i < nthreads ? packRange ( nchunks * i / nthreads, nchunks * ( i + 1 ) / nthreads ) : 0;
+    }
+
+    if ( nthreads > 1 )
+    {
+        _mutex.lock();
+        _generation++;
+        _running = _nthreads - 1;
+        _mutex.unlock();
+        _startCond.notify_all();
+    }
+
+    work ( 0 );
+
+    if ( nthreads > 1 )
+    {
+        unique_lock<mutex> lock ( _mutex );
+        _doneCond.wait ( lock, [&] { return _running == 0; } );
+    }
+
+    // Now compute the dependent double stars, which may share primaries.
+
+    for ( int i = 0; i < _nthreads; i++ )
+        for ( size_t j : _deferred[i] )
+            objects[j]->computeEphemeris ( coords );
+
+    _pObjects = nullptr;
+    _pCoords = nullptr;
+}
+
+// Returns the number of chunks computed by each thread (counts), and the total number of chunks
+// stolen from one thread by another (steals), during the last call to computeEphemeris().
+
+void SSEphemerisEngine::getStatistics ( vector<size_t> &counts, size_t &steals )
+{
+    counts = _counts;
+    steals = _steals;
+}
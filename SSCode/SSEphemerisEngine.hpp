@@ -0,0 +1,83 @@
+// SSEphemerisEngine.hpp
+// SSCore
+//
+// Created by Tim DeBenedictis on 10/16/26.
+// Copyright © 2026 Southern Stars. All rights reserved.
+//
+// Computes apparent direction, distance, and magnitude of every object in an SSObjectArray
+// from a single SSCoordinates, using a persistent pool of worker threads. The array is split
+// into fixed-size chunks of consecutive objects. Each thread starts with an equal share of
+// the chunks and works through them front to back; a thread that runs out of chunks steals
+// from the back of another thread's share. This keeps all threads busy even when objects
+// differ greatly in cost, like asteroids (Kepler's equation), satellites (SGP4/SDP4), and
+// stars (linear motion and aberration). Each thread has its own SSEphemerisContext, so
+// solar system objects are computed without locking. Double stars whose ephemeris depends on
+// their primary star are computed serially after all other objects.
+
+#ifndef SSEphemerisEngine_hpp
+#define SSEphemerisEngine_hpp
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "SSPlanet.hpp"
+
+class SSEphemerisEngine
+{
+public:
+
+    static constexpr size_t kDefaultChunkSize = 256;    // default number of objects per chunk
+
+protected:
+
+    // A thread's share of the chunks: index of the next chunk in the upper 32 bits,
+    // and one past the last chunk in the lower 32 bits. Padded to a cache line so
+    // threads updating their own shares don't contend with each other.
+
+    struct Share
+    {
+        atomic<uint64_t> range;
+        char padding[64 - sizeof ( atomic<uint64_t> )];
+    };
+
+    int _nthreads;                          // total number of threads, including the calling thread
+    size_t _chunkSize;                      // number of objects per chunk
+    vector<thread> _workers;                // worker threads; the calling thread is thread zero
+    vector<Share> _shares;                  // each thread's share of chunks
+    vector<SSEphemerisContext> _contexts;   // each thread's solar system ephemeris context
+    vector<vector<size_t>> _deferred;       // indices of dependent double stars found by each thread
+    vector<size_t> _counts;                 // number of chunks computed by each thread during the last pass
+    atomic<size_t> _steals;                 // number of chunks stolen during the last pass
+
+    SSObjectArray *_pObjects;               // objects whose ephemerides are being computed
+    SSCoordinates *_pCoords;                // observer coordinates for current computation
+
+    mutex _mutex;                           // guards everything below
+    condition_variable _startCond;          // signals workers to start a pass, or quit
+    condition_variable _doneCond;           // signals calling thread that workers have finished a pass
+    uint64_t _generation;                   // incremented at the start of each pass
+    int _running;                           // number of worker threads still working on the current pass
+    bool _quit;                             // tells worker threads to exit
+
+    void workerLoop ( int ithread );
+    void work ( int ithread );
+    bool takeChunk ( int ithread, size_t &chunk );
+    void computeChunk ( int ithread, size_t chunk );
+
+public:
+
+    SSEphemerisEngine ( int nthreads = 0 );
+    ~SSEphemerisEngine ( void );
+
+    int getNumThreads ( void ) { return _nthreads; }
+
+    void setChunkSize ( size_t chunkSize ) { _chunkSize = chunkSize > 0 ? chunkSize : 1; }
+    size_t getChunkSize ( void ) { return _chunkSize; }
+
+    void computeEphemeris ( SSObjectArray &objects, SSCoordinates &coords );
+    void getStatistics ( vector<size_t> &counts, size_t &steals );
+};
+
+#endif /* SSEphemerisEngine_hpp */
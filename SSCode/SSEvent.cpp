@@ -5,6 +5,7 @@
 // Copyright © 2020 Southern Stars. All rights reserved.
 
 #include "SSEvent.hpp"
+#include "SSPassPredictor.hpp"
 
 // Computes the hour angle when an object with declination (dec)
 // as seen from latitude (lat) reaches an altitude (alt) above
@@ -429,9 +430,24 @@ void SSEvent::findFarthestDistances ( SSCoordinates &coords, SSObjectPtr pObj1,
 // also recorded in each pass's transit struct. The method returns the total number of passes found, and
 // returns all pass circumstances in the vector of SSPass structs.  The function also stops searching when
 // it finds the maximum number of passes (maxPasses).
-// After return, both coords and pObj will be restored to their original states.
+// Earth satellites are handed to SSPassPredictor, which is much faster than the generic event search
+// in findObjectPasses(), and leaves coords and pSat untouched. Other objects use findObjectPasses().
 
 int SSEvent::findSatellitePasses ( SSCoordinates &coords, SSObjectPtr pSat, SSTime start, SSTime stop, double minAlt, vector<SSPass> &passes, int maxPasses )
+{
+    SSSatellitePtr pSatellite = SSGetSatellitePtr ( pSat );
+    if ( pSatellite == nullptr )
+        return findObjectPasses ( coords, pSat, start, stop, minAlt, passes, maxPasses );
+    
+    SSPassPredictor predictor ( coords.getLocation(), minAlt );
+    return predictor.findPasses ( pSatellite, start, stop, passes, maxPasses );
+}
+
+// Searches for passes of any object (pSat) using the generic event finders, stepping one minute at a time.
+// Arguments and return value are the same as findSatellitePasses(), and the same rules apply.
+// After return, both coords and pObj will be restored to their original states.
+
+int SSEvent::findObjectPasses ( SSCoordinates &coords, SSObjectPtr pSat, SSTime start, SSTime stop, double minAlt, vector<SSPass> &passes, int maxPasses )
 {
     SSTime  savetime = coords.getTime();
     
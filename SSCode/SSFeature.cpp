@@ -15,7 +15,7 @@ SSFeature::SSFeature ( void ) : SSObject ( kTypeFeature )
 {
     // initialize SSObject::_names with two empty strings for UTF-8 name and ASCII/Clean name
     
-    _names = vector<string> ( { "", "" } );
+    _names.assign ( 2, "" );
     _target = "";
     _type_code = "";
     _origin = "";
@@ -38,22 +38,34 @@ void SSFeature::computeEphemeris ( SSPlanet *pTarget )
 // Allocates a new SSFeature and initializes it from a CSV-formatted string.
 // Returns nullptr on error (invalid CSV string, heap allocation failure, etc.)
 
-SSObjectPtr SSFeature::fromCSV ( string csv )
+SSObjectPtr SSFeature::fromCSV ( string_view csv )
 {
     if ( csv.size() == 0 )
         return nullptr;
 
-    // split string into comma-delimited fields, Eliminate without fields or header lines.
+    // split string into comma-delimited fields, then parse them.
+    
+    vector<string_view> fields;
+    string buffer;
+    split_csv ( csv, fields, buffer );
+    return fromCSV ( fields );
+}
+
+// Creates a feature or city from fields split from a CSV-format text line by split_csv().
+// Fields are trimmed in place. Returns nullptr if the fields do not describe one.
+
+SSObjectPtr SSFeature::fromCSV ( vector<string_view> &fields )
+{
+    // Eliminate lines without fields or header lines.
     // remove leading & trailing whitespace/line breaks from each field.
     
-    vector<string> fields = split_csv ( csv );
-    if ( fields.size() < 1 || strncmp ( fields[0].c_str(), "Type", 4 ) == 0 )
+    if ( fields.size() < 1 || fields[0].substr ( 0, 4 ) == "Type" )
         return nullptr;
 
     for ( int i = 0; i < fields.size(); i++ )
-        fields[i] = trim ( fields[i] );
+        fields[i] = trim_view ( fields[i] );
     
-    SSObjectType type = SSObject::codeToType ( fields[0] );
+    SSObjectType type = SSObject::codeToType ( string ( fields[0] ) );
     if ( type != kTypeFeature && type != kTypeCity )
         return nullptr;
     
@@ -76,17 +88,17 @@ SSObjectPtr SSFeature::fromCSV ( string csv )
     if ( pFeature == nullptr )
         return nullptr;
     
-    pFeature->setName ( fields[1] );
-    pFeature->setCleanName ( fields[2] );
+    pFeature->setName ( string ( fields[1] ) );
+    pFeature->setCleanName ( string ( fields[2] ) );
 
     if ( type == kTypeFeature )
     {
-        pFeature->setTarget ( fields[3] );
+        pFeature->setTarget ( string ( fields[3] ) );
         pFeature->setDiameter ( strtofloat64 ( fields[4] ) );
         pFeature->setLatitude ( strtofloat64 ( fields[5] ) );
         pFeature->setLongitude ( strtofloat64 ( fields[6] ) );
-        pFeature->setFeatureTypeCode ( fields[7] );
-        pFeature->setOrigin ( fields[8] );
+        pFeature->setFeatureTypeCode ( string ( fields[7] ) );
+        pFeature->setOrigin ( string ( fields[8] ) );
     }
 
     if ( type == kTypeCity )
@@ -94,12 +106,12 @@ SSObjectPtr SSFeature::fromCSV ( string csv )
         pFeature->setTarget ( "Earth" );
         pFeature->setLatitude ( strtofloat64 ( fields[3] ) );
         pFeature->setLongitude ( strtofloat64 ( fields[4] ) );
-        pCity->setCountryCode ( fields[5] );
-        pCity->setAdmin1Code ( fields[6] );
+        pCity->setCountryCode ( string ( fields[5] ) );
+        pCity->setAdmin1Code ( string ( fields[6] ) );
         pCity->setPopulation ( strtoint ( fields[7] ) );
-        if ( fields[8] != "" ) pCity->setElevation ( strtofloat ( fields[8] ) );
-        pCity->setTimezoneName ( fields[9] );
-        pCity->setAdmin1Name ( fields[10] );
+        if ( ! fields[8].empty() ) pCity->setElevation ( strtofloat ( fields[8] ) );
+        pCity->setTimezoneName ( string ( fields[9] ) );
+        pCity->setAdmin1Name ( string ( fields[10] ) );
         pCity->setDaylightSaving ( !!strtoint( fields[11] ) );
         pCity->setTimezoneRawOffset ( strtofloat64 ( fields[12] ) );
     }
@@ -57,9 +57,10 @@ public:
     void setLatitude ( double lat ) { _lat = lat; }
     void setLongitude ( double lon ) { _lon = lon; }
 
-    // imports/exports from/to CSV-format text string
+    // imports/exports from/to CSV-format text string, or from fields already split from one
     
-    static SSObjectPtr fromCSV ( string csv );
+    static SSObjectPtr fromCSV ( string_view csv );
+    static SSObjectPtr fromCSV ( vector<string_view> &fields );
     virtual string toCSV ( void );
     
     // computes apparent direction and distance; planet must already have ephemeris computed.
@@ -111,7 +112,7 @@ public:
 
     // imports/exports from/to CSV-format text string
     
-    static SSObjectPtr fromCSV ( string csv );
+    static SSObjectPtr fromCSV ( string_view csv );
     virtual string toCSV ( void );
 };
 
@@ -7,8 +7,23 @@
 #include <iostream>
 #include <fstream>
 #include <string.h>
+#include <algorithm>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+// Keep clang from fusing multiplies and adds in the HTM triangle math, so the SIMD
+// versions of vector2ID() below produce exactly the same results as the scalar version.
+
+#if defined(__clang__)
+#pragma STDC FP_CONTRACT OFF
+#endif
 
 #include "SSHTM.hpp"
+#include "SSLineReader.hpp"
 
 uint64_t cc_vector2ID ( double x, double y, double z, int depth );
 int cc_IDlevel ( uint64_t htmid );
@@ -17,6 +32,21 @@ int cc_ID2name ( char *name, uint64_t id );
 uint64_t cc_name2ID ( const char *name );
 int cc_name2Triangle ( const char *name, double *v0, double *v1, double *v2 );
 
+// Geometry of an HTM triangle: vertices, and bounding circle. The bounding circle passes through
+// the vertex farthest from the triangle's centroid; since it is smaller than a hemisphere, it
+// contains the whole triangle.
+
+struct HTMTriangle
+{
+    SSVector v0, v1, v2;            // vertex unit vectors, counter-clockwise
+    SSVector center;                // bounding circle center unit vector
+    double   radius;                // bounding circle angular radius in radians
+    double   cosRadius, sinRadius;  // cosine and sine of bounding circle radius
+};
+
+static const HTMTriangle &getTriangle ( uint64_t htmID, int level, HTMTriangle &temp );
+static int triangleLevel ( uint64_t htmID );
+
 // If not NULL, this function is called after a region is loaded asynchronously.
 
 static SSHTM::RegionLoadCallback _callback = nullptr;
@@ -51,10 +81,65 @@ SSHTM::SSHTM ( const vector<float> &magLevels, const string &rootpath )
         _rootpath += '/';
 }
 
-// Destructor frees memory for all loaded regions and all objects therein.
+// Move constructor takes over another HTM's regions, settings, and indexes.
+
+SSHTM::SSHTM ( SSHTM &&other )
+{
+    *this = std::move ( other );
+}
+
+// Move assignment dumps this HTM's regions, then takes over another HTM's regions,
+// settings, and indexes, leaving the other HTM empty. Stops both HTMs' background
+// loading threads first; regions still queued for loading are discarded.
+
+SSHTM &SSHTM::operator = ( SSHTM &&other )
+{
+    if ( this == &other )
+        return *this;
+
+#if USE_THREADS
+    _stopLoadThreads ( true );
+    other._stopLoadThreads ( true );
+    _numThreads = other._numThreads;
+#endif
+    dumpRegions();
+
+    _readFunc = other._readFunc;
+    _writeFunc = other._writeFunc;
+    _regions = std::move ( other._regions );
+    _lru = std::move ( other._lru );
+    _magLevels = std::move ( other._magLevels );
+    _rootpath = std::move ( other._rootpath );
+    _maxObjects = other._maxObjects;
+    _maxBytes = other._maxBytes;
+    _numObjects = other._numObjects;
+    _numBytes = other._numBytes;
+    _hits = other._hits;
+    _misses = other._misses;
+    _evictions = other._evictions;
+    _useArenas = other._useArenas.load();
+    _panCenter = other._panCenter;
+    _panVelocity = other._panVelocity;
+    _panTime = other._panTime;
+    _nameIndex = std::move ( other._nameIndex );
+    _identIndex = std::move ( other._identIndex );
+    _nameSearch = std::move ( other._nameSearch );
+    _identSearch = std::move ( other._identSearch );
+
+    other._regions.clear();
+    other._lru.clear();
+    other._numObjects = other._numBytes = 0;
+    return *this;
+}
+
+// Destructor stops background loading threads, then frees memory
+// for all loaded regions and all objects therein.
 
 SSHTM::~SSHTM ( void )
 {
+#if USE_THREADS
+    _stopLoadThreads ( true );
+#endif
     dumpRegions();
 }
 
@@ -103,49 +188,107 @@ bool SSHTM::magLimits ( uint64_t htmID, float &min, float &max )
     return true;
 }
 
-// Stores a pointer to a star or deep sky object in this HTM, creating an HTM region to store it in, if needed.
-// Returns true if successful or false if the star cannot be stored.
+// Returns the HTM level where a star should be stored, based on its magnitude,
+// or -1 if the star cannot be stored. Stars closer than 10 parsecs go in the root region.
 
-bool SSHTM::store ( SSStar *pStar )
+int SSHTM::_storeLevel ( SSStar *pStar )
 {
     float mag = pStar->getVMagnitude();
     if ( isinf ( mag ) )
         mag = pStar->getBMagnitude();
     
-    SSVector pos = pStar->getFundamentalPosition();
+    return pStar->getParallax() > 0.1 ? 0 : magLevel ( mag );
+}
 
-    // Store stars closer than 10 parsecs in root region.
+// Stores a pointer to a star in the HTM region with the given ID (htmID), creating the region if needed.
+
+void SSHTM::_store ( SSStar *pStar, uint64_t htmID )
+{
+    unique_lock<mutex> lock ( _mutex );
+    _waitForLoad ( lock, htmID );
+
+    Region &region = _regions[htmID];
+    if ( region.pObjects == nullptr )
+    {
+        region = { kLoaded, new SSObjectVec(), 0, true };
+    }
+    else if ( ! region.stored )
+    {
+        _lru.erase ( region.lru );
+        _numObjects -= region.pObjects->size();
+        _numBytes -= region.bytes;
+        region.stored = true;
+    }
     
-    int level = pStar->getParallax() > 0.1 ? 0 : magLevel ( mag );
+    region.pObjects->append ( pStar );
+}
+
+// Stores a pointer to a star or deep sky object in this HTM, creating an HTM region to store it in, if needed.
+// Returns true if successful or false if the star cannot be stored. Regions which receive stored stars
+// are never dumped to meet the memory budget, since they may not be reloadable from files.
+
+bool SSHTM::store ( SSStar *pStar )
+{
+    int level = _storeLevel ( pStar );
     if ( level < 0 )
         return false;
     
     uint64_t htmID = 0;
     if ( level > 0 )
-        htmID = SSHTM::vector2ID ( pos, level - 1 );
+        htmID = SSHTM::vector2ID ( pStar->getFundamentalPosition(), level - 1 );
 
-    if ( _regions.count ( htmID ) == 0 )
-        _regions[htmID] = new SSObjectVec();
-    
-    _regions[htmID]->append ( pStar );
+    _store ( pStar, htmID );
     return true;
 }
 
 // Stores all stars and deep sky objects in an array of object pointers (objects)
-// into this HTM, and returns the total number of pointers stored.
+// into this HTM, and returns the total number of pointers stored. Computes the HTM IDs
+// of all stars at each level at once with vector2IDs(), then stores stars in their
+// original order, so regions receive the same objects in the same order as store ( pStar ).
 
 int SSHTM::store ( SSObjectVec &objects )
 {
-    int n = 0;
+    int n = 0, nlevels = (int) _magLevels.size();
+    vector<SSStar *> stars ( objects.size(), nullptr );
+    vector<int> levels ( objects.size(), -1 );
+    vector<uint64_t> ids ( objects.size(), 0 );
     
-    for ( int i = 0; i < objects.size(); i++ )
+    for ( size_t i = 0; i < objects.size(); i++ )
     {
-        SSStar *pStar = SSGetStarPtr ( objects[i] );
-        if ( pStar == nullptr )
-            continue;
+        stars[i] = SSGetStarPtr ( objects[i] );
+        if ( stars[i] != nullptr )
+            levels[i] = _storeLevel ( stars[i] );
+    }
+    
+    for ( int level = 1; level < nlevels; level++ )
+    {
+        vector<size_t> indexes;
+        vector<double> x, y, z;
+        for ( size_t i = 0; i < objects.size(); i++ )
+        {
+            if ( levels[i] == level )
+            {
+                SSVector pos = stars[i]->getFundamentalPosition();
+                indexes.push_back ( i );
+                x.push_back ( pos.x );
+                y.push_back ( pos.y );
+                z.push_back ( pos.z );
+            }
+        }
         
-        if ( store ( pStar ) )
+        vector<uint64_t> levelIDs ( indexes.size() );
+        vector2IDs ( x.data(), y.data(), z.data(), indexes.size(), level - 1, levelIDs.data() );
+        for ( size_t j = 0; j < indexes.size(); j++ )
+            ids[ indexes[j] ] = levelIDs[j];
+    }
+    
+    for ( size_t i = 0; i < objects.size(); i++ )
+    {
+        if ( levels[i] >= 0 )
+        {
+            _store ( stars[i], ids[i] );
             n++;
+        }
     }
     
     return n;
@@ -160,9 +303,16 @@ int SSHTM::store ( SSObjectVec &objects )
 int SSHTM::saveRegions ( void *userData )
 {
     int n = 0;
+    vector<uint64_t> ids;
     
+    _mutex.lock();
     for ( auto it = _regions.begin(); it != _regions.end(); it++ )
-        saveRegion ( it->first, userData );
+        if ( it->second.pObjects != nullptr )
+            ids.push_back ( it->first );
+    _mutex.unlock();
+
+    for ( uint64_t id : ids )
+        n += saveRegion ( id, userData );
     
     return n;
 }
@@ -176,12 +326,13 @@ int SSHTM::saveRegion ( uint64_t htmID, void *userData )
 {
     int n = 0;
     
-    if ( _regions.count ( htmID ) )
+    SSObjectVec *pObjects = _getObjects ( htmID, false );
+    if ( pObjects != nullptr )
     {
         if ( _writeFunc != nullptr )
-            n = _writeFunc ( this, htmID, _regions[htmID], userData );
+            n = _writeFunc ( this, htmID, pObjects, userData );
         else
-            n = SSExportObjectsToCSV ( _rootpath + ID2name ( htmID ) + ".csv", *_regions[htmID] );
+            n = SSExportObjectsToCSV ( _rootpath + ID2name ( htmID ) + ".csv", *pObjects );
     }
     
     return n;
@@ -207,71 +358,121 @@ int SSHTM::loadRegions ( uint64_t htmID, bool sync, void *userData )
 }
 
 // Loads star data for a single region in this HTM from a file in the HTM directory.
-// If sync is true, loads the region synchronously on the current thread, and
-// returns pointer to loaded object vector if sucessful, or nullptr on failure.
-// If sync is false, loads the region asynchronously on a background thread, and
-// returns nullptr; when finished loading region, calls notification callback
-// installed by SSHTMSetRegionLoadCallback() above, and subsequent calls to
-// loadRegion() or getObjects() return a pointer to the region's object vector.
+// If the region is already loaded, marks it as most recently used and returns pointer
+// to its object vector. If sync is true, loads the region synchronously on the current
+// thread (or waits for a background thread already loading it), and returns pointer to
+// loaded object vector if sucessful, or nullptr on failure. If sync is false, queues the
+// region for loading by a background thread, and returns nullptr; when finished loading
+// region, calls notification callback installed by SSHTMSetRegionLoadCallback() above,
+// and subsequent calls to loadRegion() or getObjects() return a pointer to the region's
+// object vector. Requests for regions already queued or loading are not repeated, and
+// regions whose data files are missing are not reloaded until dumped with dumpRegion(s).
+// First dumps least recently used regions, if needed, to meet the memory budget.
 // If USE_THREADS is 0, this function always loads synchronously.
 
 SSObjectVec *SSHTM::loadRegion ( uint64_t htmID, bool sync, void *userData )
 {
-    // If region is loaded, delete thread associated with loading it,
-    // then return pointer to that region's objects.
+    unique_lock<mutex> lock ( _mutex );
+    _trimRegions();
 
-    if ( regionLoaded ( htmID ) )
+    auto it = _regions.find ( htmID );
+    if ( it != _regions.end() && it->second.state == kLoaded )
     {
-#if USE_THREADS
-        if ( _loadThreads.count ( htmID ) != 0 )
-        {
-            if ( _loadThreads[htmID]->joinable() )
-                _loadThreads[htmID]->join();
-            delete _loadThreads[htmID];
-            _loadThreads.erase ( htmID );
-        }
-#endif
-        return getObjects ( htmID );
+        _hits++;
+        if ( ! it->second.stored )
+            _lru.splice ( _lru.end(), _lru, it->second.lru );
+        return it->second.pObjects;
     }
+
+    if ( it != _regions.end() && it->second.state == kMissing )
+        return nullptr;
     
 #if USE_THREADS
     if ( !sync )
     {
-        // Load in a background thread
+        // Queue for loading in a background thread, unless already queued or loading.
+        // If prefetchRegions() queued it, make sure it won't be cancelled.
 
-        if ( _loadThreads.count ( htmID ) == 0 )
+        if ( it == _regions.end() )
+        {
+            _misses++;
+            _regions[htmID] = { kQueued, nullptr, 0, false };
+            _loadQueue.push_back ( { htmID, _callback, userData, false } );
+            if ( _loadThreads.empty() )
+                _startLoadThreads();
+            _queueCond.notify_one();
+        }
+        else if ( it->second.state == kQueued )
         {
-            _loadThreads[htmID] = new thread ( &SSHTM::_loadRegion, this, htmID, _callback, userData );
-            _loadThreads[htmID]->detach();
+            for ( LoadRequest &request : _loadQueue )
+                if ( request.htmID == htmID )
+                    request.prefetch = false;
         }
 
         return nullptr;
     }
 #endif
     
-    // Load region synchronously.
+    // If a background thread is loading the region, wait for it.
+
+    if ( it != _regions.end() && it->second.state == kLoading )
+    {
+        _waitForLoad ( lock, htmID );
+        it = _regions.find ( htmID );
+        return it != _regions.end() ? it->second.pObjects : nullptr;
+    }
+
+    // Load region synchronously. If it was queued, background threads will skip it.
+
+    if ( it == _regions.end() )
+    {
+        _misses++;
+        _regions[htmID] = { kLoading, nullptr, 0, false };
+    }
+    else
+    {
+        it->second.state = kLoading;
+    }
 
-    _loadRegion ( htmID, nullptr, userData );
-    return _regions[htmID];
+    lock.unlock();
+    return _loadRegion ( htmID, nullptr, userData );
 }
 
-// Private method to load region, possibly from a background thread.
-// Returns pointed to loaded object vector if successful or nullptr on failure.
+// Private method to load region, possibly from a background thread. The region must already
+// be in the loading state; the mutex must not be locked. If using arenas, the region's objects,
+// including any created by a custom data file read function, are allocated from its object vector's
+// arena, and freed all at once when the region is dumped. Returns pointer to loaded object vector
+// if successful or nullptr on failure.
 
 SSObjectVec *SSHTM::_loadRegion ( uint64_t htmID, RegionLoadCallback callback, void *userData )
 {
     int n = 0;
-    SSObjectVec *objects = new SSObjectVec();
-    
+    SSObjectVec *objects = new SSObjectVec ( _useArenas );
+    SSObjectArena::Scope scope ( objects->getArena() );
+
     if ( _readFunc != nullptr )
         n = _readFunc ( this, htmID, objects, userData );
     else
         n = SSImportObjectsFromCSV ( _rootpath + ID2name ( htmID ) + ".csv", *objects );
     
+    size_t bytes = n > 0 ? estimateBytes ( objects ) : 0;
+
+    _mutex.lock();
+    Region &region = _regions[htmID];
     if ( n > 0 )
-        _regions[htmID] = objects;
+    {
+        region = { kLoaded, objects, bytes, false, _lru.insert ( _lru.end(), htmID ) };
+        _numObjects += objects->size();
+        _numBytes += bytes;
+    }
     else
+    {
+        region = { kMissing, nullptr, 0, false };
         delete objects;
+        objects = nullptr;
+    }
+    _mutex.unlock();
+    _loadedCond.notify_all();
     
     if ( callback != nullptr )
         callback ( this, htmID );
@@ -279,781 +480,2631 @@ SSObjectVec *SSHTM::_loadRegion ( uint64_t htmID, RegionLoadCallback callback, v
     return objects;
 }
 
-// Tests whether star data for a specific region in this HTM has been
-// loaded into memory, i.e. if that region exists in this HTM.
-
-bool SSHTM::regionLoaded ( uint64_t htmID )
-{
-    return _regions[htmID] != nullptr;
-}
-
-// Returns pointer to array of objects stored in the region
-// with the specified HTM triangle ID. If region is not present
-// in this HTM or objects have not been loaded, returns nullptr.
+// Waits until a region (htmID) is not being loaded by another thread. The lock must hold the mutex.
 
-SSObjectVec *SSHTM::getObjects ( uint64_t htmID )
+void SSHTM::_waitForLoad ( unique_lock<mutex> &lock, uint64_t htmID )
 {
-    return _regions[htmID];
+    _loadedCond.wait ( lock, [&]
+    {
+        auto it = _regions.find ( htmID );
+        return it == _regions.end() || it->second.state != kLoading;
+    } );
 }
 
-// Deletes all star data for a specific region in this HTM from memory.
+// Discards all regions queued for loading, then waits until no regions are being loaded
+// by other threads. The lock must hold the mutex.
 
-void SSHTM::dumpRegion ( uint64_t htmID )
+void SSHTM::_waitForLoads ( unique_lock<mutex> &lock )
 {
 #if USE_THREADS
-    // If still loading this region asynchronously, wait for load to complete
-    
-    if ( _loadThreads.count ( htmID ) != 0 )
+    _loadQueue.clear();
+#endif
+    for ( auto it = _regions.begin(); it != _regions.end(); )
     {
-        if ( _loadThreads[htmID]->joinable() )
-            _loadThreads[htmID]->join();
-        delete _loadThreads[htmID];
-        _loadThreads.erase ( htmID );
+        if ( it->second.state == kQueued )
+            it = _regions.erase ( it );
+        else
+            it++;
     }
-#endif
 
-    // Now delete object vector (and its objects) associated with this region.
-    
-    if ( _regions.count ( htmID ) )
+    _loadedCond.wait ( lock, [&]
     {
-        if ( _regions[htmID] != nullptr )
-            delete _regions[htmID];
-        _regions.erase ( htmID );
-    }
+        for ( auto it = _regions.begin(); it != _regions.end(); it++ )
+            if ( it->second.state == kLoading )
+                return false;
+        return true;
+    } );
 }
 
-// Deletes all star data for all regions in this HTM from memory if testFunc is nullptr.
-// Otherwise deletes only regions for which testFunc returns true.
-// userData is a pointer to arbitrary user-defined data passed to testFunc (if not nullptr).
+#if USE_THREADS
 
-void SSHTM::dumpRegions ( RegionTestCallback testFunc, void *userData )
+// Starts background region loading threads. The mutex must be locked.
+
+void SSHTM::_startLoadThreads ( void )
 {
-#if USE_THREADS
-    // Let all load threads run to completion, and delete them before destroying regions!
-    
-    for ( auto it = _loadThreads.begin(); it != _loadThreads.end(); it++ )
+    for ( int i = 0; i < _numThreads; i++ )
+        _loadThreads.push_back ( thread ( &SSHTM::_loadThreadLoop, this ) );
+}
+
+// Stops background region loading threads after they finish loading their current regions.
+// If discard is true, regions still queued for loading are discarded; otherwise they stay queued.
+
+void SSHTM::_stopLoadThreads ( bool discard )
+{
+    _mutex.lock();
+    _quit = true;
+    _mutex.unlock();
+    _queueCond.notify_all();
+
+    for ( thread &t : _loadThreads )
+        t.join();
+
+    unique_lock<mutex> lock ( _mutex );
+    _loadThreads.clear();
+    _quit = false;
+    if ( discard )
+        _waitForLoads ( lock );
+}
+
+// Background region loading thread main loop. Takes regions from the front of the load queue
+// and loads them until told to quit. Skips regions which have been dumped, or which another
+// thread has started loading synchronously, since they were queued. While the memory budget
+// is exceeded, waits for the owning thread to dump regions before loading more.
+
+void SSHTM::_loadThreadLoop ( void )
+{
+    unique_lock<mutex> lock ( _mutex );
+
+    while ( true )
     {
-        if ( it->second != nullptr )
-        {
-            if ( it->second->joinable() )
-                it->second->join();
-            delete it->second;
-        }
+        _queueCond.wait ( lock, [&] { return _quit || ( ! _loadQueue.empty() && ! _overBudget() ); } );
+        if ( _quit )
+            return;
+
+        LoadRequest request = _loadQueue.front();
+        _loadQueue.pop_front();
+
+        auto it = _regions.find ( request.htmID );
+        if ( it == _regions.end() || it->second.state != kQueued )
+            continue;
+
+        it->second.state = kLoading;
+        lock.unlock();
+        _loadRegion ( request.htmID, request.callback, request.userData );
+        lock.lock();
     }
+}
+
 #endif
-    
-    // Now delete object vectors (and their objects) for all loaded regions.
-    
-    for ( auto it = _regions.begin(); it != _regions.end(); it++ )
-    {
-        if ( it->second != nullptr )
-        {
-            if ( testFunc == nullptr )
-                delete it->second;
-            else if ( testFunc ( this, it->first, userData ) )
-                delete it->second;
-        }
-    }
 
+// Sets the number of background threads (n) used to load regions asynchronously.
+// Threads are started when the first region is queued. If threads are already running,
+// restarts them; regions already queued stay queued. If USE_THREADS is 0, does nothing.
+
+void SSHTM::setLoadThreads ( int n )
+{
 #if USE_THREADS
-    _loadThreads.clear();
+    n = max ( n, 1 );
+    if ( n == _numThreads )
+        return;
+
+    bool running = ! _loadThreads.empty();
+    if ( running )
+        _stopLoadThreads ( false );
+
+    lock_guard<mutex> lock ( _mutex );
+    _numThreads = n;
+    if ( running )
+        _startLoadThreads();
 #endif
-    _regions.clear();
 }
 
-// Empties all regions in this HTM, but does not delete objects!
+// Returns the number of background region loading threads, or zero if USE_THREADS is 0.
 
-void SSHTM::clearRegions ( void )
+int SSHTM::getLoadThreads ( void )
 {
-    for ( auto it = _regions.begin(); it != _regions.end(); it++ )
-        if ( it->second != nullptr )
-            it->second->clear();
+#if USE_THREADS
+    return _numThreads;
+#else
+    return 0;
+#endif
 }
 
-// Counts total number of stars stored in all regions in this HTM.
+// Estimates the number of bytes of memory used by an array of stars (pObjects), including their orbits,
+// and names and identifiers which don't fit inside the star objects, but not other strings.
 
-int SSHTM::countStars ( void )
+size_t SSHTM::estimateBytes ( SSObjectVec *pObjects )
 {
-    int count = 0;
-    
-    for ( auto it = _regions.begin(); it != _regions.end(); it++ )
-        if ( it->second != nullptr )
-            count += it->second->size();
-    
-    return count;
+    size_t bytes = sizeof ( SSObjectVec ) + pObjects->size() * sizeof ( SSObjectPtr );
+
+    for ( size_t i = 0; i < pObjects->size(); i++ )
+    {
+        SSObjectPtr pObject = pObjects->get ( i );
+        SSDoubleStarPtr pDouble = SSGetDoubleStarPtr ( pObject );
+        SSVariableStarPtr pVariable = SSGetVariableStarPtr ( pObject );
+
+        if ( pDouble && pVariable )
+            bytes += sizeof ( SSDoubleVariableStar );
+        else if ( pDouble )
+            bytes += sizeof ( SSDoubleStar );
+        else if ( pVariable )
+            bytes += sizeof ( SSVariableStar );
+        else if ( SSGetDeepSkyPtr ( pObject ) )
+            bytes += sizeof ( SSDeepSky );
+        else
+            bytes += sizeof ( SSStar );
+
+        if ( pDouble && pDouble->hasOrbit() )
+            bytes += sizeof ( SSOrbit );
+
+        const SSNames &names = pObject->getNames();
+        bytes += names.allocatedBytes();
+        for ( const string &name : names )
+            bytes += name.length() >= sizeof ( string ) ? name.length() + 1 : 0;
+
+        SSStarPtr pStar = SSGetStarPtr ( pObject );
+        if ( pStar )
+            bytes += pStar->getIdents().allocatedBytes();
+    }
+
+    return bytes;
 }
 
-// Counts number of stars stored in a single region in this HTM.
+// Sets memory budget for regions loaded from files, as a maximum number of objects (maxObjects)
+// and maximum estimated number of bytes (maxBytes). Zero means no limit. Immediately dumps
+// least recently used regions, if needed, to meet the new budget.
 
-int SSHTM::countStars ( uint64_t htmID )
+void SSHTM::setMemoryBudget ( size_t maxObjects, size_t maxBytes )
 {
-    int count = 0;
-    
-    if ( _regions.count ( htmID ) && _regions[htmID] != nullptr )
-        count = (int) _regions[htmID]->size();
-
-    return count;
+    lock_guard<mutex> lock ( _mutex );
+    _maxObjects = maxObjects;
+    _maxBytes = maxBytes;
+    _trimRegions();
 }
 
-// Given a unit vector to a point on the celestial sphere, returns the HTM ID
-// of the triangle containing that vector at a specific HTM depth level.
+// Gets memory budget for regions loaded from files, in objects (maxObjects) and bytes (maxBytes).
 
-uint64_t SSHTM::vector2ID ( const SSVector &vector, int depth )
+void SSHTM::getMemoryBudget ( size_t &maxObjects, size_t &maxBytes )
 {
-    return cc_vector2ID ( vector.x, vector.y, vector.z, depth );
+    lock_guard<mutex> lock ( _mutex );
+    maxObjects = _maxObjects;
+    maxBytes = _maxBytes;
 }
 
-// Given an HTM triangle name, returns the HTM ID of that triangle,
-// or zero if the name is not a valid HTM name.
+// Gets number of objects (numObjects) and estimated bytes (numBytes) in regions loaded from files.
 
-uint64_t SSHTM::name2ID ( const string &name )
+void SSHTM::getMemoryUsed ( size_t &numObjects, size_t &numBytes )
 {
-    if ( name.compare ( "O0" ) == 0 )
-        return 0;
-    
-    return cc_name2ID ( name.c_str() );
+    lock_guard<mutex> lock ( _mutex );
+    numObjects = _numObjects;
+    numBytes = _numBytes;
 }
 
-// Given an HTM triangle ID, returns the depth level of that triangle.
-// The whole celestrial sphere is level zero; the eight level 1 triangles
-// are N0 - N3 and S0 - S3; level 2 triangles are N00 - N33 and S00 - S33.
+// Dumps least recently used regions loaded from files until the memory budget is met, but never the
+// most recently used region. Returns the number of regions dumped. The mutex must be locked.
 
-int SSHTM::IDlevel ( uint64_t id )
+int SSHTM::_trimRegions ( void )
 {
-    return id == 0 ? 0 : cc_IDlevel ( id ) + 1;
+    int n = 0;
+
+    while ( _overBudget() )
+    {
+        _evictRegion ( _lru.front() );
+        _evictions++;
+        n++;
+    }
+
+#if USE_THREADS
+    if ( n > 0 )
+        _queueCond.notify_all();
+#endif
+    return n;
 }
 
-// Given an HTM triangle ID, returns the triangle's HTM name string,
-// or an empty string if the ID is not a valid HTM ID.
+// Returns true if regions loaded from files exceed the memory budget, and at least
+// one of them can be dumped to meet it. The mutex must be locked.
 
-string SSHTM::ID2name ( uint64_t id )
+bool SSHTM::_overBudget ( void )
 {
-    if ( id == 0 )
-        return string ( "O0" );
-    
-    char name[64] = { 0 };
-    cc_ID2name ( name, id );
-    return string ( name );
+    return _lru.size() > 1 && ( ( _maxObjects > 0 && _numObjects > _maxObjects ) || ( _maxBytes > 0 && _numBytes > _maxBytes ) );
 }
 
-// Given an HTM triangle name, computes unit vectors to the triangle's three vertices
-// on the unit sphere (v0, v1, v2).  Returns true if the name is valid, or false otherwise.
+// Dumps least recently used regions loaded from files until the memory budget is met.
+// Returns the number of regions dumped.
 
-bool SSHTM::name2Triangle ( const string &name, SSVector &v0, SSVector &v1, SSVector &v2 )
+int SSHTM::trimRegions ( void )
 {
-    return cc_name2Triangle ( name.c_str(), &v0.x, &v1.x, &v2.x ) == 0;
+    lock_guard<mutex> lock ( _mutex );
+    return _trimRegions();
 }
 
-// Given a unit vector to a point on the celestial sphere (p), determines if p is inside
-// the triangle on the celestial sphere whose vertices are the unit vectors (v0, v1, v2).
+// Gets number of loadRegion() calls for regions already loaded (hits), number of calls which
+// started loading a region (misses), and number of regions dumped to meet the memory budget (evictions).
 
-bool SSHTM::isinside ( const SSVector &p, const SSVector &v0, SSVector &v1, SSVector &v2 )
+void SSHTM::getStatistics ( size_t &hits, size_t &misses, size_t &evictions )
 {
-    return cc_isinside ( &p.x, &v0.x, &v1.x, &v2.x );
+    lock_guard<mutex> lock ( _mutex );
+    hits = _hits;
+    misses = _misses;
+    evictions = _evictions;
 }
 
-// Original C HTM implementation from Johns Hopkins in cc_aux.c was downloaded from:
-// http://www.skyserver.org/htm/implementation.aspx#download
-// This is a cleaned-up version of that code.
+// Resets cache statistics to zero.
 
-#define IDSIZE 64
-#define IDHIGHBIT  0x8000000000000000LL
-#define IDHIGHBIT2 0x4000000000000000LL
+void SSHTM::resetStatistics ( void )
+{
+    lock_guard<mutex> lock ( _mutex );
+    _hits = _misses = _evictions = 0;
+}
 
-#define HTM_INVALID_ID 0
-#define HTMNAMEMAX     32
+// Longest time between calls to prefetchRegions(), in seconds, from which view motion is predicted.
 
-static const double gEpsilon = 1.0E-15;
+static const double kMaxPanInterval = 1.0;
 
-double anchor[][3] = {
-  {0.0L,  0.0L,  1.0L}, // 0
-  {1.0L,  0.0L,  0.0L}, // 1
-  {0.0L,  1.0L,  0.0L}, // 2
-  {-1.0L,  0.0L,  0.0L}, // 3
-  {0.0L, -1.0L,  0.0L}, // 4
-  {0.0L,  0.0L, -1.0L}  // 5
-};
+// Longest segment of an HTM triangle edge, in radians, projected onto a view when testing whether
+// the triangle intersects the view. Edges are great circles, which are curved in most projections.
 
-struct _bases {
-    const char *name;
-    int ID;
-    int v1, v2, v3;
-} bases[] = {
-    {"S2", 10, 3, 5, 4},
-    {"N1", 13, 4, 0, 3},
-    {"S1", 9, 2, 5, 3},
-    {"N2", 14, 3, 0, 2},
-    {"S3", 11, 4,5,1},
-    {"N0", 12, 1, 0, 4},
-    {"S0", 8, 1, 5, 2},
-    {"N3", 15, 2, 0, 1}
-};
+static const double kEdgeStep = SSAngle::kRadPerDeg;
 
-int S_indexes[][3] = {
-  {1, 5, 2}, //S0
-  {2, 5, 3}, //S1
-  {3, 5, 4}, //S2
-  {4, 5, 1} //S3
-};
-int N_indexes[][3] = {
-  {1, 0, 4}, //N0
-  {4, 0, 3}, //N1
-  {3, 0, 2}, //N2
-  {2, 0, 1} //N3
-};
+// Tests whether an HTM triangle with vertices (v0,v1,v2) intersects the bounding rectangle of a
+// field of view (view): true if the view center is inside the triangle, or if any part of the
+// triangle's projected edges is inside the view rectangle. Edge segments which reach behind the
+// viewer, or wrap around the edges of 360-degree projections, are ignored.
 
-int cc_startpane(
-         double *v1, double *v2, double *v3,
-         double xin, double yin, double zin, char *name)
+static bool triangleInView ( SSView &view, SSVector v0, SSVector v1, SSVector v2 )
 {
-  int ix = (xin > 0 ? 4 : 0) + (yin > 0 ? 2 : 0) + (zin > 0 ? 1 : 0);
-  double *tvec;
-  const char *s;
-  int baseID;
+    SSVector center = view.getCenterVector();
+    if ( cc_isinside ( &center.x, &v0.x, &v1.x, &v2.x ) )
+        return true;
 
-  // printf("Startpane %f %f %f, (%d)\n", xin, yin, zin, ix);
-
-  baseID = bases[ix].ID;
+    SSVector verts[4] = { v0, v1, v2, v0 };
+    for ( int i = 0; i < 3; i++ )
+    {
+        SSVector a = verts[i], b = verts[i + 1];
+        int n = max ( 1, (int) ceil ( a.angularSeparation ( b ) / kEdgeStep ) );
+        SSVector p0 = view.project ( a );
+        
+        for ( int k = 1; k <= n; k++ )
+        {
+            SSVector p1 = view.project ( k < n ? ( a * (double) ( n - k ) + b * (double) k ).normalize() : b );
+            if ( isfinite ( p0.x ) && isfinite ( p0.y ) && isfinite ( p1.x ) && isfinite ( p1.y ) && ! view.lineWrap ( p0, p1 ) )
+            {
+                SSVector c0 = p0, c1 = p1;
+                if ( view.clipLine ( c0, c1 ) )
+                    return true;
+            }
+            p0 = p1;
+        }
+    }
     
-  tvec = anchor[bases[ix].v1];
-  v1[0] = tvec[0];
-  v1[1] = tvec[1];
-  v1[2] = tvec[2];
-
-  tvec = anchor[bases[ix].v2];
-  v2[0] = tvec[0];
-  v2[1] = tvec[1];
-  v2[2] = tvec[2];
-
-  tvec = anchor[bases[ix].v3];
-  v3[0] = tvec[0];
-  v3[1] = tvec[1];
-  v3[2] = tvec[2];
-
-  s = bases[ix].name;
-  name[0] = *s++;
-  name[1] = *s++;
-  name[2] = '\0';
-  return baseID;
+    return false;
 }
 
-double cc_Epsilon = 1.0E-15;
-double cc_sqrt3    = 1.7320508075688772935;
-
-#define m4_midpoint(v1, v2, w, tmp){\
-    w[0] = v1[0] + v2[0]; w[1] = v1[1] + v2[1]; w[2] = v1[2] + v2[2]; \
-    tmp = sqrt(w[0] * w[0] + w[1] * w[1] + w[2]*w[2]);\
-    w[0] /= tmp; w[1] /= tmp; w[2] /= tmp;}
-
-#define copy_vec(d, s) { d[0] = s[0]; d[1] = s[1]; d[2] = s[2]; }
+// Recursively finds an HTM region and its sub-regions, down to a given level (depth), whose triangles
+// intersect a circle of (rad) radians around a unit vector (center) and, if (pView) is not null, the
+// bounding rectangle of that view. For each region found, appends the angular distance from the circle
+// center to the nearest point of the region's bounding circle (or zero if inside it), and its HTM ID,
+// to (found). The origin region intersects everything.
 
-uint64_t cc_vector2ID(double x, double y, double z, int depth)
+void SSHTM::_findRegions ( uint64_t htmID, int depth, SSView *pView, SSVector center, SSAngle rad, vector<pair<double,uint64_t>> &found )
 {
-  uint64_t rstat = 0;
-  int startID;
-  char name[80];
-  int len = 0;
-
-  double v1[3], v2[3], v0[3];
-  double w1[3], w2[3], w0[3];
-  double p[3];
-  double dtmp;
+    double dist = 0.0;
+    
+    if ( htmID > 0 )
+    {
+        HTMTriangle temp;
+        const HTMTriangle &t = getTriangle ( htmID, triangleLevel ( htmID ), temp );
+        dist = center.angularSeparation ( t.center ) - t.radius;
+        if ( dist > rad )
+            return;
+        
+        if ( pView != nullptr && ! triangleInView ( *pView, t.v0, t.v1, t.v2 ) )
+            return;
+    }
+    
+    found.push_back ( { max ( dist, 0.0 ), htmID } );
+    if ( IDlevel ( htmID ) < depth )
+        for ( uint64_t subID : subRegionIDs ( htmID ) )
+            _findRegions ( subID, depth, pView, center, rad, found );
+}
 
-  p[0] = x;
-  p[1] = y;
-  p[2] = z;
+// Finds HTM regions whose triangles intersect the bounding rectangle of a field of view (view), down to
+// the level containing stars as faint as a limiting magnitude (limMag), or to the bottom level if limMag
+// is fainter. Region IDs are returned in (htmIDs) in order of increasing angular distance from the view
+// center, so regions containing the view center come first, from the origin downward. Does not load
+// any regions. Returns the number of regions found.
 
-  // Get the ID of the level0 triangle, and its starting vertices
+int SSHTM::viewRegions ( SSView &view, float limMag, vector<uint64_t> &htmIDs )
+{
+    int depth = magLevel ( limMag );
+    if ( depth < 0 )
+        depth = (int) _magLevels.size() - 1;
+    
+    vector<pair<double,uint64_t>> found;
+    _findRegions ( 0, depth, &view, view.getCenterVector(), view.getAngularDiagonal() / 2.0, found );
+    sort ( found.begin(), found.end() );
+    
+    htmIDs.clear();
+    for ( auto &f : found )
+        htmIDs.push_back ( f.second );
+    
+    return (int) htmIDs.size();
+}
 
-  startID = cc_startpane(v0, v1, v2, x, y, z, name);
-  len = 2;
+// Prepares to draw stars down to a limiting magnitude (limMag) in a field of view (view) by queueing
+// the regions it needs for loading by background threads, ahead of all regions already queued, nearest
+// the view center first. If the view center has moved since the last call, also queues the regions
+// around where the view center will be (lookahead) seconds later, if it keeps moving at the same rate.
+// The current time in seconds (time) may come from any clock which increases between calls; motion is
+// not predicted from calls more than a second apart. Regions queued by previous calls which are no
+// longer needed are cancelled. Visible regions already loaded are marked as most recently used, so they
+// are dumped last to meet the memory budget. The userData is passed to the data file read function.
+// Call from the thread which owns the HTM, like loadRegion(); call again every frame as the view moves.
+// Returns number of regions queued. If USE_THREADS is 0, loads visible regions synchronously
+// instead, and returns the number of regions loaded.
+
+int SSHTM::prefetchRegions ( SSView &view, float limMag, double time, double lookahead, void *userData )
+{
+    vector<uint64_t> htmIDs;
+#if USE_THREADS
+    viewRegions ( view, limMag, htmIDs );
+#else
+    int nvisible = viewRegions ( view, limMag, htmIDs );
+#endif
+    
+    // Estimate view center velocity from its motion since the last call.
+    
+    SSVector center = view.getCenterVector();
+    double dt = time - _panTime;
+    if ( dt < 0.0 || dt > kMaxPanInterval )
+        _panVelocity = SSVector ( 0.0, 0.0, 0.0 );
+    else if ( dt > 0.0 )
+        _panVelocity = ( center - _panCenter ) / dt;
+    
+    _panCenter = center;
+    _panTime = time;
+    
+    // Add regions around the predicted view center which aren't visible now,
+    // nearest the predicted center first.
+    
+    SSVector ahead = center + _panVelocity * lookahead;
+    if ( lookahead > 0.0 && _panVelocity.magnitude() > 0.0 && ahead.magnitude() > 0.0 )
+    {
+        int depth = magLevel ( limMag );
+        if ( depth < 0 )
+            depth = (int) _magLevels.size() - 1;
+        
+        vector<pair<double,uint64_t>> found;
+        _findRegions ( 0, depth, nullptr, ahead.normalize(), view.getAngularDiagonal() / 2.0, found );
+        sort ( found.begin(), found.end() );
+        
+        set<uint64_t> visible ( htmIDs.begin(), htmIDs.end() );
+        for ( auto &f : found )
+            if ( visible.count ( f.second ) == 0 )
+                htmIDs.push_back ( f.second );
+    }
+    
+#if USE_THREADS
+    return _queueRegions ( htmIDs, userData );
+#else
+    int n = 0;
+    for ( int i = 0; i < nvisible; i++ )
+        if ( loadRegion ( htmIDs[i], true, userData ) )
+            n++;
+    return n;
+#endif
+}
 
-  // Start searching for the children
+#if USE_THREADS
 
-  while(depth-- > 0){
-    m4_midpoint(v0, v1, w2, dtmp);
-    m4_midpoint(v1, v2, w0, dtmp);
-    m4_midpoint(v2, v0, w1, dtmp);
+// Queues regions (htmIDs) for loading by background threads ahead of all regions already queued,
+// in the order given, as prefetch requests. Regions already queued move to their new place in line;
+// earlier prefetch requests for regions not in (htmIDs) are cancelled. Regions already loaded are
+// marked as most recently used, the first region most recently, then the memory budget is enforced.
+// Regions which are loading or missing are skipped. Returns the number of regions queued.
 
-    if (cc_isinside(p, v0, w2, w1)) {
-      name[len++] = '0';
-      copy_vec(v1, w2);
-      copy_vec(v2, w1);
-    }
-    else if (cc_isinside(p, v1, w0, w2)) {
-      name[len++] = '1';
-      copy_vec(v0, v1);
-      copy_vec(v1, w0);
-      copy_vec(v2, w2);
+int SSHTM::_queueRegions ( const vector<uint64_t> &htmIDs, void *userData )
+{
+    lock_guard<mutex> lock ( _mutex );
+    
+    for ( size_t i = htmIDs.size(); i-- > 0; )
+    {
+        auto it = _regions.find ( htmIDs[i] );
+        if ( it != _regions.end() && it->second.state == kLoaded && ! it->second.stored )
+            _lru.splice ( _lru.end(), _lru, it->second.lru );
     }
-    else if (cc_isinside(p, v2, w1, w0)) {
-      name[len++] = '2';
-      copy_vec(v0, v2);
-      copy_vec(v1, w1);
-      copy_vec(v2, w0);
+    
+    _trimRegions();
+    
+    // Remove queued requests for the same regions, and cancel all other prefetch requests.
+    // Then put the new requests at the front of the queue, in order. Requests made by
+    // loadRegion() for the same regions keep their place at the front, but can't be cancelled.
+    
+    set<uint64_t> wanted ( htmIDs.begin(), htmIDs.end() ), pinned;
+    deque<LoadRequest> requests;
+    
+    for ( auto it = _loadQueue.begin(); it != _loadQueue.end(); )
+    {
+        if ( wanted.count ( it->htmID ) > 0 )
+        {
+            if ( ! it->prefetch )
+                pinned.insert ( it->htmID );
+            it = _loadQueue.erase ( it );
+        }
+        else if ( it->prefetch )
+        {
+            auto region = _regions.find ( it->htmID );
+            if ( region != _regions.end() && region->second.state == kQueued )
+                _regions.erase ( region );
+            it = _loadQueue.erase ( it );
+        }
+        else
+        {
+            it++;
+        }
     }
-    else if (cc_isinside(p, w0, w1, w2)) {
-      name[len++] ='3';
-      copy_vec(v0, w0);
-      copy_vec(v1, w1);
-      copy_vec(v2, w2);
+    
+    for ( uint64_t htmID : htmIDs )
+    {
+        auto it = _regions.find ( htmID );
+        if ( it == _regions.end() )
+        {
+            _misses++;
+            _regions[htmID] = { kQueued, nullptr, 0, false };
+        }
+        else if ( it->second.state != kQueued )
+        {
+            continue;
+        }
+        
+        requests.push_back ( { htmID, _callback, userData, pinned.count ( htmID ) == 0 } );
     }
-    else {
-      return HTM_INVALID_ID;
+    
+    _loadQueue.insert ( _loadQueue.begin(), requests.begin(), requests.end() );
+    if ( ! requests.empty() )
+    {
+        if ( _loadThreads.empty() )
+            _startLoadThreads();
+        _queueCond.notify_all();
     }
-  }
-  name[len] = '\0';
-  rstat = cc_name2ID(name);
-  return rstat;
+    
+    return (int) requests.size();
 }
 
-int cc_isinside ( const double *p, const double *v1, const double *v2, const double *v3 )
-{
-  double crossp[3];
-  // if (v1 X v2) . p < epsilon then false
-  // same for v2 X v3 and v3 X v1.
-  // else return true..
-  crossp[0] = v1[1] * v2[2] - v2[1] * v1[2];
-  crossp[1] = v1[2] * v2[0] - v2[2] * v1[0];
-  crossp[2] = v1[0] * v2[1] - v2[0] * v1[1];
-  if (p[0] * crossp[0] + p[1] * crossp[1] + p[2] * crossp[2] < -gEpsilon)
-    return 0;
-
-  crossp[0] = v2[1] * v3[2] - v3[1] * v2[2];
-  crossp[1] = v2[2] * v3[0] - v3[2] * v2[0];
-  crossp[2] = v2[0] * v3[1] - v3[0] * v2[1];
-  if (p[0] * crossp[0] + p[1] * crossp[1] + p[2] * crossp[2] < -gEpsilon)
-    return 0;
+#endif
 
-  crossp[0] = v3[1] * v1[2] - v1[1] * v3[2];
-  crossp[1] = v3[2] * v1[0] - v1[2] * v3[0];
-  crossp[2] = v3[0] * v1[1] - v1[0] * v3[1];
-  if (p[0] * crossp[0] + p[1] * crossp[1] + p[2] * crossp[2] < -gEpsilon)
-    return 0;
+// Tests whether star data for a specific region in this HTM has been
+// loaded into memory, i.e. if that region exists in this HTM.
 
-  return 1;
+bool SSHTM::regionLoaded ( uint64_t htmID )
+{
+    lock_guard<mutex> lock ( _mutex );
+    auto it = _regions.find ( htmID );
+    return it != _regions.end() && it->second.state == kLoaded;
 }
 
-uint64_t cc_name2ID(const char *name)
+// Returns pointer to array of objects stored in the region
+// with the specified HTM triangle ID, and marks it as most
+// recently used. If region is not present in this HTM or
+// objects have not been loaded, returns nullptr.
+
+SSObjectVec *SSHTM::getObjects ( uint64_t htmID )
 {
-  uint64_t out=0, i;
-  size_t siz = 0;
+    return _getObjects ( htmID, true );
+}
 
-  if(name == 0)              // null pointer-name
-    return 0;
-  if(name[0] != 'N' && name[0] != 'S')  // invalid name
-    return 0;
+// Private method returns pointer to array of objects loaded into a region (htmID) or nullptr if not loaded.
+// If touch is true, marks region as most recently used.
 
-  siz = strlen(name);       // determine string length
-  // at least size-2 required, don't exceed max
-  if(siz < 2)
-    return 0;
-  if(siz > HTMNAMEMAX)
-    return 0;
+SSObjectVec *SSHTM::_getObjects ( uint64_t htmID, bool touch )
+{
+    lock_guard<mutex> lock ( _mutex );
+    auto it = _regions.find ( htmID );
+    if ( it == _regions.end() || it->second.state != kLoaded )
+        return nullptr;
 
-  for(i = siz-1; i > 0; i--) {// set bits starting from the end
-    if(name[i] > '3' || name[i] < '0') {// invalid name
-      return 0;
-    }
-    out += ( (uint64_t)(name[i]-'0')) << 2*(siz - i -1);
-  }
+    if ( touch && ! it->second.stored )
+        _lru.splice ( _lru.end(), _lru, it->second.lru );
 
-  i = 2;                     // set first pair of bits, first bit always set
-  if(name[0]=='N') i++;      // for north set second bit too
-  out += (i << (2*siz - 2) );
-  return out;
+    return it->second.pObjects;
 }
 
-int cc_IDlevel(uint64_t htmid)
+// Private method deletes a region (htmID) and its objects, and removes it from the cache.
+// The mutex must be locked, and the region must not be loading.
+
+void SSHTM::_evictRegion ( uint64_t htmID )
 {
-  uint32_t size=0, i;
+    auto it = _regions.find ( htmID );
+    if ( it == _regions.end() )
+        return;
 
-  // determine index of first set bit
-  for(i = 0; i < IDSIZE; i+=2) {
-    if ( (htmid << i) & IDHIGHBIT ) break;
-    if ( (htmid << i) & IDHIGHBIT2 )  // invalid id
-      return HTM_INVALID_ID;
-  }
-  if(htmid == 0)
-    return HTM_INVALID_ID;
+    Region &region = it->second;
+    if ( region.pObjects != nullptr && ! region.stored )
+    {
+        _lru.erase ( region.lru );
+        _numObjects -= region.pObjects->size();
+        _numBytes -= region.bytes;
+    }
 
-  size=(IDSIZE-i) >> 1;
-  /* Size is the length of the string representing the name of the
-     trixel, the level is size - 2
-  */
-  return size-2;
+    delete region.pObjects;
+    _regions.erase ( it );
 }
 
-int cc_ID2name(char *name, uint64_t id)
+// Deletes all star data for a specific region in this HTM from memory.
+// If region is being loaded on a background thread, waits for it to finish;
+// if queued for loading, removes it from the queue.
+
+void SSHTM::dumpRegion ( uint64_t htmID )
 {
-  uint32_t size=0, i;
-  int c; // a spare character;
+    unique_lock<mutex> lock ( _mutex );
+    _waitForLoad ( lock, htmID );
+    _evictRegion ( htmID );
+}
 
-  // determine index of first set bit
-  for(i = 0; i < IDSIZE; i+=2) {
-    if ( (id << i) & IDHIGHBIT ) break;
-    if ( (id << i) & IDHIGHBIT2 )  // invalid id
-      return HTM_INVALID_ID;
-  }
-  if(id == 0)
-    return HTM_INVALID_ID;
+// Deletes all star data for all regions in this HTM from memory if testFunc is nullptr.
+// Otherwise deletes only regions for which testFunc returns true.
+// userData is a pointer to arbitrary user-defined data passed to testFunc (if not nullptr).
+// First discards all regions queued for loading and waits for regions being loaded to finish.
 
-  size=(IDSIZE-i) >> 1;
+void SSHTM::dumpRegions ( RegionTestCallback testFunc, void *userData )
+{
+    unique_lock<mutex> lock ( _mutex );
+    _waitForLoads ( lock );
 
-  // fill characters starting with the last one
-  for(i = 0; i < size-1; i++) {
-    c =  '0' + (int) ((id >> i*2) & (uint32_t) 3);
-    name[size-i-1] = (char ) c;
-  }
+    vector<uint64_t> ids;
+    for ( auto it = _regions.begin(); it != _regions.end(); it++ )
+        ids.push_back ( it->first );
 
-  // put in first character
-  if( (id >> (size*2-2)) & 1 ) {
-    name[0] = 'N';
-  } else {
-    name[0] = 'S';
-  }
-  name[size] = 0; // end string
+    if ( testFunc == nullptr )
+    {
+        for ( uint64_t id : ids )
+            _evictRegion ( id );
+        return;
+    }
 
-  return 0;
+    // Call testFunc without the mutex locked, since it may call this HTM.
+
+    lock.unlock();
+    for ( uint64_t id : ids )
+        if ( testFunc ( this, id, userData ) )
+            dumpRegion ( id );
 }
 
-int cc_name2Triangle(const char *name, double *v0, double *v1, double *v2)
+// Empties all regions in this HTM, but does not delete objects!
+
+void SSHTM::clearRegions ( void )
 {
-  int rstat = 0;
+    lock_guard<mutex> lock ( _mutex );
+    for ( auto it = _regions.begin(); it != _regions.end(); it++ )
+    {
+        if ( it->second.pObjects != nullptr )
+        {
+            it->second.pObjects->clear();
+            it->second.bytes = 0;
+        }
+    }
+
+    _numObjects = _numBytes = 0;
+}
+
+// Counts number of regions loaded into memory in this HTM.
+
+int SSHTM::countRegions ( void )
+{
+    int count = 0;
+
+    lock_guard<mutex> lock ( _mutex );
+    for ( auto it = _regions.begin(); it != _regions.end(); it++ )
+        if ( it->second.pObjects != nullptr )
+            count++;
+
+    return count;
+}
+
+// Counts total number of stars stored in all regions in this HTM.
+
+int SSHTM::countStars ( void )
+{
+    int count = 0;
+    
+    lock_guard<mutex> lock ( _mutex );
+    for ( auto it = _regions.begin(); it != _regions.end(); it++ )
+        if ( it->second.pObjects != nullptr )
+            count += it->second.pObjects->size();
+    
+    return count;
+}
+
+// Counts number of stars stored in a single region in this HTM.
+
+int SSHTM::countStars ( uint64_t htmID )
+{
+    SSObjectVec *pObjects = _getObjects ( htmID, false );
+    return pObjects ? (int) pObjects->size() : 0;
+}
+
+// Given a unit vector to a point on the celestial sphere, returns the HTM ID
+// of the triangle containing that vector at a specific HTM depth level.
+
+uint64_t SSHTM::vector2ID ( const SSVector &vector, int depth )
+{
+    return cc_vector2ID ( vector.x, vector.y, vector.z, depth );
+}
+
+// Given an HTM triangle name, returns the HTM ID of that triangle,
+// or zero if the name is not a valid HTM name.
+
+uint64_t SSHTM::name2ID ( const string &name )
+{
+    if ( name.compare ( "O0" ) == 0 )
+        return 0;
+    
+    return cc_name2ID ( name.c_str() );
+}
+
+// Given an HTM triangle ID, returns the depth level of that triangle.
+// The whole celestrial sphere is level zero; the eight level 1 triangles
+// are N0 - N3 and S0 - S3; level 2 triangles are N00 - N33 and S00 - S33.
+
+int SSHTM::IDlevel ( uint64_t id )
+{
+    return id == 0 ? 0 : cc_IDlevel ( id ) + 1;
+}
+
+// Given an HTM triangle ID, returns the triangle's HTM name string,
+// or an empty string if the ID is not a valid HTM ID.
+
+string SSHTM::ID2name ( uint64_t id )
+{
+    if ( id == 0 )
+        return string ( "O0" );
+    
+    char name[64] = { 0 };
+    cc_ID2name ( name, id );
+    return string ( name );
+}
+
+// Given an HTM triangle name, computes unit vectors to the triangle's three vertices
+// on the unit sphere (v0, v1, v2).  Returns true if the name is valid, or false otherwise.
+
+bool SSHTM::name2Triangle ( const string &name, SSVector &v0, SSVector &v1, SSVector &v2 )
+{
+    return cc_name2Triangle ( name.c_str(), &v0.x, &v1.x, &v2.x ) == 0;
+}
+
+// Given a unit vector to a point on the celestial sphere (p), determines if p is inside
+// the triangle on the celestial sphere whose vertices are the unit vectors (v0, v1, v2).
+
+bool SSHTM::isinside ( const SSVector &p, const SSVector &v0, SSVector &v1, SSVector &v2 )
+{
+    return cc_isinside ( &p.x, &v0.x, &v1.x, &v2.x );
+}
+
+// Original C HTM implementation from Johns Hopkins in cc_aux.c was downloaded from:
+// http://www.skyserver.org/htm/implementation.aspx#download
+// This is a cleaned-up version of that code.
+
+#define IDSIZE 64
+#define IDHIGHBIT  0x8000000000000000LL
+#define IDHIGHBIT2 0x4000000000000000LL
+
+#define HTM_INVALID_ID 0
+#define HTMNAMEMAX     32
+
+static const double gEpsilon = 1.0E-15;
+
+double anchor[][3] = {
+  {0.0L,  0.0L,  1.0L}, // 0
+  {1.0L,  0.0L,  0.0L}, // 1
+  {0.0L,  1.0L,  0.0L}, // 2
+  {-1.0L,  0.0L,  0.0L}, // 3
+  {0.0L, -1.0L,  0.0L}, // 4
+  {0.0L,  0.0L, -1.0L}  // 5
+};
+
+struct _bases {
+    const char *name;
+    int ID;
+    int v1, v2, v3;
+} bases[] = {
+    {"S2", 10, 3, 5, 4},
+    {"N1", 13, 4, 0, 3},
+    {"S1", 9, 2, 5, 3},
+    {"N2", 14, 3, 0, 2},
+    {"S3", 11, 4,5,1},
+    {"N0", 12, 1, 0, 4},
+    {"S0", 8, 1, 5, 2},
+    {"N3", 15, 2, 0, 1}
+};
+
+int S_indexes[][3] = {
+  {1, 5, 2}, //S0
+  {2, 5, 3}, //S1
+  {3, 5, 4}, //S2
+  {4, 5, 1} //S3
+};
+int N_indexes[][3] = {
+  {1, 0, 4}, //N0
+  {4, 0, 3}, //N1
+  {3, 0, 2}, //N2
+  {2, 0, 1} //N3
+};
+
+int cc_startpane(
+         double *v1, double *v2, double *v3,
+         double xin, double yin, double zin, char *name)
+{
+  int ix = (xin > 0 ? 4 : 0) + (yin > 0 ? 2 : 0) + (zin > 0 ? 1 : 0);
+  double *tvec;
   const char *s;
+  int baseID;
+
+  // printf("Startpane %f %f %f, (%d)\n", xin, yin, zin, ix);
+
+  baseID = bases[ix].ID;
+    
+  tvec = anchor[bases[ix].v1];
+  v1[0] = tvec[0];
+  v1[1] = tvec[1];
+  v1[2] = tvec[2];
+
+  tvec = anchor[bases[ix].v2];
+  v2[0] = tvec[0];
+  v2[1] = tvec[1];
+  v2[2] = tvec[2];
+
+  tvec = anchor[bases[ix].v3];
+  v3[0] = tvec[0];
+  v3[1] = tvec[1];
+  v3[2] = tvec[2];
+
+  s = bases[ix].name;
+  name[0] = *s++;
+  name[1] = *s++;
+  name[2] = '\0';
+  return baseID;
+}
+
+double cc_Epsilon = 1.0E-15;
+double cc_sqrt3    = 1.7320508075688772935;
+
+#define m4_midpoint(v1, v2, w, tmp){\
+    w[0] = v1[0] + v2[0]; w[1] = v1[1] + v2[1]; w[2] = v1[2] + v2[2]; \
+    tmp = sqrt(w[0] * w[0] + w[1] * w[1] + w[2]*w[2]);\
+    w[0] /= tmp; w[1] /= tmp; w[2] /= tmp;}
+
+#define copy_vec(d, s) { d[0] = s[0]; d[1] = s[1]; d[2] = s[2]; }
+
+uint64_t cc_vector2ID(double x, double y, double z, int depth)
+{
+  uint64_t rstat = 0;
+  int startID;
+  char name[80];
+  int len = 0;
+
+  double v1[3], v2[3], v0[3];
   double w1[3], w2[3], w0[3];
+  double p[3];
   double dtmp;
 
-  // Get the top level hemi-demi-semi space
+  p[0] = x;
+  p[1] = y;
+  p[2] = z;
 
-  int k;
-  int anchor_offsets[3];
-  k = (int) name[1] - '0';
+  // Get the ID of the level0 triangle, and its starting vertices
 
-  if (name[0] == 'S') {
-    anchor_offsets[0] = S_indexes[k][0];
-    anchor_offsets[1] = S_indexes[k][1];
-    anchor_offsets[2] = S_indexes[k][2];
-  } else {
-    anchor_offsets[0] = N_indexes[k][0];
-    anchor_offsets[1] = N_indexes[k][1];
-    anchor_offsets[2] = N_indexes[k][2];
-  }
+  startID = cc_startpane(v0, v1, v2, x, y, z, name);
+  len = 2;
 
-  s = name+2;
-  copy_vec(v0, anchor[anchor_offsets[0]]);
-  copy_vec(v1, anchor[anchor_offsets[1]]);
-  copy_vec(v2, anchor[anchor_offsets[2]]);
+  // Start searching for the children
 
-  while(*s){
+  while(depth-- > 0){
     m4_midpoint(v0, v1, w2, dtmp);
     m4_midpoint(v1, v2, w0, dtmp);
     m4_midpoint(v2, v0, w1, dtmp);
-    switch(*s) {
-    case '0':
+
+    if (cc_isinside(p, v0, w2, w1)) {
+      name[len++] = '0';
       copy_vec(v1, w2);
       copy_vec(v2, w1);
-      break;
-    case '1':
+    }
+    else if (cc_isinside(p, v1, w0, w2)) {
+      name[len++] = '1';
       copy_vec(v0, v1);
       copy_vec(v1, w0);
       copy_vec(v2, w2);
-      break;
-    case '2':
+    }
+    else if (cc_isinside(p, v2, w1, w0)) {
+      name[len++] = '2';
       copy_vec(v0, v2);
       copy_vec(v1, w1);
       copy_vec(v2, w0);
-      break;
-    case '3':
+    }
+    else if (cc_isinside(p, w0, w1, w2)) {
+      name[len++] ='3';
       copy_vec(v0, w0);
       copy_vec(v1, w1);
       copy_vec(v2, w2);
-      break;
     }
-    s++;
+    else {
+      return HTM_INVALID_ID;
+    }
   }
-  return rstat;
+  name[len] = '\0';
+  rstat = cc_name2ID(name);
+  return rstat;
+}
+
+int cc_isinside ( const double *p, const double *v1, const double *v2, const double *v3 )
+{
+  double crossp[3];
+  // if (v1 X v2) . p < epsilon then false
+  // same for v2 X v3 and v3 X v1.
+  // else return true..
+  crossp[0] = v1[1] * v2[2] - v2[1] * v1[2];
+  crossp[1] = v1[2] * v2[0] - v2[2] * v1[0];
+  crossp[2] = v1[0] * v2[1] - v2[0] * v1[1];
+  if (p[0] * crossp[0] + p[1] * crossp[1] + p[2] * crossp[2] < -gEpsilon)
+    return 0;
+
+  crossp[0] = v2[1] * v3[2] - v3[1] * v2[2];
+  crossp[1] = v2[2] * v3[0] - v3[2] * v2[0];
+  crossp[2] = v2[0] * v3[1] - v3[0] * v2[1];
+  if (p[0] * crossp[0] + p[1] * crossp[1] + p[2] * crossp[2] < -gEpsilon)
+    return 0;
+
+  crossp[0] = v3[1] * v1[2] - v1[1] * v3[2];
+  crossp[1] = v3[2] * v1[0] - v1[2] * v3[0];
+  crossp[2] = v3[0] * v1[1] - v1[0] * v3[1];
+  if (p[0] * crossp[0] + p[1] * crossp[1] + p[2] * crossp[2] < -gEpsilon)
+    return 0;
+
+  return 1;
+}
+
+uint64_t cc_name2ID(const char *name)
+{
+  uint64_t out=0, i;
+  size_t siz = 0;
+
+  if(name == 0)              // null pointer-name
+    return 0;
+  if(name[0] != 'N' && name[0] != 'S')  // invalid name
+    return 0;
+
+  siz = strlen(name);       // determine string length
+  // at least size-2 required, don't exceed max
+  if(siz < 2)
+    return 0;
+  if(siz > HTMNAMEMAX)
+    return 0;
+
+  for(i = siz-1; i > 0; i--) {// set bits starting from the end
+    if(name[i] > '3' || name[i] < '0') {// invalid name
+      return 0;
+    }
+    out += ( (uint64_t)(name[i]-'0')) << 2*(siz - i -1);
+  }
+
+  i = 2;                     // set first pair of bits, first bit always set
+  if(name[0]=='N') i++;      // for north set second bit too
+  out += (i << (2*siz - 2) );
+  return out;
+}
+
+int cc_IDlevel(uint64_t htmid)
+{
+  uint32_t size=0, i;
+
+  // determine index of first set bit
+  for(i = 0; i < IDSIZE; i+=2) {
+    if ( (htmid << i) & IDHIGHBIT ) break;
+    if ( (htmid << i) & IDHIGHBIT2 )  // invalid id
+      return HTM_INVALID_ID;
+  }
+  if(htmid == 0)
+    return HTM_INVALID_ID;
+
+  size=(IDSIZE-i) >> 1;
+  /* Size is the length of the string representing the name of the
+     trixel, the level is size - 2
+  */
+  return size-2;
+}
+
+int cc_ID2name(char *name, uint64_t id)
+{
+  uint32_t size=0, i;
+  int c; // a spare character;
+
+  // determine index of first set bit
+  for(i = 0; i < IDSIZE; i+=2) {
+    if ( (id << i) & IDHIGHBIT ) break;
+    if ( (id << i) & IDHIGHBIT2 )  // invalid id
+      return HTM_INVALID_ID;
+  }
+  if(id == 0)
+    return HTM_INVALID_ID;
+
+  size=(IDSIZE-i) >> 1;
+
+  // fill characters starting with the last one
+  for(i = 0; i < size-1; i++) {
+    c =  '0' + (int) ((id >> i*2) & (uint32_t) 3);
+    name[size-i-1] = (char ) c;
+  }
+
+  // put in first character
+  if( (id >> (size*2-2)) & 1 ) {
+    name[0] = 'N';
+  } else {
+    name[0] = 'S';
+  }
+  name[size] = 0; // end string
+
+  return 0;
+}
+
+int cc_name2Triangle(const char *name, double *v0, double *v1, double *v2)
+{
+  int rstat = 0;
+  const char *s;
+  double w1[3], w2[3], w0[3];
+  double dtmp;
+
+  // Get the top level hemi-demi-semi space
+
+  int k;
+  int anchor_offsets[3];
+  k = (int) name[1] - '0';
+
+  if (name[0] == 'S') {
+    anchor_offsets[0] = S_indexes[k][0];
+    anchor_offsets[1] = S_indexes[k][1];
+    anchor_offsets[2] = S_indexes[k][2];
+  } else {
+    anchor_offsets[0] = N_indexes[k][0];
+    anchor_offsets[1] = N_indexes[k][1];
+    anchor_offsets[2] = N_indexes[k][2];
+  }
+
+  s = name+2;
+  copy_vec(v0, anchor[anchor_offsets[0]]);
+  copy_vec(v1, anchor[anchor_offsets[1]]);
+  copy_vec(v2, anchor[anchor_offsets[2]]);
+
+  while(*s){
+    m4_midpoint(v0, v1, w2, dtmp);
+    m4_midpoint(v1, v2, w0, dtmp);
+    m4_midpoint(v2, v0, w1, dtmp);
+    switch(*s) {
+    case '0':
+      copy_vec(v1, w2);
+      copy_vec(v2, w1);
+      break;
+    case '1':
+      copy_vec(v0, v1);
+      copy_vec(v1, w0);
+      copy_vec(v2, w2);
+      break;
+    case '2':
+      copy_vec(v0, v2);
+      copy_vec(v1, w1);
+      copy_vec(v2, w0);
+      break;
+    case '3':
+      copy_vec(v0, w0);
+      copy_vec(v1, w1);
+      copy_vec(v2, w2);
+      break;
+    }
+    s++;
+  }
+  return rstat;
+}
+
+// Triangles at levels 1 to kTriangleTableLevels are computed once and kept in a table,
+// indexed by level and position within level. Deeper triangles are computed from their
+// ancestors at the deepest level in the table. Level 6 has 8192 triangles.
+
+static const int kTriangleTableLevels = 6;
+static vector<vector<HTMTriangle>> _triangleTable;
+static once_flag _triangleTableOnce;
+
+// Normalized midpoint of two unit vectors, computed exactly as m4_midpoint() above,
+// so triangles computed from HTM IDs and HTM names are identical.
+
+static SSVector midpoint ( const SSVector &v1, const SSVector &v2 )
+{
+    SSVector w ( v1.x + v2.x, v1.y + v2.y, v1.z + v2.z );
+    double tmp = sqrt ( w.x * w.x + w.y * w.y + w.z * w.z );
+    return SSVector ( w.x / tmp, w.y / tmp, w.z / tmp );
+}
+
+// Replaces triangle vertices (v0,v1,v2) with those of their child triangle (child), from 0 to 3.
+
+static void subdivide ( SSVector &v0, SSVector &v1, SSVector &v2, int child )
+{
+    SSVector w2 = midpoint ( v0, v1 );
+    SSVector w0 = midpoint ( v1, v2 );
+    SSVector w1 = midpoint ( v2, v0 );
+    
+    if ( child == 0 )
+    {
+        v1 = w2;
+        v2 = w1;
+    }
+    else if ( child == 1 )
+    {
+        v0 = v1;
+        v1 = w0;
+        v2 = w2;
+    }
+    else if ( child == 2 )
+    {
+        v0 = v2;
+        v1 = w1;
+        v2 = w0;
+    }
+    else
+    {
+        v0 = w0;
+        v1 = w1;
+        v2 = w2;
+    }
+}
+
+// Computes the bounding circle of a triangle whose vertices are already set.
+
+static void boundTriangle ( HTMTriangle &t )
+{
+    t.center = ( t.v0 + t.v1 + t.v2 ).normalize();
+    t.cosRadius = min ( min ( t.center * t.v0, t.center * t.v1 ), t.center * t.v2 );
+    t.radius = acos ( t.cosRadius );
+    t.sinRadius = sin ( t.radius );
+}
+
+// Returns level of an HTM triangle ID; root triangles are level 1.
+// Returns zero if the ID is not a valid triangle ID, including the origin (ID 0).
+
+static int triangleLevel ( uint64_t htmID )
+{
+    int level = 1;
+    for ( ; htmID >= 16; htmID >>= 2 )
+        level++;
+    return htmID >= 8 ? level : 0;
+}
+
+// Builds the table of triangles at levels 1 to kTriangleTableLevels.
+
+static void buildTriangleTable ( void )
+{
+    _triangleTable = vector<vector<HTMTriangle>> ( kTriangleTableLevels );
+    _triangleTable[0] = vector<HTMTriangle> ( 8 );
+    
+    for ( int k = 0; k < 8; k++ )
+    {
+        int *offsets = k < 4 ? S_indexes[k] : N_indexes[k - 4];
+        HTMTriangle &t = _triangleTable[0][k];
+        t.v0 = SSVector ( anchor[offsets[0]][0], anchor[offsets[0]][1], anchor[offsets[0]][2] );
+        t.v1 = SSVector ( anchor[offsets[1]][0], anchor[offsets[1]][1], anchor[offsets[1]][2] );
+        t.v2 = SSVector ( anchor[offsets[2]][0], anchor[offsets[2]][1], anchor[offsets[2]][2] );
+        boundTriangle ( t );
+    }
+    
+    for ( int l = 1; l < kTriangleTableLevels; l++ )
+    {
+        vector<HTMTriangle> &parents = _triangleTable[l - 1];
+        vector<HTMTriangle> &children = _triangleTable[l];
+        children = vector<HTMTriangle> ( parents.size() * 4 );
+        
+        for ( size_t i = 0; i < children.size(); i++ )
+        {
+            HTMTriangle &t = children[i];
+            t.v0 = parents[i / 4].v0;
+            t.v1 = parents[i / 4].v1;
+            t.v2 = parents[i / 4].v2;
+            subdivide ( t.v0, t.v1, t.v2, i % 4 );
+            boundTriangle ( t );
+        }
+    }
+}
+
+// Returns geometry of the triangle with a valid HTM ID (htmID) at a given level (level).
+// Triangles in the table are returned directly; deeper triangles are computed in (temp).
+
+static const HTMTriangle &getTriangle ( uint64_t htmID, int level, HTMTriangle &temp )
+{
+    call_once ( _triangleTableOnce, buildTriangleTable );
+    
+    if ( level <= kTriangleTableLevels )
+        return _triangleTable[level - 1][ htmID - ( 8ULL << ( 2 * ( level - 1 ) ) ) ];
+    
+    int shift = 2 * ( level - kTriangleTableLevels );
+    uint64_t ancestorID = htmID >> shift;
+    const HTMTriangle &ancestor = _triangleTable[kTriangleTableLevels - 1][ ancestorID - ( 8ULL << ( 2 * ( kTriangleTableLevels - 1 ) ) ) ];
+    temp.v0 = ancestor.v0;
+    temp.v1 = ancestor.v1;
+    temp.v2 = ancestor.v2;
+    
+    for ( shift -= 2; shift >= 0; shift -= 2 )
+        subdivide ( temp.v0, temp.v1, temp.v2, ( htmID >> shift ) & 3 );
+    
+    boundTriangle ( temp );
+    return temp;
+}
+
+// Computes unit vectors to the vertices (v0, v1, v2) of the triangle with an HTM ID (id) directly
+// from the ID, using a table of precomputed triangles for the top levels of the mesh. Vertices are
+// identical to those from name2Triangle ( ID2name ( id ) ). Returns false if the ID is not a valid
+// triangle ID; the origin region (ID 0) covers the whole sky and has no vertices.
+
+bool SSHTM::ID2Triangle ( uint64_t id, SSVector &v0, SSVector &v1, SSVector &v2 )
+{
+    int level = triangleLevel ( id );
+    if ( level == 0 )
+        return false;
+    
+    HTMTriangle temp;
+    const HTMTriangle &t = getTriangle ( id, level, temp );
+    v0 = t.v0;
+    v1 = t.v1;
+    v2 = t.v2;
+    return true;
+}
+
+// Computes the HTM ID of the triangle containing a point (x,y,z) at a given depth, like cc_vector2ID(),
+// but accumulates the ID directly instead of building and parsing a name string. Performs exactly the
+// same floating-point operations as cc_vector2ID(), so results are identical.
+
+static uint64_t vector2IDScalar ( double x, double y, double z, int depth )
+{
+    double v0[3], v1[3], v2[3], w0[3], w1[3], w2[3], p[3] = { x, y, z }, dtmp;
+    int ix = ( x > 0 ? 4 : 0 ) + ( y > 0 ? 2 : 0 ) + ( z > 0 ? 1 : 0 );
+    uint64_t id = bases[ix].ID;
+    
+    copy_vec ( v0, anchor[bases[ix].v1] );
+    copy_vec ( v1, anchor[bases[ix].v2] );
+    copy_vec ( v2, anchor[bases[ix].v3] );
+    
+    while ( depth-- > 0 )
+    {
+        m4_midpoint ( v0, v1, w2, dtmp );
+        m4_midpoint ( v1, v2, w0, dtmp );
+        m4_midpoint ( v2, v0, w1, dtmp );
+        
+        if ( cc_isinside ( p, v0, w2, w1 ) )
+        {
+            id = id << 2;
+            copy_vec ( v1, w2 );
+            copy_vec ( v2, w1 );
+        }
+        else if ( cc_isinside ( p, v1, w0, w2 ) )
+        {
+            id = ( id << 2 ) | 1;
+            copy_vec ( v0, v1 );
+            copy_vec ( v1, w0 );
+            copy_vec ( v2, w2 );
+        }
+        else if ( cc_isinside ( p, v2, w1, w0 ) )
+        {
+            id = ( id << 2 ) | 2;
+            copy_vec ( v0, v2 );
+            copy_vec ( v1, w1 );
+            copy_vec ( v2, w0 );
+        }
+        else if ( cc_isinside ( p, w0, w1, w2 ) )
+        {
+            id = ( id << 2 ) | 3;
+            copy_vec ( v0, w0 );
+            copy_vec ( v1, w1 );
+            copy_vec ( v2, w2 );
+        }
+        else
+        {
+            return HTM_INVALID_ID;
+        }
+    }
+    
+    return id;
+}
+
+#if defined(__AVX2__)
+
+// Four points or vertices, one per AVX2 lane.
+
+struct HTMVec4
+{
+    __m256d x, y, z;
+};
+
+// Normalized midpoints of four pairs of unit vectors, computed exactly as m4_midpoint().
+
+static inline HTMVec4 midpoint4 ( const HTMVec4 &a, const HTMVec4 &b )
+{
+    __m256d x = _mm256_add_pd ( a.x, b.x ), y = _mm256_add_pd ( a.y, b.y ), z = _mm256_add_pd ( a.z, b.z );
+    __m256d t = _mm256_sqrt_pd ( _mm256_add_pd ( _mm256_add_pd ( _mm256_mul_pd ( x, x ), _mm256_mul_pd ( y, y ) ), _mm256_mul_pd ( z, z ) ) );
+    return { _mm256_div_pd ( x, t ), _mm256_div_pd ( y, t ), _mm256_div_pd ( z, t ) };
+}
+
+// Returns mask of lanes where point (p) is not more than gEpsilon to the right of the edge
+// from a to b, computed exactly as each edge test in cc_isinside().
+
+static inline __m256d edge4 ( const HTMVec4 &p, const HTMVec4 &a, const HTMVec4 &b, __m256d neps )
+{
+    __m256d cx = _mm256_sub_pd ( _mm256_mul_pd ( a.y, b.z ), _mm256_mul_pd ( b.y, a.z ) );
+    __m256d cy = _mm256_sub_pd ( _mm256_mul_pd ( a.z, b.x ), _mm256_mul_pd ( b.z, a.x ) );
+    __m256d cz = _mm256_sub_pd ( _mm256_mul_pd ( a.x, b.y ), _mm256_mul_pd ( b.x, a.y ) );
+    __m256d dot = _mm256_add_pd ( _mm256_add_pd ( _mm256_mul_pd ( p.x, cx ), _mm256_mul_pd ( p.y, cy ) ), _mm256_mul_pd ( p.z, cz ) );
+    return _mm256_cmp_pd ( dot, neps, _CMP_NLT_UQ );
+}
+
+static inline __m256d inside4 ( const HTMVec4 &p, const HTMVec4 &a, const HTMVec4 &b, const HTMVec4 &c, __m256d neps )
+{
+    return _mm256_and_pd ( _mm256_and_pd ( edge4 ( p, a, b, neps ), edge4 ( p, b, c, neps ) ), edge4 ( p, c, a, neps ) );
+}
+
+static inline HTMVec4 blend4 ( const HTMVec4 &a, const HTMVec4 &b, __m256d mask )
+{
+    return { _mm256_blendv_pd ( a.x, b.x, mask ), _mm256_blendv_pd ( a.y, b.y, mask ), _mm256_blendv_pd ( a.z, b.z, mask ) };
+}
+
+// Computes HTM IDs of four points at a time, from index i to i + 3, like vector2IDScalar().
+// Each lane descends the mesh independently; the child triangle tests are done in all lanes,
+// and each lane's vertices are blended from the first child which contains its point.
+
+static void vector2IDs4 ( const double *x, const double *y, const double *z, size_t i, int depth, uint64_t *ids )
+{
+    double v[3][3][4];
+    int64_t id0[4];
+    
+    for ( int j = 0; j < 4; j++ )
+    {
+        int ix = ( x[i + j] > 0 ? 4 : 0 ) + ( y[i + j] > 0 ? 2 : 0 ) + ( z[i + j] > 0 ? 1 : 0 );
+        const double *a[3] = { anchor[bases[ix].v1], anchor[bases[ix].v2], anchor[bases[ix].v3] };
+        for ( int k = 0; k < 3; k++ )
+            for ( int c = 0; c < 3; c++ )
+                v[k][c][j] = a[k][c];
+        id0[j] = bases[ix].ID;
+    }
+    
+    HTMVec4 p = { _mm256_loadu_pd ( x + i ), _mm256_loadu_pd ( y + i ), _mm256_loadu_pd ( z + i ) };
+    HTMVec4 v0 = { _mm256_loadu_pd ( v[0][0] ), _mm256_loadu_pd ( v[0][1] ), _mm256_loadu_pd ( v[0][2] ) };
+    HTMVec4 v1 = { _mm256_loadu_pd ( v[1][0] ), _mm256_loadu_pd ( v[1][1] ), _mm256_loadu_pd ( v[1][2] ) };
+    HTMVec4 v2 = { _mm256_loadu_pd ( v[2][0] ), _mm256_loadu_pd ( v[2][1] ), _mm256_loadu_pd ( v[2][2] ) };
+    __m256i id = _mm256_loadu_si256 ( (const __m256i *) id0 );
+    __m256d neps = _mm256_set1_pd ( -gEpsilon ), valid = _mm256_castsi256_pd ( _mm256_set1_epi64x ( -1 ) );
+    __m256i one = _mm256_set1_epi64x ( 1 ), two = _mm256_set1_epi64x ( 2 ), three = _mm256_set1_epi64x ( 3 );
+    
+    while ( depth-- > 0 )
+    {
+        HTMVec4 w2 = midpoint4 ( v0, v1 ), w0 = midpoint4 ( v1, v2 ), w1 = midpoint4 ( v2, v0 );
+        
+        __m256d m0 = inside4 ( p, v0, w2, w1, neps );
+        __m256d m1 = _mm256_andnot_pd ( m0, inside4 ( p, v1, w0, w2, neps ) );
+        __m256d m01 = _mm256_or_pd ( m0, m1 );
+        __m256d m2 = _mm256_andnot_pd ( m01, inside4 ( p, v2, w1, w0, neps ) );
+        __m256d m012 = _mm256_or_pd ( m01, m2 );
+        __m256d m3 = _mm256_andnot_pd ( m012, inside4 ( p, w0, w1, w2, neps ) );
+        valid = _mm256_and_pd ( valid, _mm256_or_pd ( m012, m3 ) );
+        
+        __m256i digit = _mm256_or_si256 ( _mm256_or_si256 ( _mm256_and_si256 ( _mm256_castpd_si256 ( m1 ), one ),
+                                                            _mm256_and_si256 ( _mm256_castpd_si256 ( m2 ), two ) ),
+                                          _mm256_and_si256 ( _mm256_castpd_si256 ( m3 ), three ) );
+        id = _mm256_or_si256 ( _mm256_slli_epi64 ( id, 2 ), digit );
+        
+        HTMVec4 n0 = blend4 ( blend4 ( blend4 ( v0, v1, m1 ), v2, m2 ), w0, m3 );
+        HTMVec4 n1 = blend4 ( blend4 ( w1, w2, m0 ), w0, m1 );
+        HTMVec4 n2 = blend4 ( blend4 ( w2, w1, m0 ), w0, m2 );
+        v0 = n0;
+        v1 = n1;
+        v2 = n2;
+    }
+    
+    id = _mm256_and_si256 ( id, _mm256_castpd_si256 ( valid ) );
+    _mm256_storeu_si256 ( (__m256i *) ( ids + i ), id );
+}
+
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+
+// Two points or vertices, one per NEON lane.
+
+struct HTMVec2
+{
+    float64x2_t x, y, z;
+};
+
+// Normalized midpoints of two pairs of unit vectors, computed exactly as m4_midpoint().
+
+static inline HTMVec2 midpoint2 ( const HTMVec2 &a, const HTMVec2 &b )
+{
+    float64x2_t x = vaddq_f64 ( a.x, b.x ), y = vaddq_f64 ( a.y, b.y ), z = vaddq_f64 ( a.z, b.z );
+    float64x2_t t = vsqrtq_f64 ( vaddq_f64 ( vaddq_f64 ( vmulq_f64 ( x, x ), vmulq_f64 ( y, y ) ), vmulq_f64 ( z, z ) ) );
+    return { vdivq_f64 ( x, t ), vdivq_f64 ( y, t ), vdivq_f64 ( z, t ) };
+}
+
+// Returns mask of lanes where point (p) is not more than gEpsilon to the right of the edge
+// from a to b, computed exactly as each edge test in cc_isinside().
+
+static inline uint64x2_t edge2 ( const HTMVec2 &p, const HTMVec2 &a, const HTMVec2 &b, float64x2_t neps )
+{
+    float64x2_t cx = vsubq_f64 ( vmulq_f64 ( a.y, b.z ), vmulq_f64 ( b.y, a.z ) );
+    float64x2_t cy = vsubq_f64 ( vmulq_f64 ( a.z, b.x ), vmulq_f64 ( b.z, a.x ) );
+    float64x2_t cz = vsubq_f64 ( vmulq_f64 ( a.x, b.y ), vmulq_f64 ( b.x, a.y ) );
+    float64x2_t dot = vaddq_f64 ( vaddq_f64 ( vmulq_f64 ( p.x, cx ), vmulq_f64 ( p.y, cy ) ), vmulq_f64 ( p.z, cz ) );
+    return vreinterpretq_u64_u32 ( vmvnq_u32 ( vreinterpretq_u32_u64 ( vcltq_f64 ( dot, neps ) ) ) );
+}
+
+static inline uint64x2_t inside2 ( const HTMVec2 &p, const HTMVec2 &a, const HTMVec2 &b, const HTMVec2 &c, float64x2_t neps )
+{
+    return vandq_u64 ( vandq_u64 ( edge2 ( p, a, b, neps ), edge2 ( p, b, c, neps ) ), edge2 ( p, c, a, neps ) );
+}
+
+static inline HTMVec2 blend2 ( const HTMVec2 &a, const HTMVec2 &b, uint64x2_t mask )
+{
+    return { vbslq_f64 ( mask, b.x, a.x ), vbslq_f64 ( mask, b.y, a.y ), vbslq_f64 ( mask, b.z, a.z ) };
+}
+
+// Computes HTM IDs of two points at a time, at index i and i + 1, like vector2IDScalar().
+
+static void vector2IDs2 ( const double *x, const double *y, const double *z, size_t i, int depth, uint64_t *ids )
+{
+    double v[3][3][2];
+    uint64_t id0[2];
+    
+    for ( int j = 0; j < 2; j++ )
+    {
+        int ix = ( x[i + j] > 0 ? 4 : 0 ) + ( y[i + j] > 0 ? 2 : 0 ) + ( z[i + j] > 0 ? 1 : 0 );
+        const double *a[3] = { anchor[bases[ix].v1], anchor[bases[ix].v2], anchor[bases[ix].v3] };
+        for ( int k = 0; k < 3; k++ )
+            for ( int c = 0; c < 3; c++ )
+                v[k][c][j] = a[k][c];
+        id0[j] = bases[ix].ID;
+    }
+    
+    HTMVec2 p = { vld1q_f64 ( x + i ), vld1q_f64 ( y + i ), vld1q_f64 ( z + i ) };
+    HTMVec2 v0 = { vld1q_f64 ( v[0][0] ), vld1q_f64 ( v[0][1] ), vld1q_f64 ( v[0][2] ) };
+    HTMVec2 v1 = { vld1q_f64 ( v[1][0] ), vld1q_f64 ( v[1][1] ), vld1q_f64 ( v[1][2] ) };
+    HTMVec2 v2 = { vld1q_f64 ( v[2][0] ), vld1q_f64 ( v[2][1] ), vld1q_f64 ( v[2][2] ) };
+    uint64x2_t id = vld1q_u64 ( id0 ), valid = vdupq_n_u64 ( ~0ULL );
+    uint64x2_t one = vdupq_n_u64 ( 1 ), two = vdupq_n_u64 ( 2 ), three = vdupq_n_u64 ( 3 );
+    float64x2_t neps = vdupq_n_f64 ( -gEpsilon );
+    
+    while ( depth-- > 0 )
+    {
+        HTMVec2 w2 = midpoint2 ( v0, v1 ), w0 = midpoint2 ( v1, v2 ), w1 = midpoint2 ( v2, v0 );
+        
+        uint64x2_t m0 = inside2 ( p, v0, w2, w1, neps );
+        uint64x2_t m1 = vbicq_u64 ( inside2 ( p, v1, w0, w2, neps ), m0 );
+        uint64x2_t m01 = vorrq_u64 ( m0, m1 );
+        uint64x2_t m2 = vbicq_u64 ( inside2 ( p, v2, w1, w0, neps ), m01 );
+        uint64x2_t m012 = vorrq_u64 ( m01, m2 );
+        uint64x2_t m3 = vbicq_u64 ( inside2 ( p, w0, w1, w2, neps ), m012 );
+        valid = vandq_u64 ( valid, vorrq_u64 ( m012, m3 ) );
+        
+        uint64x2_t digit = vorrq_u64 ( vorrq_u64 ( vandq_u64 ( m1, one ), vandq_u64 ( m2, two ) ), vandq_u64 ( m3, three ) );
+        id = vorrq_u64 ( vshlq_n_u64 ( id, 2 ), digit );
+        
+        HTMVec2 n0 = blend2 ( blend2 ( blend2 ( v0, v1, m1 ), v2, m2 ), w0, m3 );
+        HTMVec2 n1 = blend2 ( blend2 ( w1, w2, m0 ), w0, m1 );
+        HTMVec2 n2 = blend2 ( blend2 ( w2, w1, m0 ), w0, m2 );
+        v0 = n0;
+        v1 = n1;
+        v2 = n2;
+    }
+    
+    vst1q_u64 ( ids + i, vandq_u64 ( id, valid ) );
+}
+
+#endif
+
+// Computes HTM IDs of points from index start to end (exclusive) in arrays of coordinates (x,y,z),
+// using SIMD instructions where available, and stores them in (ids).
+
+static void vector2IDRange ( const double *x, const double *y, const double *z, size_t start, size_t end, int depth, uint64_t *ids )
+{
+    size_t i = start;
+    
+#if defined(__AVX2__)
+    for ( ; i + 4 <= end; i += 4 )
+        vector2IDs4 ( x, y, z, i, depth, ids );
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    for ( ; i + 2 <= end; i += 2 )
+        vector2IDs2 ( x, y, z, i, depth, ids );
+#endif
+    
+    for ( ; i < end; i++ )
+        ids[i] = vector2IDScalar ( x[i], y[i], z[i], depth );
+}
+
+// Computes HTM IDs of many points at once. The points' unit vectors are given as separate arrays
+// of x, y, and z coordinates, each with (n) elements. The IDs of the triangles containing them at
+// a specific depth (depth), like vector2ID(), are stored in (ids), which must also have (n) elements.
+// Results are identical to vector2ID() for every point. Uses AVX2 or NEON if the compiler targets
+// them, and splits the points among (nthreads) threads, including the calling thread; if nthreads
+// is zero or negative, uses one thread per hardware core. If USE_THREADS is 0, uses only the calling thread.
+
+void SSHTM::vector2IDs ( const double *x, const double *y, const double *z, size_t n, int depth, uint64_t *ids, int nthreads )
+{
+    static constexpr size_t kMinPointsPerThread = 4096;
+    
+#if USE_THREADS
+    if ( nthreads < 1 )
+        nthreads = max ( 1, (int) thread::hardware_concurrency() );
+    nthreads = (int) min ( (size_t) nthreads, max ( (size_t) 1, n / kMinPointsPerThread ) );
+#else
+    nthreads = 1;
+#endif
+    
+    if ( nthreads == 1 )
+    {
+        vector2IDRange ( x, y, z, 0, n, depth, ids );
+        return;
+    }
+    
+#if USE_THREADS
+    vector<thread> threads;
+    for ( int t = 1; t < nthreads; t++ )
+        threads.push_back ( thread ( vector2IDRange, x, y, z, n * t / nthreads, n * ( t + 1 ) / nthreads, depth, ids ) );
+    
+    vector2IDRange ( x, y, z, 0, n / nthreads, depth, ids );
+    for ( thread &t : threads )
+        t.join();
+#endif
+}
+
+// Creates a map of objects in this HTM with identifiers in the specific catalog (cat).
+// Assumes entire HTM, including all regions and objects therein, is loaded into memory!
+// Returns number of index entries generated.
+
+size_t SSHTM::makeObjectMap ( SSCatalog cat )
+{
+    NameMap  nameMap;
+    IdentMap identMap;
+
+    vector<uint64_t> ids;
+    _mutex.lock();
+    for ( auto it = _regions.begin(); it != _regions.end(); it++ )
+        ids.push_back ( it->first );
+    _mutex.unlock();
+
+    for ( uint64_t id : ids )
+        makeObjectMap ( cat, id, nameMap, identMap );
+    
+    if ( cat == kCatUnknown && nameMap.size() > 0 )
+    {
+        _nameIndex[cat] = nameMap;
+        _nameSearch.build ( nameMap );
+    }
+    if ( cat != kCatUnknown && identMap.size() > 0 )
+    {
+        _identIndex[cat] = identMap;
+        _identSearch[cat].build ( identMap );
+    }
+    
+    return cat == kCatUnknown ? nameMap.size() : identMap.size();
+}
+
+// Adds index entries for objects with identifiers in the specifid catalog (cat)
+// contained in the HTM region (regionID).
+// Index entries are appended to the provided ObjectIndex (index).
+// The function returns the number of index entries added.
+
+size_t SSHTM::makeObjectMap ( SSCatalog cat, uint64_t regionID, NameMap &nameMap, IdentMap &identMap )
+{
+    size_t n = cat == kCatUnknown ? nameMap.size() : identMap.size();
+    
+    SSObjectVec *pObjects = _getObjects ( regionID, false );
+    size_t nObjects = pObjects ? pObjects->size() : 0;
+    for ( size_t offset = 0; offset < nObjects; offset++ )
+    {
+        SSObjectPtr pObject = pObjects->get ( offset );
+
+        if ( cat == kCatUnknown )
+        {
+            for ( const string &name : pObject->getNames() )
+               nameMap.insert ( { name, { regionID, offset } } );
+        }
+        else
+        {
+            SSStarPtr pStar = SSGetStarPtr ( pObject );
+            if ( pStar == nullptr )
+                continue;
+
+            for ( SSIdentifier ident : pStar->getIdents() )
+                if ( ident.catalog() == cat )
+                    identMap.insert ( { ident, { regionID, offset } } );
+        }
+    }
+    
+    return ( cat == kCatUnknown ? nameMap.size() : identMap.size() ) - n;
+}
+
+// Saves this HTM's object map for the specified catalog (cat) to a file.
+// Writes objects with user-definded function (saveFunc) and data (userData);
+// if these are nullptr, writes map in CSV format to HTM's "index" subdirectory.
+// Returns number of map entries written to file.
+
+size_t SSHTM::saveObjectMap ( SSCatalog cat, IdentMapFunc saveFunc, void *userData )
+{
+    int n = 0;
+    
+    if ( saveFunc != nullptr && cat != kCatUnknown )
+    {
+        n = saveFunc ( this, cat, &getIdentMap ( cat ), userData );
+        return n;
+    }
+
+    // Open file; return on failure.
+    
+    string catname = cat == kCatUnknown ? string ( "Name" ) : catalog_to_string ( cat );
+    string filepath ( _rootpath + "index/" + catname + ".csv" );
+    ofstream file ( filepath, ios::trunc );
+    if ( ! file )
+        return n;
+    
+    // Write name map if catalog is not specified; otherwise write identifier map.
+    // The name map may have been loaded from a binary name index file, without a multimap;
+    // write the CSV file from the name index, then write the binary name index file too.
+    // Close the CSV file first, so the binary index is never older than it; see loadObjectMap().
+    
+    if ( cat == kCatUnknown )
+    {
+        NameMap &nameMap = _nameIndex[cat];
+        if ( nameMap.size() > 0 )
+            _nameSearch.build ( nameMap );
+        
+        for ( size_t i = 0; i < _nameSearch.size(); i++ )
+        {
+            ObjectLoc loc = _nameSearch.getLoc ( i );
+            string htmIDstr = ID2name ( loc.region );
+            file << _nameSearch.getName ( i ) << "," << htmIDstr << "," << to_string ( loc.offset ) << endl;
+            n++;
+        }
+        
+        file.close();
+        _nameSearch.save ( _rootpath + "index/" + catname + ".bin" );
+    }
+    else
+    {
+        IdentMap &identMap = _identIndex[cat];
+        IdentIndex &identIndex = _identSearch[cat];
+        if ( identMap.size() > 0 )
+            identIndex.build ( identMap );
+        
+        for ( size_t i = 0; i < identIndex.size(); i++ )
+        {
+            ObjectLoc loc = identIndex.getLoc ( i );
+            string identstr = identIndex.getIdent ( i ).toString();
+            string htmIDstr = ID2name ( loc.region );
+            file << identstr << "," << htmIDstr << "," << to_string ( loc.offset ) << endl;
+            n++;
+        }
+        
+        file.close();
+        identIndex.save ( _rootpath + "index/" + catname + ".bin", cat );
+    }
+    
+    return n;
+}
+
+// Loads an object map for the specified catalog (cat) into this HTM's object indexes.
+// Writes objects with user-definded function (saveFunc) and data (userData);
+// if these are nullptr, reads map in CSV format from HTM's "index" subdirectory.
+// Returns number of map entries read from file.
+
+size_t SSHTM::loadObjectMap ( SSCatalog cat, IdentMapFunc loadFunc, void *userData )
+{
+    int n = 0;
+    bool stale = false;
+    string binpath;
+    NameMap nameMap;
+    IdentMap identMap;
+
+    if ( loadFunc != nullptr && cat != kCatUnknown )
+    {
+        n = loadFunc ( this, cat, &identMap, userData );
+    }
+    else
+    {
+        string catname = cat == kCatUnknown ? string ( "Name" ) : catalog_to_string ( cat );
+        
+        // Prefer memory-mapping a binary name or identifier index file, which needs no parsing,
+        // to reading the CSV file; its entries are searched in place. But if the CSV file was
+        // modified after the binary index, the binary index is stale: read the CSV file instead,
+        // and rebuild the binary index from it below.
+        
+        binpath = _rootpath + "index/" + catname + ".bin";
+        string filepath ( _rootpath + "index/" + catname + ".csv" );
+        stale = isfile ( binpath ) && filetime ( binpath ) < filetime ( filepath );
+        
+        if ( cat == kCatUnknown && ! stale && _nameSearch.open ( binpath ) )
+        {
+            _nameIndex[cat].clear();
+            return _nameSearch.size();
+        }
+        
+        if ( cat != kCatUnknown && ! stale && _identSearch[cat].open ( binpath, cat ) )
+        {
+            _identIndex[cat].clear();
+            return _identSearch[cat].size();
+        }
+        
+        // Open file; return on failure.
+        
+        SSLineReader reader ( filepath );
+        if ( ! reader.isOpen() )
+            return n;
+
+        // Read file line-by-line until we reach end-of-file
+
+        string_view line;
+        vector<string_view> fields;
+        string buffer;
+        while ( reader.readLine ( line ) )
+        {
+            split_csv ( line, fields, buffer );
+            if ( fields.size() < 3 )
+                continue;
+
+            // Read name map if catalog is not specified; otherwise read identifier map.
+            
+            if ( cat == kCatUnknown )
+            {
+                string name ( fields[0] );
+                if ( ! name.empty() )
+                {
+                    uint64_t htmID = name2ID ( string ( fields[1] ) );
+                    size_t offset = strtoint64 ( fields[2] );
+                    nameMap.insert ( { name, { htmID, offset } } );
+                    n++;
+                }
+            }
+            else
+            {
+                SSIdentifier ident = SSIdentifier::fromString ( string ( fields[0] ), kTypeNonexistent, true );
+                if ( ident != 0 )
+                {
+                    uint64_t htmID = name2ID ( string ( fields[1] ) );
+                    size_t offset = strtoint64 ( fields[2] );
+                    identMap.insert ( { ident, { htmID, offset } } );
+                    n++;
+                }
+            }
+        }
+    }
+    
+    // If we read anything, save the name map or ident map we just read.
+    // Replace a stale binary index file with one built from the map.
+    
+    if ( n > 0 )
+    {
+        if ( cat == kCatUnknown )
+        {
+            _nameIndex[cat] = nameMap;
+            _nameSearch.build ( nameMap );
+            if ( stale )
+                _nameSearch.save ( binpath );
+        }
+        else
+        {
+            _identIndex[cat] = identMap;
+            _identSearch[cat].build ( identMap );
+            if ( stale )
+                _identSearch[cat].save ( binpath, cat );
+        }
+    }
+
+    return n;
+}
+
+// Given an identifier, uses this HTM's identifier index to find all objects matching
+// the identifier. Object locations are appended to the vector (results).
+// Returns number of object locations found.
+
+int SSHTM::findObjectLocs ( SSIdentifier ident, vector<SSHTM::ObjectLoc> &results )
+{
+    SSCatalog cat = ident.catalog();
+    if ( objectMapSize ( cat ) == 0 )
+        return 0;
+    
+    IdentIndex &index = _identSearch[cat];
+    if ( index.size() > 0 )
+        return index.find ( ident, results );
+    
+    IdentMap &map = _identIndex[cat];
+    auto it0 = map.lower_bound ( ident );
+    auto it1 = map.upper_bound ( ident );
+    
+    int n = (int) results.size();
+    for ( auto it = it0; it != it1; it++ )
+        results.push_back ( it->second );
+    return (int) results.size() - n;
+}
+
+// Returns a reference to this HTM's identifier map for a catalog (cat). If the identifier
+// index was memory-mapped from a binary file, the map is filled from it on first use,
+// for compatibility with code which expects an IdentMap.
+
+SSHTM::IdentMap &SSHTM::getIdentMap ( SSCatalog cat )
+{
+    IdentMap &map = _identIndex[cat];
+    if ( map.empty() )
+        _identSearch[cat].toMap ( map );
+    
+    return map;
+}
+
+// Given a name string (name), uses this HTM's name index to find all objects matching the name string.
+// Pass true for (casesens) for Case-Sensitive string matching; pass false for case-insensitive matching.
+// Pass true for (begins) for "begins-with" string matching; pass false for whole-string matching.
+// Object locations are appended to the vector (results); returns number of object locations found.
+
+int SSHTM::findObjectLocs ( const string &name, vector<SSHTM::ObjectLoc> &results, bool casesens, bool begins )
+{
+    if ( objectMapSize ( kCatUnknown ) == 0 )
+        return 0;
+    
+    NameMap &map = _nameIndex[kCatUnknown];
+    int n = (int) results.size();
+    
+    if ( casesens == true && begins == false && map.size() > 0 )
+    {
+        auto it0 = map.lower_bound ( name );
+        auto it1 = map.upper_bound ( name );
+        for ( auto it = it0; it != it1; it++ )
+            results.push_back ( it->second );
+    }
+    else if ( _nameSearch.size() > 0 )
+    {
+        // Binary-search the normalized name index; case-insensitive matches
+        // also ignore differences in whitespace.
+        
+        _nameSearch.find ( name, results, casesens, begins );
+    }
+    else
+    {
+        // No name index; brute-force-search the name map for entries matching the name string.
+        
+        auto it0 = map.begin();
+        auto it1 = map.end();
+        for ( auto it = it0; it != it1; it++ )
+            if ( compare ( it->first, name, begins ? name.length() : 0, casesens ) == 0 )
+                results.push_back ( it->second );
+    }
+    
+    return (int) results.size() - n;
+}
+
+// Appends to vector (names) up to (maxNames) distinct object names which begin with the string (prefix),
+// ignoring case and differences in whitespace, in normalized alphabetical order; zero means no limit.
+// Intended for "type-ahead" name searches. Returns number of names appended.
+
+int SSHTM::completeObjectNames ( const string &prefix, vector<string> &names, size_t maxNames )
+{
+    return _nameSearch.complete ( prefix, names, maxNames );
+}
+
+static const char kNameIndexMagic[8] = { 'S', 'S', 'H', 'T', 'M', 'N', 'A', 'M' };
+
+static_assert ( sizeof ( SSHTM::NameIndex::Header ) == 32, "SSHTM::NameIndex::Header must be 32 bytes" );
+static_assert ( sizeof ( SSHTM::NameIndex::Entry ) == 24, "SSHTM::NameIndex::Entry must be 24 bytes" );
+
+// Constructs an empty name index.
+
+SSHTM::NameIndex::NameIndex ( void )
+{
+    _pData = nullptr;
+    _size = 0;
+    _pEntries = nullptr;
+    _pStrings = nullptr;
+    _numEntries = 0;
+}
+
+// Move constructor takes over another name index's entries or memory-mapped file.
+
+SSHTM::NameIndex::NameIndex ( NameIndex &&other ) : NameIndex()
+{
+    *this = std::move ( other );
+}
+
+// Move assignment clears this name index, then takes over another name index's
+// entries or memory-mapped file, leaving the other index empty.
+
+SSHTM::NameIndex &SSHTM::NameIndex::operator = ( NameIndex &&other )
+{
+    if ( this == &other )
+        return *this;
+    
+    clear();
+    _entries = std::move ( other._entries );
+    _strings = std::move ( other._strings );
+    _pData = other._pData;
+    _size = other._size;
+    _pEntries = other._pEntries;
+    _pStrings = other._pStrings;
+    _numEntries = other._numEntries;
+    
+    other._pData = nullptr;
+    other.clear();
+    return *this;
+}
+
+// Destructor unmaps file, if open.
+
+SSHTM::NameIndex::~NameIndex ( void )
+{
+    clear();
+}
+
+// Empties the name index and unmaps its file, if memory-mapped.
+
+void SSHTM::NameIndex::clear ( void )
+{
+    if ( _pData != nullptr )
+        unmapfile ( _pData, _size );
+    
+    _entries.clear();
+    _strings.clear();
+    _pData = nullptr;
+    _size = 0;
+    _pEntries = nullptr;
+    _pStrings = nullptr;
+    _numEntries = 0;
+}
+
+// Returns normalized form of an object name (name): ASCII letters are converted to lower case,
+// leading whitespace is removed, and runs of whitespace are collapsed to a single space.
+// Trailing whitespace is removed if (trim) is true; otherwise one trailing space is kept,
+// so a "begins-with" search for "alpha " does not match "alphard".
+
+string SSHTM::NameIndex::normalize ( const string &name, bool trim )
+{
+    string key;
+    bool space = false;
+    
+    key.reserve ( name.length() );
+    for ( unsigned char c : name )
+    {
+        if ( c < 0x80 && isspace ( c ) )
+        {
+            space = ! key.empty();
+            continue;
+        }
+        
+        if ( space )
+            key += ' ';
+        
+        key += c < 0x80 ? (char) tolower ( c ) : (char) c;
+        space = false;
+    }
+    
+    if ( space && ! trim )
+        key += ' ';
+    
+    return key;
+}
+
+// Builds the name index in memory from entries in a name map (nameMap), replacing any
+// previous contents. Entries are sorted by normalized name, then by original name.
+
+void SSHTM::NameIndex::build ( const NameMap &nameMap )
+{
+    vector<string> keys;
+    vector<Entry> entries;
+    vector<char> strings;
+    
+    // Equal names are adjacent in the multimap; store each distinct name once.
+    
+    keys.reserve ( nameMap.size() );
+    entries.reserve ( nameMap.size() );
+    for ( auto it = nameMap.begin(); it != nameMap.end(); it++ )
+    {
+        uint32_t name = (uint32_t) strings.size();
+        if ( it != nameMap.begin() && std::prev ( it )->first == it->first )
+            name = entries.back().name;
+        else
+            strings.insert ( strings.end(), it->first.c_str(), it->first.c_str() + it->first.length() + 1 );
+        
+        keys.push_back ( normalize ( it->first ) );
+        entries.push_back ( { name, name, it->second.region, it->second.offset } );
+    }
+    
+    // Store normalized names separately only where they differ from the originals.
+    
+    for ( size_t i = 0; i < entries.size(); i++ )
+    {
+        if ( keys[i] == strings.data() + entries[i].name )
+            continue;
+        
+        if ( i > 0 && keys[i] == keys[i - 1] )
+        {
+            entries[i].key = entries[i - 1].key;
+            continue;
+        }
+        
+        entries[i].key = (uint32_t) strings.size();
+        strings.insert ( strings.end(), keys[i].c_str(), keys[i].c_str() + keys[i].length() + 1 );
+    }
+    
+    // Entries are already in original name order, which stable sorting keeps among equal keys.
+    
+    const char *pStrings = strings.data();
+    stable_sort ( entries.begin(), entries.end(), [pStrings] ( const Entry &a, const Entry &b )
+    {
+        return strcmp ( pStrings + a.key, pStrings + b.key ) < 0;
+    } );
+    
+    clear();
+    _entries = std::move ( entries );
+    _strings = std::move ( strings );
+    _pEntries = _entries.data();
+    _pStrings = _strings.data();
+    _numEntries = _entries.size();
+}
+
+// Memory-maps a binary name index file (path) and validates its header, table sizes, and entry offsets.
+// Replaces this index's contents only if successful. Returns true if successful or false on failure.
+
+bool SSHTM::NameIndex::open ( const string &path )
+{
+    size_t size = 0;
+    const char *pData = (const char *) mapfile ( path, size );
+    if ( pData == nullptr )
+        return false;
+    
+    const Header *pHeader = (const Header *) pData;
+    if ( size < sizeof ( Header ) || memcmp ( pHeader->magic, kNameIndexMagic, sizeof ( kNameIndexMagic ) ) != 0
+        || pHeader->version != kVersion || pHeader->entrySize != sizeof ( Entry ) )
+    {
+        unmapfile ( pData, size );
+        return false;
+    }
+    
+    // Check entry count before multiplying, so a huge count can't overflow into a plausible file size.
+    
+    uint64_t numEntries = pHeader->numEntries, stringsSize = pHeader->stringsSize;
+    if ( numEntries > ( size - sizeof ( Header ) ) / sizeof ( Entry )
+        || stringsSize != size - sizeof ( Header ) - numEntries * sizeof ( Entry )
+        || stringsSize == 0 || pData[ size - 1 ] != 0 )
+    {
+        unmapfile ( pData, size );
+        return false;
+    }
+    
+    // Reject entries whose strings lie outside the string table. The table ends with a NUL,
+    // so every string which starts inside it also ends inside it.
+    
+    const Entry *pEntries = (const Entry *) ( pData + sizeof ( Header ) );
+    for ( uint64_t i = 0; i < numEntries; i++ )
+        if ( pEntries[i].key >= stringsSize || pEntries[i].name >= stringsSize )
+        {
+            unmapfile ( pData, size );
+            return false;
+        }
+    
+    clear();
+    _pData = pData;
+    _size = size;
+    _pEntries = pEntries;
+    _pStrings = (const char *) ( pEntries + numEntries );
+    _numEntries = numEntries;
+    return true;
+}
+
+// Writes this name index to a binary file (path) which can be memory-mapped with open().
+// Returns true if successful or false on failure.
+
+bool SSHTM::NameIndex::save ( const string &path )
+{
+    // String table ends after the last string any entry refers to.
+    // An empty index gets a one-byte string table, so open() can validate it.
+    
+    uint64_t stringsSize = 0;
+    for ( size_t i = 0; i < _numEntries; i++ )
+    {
+        uint32_t offset = max ( _pEntries[i].key, _pEntries[i].name );
+        stringsSize = max ( stringsSize, (uint64_t) ( offset + strlen ( _pStrings + offset ) + 1 ) );
+    }
+    
+    const char empty = 0;
+    const char *pStrings = stringsSize > 0 ? _pStrings : &empty;
+    stringsSize = max ( stringsSize, (uint64_t) 1 );
+    
+    Header header = { { 0 }, kVersion, sizeof ( Entry ), _numEntries, stringsSize };
+    memcpy ( header.magic, kNameIndexMagic, sizeof ( kNameIndexMagic ) );
+    
+    FILE *file = fopen ( path.c_str(), "wb" );
+    if ( file == nullptr )
+        return false;
+    
+    bool ok = fwrite ( &header, sizeof ( header ), 1, file ) == 1
+           && fwrite ( _pEntries, sizeof ( Entry ), _numEntries, file ) == _numEntries
+           && fwrite ( pStrings, 1, stringsSize, file ) == stringsSize;
+    
+    if ( fclose ( file ) != 0 )
+        ok = false;
+    
+    return ok;
+}
+
+// Returns index of the first entry whose normalized name is not less than (key).
+
+size_t SSHTM::NameIndex::_lowerBound ( const string &key )
+{
+    size_t lo = 0, hi = _numEntries;
+    while ( lo < hi )
+    {
+        size_t mid = lo + ( hi - lo ) / 2;
+        if ( strcmp ( _pStrings + _pEntries[mid].key, key.c_str() ) < 0 )
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    
+    return lo;
+}
+
+// Finds entries matching an object name (name). If (begins) is true, matches names which begin
+// with (name); otherwise matches whole names. If (casesens) is false, names are matched in normalized
+// form; if true, they must also match case and whitespace exactly. Object locations are appended
+// to vector (results); returns number of locations found.
+
+int SSHTM::NameIndex::find ( const string &name, vector<ObjectLoc> &results, bool casesens, bool begins )
+{
+    string key = normalize ( name, ! begins );
+    if ( key.empty() )
+        return 0;
+    
+    int n = (int) results.size();
+    for ( size_t i = _lowerBound ( key ); i < _numEntries; i++ )
+    {
+        const char *entryKey = _pStrings + _pEntries[i].key;
+        if ( begins ? strncmp ( entryKey, key.c_str(), key.length() ) != 0 : strcmp ( entryKey, key.c_str() ) != 0 )
+            break;
+        
+        if ( casesens && compare ( getName ( i ), name, begins ? name.length() : 0, true ) != 0 )
+            continue;
+        
+        results.push_back ( getLoc ( i ) );
+    }
+    
+    return (int) results.size() - n;
+}
+
+// Appends to vector (names) up to (maxNames) distinct original names whose normalized form begins
+// with the normalized (prefix); zero means no limit. Returns number of names appended.
+
+int SSHTM::NameIndex::complete ( const string &prefix, vector<string> &names, size_t maxNames )
+{
+    string key = normalize ( prefix, false );
+    if ( key.empty() )
+        return 0;
+    
+    size_t n = 0;
+    uint32_t last = UINT32_MAX;
+    for ( size_t i = _lowerBound ( key ); i < _numEntries && ( maxNames == 0 || n < maxNames ); i++ )
+    {
+        if ( strncmp ( _pStrings + _pEntries[i].key, key.c_str(), key.length() ) != 0 )
+            break;
+        
+        // Entries for the same original name are adjacent and share its string table offset.
+        
+        if ( _pEntries[i].name == last )
+            continue;
+        
+        last = _pEntries[i].name;
+        names.push_back ( getName ( i ) );
+        n++;
+    }
+    
+    return (int) n;
+}
+
+static const char kIdentIndexMagic[8] = { 'S', 'S', 'H', 'T', 'M', 'I', 'D', 'X' };
+
+static_assert ( sizeof ( SSHTM::IdentIndex::Header ) == 32, "SSHTM::IdentIndex::Header must be 32 bytes" );
+static_assert ( sizeof ( SSHTM::IdentIndex::Entry ) == 24, "SSHTM::IdentIndex::Entry must be 24 bytes" );
+
+// Constructs an empty identifier index.
+
+SSHTM::IdentIndex::IdentIndex ( void )
+{
+    _pData = nullptr;
+    _size = 0;
+    _pEntries = nullptr;
+    _numEntries = 0;
+}
+
+// Move constructor takes over another identifier index's entries or memory-mapped file.
+
+SSHTM::IdentIndex::IdentIndex ( IdentIndex &&other ) : IdentIndex()
+{
+    *this = std::move ( other );
+}
+
+// Move assignment clears this identifier index, then takes over another identifier index's
+// entries or memory-mapped file, leaving the other index empty.
+
+SSHTM::IdentIndex &SSHTM::IdentIndex::operator = ( IdentIndex &&other )
+{
+    if ( this == &other )
+        return *this;
+    
+    clear();
+    _entries = std::move ( other._entries );
+    _pData = other._pData;
+    _size = other._size;
+    _pEntries = other._pEntries;
+    _numEntries = other._numEntries;
+    
+    other._pData = nullptr;
+    other.clear();
+    return *this;
+}
+
+// Destructor unmaps file, if open.
+
+SSHTM::IdentIndex::~IdentIndex ( void )
+{
+    clear();
+}
+
+// Empties the identifier index and unmaps its file, if memory-mapped.
+
+void SSHTM::IdentIndex::clear ( void )
+{
+    if ( _pData != nullptr )
+        unmapfile ( _pData, _size );
+    
+    _entries.clear();
+    _pData = nullptr;
+    _size = 0;
+    _pEntries = nullptr;
+    _numEntries = 0;
+}
+
+// Builds the identifier index in memory from entries in an identifier map (identMap),
+// replacing any previous contents. The map is already sorted by identifier.
+
+void SSHTM::IdentIndex::build ( const IdentMap &identMap )
+{
+    vector<Entry> entries;
+    
+    entries.reserve ( identMap.size() );
+    for ( auto it = identMap.begin(); it != identMap.end(); it++ )
+        entries.push_back ( { (uint64_t) it->first, it->second.region, (uint32_t) it->second.offset, 0 } );
+    
+    clear();
+    _entries = std::move ( entries );
+    _pEntries = _entries.data();
+    _numEntries = _entries.size();
+}
+
+// Memory-maps a binary identifier index file (path) and validates its header, catalog (cat), and size.
+// Replaces this index's contents only if successful. Returns true if successful or false on failure.
+
+bool SSHTM::IdentIndex::open ( const string &path, SSCatalog cat )
+{
+    size_t size = 0;
+    const char *pData = (const char *) mapfile ( path, size );
+    if ( pData == nullptr )
+        return false;
+    
+    const Header *pHeader = (const Header *) pData;
+    if ( size < sizeof ( Header ) || memcmp ( pHeader->magic, kIdentIndexMagic, sizeof ( kIdentIndexMagic ) ) != 0
+        || pHeader->version != kVersion || pHeader->entrySize != sizeof ( Entry ) || pHeader->catalog != cat
+        || pHeader->numEntries > ( size - sizeof ( Header ) ) / sizeof ( Entry )
+        || sizeof ( Header ) + pHeader->numEntries * sizeof ( Entry ) != size )
+    {
+        unmapfile ( pData, size );
+        return false;
+    }
+    
+    clear();
+    _pData = pData;
+    _size = size;
+    _pEntries = (const Entry *) ( pData + sizeof ( Header ) );
+    _numEntries = pHeader->numEntries;
+    return true;
+}
+
+// Writes this identifier index for catalog (cat) to a binary file (path) which can be memory-mapped
+// with open(). Returns true if successful or false on failure.
+
+bool SSHTM::IdentIndex::save ( const string &path, SSCatalog cat )
+{
+    Header header = { { 0 }, kVersion, sizeof ( Entry ), _numEntries, (uint32_t) cat, 0 };
+    memcpy ( header.magic, kIdentIndexMagic, sizeof ( kIdentIndexMagic ) );
+    
+    FILE *file = fopen ( path.c_str(), "wb" );
+    if ( file == nullptr )
+        return false;
+    
+    bool ok = fwrite ( &header, sizeof ( header ), 1, file ) == 1
+           && fwrite ( _pEntries, sizeof ( Entry ), _numEntries, file ) == _numEntries;
+    
+    if ( fclose ( file ) != 0 )
+        ok = false;
+    
+    return ok;
+}
+
+// Finds entries matching an identifier (ident). The search is branchless, so its loop
+// compiles to conditional moves, and touches at most log2(n) + 1 entries.
+// Object locations are appended to vector (results); returns number of locations found.
+
+int SSHTM::IdentIndex::find ( SSIdentifier ident, vector<ObjectLoc> &results )
+{
+    if ( _numEntries == 0 )
+        return 0;
+    
+    uint64_t id = ident;
+    const Entry *base = _pEntries;
+    size_t n = _numEntries;
+    while ( n > 1 )
+    {
+        size_t half = n / 2;
+        base = base[ half - 1 ].ident < id ? base + half : base;
+        n -= half;
+    }
+    
+    if ( base->ident < id )
+        base++;
+    
+    int count = 0;
+    for ( const Entry *end = _pEntries + _numEntries; base < end && base->ident == id; base++, count++ )
+        results.push_back ( { base->region, (size_t) base->offset } );
+    
+    return count;
 }
 
-// Creates a map of objects in this HTM with identifiers in the specific catalog (cat).
-// Assumes entire HTM, including all regions and objects therein, is loaded into memory!
-// Returns number of index entries generated.
+// Appends all entries in this identifier index to an identifier map (identMap).
 
-size_t SSHTM::makeObjectMap ( SSCatalog cat )
+void SSHTM::IdentIndex::toMap ( IdentMap &identMap )
 {
-    NameMap  nameMap;
-    IdentMap identMap;
+    for ( size_t i = 0; i < _numEntries; i++ )
+        identMap.insert ( identMap.end(), { getIdent ( i ), getLoc ( i ) } );
+}
 
-    for ( auto it = _regions.begin(); it != _regions.end(); it++ )
-        makeObjectMap ( cat, it->first, nameMap, identMap );
-    
-    if ( cat == kCatUnknown && nameMap.size() > 0 )
-        _nameIndex[cat] = nameMap;
-    if ( cat != kCatUnknown && identMap.size() > 0 )
-        _identIndex[cat] = identMap;
+// Given an object location in this HTM, synchronously loads the region containing the object
+// (if not already loaded) and returns a pointer to the object, or nullptr on failure.
+
+SSObjectPtr SSHTM::loadObject ( const ObjectLoc &loc )
+{
+    SSObjectVec *pObjects = loadRegion ( loc.region, true );
+    if ( pObjects )
+        return pObjects->get ( loc.offset );
     
-    return cat == kCatUnknown ? nameMap.size() : identMap.size();
+    return nullptr;
 }
 
-// Adds index entries for objects with identifiers in the specifid catalog (cat)
-// contained in the HTM region (regionID).
-// Index entries are appended to the provided ObjectIndex (index).
-// The function returns the number of index entries added.
+// Returns a cap centered on a unit vector (center) with an angular radius (radius) in radians.
+// Radii are limited to the range 0 to pi.
 
-size_t SSHTM::makeObjectMap ( SSCatalog cat, uint64_t regionID, NameMap &nameMap, IdentMap &identMap )
+SSHTM::Cap SSHTM::makeCap ( SSVector center, SSAngle radius )
 {
-    size_t n = cat == kCatUnknown ? nameMap.size() : identMap.size();
+    double r = min ( max ( (double) radius, 0.0 ), SSAngle::kPi );
+    return { center.normalize(), r, cos ( r ), sin ( r ) };
+}
+
+// Returns a convex region bounded by a convex spherical polygon, whose vertices are unit vectors
+// (vertices) listed in order around the polygon, either clockwise or counter-clockwise. Each edge
+// is a great circle, so the region is the intersection of hemispheres. The polygon must be smaller
+// than a hemisphere, and have at least three vertices; otherwise the returned convex is empty.
+
+SSHTM::Convex SSHTM::makePolygon ( const vector<SSVector> &vertices )
+{
+    Convex convex;
+    size_t n = vertices.size();
+    if ( n < 3 )
+        return convex;
     
-    SSObjectVec *pObjects = getObjects ( regionID );
-    size_t nObjects = pObjects ? pObjects->size() : 0;
-    for ( size_t offset = 0; offset < nObjects; offset++ )
+    SSVector centroid ( 0.0, 0.0, 0.0 );
+    for ( const SSVector &v : vertices )
+        centroid += v;
+    
+    for ( size_t i = 0; i < n; i++ )
     {
-        SSObjectPtr pObject = pObjects->get ( offset );
-
-        if ( cat == kCatUnknown )
-        {
-            vector<string> names = pObject->getNames();
-            for ( string name : names )
-               nameMap.insert ( { name, { regionID, offset } } );
-        }
-        else
-        {
-            vector<SSIdentifier> idents = pObject->getIdentifiers();
-            for ( SSIdentifier ident : idents )
-                if ( ident.catalog() == cat )
-                    identMap.insert ( { ident, { regionID, offset } } );
-        }
+        SSVector v0 = vertices[i], v1 = vertices[ ( i + 1 ) % n ];
+        convex.push_back ( { v0.crossProduct ( v1 ).normalize(), SSAngle::kHalfPi, 0.0, 1.0 } );
     }
     
-    return ( cat == kCatUnknown ? nameMap.size() : identMap.size() ) - n;
+    // If vertices are clockwise, edge normals point away from the polygon; flip them.
+    
+    if ( convex[0].center * centroid < 0.0 )
+        for ( Cap &cap : convex )
+            cap.center = cap.center * -1.0;
+    
+    return convex;
 }
 
-// Saves this HTM's object map for the specified catalog (cat) to a file.
-// Writes objects with user-definded function (saveFunc) and data (userData);
-// if these are nullptr, writes map in CSV format to HTM's "index" subdirectory.
-// Returns number of map entries written to file.
+// Tests whether a unit vector (p) is inside all caps in a convex region (convex).
 
-size_t SSHTM::saveObjectMap ( SSCatalog cat, IdentMapFunc saveFunc, void *userData )
+bool SSHTM::inConvex ( const Convex &convex, SSVector p )
 {
-    int n = 0;
+    for ( const Cap &cap : convex )
+        if ( p * cap.center <= cap.cosRadius )
+            return false;
     
-    if ( saveFunc != nullptr && cat != kCatUnknown )
-    {
-        n = saveFunc ( this, cat, &_identIndex[cat], userData );
-        return n;
-    }
+    return true;
+}
 
-    // Open file; return on failure.
+// How an HTM triangle relates to a search region
+
+enum SSHTMOverlap
+{
+    kOutside = 0,       // triangle is entirely outside region
+    kPartial = 1,       // triangle may be partly inside region
+    kInside = 2,        // triangle is entirely inside region
+};
+
+// Tests whether two circles, centered on unit vectors c1 and c2, with angular radii r1 and r2
+// whose cosines and sines are cos1, sin1, cos2, sin2, are disjoint. Uses only dot products.
+
+static bool disjoint ( SSVector c1, double r1, double cos1, double sin1, SSVector c2, double r2, double cos2, double sin2 )
+{
+    return r1 + r2 < SSAngle::kPi && c1 * c2 < cos1 * cos2 - sin1 * sin2;
+}
+
+// Classifies an HTM triangle (t) against a cap. A cap no larger than a hemisphere is convex,
+// so the triangle is inside if all its vertices are. The outside of a cap at least as large as
+// a hemisphere is convex, so the triangle is outside if all its vertices are. Otherwise, the
+// triangle's bounding circle is compared to the cap and to its outside.
+
+static SSHTMOverlap classifyCap ( const HTMTriangle &t, const SSHTM::Cap &cap )
+{
+    SSVector c = cap.center;
+    int n = ( c * t.v0 > cap.cosRadius ) + ( c * t.v1 > cap.cosRadius ) + ( c * t.v2 > cap.cosRadius );
     
-    string catname = cat == kCatUnknown ? string ( "Name" ) : catalog_to_string ( cat );
-    string filepath ( _rootpath + "index/" + catname + ".csv" );
-    ofstream file ( filepath, ios::trunc );
-    if ( ! file )
-        return n;
+    if ( n == 3 && cap.cosRadius >= 0.0 )
+        return kInside;
     
-    // Write name map if catalog is not specified; otherwise write identifier map.
+    if ( n == 0 && cap.cosRadius <= 0.0 )
+        return kOutside;
     
-    if ( cat == kCatUnknown )
-    {
-        NameMap &nameMap = _nameIndex[cat];
-        for ( auto it = nameMap.begin(); it != nameMap.end(); it++ )
-        {
-            string name = it->first;
-            ObjectLoc loc = it->second;
-            string htmIDstr = ID2name ( loc.region );
-            file << name << "," << htmIDstr << "," << to_string ( loc.offset ) << endl;
-            n++;
-        }
-    }
-    else
+    if ( disjoint ( t.center, t.radius, t.cosRadius, t.sinRadius, c, cap.radius, cap.cosRadius, cap.sinRadius ) )
+        return kOutside;
+    
+    if ( cap.cosRadius < 0.0 && disjoint ( t.center, t.radius, t.cosRadius, t.sinRadius, c * -1.0, SSAngle::kPi - cap.radius, -cap.cosRadius, cap.sinRadius ) )
+        return kInside;
+    
+    return kPartial;
+}
+
+// Classifies an HTM triangle (t) against a convex region: outside if outside any cap,
+// inside if inside all caps, otherwise partly inside.
+
+static SSHTMOverlap classifyConvex ( const HTMTriangle &t, const SSHTM::Convex &convex )
+{
+    SSHTMOverlap overlap = kInside;
+    
+    for ( const SSHTM::Cap &cap : convex )
     {
-        IdentMap &identMap = _identIndex[cat];
-        for ( auto it = identMap.begin(); it != identMap.end(); it++ )
-        {
-            SSIdentifier ident = it->first;
-            ObjectLoc loc = it->second;
-            string identstr = ident.toString();
-            string htmIDstr = ID2name ( loc.region );
-            file << identstr << "," << htmIDstr << "," << to_string ( loc.offset ) << endl;
-            n++;
-        }
+        SSHTMOverlap o = classifyCap ( t, cap );
+        if ( o == kOutside )
+            return kOutside;
+        if ( o == kPartial )
+            overlap = kPartial;
     }
     
-    return n;
+    return overlap;
 }
 
-// Loads an object map for the specified catalog (cat) into this HTM's object indexes.
-// Writes objects with user-definded function (saveFunc) and data (userData);
-// if these are nullptr, reads map in CSV format from HTM's "index" subdirectory.
-// Returns number of map entries read from file.
+// Searches an HTM region and all of its sub-regions for objects within a circle centered on the
+// celestial sphere at unit direction vector (center) in the fundamental frame, of (radius) radians.
+// Only searches regions pre-loaded into memory; does not load regions. Results are appended to
+// vector (results). Returns number of objects found within circle.
 
-size_t SSHTM::loadObjectMap ( SSCatalog cat, IdentMapFunc loadFunc, void *userData )
+int SSHTM::search ( uint64_t htmID, SSVector center, SSAngle rad, vector<SSObjectPtr> &results )
 {
-    int n = 0;
-    NameMap nameMap;
-    IdentMap identMap;
+    return search ( Convex ( { makeCap ( center, rad ) } ), results, htmID );
+}
 
-    if ( loadFunc != nullptr && cat != kCatUnknown )
+// Searches an HTM region (htmID) and all of its sub-regions for objects whose fundamental positions
+// are inside a convex region (convex). Only searches regions pre-loaded into memory; does not load
+// regions. Walks the mesh with an explicit stack, using precomputed triangle geometry. Regions outside
+// the convex are skipped with their sub-regions; objects in regions entirely inside the convex are
+// returned without testing them. Results are appended to vector (results) in the same order as a
+// recursive search: each region's objects before its sub-regions'. Returns number of objects found.
+
+int SSHTM::search ( const Convex &convex, vector<SSObjectPtr> &results, uint64_t htmID )
+{
+    struct Entry
     {
-        n = loadFunc ( this, cat, &identMap, userData );
+        uint64_t     htmID;     // region ID
+        int          level;     // region level
+        SSHTMOverlap overlap;   // how region relates to convex
+    };
+    
+    int level = htmID == 0 ? 0 : triangleLevel ( htmID );
+    SSHTMOverlap overlap = convex.empty() ? kInside : kPartial;
+    HTMTriangle temp;
+    
+    if ( htmID > 0 )
+    {
+        if ( level == 0 )
+            return 0;
+        
+        overlap = classifyConvex ( getTriangle ( htmID, level, temp ), convex );
+        if ( overlap == kOutside )
+            return 0;
     }
-    else
+    
+    int n = 0, depth = (int) _magLevels.size() - 1;
+    vector<Entry> stack = { { htmID, level, overlap } };
+    
+    while ( ! stack.empty() )
     {
-        // Open file; return on failure.
-
-        string catname = cat == kCatUnknown ? string ( "Name" ) : catalog_to_string ( cat );
-        string filepath ( _rootpath + "index/" + catname + ".csv" );
-        FILE *file = fopen ( filepath.c_str(), "rb" );
-        if ( ! file )
-            return n;
-
-        // Read file line-by-line until we reach end-of-file
-
-        string line = "";
-        while ( fgetline ( file, line ) )
+        Entry entry = stack.back();
+        stack.pop_back();
+        
+        SSObjectVec *pObjects = _getObjects ( entry.htmID, false );
+        if ( pObjects != nullptr )
         {
-            vector<string> fields = split_csv ( line );
-            if ( fields.size() < 3 )
-                continue;
-
-            // Read name map if catalog is not specified; otherwise read identifier map.
-            
-            if ( cat == kCatUnknown )
+            for ( size_t i = 0; i < pObjects->size(); i++ )
             {
-                string name = fields[0];
-                if ( ! name.empty() )
-                {
-                    uint64_t htmID = name2ID ( fields[1] );
-                    size_t offset = strtoint64 ( fields[2] );
-                    nameMap.insert ( { name, { htmID, offset } } );
-                    n++;
-                }
-            }
-            else
-            {
-                SSIdentifier ident = SSIdentifier::fromString ( fields[0], kTypeNonexistent, true );
-                if ( ident != 0 )
+                // Skip the dynamic cast for objects whose type guarantees they are stars.
+                
+                SSObjectPtr pObj = pObjects->get ( i );
+                SSObjectType type = pObj ? pObj->getType() : kTypeNonexistent;
+                SSStar *pStar = type >= kTypeStar && type <= kTypeGalaxy ? static_cast<SSStar *> ( pObj ) : SSGetStarPtr ( pObj );
+                if ( pStar && ( entry.overlap == kInside || inConvex ( convex, pStar->getFundamentalPosition() ) ) )
                 {
-                    uint64_t htmID = name2ID ( fields[1] );
-                    size_t offset = strtoint64 ( fields[2] );
-                    identMap.insert ( { ident, { htmID, offset } } );
+                    results.push_back ( pObj );
                     n++;
                 }
             }
         }
         
-        fclose ( file );
+        if ( entry.level >= depth )
+            continue;
+        
+        // Push sub-regions in reverse order, so they come off the stack in order.
+        // Sub-regions of a region inside the convex are inside it, too.
+        
+        uint64_t firstID = entry.htmID == 0 ? 8 : entry.htmID * 4;
+        uint64_t lastID = entry.htmID == 0 ? 15 : firstID + 3;
+        
+        for ( uint64_t subID = lastID; subID >= firstID; subID-- )
+        {
+            SSHTMOverlap o = kInside;
+            if ( entry.overlap != kInside )
+                o = classifyConvex ( getTriangle ( subID, entry.level + 1, temp ), convex );
+            
+            if ( o != kOutside )
+                stack.push_back ( { subID, entry.level + 1, o } );
+        }
     }
     
-    // If we read anything, save the name map or ident map we just read.
-    
-    if ( n > 0 )
-    {
-        if ( cat == kCatUnknown )
-            _nameIndex[cat] = nameMap;
-        else
-            _identIndex[cat] = identMap;
-    }
-
     return n;
 }
 
-// Given an identifier, uses this HTM's identifier index to find all objects matching
-// the identifier. Object locations are appended to the vector (results).
-// Returns number of object locations found.
+// Appends a half-open range of HTM IDs from start to end to a sorted list of ranges,
+// merging it with the last range in the list if they are adjacent.
 
-int SSHTM::findObjectLocs ( SSIdentifier ident, vector<SSHTM::ObjectLoc> &results )
+static void appendRange ( vector<SSHTM::IDRange> &ranges, uint64_t start, uint64_t end )
 {
-    SSCatalog cat = ident.catalog();
-    if ( objectMapSize ( cat ) == 0 )
-        return 0;
-    
-    IdentMap &map = _identIndex[cat];
-    auto it0 = map.lower_bound ( ident );
-    auto it1 = map.upper_bound ( ident );
-    
-    int n = (int) results.size();
-    for ( auto it = it0; it != it1; it++ )
-        results.push_back ( it->second );
-    return (int) results.size() - n;
+    if ( ! ranges.empty() && ranges.back().second == start )
+        ranges.back().second = end;
+    else
+        ranges.push_back ( { start, end } );
 }
 
-// Given a name string (name), uses this HTM's name index to find all objects matching the name string.
-// Pass true for (casesens) for Case-Sensitive string matching; pass false for case-insensitive matching.
-// Pass true for (begins) for "begins-with" string matching; pass false for whole-string matching.
-// Object locations are appended to the vector (results); returns number of object locations found.
+// Finds the HTM triangles at a given level (level) which cover a convex region (convex), and returns
+// their IDs as a sorted list of half-open ranges [first, second) in (ranges), with adjacent ranges merged.
+// Every point inside the convex has an ID at that level, from vector2ID ( p, level - 1 ), in one of the
+// ranges; triangles which only partly overlap the convex are included. Levels count from 1 at the HTM
+// root triangles, like IDlevel(), up to kMaxCoverLevel. An empty convex covers the whole sky.
+// Returns the number of ranges, or zero if the level is invalid or the convex is empty of points.
 
-int SSHTM::findObjectLocs ( const string &name, vector<SSHTM::ObjectLoc> &results, bool casesens, bool begins )
+int SSHTM::coverRanges ( const Convex &convex, int level, vector<IDRange> &ranges )
 {
-    if ( objectMapSize ( kCatUnknown ) == 0 )
+    ranges.clear();
+    if ( level < 1 || level > kMaxCoverLevel )
         return 0;
     
-    NameMap &map = _nameIndex[kCatUnknown];
-    int n = (int) results.size();
+    // Walk the mesh in ID order, so ranges come out sorted. Triangles entirely inside the convex,
+    // or partly inside it at the target level, contribute all their descendants at the target level.
     
-    if ( casesens == true && begins == false )
-    {
-        auto it0 = map.lower_bound ( name );
-        auto it1 = map.upper_bound ( name );
-        for ( auto it = it0; it != it1; it++ )
-            results.push_back ( it->second );
-    }
-    else
+    vector<pair<uint64_t,int>> stack;
+    for ( uint64_t id = 15; id >= 8; id-- )
+        stack.push_back ( { id, 1 } );
+    
+    HTMTriangle temp;
+    while ( ! stack.empty() )
     {
-        // We have to brute-force-search the name map for entries matching the name string.
-        // But since the map only contains a few hundred entries, this should still be fast.
+        uint64_t id = stack.back().first;
+        int l = stack.back().second;
+        stack.pop_back();
         
-        auto it0 = map.begin();
-        auto it1 = map.end();
-        for ( auto it = it0; it != it1; it++ )
-            if ( compare ( it->first, name, begins ? name.length() : 0, casesens ) == 0 )
-                results.push_back ( it->second );
+        SSHTMOverlap overlap = classifyConvex ( getTriangle ( id, l, temp ), convex );
+        if ( overlap == kOutside )
+            continue;
+        
+        if ( overlap == kInside || l == level )
+        {
+            int shift = 2 * ( level - l );
+            appendRange ( ranges, id << shift, ( id + 1 ) << shift );
+            continue;
+        }
+        
+        for ( uint64_t subID = id * 4 + 3; subID >= id * 4; subID-- )
+            stack.push_back ( { subID, l + 1 } );
     }
     
-    return (int) results.size() - n;
-}
-
-// Given an object location in this HTM, synchronously loads the region containing the object
-// (if not already loaded) and returns a pointer to the object, or nullptr on failure.
-
-SSObjectPtr SSHTM::loadObject ( const ObjectLoc &loc )
-{
-    SSObjectVec *pObjects = loadRegion ( loc.region, true );
-    if ( pObjects )
-        return pObjects->get ( loc.offset );
-    
-    return nullptr;
+    return (int) ranges.size();
 }
 
-// Searches an HTM region and all of its sub-regions, recursively, for objects within a circle
-// centered on the celestial sphere at unit direction vector (center) in the fundamental frame,
-// of (radius) radians. Only searches regions pre-loaded into memory; does not load regions.
-// Results are appended to vector (results). Returns number of objects found within circle.
+// Finds the HTM triangles at a given level (level) which intersect the bounding rectangle of a field of
+// view (view), and returns their IDs as a sorted list of half-open ranges in (ranges), like the function
+// above. Gnomonic views are converted to convex polygons, since their edges are great circles; in other
+// projections, triangles are tested against the view's projected rectangle. Returns number of ranges.
 
-int SSHTM::search ( uint64_t htmID, SSVector center, SSAngle rad, vector<SSObjectPtr> &results )
+int SSHTM::coverRanges ( SSView &view, int level, vector<IDRange> &ranges )
 {
-    // Unless this is the root region, get region center and angular radius. Always search root!
-    // If non-root region's bounding circle does not intersect search circle, don't search it.
-    
-    if ( htmID > 0 )
+    if ( view.getProjection() == kGnomonic )
     {
-        SSVector v0, v1, v2;
-        name2Triangle ( ID2name ( htmID ), v0, v1, v2 );
-        SSVector vC = ( v0 + v1 + v2 ) / 3.0;
-        SSAngle r = vC.angularSeparation ( v0 );
-        if ( center.angularSeparation ( vC ) > r + rad )
-            return 0;
+        vector<SSVector> corners =
+        {
+            view.unproject ( SSVector ( view.getLeft(), view.getTop(), 0.0 ) ),
+            view.unproject ( SSVector ( view.getRight(), view.getTop(), 0.0 ) ),
+            view.unproject ( SSVector ( view.getRight(), view.getBottom(), 0.0 ) ),
+            view.unproject ( SSVector ( view.getLeft(), view.getBottom(), 0.0 ) )
+        };
+        
+        return coverRanges ( makePolygon ( corners ), level, ranges );
     }
     
-    // Search this region's objects if they're loaded into memory.
-    // Then recursively search this region's sub-regions.
+    ranges.clear();
+    if ( level < 1 || level > kMaxCoverLevel )
+        return 0;
     
-    SSObjectVec *pObjects = getObjects ( htmID );
-    int n = pObjects ? pObjects->search ( center, rad, results ) : 0;
+    // Reject triangles outside the view's bounding circle before testing them against the view.
+    // Azimuthal projections show circles around the view center as circles, so triangles inside
+    // the circle inscribed in the view rectangle are inside the view.
     
-    vector<uint64_t> subIDs = subRegionIDs ( htmID );
-    for ( int i = 0; i < subIDs.size(); i++ )
-       n += search ( subIDs[i], center, rad, results );
+    SSProjection proj = view.getProjection();
+    Cap bound = makeCap ( view.getCenterVector(), view.getAngularDiagonal() / 2.0 );
+    Cap inner = makeCap ( view.getCenterVector(), proj == kOrthographic || proj == kStereographic ? min ( view.getAngularWidth(), view.getAngularHeight() ) / 2.0 : 0.0 );
+    vector<pair<uint64_t,int>> stack;
+    for ( uint64_t id = 15; id >= 8; id-- )
+        stack.push_back ( { id, 1 } );
+    
+    HTMTriangle temp;
+    while ( ! stack.empty() )
+    {
+        uint64_t id = stack.back().first;
+        int l = stack.back().second;
+        stack.pop_back();
+        
+        const HTMTriangle &t = getTriangle ( id, l, temp );
+        if ( classifyCap ( t, bound ) == kOutside )
+            continue;
+        
+        bool inside = inner.radius > 0.0 && classifyCap ( t, inner ) == kInside;
+        if ( ! inside && ! triangleInView ( view, t.v0, t.v1, t.v2 ) )
+            continue;
+        
+        if ( inside || l == level )
+        {
+            int shift = 2 * ( level - l );
+            appendRange ( ranges, id << shift, ( id + 1 ) << shift );
+            continue;
+        }
+        
+        for ( uint64_t subID = id * 4 + 3; subID >= id * 4; subID-- )
+            stack.push_back ( { subID, l + 1 } );
+    }
+    
+    return (int) ranges.size();
+}
 
-    return n;
+// Tests whether an HTM ID (id) is inside any range in a sorted list of ranges (ranges)
+// from coverRanges(), using a binary search.
+
+bool SSHTM::inRanges ( const vector<IDRange> &ranges, uint64_t id )
+{
+    auto it = upper_bound ( ranges.begin(), ranges.end(), id, [] ( uint64_t id, const IDRange &range ) { return id < range.second; } );
+    return it != ranges.end() && id >= it->first;
 }
@@ -19,9 +19,17 @@
 #include <thread>
 #endif
 
+#include <list>
+#include <deque>
+#include <set>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+
 #include "SSObject.hpp"
 #include "SSStar.hpp"
 #include "SSVector.hpp"
+#include "SSView.hpp"
 
 // No, not Hypertext Markup Language!
 // This class implements the Heirarchial Triangle Mesh, a method for subdividing the celestial sphere
@@ -32,7 +40,16 @@
 // with HTM ID numbers 8, 9, 10, 11, 12, 13, 14, 15. Each of those has four childred at level 2,
 // named S00, S01, S02, S02, etc. with HTM ID numbers 32, 33, 34, 35 etc., and so on down the mesh tree.
 // This class also contains methods for loading, saving, and storing objects in the regions to files.
-// Regions can be loaded synchronously on the current thread, or asynchronously on a background thread.
+// Regions can be loaded synchronously on the current thread, or asynchronously by a fixed pool of
+// background threads. Loaded regions form a cache with an optional memory budget: when the budget
+// is exceeded, the least recently used regions are dumped from memory. Regions created by store()
+// cannot be reloaded from files, so they are never dumped to meet the budget.
+// Regions are only dumped by calls made from the thread which owns the HTM (loadRegion(),
+// trimRegions(), dumpRegion(), etc.), never by background threads, so object vector pointers
+// obtained from the HTM remain valid until that thread's next such call. Background threads
+// stop loading while the budget is exceeded, until the owning thread dumps regions.
+// prefetchRegions() queues the regions visible in a view, nearest the view center first,
+// ahead of older requests, plus regions the view is moving toward as it pans.
 
 // Callback function to notify external HTM user when regions are loaded asynchronously.
 
@@ -43,24 +60,96 @@ public:
     typedef int (* DataFileFunc) ( SSHTM *pHTM, uint64_t htmID, SSObjectArray *objects, void *userData );
     typedef bool (* RegionTestCallback) ( SSHTM *pHTM, uint64_t htmID, void *userData );
     
+    static constexpr int kDefaultLoadThreads = 2;       // default number of background region loading threads
+    static constexpr double kDefaultLookahead = 1.0;    // default time to predict view motion ahead for prefetching, in seconds
+
 protected:
+
+    // Loading state of an HTM region
+
+    enum RegionState
+    {
+        kQueued = 0,        // waiting for a background thread to load it
+        kLoading = 1,       // currently being loaded
+        kLoaded = 2,        // objects loaded into memory
+        kMissing = 3,       // region data file is missing or empty
+    };
+
+    // An HTM region in the cache
+
+    struct Region
+    {
+        RegionState     state;          // loading state
+        SSObjectVec     *pObjects;      // loaded objects, or nullptr if not loaded
+        size_t          bytes;          // estimated memory used by loaded objects
+        bool            stored;         // true if created by store(); never evicted
+        list<uint64_t>::iterator lru;   // position in least-recently-used list, if loaded from file
+    };
+
+    // A request to load a region on a background thread
+
+    struct LoadRequest
+    {
+        uint64_t            htmID;      // ID of region to load
+        RegionLoadCallback  callback;   // function to call when done
+        void                *userData;  // user data passed to data file read function
+        bool                prefetch;   // true if queued by prefetchRegions(); cancelled when no longer needed
+    };
+
     DataFileFunc                _readFunc = nullptr;    // custom function for reading region data files
     DataFileFunc                _writeFunc = nullptr;   // custom function for writing region data files
-    map<uint64_t,SSObjectVec *> _regions;               // arrays of objects loaded into memory, indexed by HTM region ID
+    map<uint64_t,Region>        _regions;               // regions loaded, loading, or queued for loading, indexed by HTM region ID
+    list<uint64_t>              _lru;                   // IDs of regions loaded from files, least recently used first
     vector<float>               _magLevels;             // faintest magnitude of objects at each HTM level; vector size is depth of mesh tree
     string                      _rootpath;              // directory containing object data files on filesystem.
-    
+
+    size_t  _maxObjects = 0;                            // memory budget in objects; zero if unlimited
+    size_t  _maxBytes = 0;                              // memory budget in bytes; zero if unlimited
+    size_t  _numObjects = 0;                            // number of objects in regions loaded from files
+    size_t  _numBytes = 0;                              // estimated bytes used by regions loaded from files
+    size_t  _hits = 0, _misses = 0, _evictions = 0;     // cache statistics
+    atomic<bool> _useArenas { false };                  // if true, each region loaded from a file allocates its objects from its own arena
+
+    SSVector _panCenter;                                // view center unit vector at last call to prefetchRegions()
+    SSVector _panVelocity;                              // rate of change of view center unit vector per second
+    double   _panTime = -INFINITY;                      // time of last call to prefetchRegions() in seconds
+
+    mutex                       _mutex;                 // guards all region data above
+    condition_variable          _loadedCond;            // signals that a region has finished loading
+
 #if USE_THREADS
-    map<uint64_t,thread *>      _loadThreads;           // background threads currently loading region objects from data files, indexed by HTM region ID
+    int                         _numThreads = kDefaultLoadThreads; // number of background loading threads
+    vector<thread>              _loadThreads;           // background threads which load regions
+    deque<LoadRequest>          _loadQueue;             // regions waiting to be loaded in the background
+    condition_variable          _queueCond;             // signals background threads that requests are queued
+    bool                        _quit = false;          // tells background threads to exit
+
+    void _startLoadThreads ( void );
+    void _stopLoadThreads ( bool discard );
+    void _loadThreadLoop ( void );
+    int _queueRegions ( const vector<uint64_t> &htmIDs, void *userData );
 #endif
+
+    int _storeLevel ( SSStar *pStar );
+    void _store ( SSStar *pStar, uint64_t htmID );
     SSObjectVec *_loadRegion ( uint64_t htmID, RegionLoadCallback callback, void *userData );    // private method to load object data file for a given HTM region ID
-    
+    SSObjectVec *_getObjects ( uint64_t htmID, bool touch );
+    void _waitForLoad ( unique_lock<mutex> &lock, uint64_t htmID );
+    void _waitForLoads ( unique_lock<mutex> &lock );
+    void _evictRegion ( uint64_t htmID );
+    int _trimRegions ( void );
+    bool _overBudget ( void );
+    void _findRegions ( uint64_t htmID, int depth, SSView *pView, SSVector center, SSAngle rad, vector<pair<double,uint64_t>> &found );
+    static size_t estimateBytes ( SSObjectVec *pObjects );
+
 public:
     
     // constructors and destructor
     
     SSHTM();
     SSHTM ( const vector<float> &magLevels, const string &rootpath );
+    SSHTM ( SSHTM &&other );
+    SSHTM &operator = ( SSHTM &&other );
     virtual ~SSHTM ( void );
     
     // return path to directory containing region data files
@@ -80,7 +169,7 @@ public:
  
     // Count number of regions and objects in HTM or in a region therein.
     
-    int countRegions ( void ) { return (int) _regions.size(); }
+    int countRegions ( void );
     int countStars ( void );
     int countStars ( uint64_t htmID );
     
@@ -99,6 +188,24 @@ public:
     bool regionLoaded ( uint64_t id );
     SSObjectVec *getObjects ( uint64_t id );
     
+    // region cache memory budget, background loading threads, per-region object arenas, and statistics
+
+    void setMemoryBudget ( size_t maxObjects, size_t maxBytes );
+    void getMemoryBudget ( size_t &maxObjects, size_t &maxBytes );
+    void getMemoryUsed ( size_t &numObjects, size_t &numBytes );
+    int trimRegions ( void );
+    void setLoadThreads ( int n );
+    int getLoadThreads ( void );
+    void setUseArenas ( bool use ) { _useArenas = use; }
+    bool getUseArenas ( void ) { return _useArenas; }
+    void getStatistics ( size_t &hits, size_t &misses, size_t &evictions );
+    void resetStatistics ( void );
+
+    // find regions intersecting a field of view; load them in advance of rendering, as the view moves
+
+    int viewRegions ( SSView &view, float limMag, vector<uint64_t> &htmIDs );
+    int prefetchRegions ( SSView &view, float limMag, double time, double lookahead = kDefaultLookahead, void *userData = nullptr );
+    
     // Get child HTM region IDs of a particular region; gets empty vector if region has no children.
     
     virtual vector<uint64_t> subRegionIDs ( uint64_t id );
@@ -106,12 +213,17 @@ public:
     // wrappers around functions in original Johns Hopkins C HTM implementation, cc_aux.c
     
     virtual uint64_t vector2ID ( const SSVector &vector, int depth );
+    static void vector2IDs ( const double *x, const double *y, const double *z, size_t n, int depth, uint64_t *ids, int nthreads = 0 );
     virtual uint64_t name2ID ( const string &name );
     virtual int IDlevel ( uint64_t id );
     virtual string ID2name ( uint64_t id );
     virtual bool name2Triangle ( const string &name, SSVector &v0, SSVector &v1, SSVector &v2 );
     virtual bool isinside ( const SSVector &p, const SSVector &v0, SSVector &v1, SSVector &v2 );
     
+    // computes triangle vertices directly from HTM ID, without converting ID to name string
+    
+    static bool ID2Triangle ( uint64_t id, SSVector &v0, SSVector &v1, SSVector &v2 );
+    
     // Describes the location of particular object inside an HTM
     
     struct ObjectLoc
@@ -123,8 +235,139 @@ public:
     typedef multimap<string,ObjectLoc>       NameMap;
     typedef multimap<SSIdentifier,ObjectLoc> IdentMap;
     
-    map<SSCatalog,NameMap>  _nameIndex;
-    map<SSCatalog,IdentMap> _identIndex;
+    // Sorted array of object names, keyed by normalized name: case-folded, with leading and
+    // trailing whitespace removed, and interior runs of whitespace collapsed to a single space.
+    // Finds exact and "begins-with" name matches by binary search in O(log n + k) time.
+    // Built in memory from a name map, or memory-mapped from a binary file written by save(),
+    // which contains a header, an array of entries sorted by key, and a table of NUL-terminated
+    // strings which the entries refer to by offset. Multi-byte values are in native byte order.
+    
+    class NameIndex
+    {
+    public:
+        
+        static constexpr uint32_t kVersion = 1;     // current file format version
+        
+        // File header: always the first 32 bytes of the file.
+        
+        struct Header
+        {
+            char     magic[8];          // "SSHTMNAM"
+            uint32_t version;           // file format version; currently kVersion
+            uint32_t entrySize;         // size of each entry in bytes
+            uint64_t numEntries;        // number of entries, which follow header
+            uint64_t stringsSize;       // size of string table in bytes, which follows entries
+        };
+        
+        // Index entry.
+        
+        struct Entry
+        {
+            uint32_t key;               // string table offset of normalized name
+            uint32_t name;              // string table offset of original name
+            uint64_t region;            // HTM ID of region containing object
+            uint64_t offset;            // position of object within region's object vector
+        };
+        
+    protected:
+        
+        vector<Entry>   _entries;       // entries and strings built in memory; empty if memory-mapped
+        vector<char>    _strings;
+        const char      *_pData;        // pointer to start of memory-mapped file, or nullptr if none
+        size_t          _size;          // size of memory-mapped file in bytes
+        const Entry     *_pEntries;     // pointers to entry and string tables, in memory or memory-mapped file
+        const char      *_pStrings;
+        size_t          _numEntries;    // number of entries
+        
+        size_t _lowerBound ( const string &key );
+        
+    public:
+        
+        NameIndex ( void );
+        NameIndex ( NameIndex &&other );
+        NameIndex &operator = ( NameIndex &&other );
+        ~NameIndex ( void );
+        
+        void build ( const NameMap &nameMap );
+        bool open ( const string &path );
+        bool save ( const string &path );
+        void clear ( void );
+        
+        size_t size ( void ) { return _numEntries; }
+        const char *getName ( size_t i ) { return _pStrings + _pEntries[i].name; }
+        ObjectLoc getLoc ( size_t i ) { return { _pEntries[i].region, (size_t) _pEntries[i].offset }; }
+        
+        int find ( const string &name, vector<ObjectLoc> &results, bool casesens, bool begins );
+        int complete ( const string &prefix, vector<string> &names, size_t maxNames );
+        
+        static string normalize ( const string &name, bool trim = true );
+    };
+    
+    // Sorted array of catalog identifiers with object locations, for one catalog.
+    // Finds identifiers by binary search in O(log n) time. Built in memory from an identifier map,
+    // or memory-mapped from a binary file written by save(), which contains a header followed by
+    // an array of entries sorted by identifier. Multi-byte values are in native byte order.
+    
+    class IdentIndex
+    {
+    public:
+        
+        static constexpr uint32_t kVersion = 1;     // current file format version
+        
+        // File header: always the first 32 bytes of the file.
+        
+        struct Header
+        {
+            char     magic[8];          // "SSHTMIDX"
+            uint32_t version;           // file format version; currently kVersion
+            uint32_t entrySize;         // size of each entry in bytes
+            uint64_t numEntries;        // number of entries, which follow header
+            uint32_t catalog;           // catalog (SSCatalog) of identifiers in file
+            uint32_t reserved;          // reserved for future use; zero
+        };
+        
+        // Index entry.
+        
+        struct Entry
+        {
+            uint64_t ident;             // catalog identifier encoded as unsigned 64-bit integer (SSIdentifier)
+            uint64_t region;            // HTM ID of region containing object
+            uint32_t offset;            // position of object within region's object vector
+            uint32_t reserved;          // reserved for future use; zero
+        };
+        
+    protected:
+        
+        vector<Entry>   _entries;       // entries built in memory; empty if memory-mapped
+        const char      *_pData;        // pointer to start of memory-mapped file, or nullptr if none
+        size_t          _size;          // size of memory-mapped file in bytes
+        const Entry     *_pEntries;     // pointer to entry table, in memory or memory-mapped file
+        size_t          _numEntries;    // number of entries
+        
+    public:
+        
+        IdentIndex ( void );
+        IdentIndex ( IdentIndex &&other );
+        IdentIndex &operator = ( IdentIndex &&other );
+        ~IdentIndex ( void );
+        
+        void build ( const IdentMap &identMap );
+        bool open ( const string &path, SSCatalog cat );
+        bool save ( const string &path, SSCatalog cat );
+        void clear ( void );
+        
+        size_t size ( void ) { return _numEntries; }
+        SSIdentifier getIdent ( size_t i ) { return SSIdentifier ( _pEntries[i].ident ); }
+        ObjectLoc getLoc ( size_t i ) { return { _pEntries[i].region, (size_t) _pEntries[i].offset }; }
+        
+        int find ( SSIdentifier ident, vector<ObjectLoc> &results );
+        void toMap ( IdentMap &identMap );
+    };
+    
+    map<SSCatalog,NameMap>    _nameIndex;
+    map<SSCatalog,IdentMap>   _identIndex;
+    NameIndex                 _nameSearch;    // normalized name index for case-insensitive and begins-with searches
+    map<SSCatalog,IdentIndex> _identSearch;   // sorted identifier indexes, possibly memory-mapped from binary files
 
     typedef int (* IdentMapFunc) ( SSHTM *pHTM, SSCatalog cat, IdentMap *pMap, void *userData );
 
@@ -134,9 +377,11 @@ public:
     size_t makeObjectMap ( SSCatalog cat );
     size_t makeObjectMap ( SSCatalog cat, uint64_t regionID, NameMap &nameMap, IdentMap &identMap );
     
-    size_t objectMapSize ( SSCatalog cat ) { return cat == kCatUnknown ? _nameIndex[cat].size() : _identIndex[cat].size(); }
+    size_t objectMapSize ( SSCatalog cat ) { return cat == kCatUnknown ? max ( _nameIndex[cat].size(), _nameSearch.size() ) : max ( _identIndex[cat].size(), _identSearch[cat].size() ); }
+    IdentMap &getIdentMap ( SSCatalog cat );
     
     int findObjectLocs ( const string &name, vector<ObjectLoc> &locs, bool casesens = true, bool begins = false );
+    int completeObjectNames ( const string &prefix, vector<string> &names, size_t maxNames = 0 );
     int findObjectLocs ( SSIdentifier ident, vector<ObjectLoc> &locs );
     
     SSObjectPtr loadObject ( const ObjectLoc &loc );
@@ -147,7 +392,38 @@ public:
     void setDataFileWriteFunc ( DataFileFunc func ) { _writeFunc = func; }
     DataFileFunc getDataFileWriteFunc ( void ) { return _writeFunc; }
 
+    // A circular cap on the celestial sphere: all unit vectors (p) where p * center > cosRadius.
+    // A convex region is the intersection of one or more caps; an empty convex is the whole sky.
+
+    struct Cap
+    {
+        SSVector center;        // unit vector to cap center
+        double   radius;        // angular radius in radians, from 0 to pi
+        double   cosRadius;     // cosine of angular radius
+        double   sinRadius;     // sine of angular radius
+    };
+
+    typedef vector<Cap> Convex;
+
+    static Cap makeCap ( SSVector center, SSAngle radius );
+    static Convex makePolygon ( const vector<SSVector> &vertices );
+    static bool inConvex ( const Convex &convex, SSVector p );
+
+    // Convert a convex region or field of view to a sorted list of half-open ranges of HTM IDs at one level
+    // which cover it; test whether an HTM ID is in a list of ranges.
+
+    typedef pair<uint64_t,uint64_t> IDRange;
+
+    static constexpr int kMaxCoverLevel = 30;       // deepest level whose ID ranges fit in 64 bits
+
+    static int coverRanges ( const Convex &convex, int level, vector<IDRange> &ranges );
+    static int coverRanges ( SSView &view, int level, vector<IDRange> &ranges );
+    static bool inRanges ( const vector<IDRange> &ranges, uint64_t id );
+
+    // search loaded regions for objects inside a circle or convex region
+    
     int search ( uint64_t htmID, SSVector center, SSAngle rad, vector<SSObjectPtr> &results );
+    int search ( const Convex &convex, vector<SSObjectPtr> &results, uint64_t htmID = 0 );
 };
 
 // Callback function to notify external HTM user when regions are loaded asynchronously.
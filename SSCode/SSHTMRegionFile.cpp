@@ -0,0 +1,429 @@
+// SSHTMRegionFile.cpp
+// SSCore
+//
+// Created by Tim DeBenedictis on 10/16/26.
+// Copyright © 2026 Southern Stars. All rights reserved.
+
+#include <stdio.h>
+#include <string.h>
+
+#include "SSHTMRegionFile.hpp"
+
+static const char kMagic[8] = { 'S', 'S', 'H', 'T', 'M', 'B', 'I', 'N' };
+
+static_assert ( sizeof ( SSHTMRegionFile::Header ) == 64, "SSHTMRegionFile::Header must be 64 bytes" );
+static_assert ( sizeof ( SSHTMRegionFile::Record ) == 144, "SSHTMRegionFile::Record must be 144 bytes" );
+static_assert ( sizeof ( SSOrbit ) == 12 * sizeof ( double ), "SSOrbit must contain only 12 doubles" );
+
+// Constructs a region file object which is not yet open.
+
+SSHTMRegionFile::SSHTMRegionFile ( void )
+{
+    _pData = nullptr;
+    _size = 0;
+    _pHeader = nullptr;
+    _pRecords = nullptr;
+    _pIdents = nullptr;
+    _pOrbits = nullptr;
+    _pStrings = nullptr;
+}
+
+// Destructor unmaps file, if open.
+
+SSHTMRegionFile::~SSHTMRegionFile ( void )
+{
+    close();
+}
+
+// Memory-maps a binary region file (path) and validates its header, table sizes, and record offsets.
+// Closes any file already open. Returns true if successful or false on failure.
+
+bool SSHTMRegionFile::open ( const string &path )
+{
+    close();
+
+    size_t size = 0;
+    const char *pData = (const char *) mapfile ( path, size );
+    if ( pData == nullptr )
+        return false;
+
+    const Header *pHeader = (const Header *) pData;
+    if ( size < sizeof ( Header ) || memcmp ( pHeader->magic, kMagic, sizeof ( kMagic ) ) != 0
+        || pHeader->version != kVersion || pHeader->recordSize != sizeof ( Record ) )
+    {
+        unmapfile ( pData, size );
+        return false;
+    }
+
+    uint64_t expected = sizeof ( Header ) + (uint64_t) pHeader->numRecords * sizeof ( Record )
+                      + (uint64_t) pHeader->numIdents * sizeof ( uint64_t )
+                      + (uint64_t) pHeader->numOrbits * sizeof ( SSOrbit ) + pHeader->stringsSize;
+
+    if ( expected != size || pHeader->stringsSize == 0 || pData[ size - 1 ] != 0 )
+    {
+        unmapfile ( pData, size );
+        return false;
+    }
+
+    const Record *pRecords = (const Record *) ( pData + sizeof ( Header ) );
+    const uint64_t *pIdents = (const uint64_t *) ( pRecords + pHeader->numRecords );
+    const SSOrbit *pOrbits = (const SSOrbit *) ( pIdents + pHeader->numIdents );
+    const char *pStrings = (const char *) ( pOrbits + pHeader->numOrbits );
+
+    // Reject files whose records refer to strings or identifiers outside their tables.
+    // The string table ends with a NUL, so every string which starts inside it also ends inside it.
+
+    for ( uint32_t i = 0; i < pHeader->numRecords; i++ )
+        if ( ! validRecord ( pRecords[i], pHeader, pStrings ) )
+        {
+            unmapfile ( pData, size );
+            return false;
+        }
+
+    _pData = pData;
+    _size = size;
+    _pHeader = pHeader;
+    _pRecords = pRecords;
+    _pIdents = pIdents;
+    _pOrbits = pOrbits;
+    _pStrings = pStrings;
+
+    return true;
+}
+
+// Returns true if all string offsets and identifier indexes in a star record (rec) lie within
+// the string table (pStrings) and identifier table described by a file header (pHeader).
+
+bool SSHTMRegionFile::validRecord ( const Record &rec, const Header *pHeader, const char *pStrings )
+{
+    uint32_t size = pHeader->stringsSize;
+    if ( rec.spectrum >= size || rec.comps >= size || rec.varType >= size )
+        return false;
+
+    if ( (uint64_t) rec.firstIdent + rec.numIdents > pHeader->numIdents )
+        return false;
+
+    uint32_t offset = rec.names;
+    for ( int n = 0; n < rec.numNames; n++ )
+    {
+        if ( offset >= size )
+            return false;
+        offset += (uint32_t) strlen ( pStrings + offset ) + 1;
+    }
+
+    return true;
+}
+
+// Unmaps file, if open.
+
+void SSHTMRegionFile::close ( void )
+{
+    if ( _pData != nullptr )
+        unmapfile ( _pData, _size );
+
+    _pData = nullptr;
+    _size = 0;
+    _pHeader = nullptr;
+    _pRecords = nullptr;
+    _pIdents = nullptr;
+    _pOrbits = nullptr;
+    _pStrings = nullptr;
+}
+
+// Returns the n-th name of the i-th star record, or empty string if n is out of range.
+
+string SSHTMRegionFile::getName ( size_t i, int n )
+{
+    const Record &rec = _pRecords[i];
+    if ( n < 0 || n >= rec.numNames )
+        return "";
+
+    const char *name = _pStrings + rec.names;
+    while ( n-- > 0 )
+        name += strlen ( name ) + 1;
+
+    return string ( name );
+}
+
+// Returns the n-th identifier of the i-th star record, or null identifier if n is out of range.
+
+SSIdentifier SSHTMRegionFile::getIdentifier ( size_t i, int n )
+{
+    const Record &rec = _pRecords[i];
+    if ( n < 0 || n >= rec.numIdents )
+        return SSIdentifier();
+
+    return SSIdentifier ( _pIdents[ rec.firstIdent + n ] );
+}
+
+// Allocates a new star object from the i-th star record, or nullptr if the record's type is not a star.
+
+SSObjectPtr SSHTMRegionFile::toObject ( size_t i )
+{
+    const Record &rec = _pRecords[i];
+    SSObjectPtr pObj = SSNewObject ( (SSObjectType) rec.type );
+    SSStarPtr pStar = SSGetStarPtr ( pObj );
+    if ( pStar == nullptr )
+    {
+        delete pObj;
+        return nullptr;
+    }
+
+    SSNames names;
+    const char *name = _pStrings + rec.names;
+    for ( int n = 0; n < rec.numNames; n++, name += strlen ( name ) + 1 )
+        names.push_back ( name );
+
+    SSIdentifiers idents;
+    idents.reserve ( rec.numIdents );
+    for ( int n = 0; n < rec.numIdents; n++ )
+        idents.push_back ( SSIdentifier ( _pIdents[ rec.firstIdent + n ] ) );
+
+    pStar->setNames ( names );
+    pStar->setIdentifiers ( idents );
+    pStar->setFundamentalPosition ( SSVector ( rec.position[0], rec.position[1], rec.position[2] ) );
+    pStar->setFundamentalVelocity ( SSVector ( rec.velocity[0], rec.velocity[1], rec.velocity[2] ) );
+    pStar->setParallax ( rec.parallax );
+    pStar->setRadVel ( rec.radvel );
+    pStar->setVMagnitude ( rec.Vmag );
+    pStar->setBMagnitude ( rec.Bmag );
+    pStar->setSpectralType ( _pStrings + rec.spectrum );
+
+    SSDoubleStarPtr pDouble = SSGetDoubleStarPtr ( pObj );
+    if ( pDouble != nullptr )
+    {
+        pDouble->setComponents ( _pStrings + rec.comps );
+        pDouble->setMagnitudeDelta ( rec.magDelta );
+        pDouble->setSeparation ( rec.sep );
+        pDouble->setPositionAngle ( rec.PA );
+        pDouble->setPositionAngleYear ( rec.PAyr );
+        if ( rec.orbit != kNoOrbit && rec.orbit < _pHeader->numOrbits )
+            pDouble->setOrbit ( _pOrbits[ rec.orbit ] );
+    }
+
+    SSVariableStarPtr pVariable = SSGetVariableStarPtr ( pObj );
+    if ( pVariable != nullptr )
+    {
+        pVariable->setVariableType ( _pStrings + rec.varType );
+        pVariable->setMaximumMagnitude ( rec.varMaxMag );
+        pVariable->setMinimumMagnitude ( rec.varMinMag );
+        pVariable->setPeriod ( rec.varPeriod );
+        pVariable->setEpoch ( rec.varEpoch );
+    }
+
+    SSDeepSkyPtr pDeepSky = SSGetDeepSkyPtr ( pObj );
+    if ( pDeepSky != nullptr )
+    {
+        pDeepSky->setMajorAxis ( rec.majAxis );
+        pDeepSky->setMinorAxis ( rec.minAxis );
+        pDeepSky->setPositionAngle ( rec.PA );
+    }
+
+    return pObj;
+}
+
+// Allocates star objects from all records in this file and appends them to an object array (objects).
+// Returns the number of objects appended.
+
+int SSHTMRegionFile::toObjects ( SSObjectVec &objects )
+{
+    SSObjectArena::Scope scope ( objects.getArena() );
+    int n = 0;
+
+    for ( size_t i = 0; i < size(); i++ )
+    {
+        SSObjectPtr pObj = toObject ( i );
+        if ( pObj != nullptr )
+        {
+            objects.append ( pObj );
+            n++;
+        }
+    }
+
+    return n;
+}
+
+// Writes all stars and deep sky objects in an array (objects) to a binary region file (path)
+// for an HTM region (htmID). Other objects are ignored. Overwrites any existing file.
+// Returns the number of star records written, or -1 on failure.
+
+int SSHTMRegionFile::write ( const string &path, uint64_t htmID, SSObjectVec &objects )
+{
+    Header header = { { 0 } };
+    vector<Record> records;
+    vector<uint64_t> idents;
+    vector<SSOrbit> orbits;
+    string strings ( 1, '\0' );
+    map<string,uint32_t> shared;
+
+    // Adds a string to the string table and returns its offset. Empty strings are all at offset zero.
+    // Spectral types, components, and variable types repeat often, so those are shared.
+
+    auto addString = [&] ( const string &str, bool share )
+    {
+        if ( str.empty() )
+            return (uint32_t) 0;
+
+        if ( share && shared.count ( str ) )
+            return shared[str];
+
+        uint32_t offset = (uint32_t) strings.size();
+        strings.append ( str.c_str(), str.length() + 1 );
+        if ( share )
+            shared[str] = offset;
+
+        return offset;
+    };
+
+    memcpy ( header.magic, kMagic, sizeof ( kMagic ) );
+    header.version = kVersion;
+    header.recordSize = sizeof ( Record );
+    header.htmID = htmID;
+    header.minMag = INFINITY;
+    header.maxMag = -INFINITY;
+
+    for ( size_t i = 0; i < objects.size(); i++ )
+    {
+        SSStarPtr pStar = SSGetStarPtr ( objects[i] );
+        if ( pStar == nullptr )
+            continue;
+
+        Record rec = { { 0.0 } };
+        SSVector pos = pStar->getFundamentalPosition();
+        SSVector vel = pStar->getFundamentalVelocity();
+
+        rec.position[0] = pos.x;
+        rec.position[1] = pos.y;
+        rec.position[2] = pos.z;
+        rec.velocity[0] = vel.x;
+        rec.velocity[1] = vel.y;
+        rec.velocity[2] = vel.z;
+        rec.parallax = pStar->getParallax();
+        rec.radvel = pStar->getRadVel();
+        rec.Vmag = pStar->getVMagnitude();
+        rec.Bmag = pStar->getBMagnitude();
+        rec.type = pStar->getType();
+
+        const SSNames &names = pStar->getNames();
+        rec.numNames = (uint8_t) min ( names.size(), (size_t) UINT8_MAX );
+        rec.names = rec.numNames > 0 ? (uint32_t) strings.size() : 0;
+        for ( int n = 0; n < rec.numNames; n++ )
+            strings.append ( names[n].c_str(), names[n].length() + 1 );
+
+        const SSIdentifiers &ids = pStar->getIdents();
+        rec.numIdents = (uint16_t) min ( ids.size(), (size_t) UINT16_MAX );
+        rec.firstIdent = (uint32_t) idents.size();
+        for ( int n = 0; n < rec.numIdents; n++ )
+            idents.push_back ( ids[n] );
+
+        rec.spectrum = addString ( pStar->getSpectralType(), true );
+        rec.orbit = kNoOrbit;
+        rec.magDelta = rec.sep = rec.PA = rec.PAyr = INFINITY;
+        rec.majAxis = rec.minAxis = INFINITY;
+        rec.varMaxMag = rec.varMinMag = INFINITY;
+        rec.varPeriod = rec.varEpoch = INFINITY;
+
+        SSDoubleStarPtr pDouble = SSGetDoubleStarPtr ( pStar );
+        if ( pDouble != nullptr )
+        {
+            rec.comps = addString ( pDouble->getComponents(), true );
+            rec.magDelta = pDouble->getMagnitudeDelta();
+            rec.sep = pDouble->getSeparation();
+            rec.PA = pDouble->getPositionAngle();
+            rec.PAyr = pDouble->getPositionAngleYear();
+            if ( pDouble->hasOrbit() )
+            {
+                rec.orbit = (uint32_t) orbits.size();
+                orbits.push_back ( pDouble->getOrbit() );
+            }
+        }
+
+        SSVariableStarPtr pVariable = SSGetVariableStarPtr ( pStar );
+        if ( pVariable != nullptr )
+        {
+            rec.varType = addString ( pVariable->getVariableType(), true );
+            rec.varMaxMag = pVariable->getMaximumMagnitude();
+            rec.varMinMag = pVariable->getMinimumMagnitude();
+            rec.varPeriod = pVariable->getPeriod();
+            rec.varEpoch = pVariable->getEpoch();
+        }
+
+        SSDeepSkyPtr pDeepSky = SSGetDeepSkyPtr ( pStar );
+        if ( pDeepSky != nullptr )
+        {
+            rec.majAxis = pDeepSky->getMajorAxis();
+            rec.minAxis = pDeepSky->getMinorAxis();
+            rec.PA = pDeepSky->getPositionAngle();
+        }
+
+        float mag = isinf ( rec.Vmag ) ? rec.Bmag : rec.Vmag;
+        if ( ! isinf ( mag ) )
+        {
+            header.minMag = min ( header.minMag, mag );
+            header.maxMag = max ( header.maxMag, mag );
+        }
+
+        records.push_back ( rec );
+    }
+
+    header.numRecords = (uint32_t) records.size();
+    header.numIdents = (uint32_t) idents.size();
+    header.numOrbits = (uint32_t) orbits.size();
+    header.stringsSize = (uint32_t) strings.size();
+
+    FILE *file = fopen ( path.c_str(), "wb" );
+    if ( file == nullptr )
+        return -1;
+
+    bool ok = fwrite ( &header, sizeof ( header ), 1, file ) == 1;
+    ok = ok && fwrite ( records.data(), sizeof ( Record ), records.size(), file ) == records.size();
+    ok = ok && fwrite ( idents.data(), sizeof ( uint64_t ), idents.size(), file ) == idents.size();
+    ok = ok && fwrite ( orbits.data(), sizeof ( SSOrbit ), orbits.size(), file ) == orbits.size();
+    ok = ok && fwrite ( strings.data(), 1, strings.size(), file ) == strings.size();
+    ok = fclose ( file ) == 0 && ok;
+
+    return ok ? (int) records.size() : -1;
+}
+
+// SSHTM data file read function: loads objects from the binary region file for an HTM region (htmID)
+// in the HTM's root directory, and appends them to an object array (pObjects).
+// Returns the number of objects loaded. userData is not used.
+
+int SSHTMRegionFile::readRegion ( SSHTM *pHTM, uint64_t htmID, SSObjectVec *pObjects, void *userData )
+{
+    SSHTMRegionFile file;
+    if ( ! file.open ( pHTM->rootPath() + pHTM->ID2name ( htmID ) + ".bin" ) )
+        return 0;
+
+    return file.toObjects ( *pObjects );
+}
+
+// SSHTM data file write function: saves objects in an array (pObjects) as the binary region file
+// for an HTM region (htmID) in the HTM's root directory. Returns the number of objects saved.
+// userData is not used.
+
+int SSHTMRegionFile::writeRegion ( SSHTM *pHTM, uint64_t htmID, SSObjectVec *pObjects, void *userData )
+{
+    return max ( 0, write ( pHTM->rootPath() + pHTM->ID2name ( htmID ) + ".bin", htmID, *pObjects ) );
+}
+
+// Converts the CSV region file for an HTM region (htmID) in the HTM's root directory to a binary
+// region file in the same directory, then recursively does the same for all of its sub-regions.
+// Regions without CSV files are skipped. Regions are loaded one at a time; does not modify the regions
+// already loaded into the HTM. Returns the number of region files converted.
+
+int SSHTMRegionFile::convertRegions ( SSHTM &htm, uint64_t htmID )
+{
+    int n = 0;
+    SSObjectVec objects;
+
+    if ( SSImportObjectsFromCSV ( htm.rootPath() + htm.ID2name ( htmID ) + ".csv", objects ) > 0 )
+        if ( writeRegion ( &htm, htmID, &objects, nullptr ) > 0 )
+            n++;
+
+    vector<uint64_t> subIDs = htm.subRegionIDs ( htmID );
+    for ( uint64_t subID : subIDs )
+        n += convertRegions ( htm, subID );
+
+    return n;
+}
@@ -0,0 +1,122 @@
+// SSHTMRegionFile.hpp
+// SSCore
+//
+// Created by Tim DeBenedictis on 10/16/26.
+// Copyright © 2026 Southern Stars. All rights reserved.
+//
+// Binary region data file format for SSHTM, as a faster alternative to CSV region files.
+// Each file contains a header, an array of fixed-size star records, a table of identifiers,
+// a table of double star orbits, and a table of NUL-terminated strings (names, spectral types,
+// etc.) which the records refer to by offset. Files are memory-mapped, so star positions and
+// magnitudes can be read directly from the records without any parsing or allocation.
+// Records can also be converted to SSStar objects for use with SSHTM's region arrays.
+// Multi-byte values are stored in native byte order; the header's magic string and record
+// size guard against reading files written with a different layout.
+
+#ifndef SSHTMRegionFile_hpp
+#define SSHTMRegionFile_hpp
+
+#include "SSHTM.hpp"
+
+class SSHTMRegionFile
+{
+public:
+
+    static constexpr uint32_t kVersion = 1;             // current file format version
+    static constexpr uint32_t kNoOrbit = 0xffffffff;    // orbit index of stars without orbits
+
+    // File header: always the first 64 bytes of the file.
+
+    struct Header
+    {
+        char     magic[8];          // "SSHTMBIN"
+        uint32_t version;           // file format version; currently kVersion
+        uint32_t recordSize;        // size of each star record in bytes
+        uint64_t htmID;             // HTM ID of region stored in file
+        uint32_t numRecords;        // number of star records, which follow header
+        uint32_t numIdents;         // number of identifiers, which follow star records
+        uint32_t numOrbits;         // number of orbits, which follow identifiers
+        uint32_t stringsSize;       // size of string table in bytes, which follows orbits
+        float    minMag;            // magnitude of brightest star in region; infinite if none
+        float    maxMag;            // magnitude of faintest star in region; -infinite if none
+        uint8_t  reserved[16];      // reserved for future use; zero
+    };
+
+    // Star record. Fields which don't apply to a star's type are infinite (or empty strings).
+
+    struct Record
+    {
+        double   position[3];       // heliocentric position unit vector in fundamental frame at epoch J2000
+        double   velocity[3];       // heliocentric space velocity in fundamental frame in distance units per Julian year; infinite if unknown
+        float    parallax;          // parallax in arcseconds; zero if unknown
+        float    radvel;            // radial velocity as fraction of light speed; infinite if unknown
+        float    Vmag;              // visual magnitude at J2000; infinite if unknown
+        float    Bmag;              // blue magnitude at J2000; infinite if unknown
+        uint8_t  type;              // object type code (SSObjectType)
+        uint8_t  numNames;          // number of names
+        uint16_t numIdents;         // number of identifiers
+        uint32_t firstIdent;        // index of first identifier in identifier table
+        uint32_t names;             // string table offset of first name; names are consecutive strings
+        uint32_t spectrum;          // string table offset of spectral type (or galaxy type for deep sky objects)
+        uint32_t comps;             // string table offset of double star components
+        uint32_t varType;           // string table offset of variable star type
+        uint32_t orbit;             // index of double star orbit in orbit table, or kNoOrbit
+        uint32_t reserved;          // reserved for future use; zero
+        float    magDelta;          // double star magnitude difference
+        float    sep;               // double star separation in radians
+        float    PA;                // double star position angle, or deep sky major axis position angle, in radians
+        float    PAyr;              // Julian year of double star position angle measurement
+        float    majAxis;           // deep sky object major axis in radians
+        float    minAxis;           // deep sky object minor axis in radians
+        float    varMaxMag;         // variable star maximum magnitude (when faintest)
+        float    varMinMag;         // variable star minimum magnitude (when brightest)
+        double   varPeriod;         // variable star period in days
+        double   varEpoch;          // variable star epoch as Julian Date
+    };
+
+protected:
+
+    const char     *_pData;         // pointer to start of memory-mapped file, or nullptr if not open
+    size_t          _size;          // size of memory-mapped file in bytes
+    const Header   *_pHeader;       // pointers to header and tables within memory-mapped file
+    const Record   *_pRecords;
+    const uint64_t *_pIdents;
+    const SSOrbit  *_pOrbits;
+    const char     *_pStrings;
+
+    static bool validRecord ( const Record &rec, const Header *pHeader, const char *pStrings );
+
+public:
+
+    SSHTMRegionFile ( void );
+    ~SSHTMRegionFile ( void );
+
+    bool open ( const string &path );
+    void close ( void );
+    bool isOpen ( void ) { return _pData != nullptr; }
+
+    uint64_t getHTMID ( void ) { return _pHeader ? _pHeader->htmID : 0; }
+    size_t size ( void ) { return _pHeader ? _pHeader->numRecords : 0; }
+    float getMinMagnitude ( void ) { return _pHeader ? _pHeader->minMag : INFINITY; }
+    float getMaxMagnitude ( void ) { return _pHeader ? _pHeader->maxMag : -INFINITY; }
+
+    const Record &getRecord ( size_t i ) { return _pRecords[i]; }
+    const char *getString ( uint32_t offset ) { return _pHeader && offset < _pHeader->stringsSize ? _pStrings + offset : ""; }
+    string getName ( size_t i, int n );
+    SSIdentifier getIdentifier ( size_t i, int n );
+
+    SSObjectPtr toObject ( size_t i );
+    int toObjects ( SSObjectVec &objects );
+
+    static int write ( const string &path, uint64_t htmID, SSObjectVec &objects );
+
+    // SSHTM data file functions which read and write binary region files named like CSV region files,
+    // but with a ".bin" extension; use with SSHTM::setDataFileReadFunc() and setDataFileWriteFunc().
+
+    static int readRegion ( SSHTM *pHTM, uint64_t htmID, SSObjectVec *pObjects, void *userData );
+    static int writeRegion ( SSHTM *pHTM, uint64_t htmID, SSObjectVec *pObjects, void *userData );
+
+    static int convertRegions ( SSHTM &htm, uint64_t htmID = 0 );
+};
+
+#endif /* SSHTMRegionFile_hpp */
@@ -0,0 +1,212 @@
+// SSHashMap.hpp
+// SSCore
+//
+// Created by Tim DeBenedictis on 10/16/26.
+// Copyright © 2026 Southern Stars. All rights reserved.
+//
+// An open-addressing hash map with 64-bit integer keys, such as SSIdentifiers and GAIA source IDs.
+// Catalog cross-matching builds maps of millions of identifiers, then looks up millions more;
+// std::map allocates a tree node for every entry and chases pointers through ~20 levels per lookup.
+// This map stores its entries in a single array, and finds most keys in the first slot it probes.
+// Its interface is the subset of std::map's which the importers use: find(), count(), insert(),
+// operator [], size(), clear(), and iteration; it also has reserve(). Entries can't be erased.
+// Unlike std::map, iteration order is unspecified, and inserting an entry may invalidate
+// iterators and references to other entries. As in std::map, entries' keys are const,
+// since changing a key in place would put its entry in the wrong slot.
+// The key type (K) must convert to uint64_t, and its default value must convert to zero.
+
+#ifndef SSHashMap_hpp
+#define SSHashMap_hpp
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <new>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+template <class K, class V> class SSHashMap
+{
+public:
+
+    typedef K key_type;
+    typedef V mapped_type;
+    typedef pair<const K,V> value_type;
+
+protected:
+
+    // Slots hold entries; a slot whose key is zero is empty. Linear probing, starting from the
+    // key's hashed slot, uses the first (capacity) slots. The last slot holds the entry whose key
+    // is zero, if any (_hasZero), so it can't be mistaken for an empty slot.
+
+    vector<value_type>  _slots;     // capacity + 1 slots; capacity is zero or a power of two
+    size_t              _size;      // number of entries
+    bool                _hasZero;   // true if map contains an entry whose key is zero
+
+    size_t capacity ( void ) const { return _slots.empty() ? 0 : _slots.size() - 1; }
+    bool occupied ( size_t i ) const { return i < capacity() ? (uint64_t) _slots[i].first != 0 : _hasZero; }
+
+    // Replaces the entry in a slot (i) with a new entry. Entries' keys are const, so they can't be
+    // assigned; the old entry is destroyed and the new one constructed in its place instead.
+
+    template <class E> void place ( size_t i, E &&entry )
+    {
+        _slots[i].~value_type();
+        new ( &_slots[i] ) value_type ( std::forward<E> ( entry ) );
+    }
+
+    // Mixes all bits of a key into its low bits, since identifiers in one catalog often differ only in a few bits.
+    // This is the finalizer of MurmurHash3.
+
+    static uint64_t hash ( uint64_t key )
+    {
+        key ^= key >> 33;
+        key *= 0xff51afd7ed558ccdULL;
+        key ^= key >> 33;
+        key *= 0xc4ceb9fe1a85ec53ULL;
+        key ^= key >> 33;
+        return key;
+    }
+
+    // Returns index of the slot which holds a key, or of the empty slot where it belongs.
+    // The map must have nonzero capacity.
+
+    size_t slot ( uint64_t key ) const
+    {
+        size_t mask = capacity() - 1;
+        if ( key == 0 )
+            return mask + 1;
+
+        for ( size_t i = hash ( key ) & mask; ; i = ( i + 1 ) & mask )
+        {
+            uint64_t k = _slots[i].first;
+            if ( k == key || k == 0 )
+                return i;
+        }
+    }
+
+    // Moves all entries into new storage with the given capacity (n), which must be a power of two
+    // more than twice the number of entries.
+
+    void rehash ( size_t n )
+    {
+        vector<value_type> slots ( n + 1 );
+        swap ( slots, _slots );
+
+        for ( size_t i = 0; i + 1 < slots.size(); i++ )
+            if ( (uint64_t) slots[i].first != 0 )
+                place ( slot ( slots[i].first ), std::move ( slots[i] ) );
+
+        if ( _hasZero )
+            place ( n, std::move ( slots.back() ) );
+    }
+
+    // Iterators visit occupied slots in index order.
+
+    template <class M, class T> class Iterator
+    {
+        M       *_pMap;     // map being iterated
+        size_t  _i;         // index of current slot
+
+    public:
+
+        Iterator ( M *pMap, size_t i ) : _pMap ( pMap ), _i ( i )
+        {
+            while ( _i < _pMap->_slots.size() && ! _pMap->occupied ( _i ) )
+                _i++;
+        }
+
+        T &operator * ( void ) const { return _pMap->_slots[_i]; }
+        T *operator -> ( void ) const { return &_pMap->_slots[_i]; }
+        Iterator &operator ++ ( void ) { *this = Iterator ( _pMap, _i + 1 ); return *this; }
+        bool operator == ( const Iterator &other ) const { return _i == other._i; }
+        bool operator != ( const Iterator &other ) const { return _i != other._i; }
+    };
+
+public:
+
+    typedef Iterator<SSHashMap, value_type> iterator;
+    typedef Iterator<const SSHashMap, const value_type> const_iterator;
+
+    SSHashMap ( void ) : _size ( 0 ), _hasZero ( false ) {}
+
+    size_t size ( void ) const { return _size; }
+    bool empty ( void ) const { return _size == 0; }
+
+    iterator begin ( void ) { return iterator ( this, 0 ); }
+    iterator end ( void ) { return iterator ( this, _slots.size() ); }
+    const_iterator begin ( void ) const { return const_iterator ( this, 0 ); }
+    const_iterator end ( void ) const { return const_iterator ( this, _slots.size() ); }
+
+    // Removes all entries and frees their storage.
+
+    void clear ( void )
+    {
+        _slots.clear();
+        _slots.shrink_to_fit();
+        _size = 0;
+        _hasZero = false;
+    }
+
+    // Allocates storage for at least (n) entries, so inserting that many won't rehash.
+
+    void reserve ( size_t n )
+    {
+        size_t cap = 16;
+        while ( cap < n * 2 )
+            cap *= 2;
+
+        if ( cap > capacity() )
+            rehash ( cap );
+    }
+
+    iterator find ( K key )
+    {
+        if ( _size == 0 )
+            return end();
+
+        size_t i = slot ( key );
+        return occupied ( i ) ? iterator ( this, i ) : end();
+    }
+
+    const_iterator find ( K key ) const
+    {
+        if ( _size == 0 )
+            return end();
+
+        size_t i = slot ( key );
+        return occupied ( i ) ? const_iterator ( this, i ) : end();
+    }
+
+    size_t count ( K key ) const { return find ( key ) == end() ? 0 : 1; }
+
+    // Inserts an entry unless the map already contains its key, like std::map::insert().
+    // Returns an iterator to the entry with that key, and true if the entry was inserted.
+
+    pair<iterator,bool> insert ( const value_type &entry )
+    {
+        if ( ( _size + 1 ) * 2 > capacity() )
+            reserve ( _size + 1 );
+
+        size_t i = slot ( entry.first );
+        if ( occupied ( i ) )
+            return { iterator ( this, i ), false };
+
+        place ( i, entry );
+        _hasZero = _hasZero || (uint64_t) entry.first == 0;
+        _size++;
+        return { iterator ( this, i ), true };
+    }
+
+    // Returns a reference to the value mapped to a key, inserting a default value if the key is not present.
+
+    V &operator [] ( K key )
+    {
+        return insert ( { key, V() } ).first->second;
+    }
+};
+
+#endif /* SSHashMap_hpp */
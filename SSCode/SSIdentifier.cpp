@@ -90,14 +90,19 @@ static map<string,SSCatalog> _nameCatMap =
     { "UGCA", kCatUGCA },
 };
 
+// These use find() rather than operator[], which would insert missing keys,
+// so they are safe to call from multiple threads at once.
+
 string catalog_to_string ( SSCatalog cat )
 {
-    return _catNameMap[cat];
+    auto it = _catNameMap.find ( cat );
+    return it == _catNameMap.end() ? "" : it->second;
 }
 
 SSCatalog string_to_catalog ( string str )
 {
-    return _nameCatMap[str];
+    auto it = _nameCatMap.find ( str );
+    return it == _nameCatMap.end() ? kCatUnknown : it->second;
 }
 
 static vector<string> _bayvec =
@@ -143,19 +148,24 @@ vector<string> _convec =
     "TrA", "Tuc", "UMa", "UMi", "Vel", "Vir", "Vol", "Vul"
 };
 
-map<string,int> _conmap;
-static map<string,int> _baymap;
-extern SSObjectVec _constellationVec;
+// Maps Bayer letter and constellation strings to 1-based indices in the vectors above.
+// They are built once at startup, rather than on first use, so that identifiers
+// can be parsed from multiple threads without racing to initialize them.
 
-static void mapinit ( void )
+static map<string,int> mapinit ( const vector<string> &vec )
 {
-    for ( int i = 0; i < _bayvec.size(); i++ )
-        _baymap.insert ( { _bayvec[i], i + 1 } );
-
-    for ( int i = 0; i < _convec.size(); i++ )
-        _conmap.insert ( { _convec[i], i + 1 } );
+    map<string,int> m;
+    
+    for ( int i = 0; i < vec.size(); i++ )
+        m.insert ( { vec[i], i + 1 } );
+    
+    return m;
 }
 
+map<string,int> _conmap = mapinit ( _convec );
+static map<string,int> _baymap = mapinit ( _bayvec );
+extern SSObjectVec _constellationVec;
+
 string con_to_string ( int con )
 {
     return con > 0 && con < _convec.size() ? _convec[con - 1] : "";
@@ -163,11 +173,11 @@ string con_to_string ( int con )
 
 int string_to_con ( const string &str, bool casesens )
 {
-    if ( _conmap.size() == 0 )
-        mapinit();
-    
     if ( casesens )
-        return _conmap[ str ];
+    {
+        auto it = _conmap.find ( str );
+        return it == _conmap.end() ? 0 : it->second;
+    }
     
     for ( int i = 0; i < _convec.size(); i++ )
         if ( compare ( _convec[i], str, 0, casesens ) == 0 )
@@ -600,9 +610,6 @@ uint64_t SSIdentifier::identifier ( void )
 
 SSIdentifier SSIdentifier::fromString ( const string &str, SSObjectType type, bool casesens )
 {
-    if ( _conmap.size() == 0 || _baymap.size() == 0 )
-        mapinit();
-
     size_t len = str.length();
 
     // if string begins with "M", attempt to parse a Messier number
@@ -942,9 +949,6 @@ SSIdentifier SSIdentifier::fromString ( const string &str, SSObjectType type, bo
 
 string SSIdentifier::toString ( void )
 {
-    if ( _conmap.size() == 0 || _baymap.size() == 0 )
-        mapinit();
-
     SSCatalog cat = catalog();
     uint64_t id = identifier();
     string str = "";
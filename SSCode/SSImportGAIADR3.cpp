@@ -5,10 +5,10 @@
 // Copyright ©2023 Southern Stars Group, LLC. All rights reserved.
 //
 // Routines for importing GAIA DR3 star catalog data.
-// Currently only tested on MacOS; will not compile on Windows due to
+// Currently only tested on MacOS and Linux; will not compile on Windows due to
 // dependencies on zlib.h and dirent.h (and possibly others).
 
-#ifdef __APPLE__
+#if defined ( __APPLE__ ) || defined ( __linux__ )
 
 #include <algorithm>
 #include <iostream>
@@ -229,8 +229,10 @@ int SSReadGAIACrossMatchFile ( const string &path, SSGAIACrossMatchFile cmf, SSG
 
     gzfp = gzopen ( path.c_str(), "r" );
     if ( gzfp == NULL )
-        return NULL;
+        return 0;
     
+    records.reserve ( cmf == kTycho2CrossMatch ? 2511088 : 99525 );
+
     while ( true )
     {
         SSGAIACrossMatchRecord    record = { 0 };
@@ -388,7 +390,7 @@ int SSExportGAIADR3StarData ( const string &root, const string &outpath, const S
         if ( fwrite ( &outrec, sizeof ( outrec ), 1, outfile ) == 1 )
             n_outrecs++;
         else
-            printf ( "Failed to write output record for GAIA source ID %lld to %s!\n", outrec.source_id, outpath.c_str() );
+            printf ( "Failed to write output record for GAIA source ID %llu to %s!\n", (unsigned long long) outrec.source_id, outpath.c_str() );
     }
     
     // Free memory for array anc close file.
@@ -572,4 +574,4 @@ int SSImportGAIA17 ( const string &filename, SSObjectArray &stars, float vmin, f
     return numStars;
 }
 
-#endif // __APPLE__
+#endif // __APPLE__ || __linux__
@@ -8,6 +8,7 @@
 #define SSImportGAIADR3_hpp
 
 #include "SSStar.hpp"
+#include "SSHashMap.hpp"
 
 #include <stdio.h>
 #include <stdbool.h>
@@ -100,7 +101,7 @@ struct SSGAIACrossMatchRecord
 
 // Represents an entire GAIA cross-match file, indexed by GAIA DR3 source_id for fast lookups
 
-typedef map<uint64_t,SSGAIACrossMatchRecord> SSGAIACrossMatch;
+typedef SSHashMap<uint64_t,SSGAIACrossMatchRecord> SSGAIACrossMatch;
 
 struct SSGAIADir;   // Forward declaration of opaque GAIA directory/file reference
 
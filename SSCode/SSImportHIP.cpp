@@ -11,6 +11,7 @@
 #include "SSCoordinates.hpp"
 #include "SSImportGCVS.hpp"
 #include "SSImportHIP.hpp"
+#include "SSLineReader.hpp"
 #include "SSImportSKY2000.hpp"
 
 // Cleans up some oddball conventions in the Hipparcos star name identification tables
@@ -58,8 +59,8 @@ int SSImportHIPNames ( const string &filename, SSIdentifierNameMap &nameMap )
 {
     // Open file; return on failure.
 
-    ifstream file ( filename );
-    if ( ! file )
+    SSLineReader reader ( filename );
+    if ( ! reader.isOpen() )
         return 0;
 
     // Read file line-by-line until we reach end-of-file
@@ -67,7 +68,7 @@ int SSImportHIPNames ( const string &filename, SSIdentifierNameMap &nameMap )
     string line = "";
     int nameCount = 0;
 
-    while ( getline ( file, line ) )
+    while ( reader.readLine ( line ) )
     {
         string strHIP = trim ( line.substr ( 17, 6 ) );
         string strName = trim ( line.substr ( 0, 16 ) );
@@ -132,8 +133,8 @@ int SSImportHIC ( const string &filename, SSObjectVec &stars )
 {
     // Open file; return on failure.
 
-    ifstream file ( filename );
-    if ( ! file )
+    SSLineReader reader ( filename );
+    if ( ! reader.isOpen() )
         return 0;
     
     // Read file line-by-line until we reach end-of-file
@@ -141,7 +142,7 @@ int SSImportHIC ( const string &filename, SSObjectVec &stars )
     string line = "";
     int numStars = 0;
 
-    while ( getline ( file, line ) )
+    while ( reader.readLine ( line ) )
     {
         string strHIP = trim ( line.substr ( 0, 6 ) );
         string strRA = trim ( line.substr ( 13, 12 ) );
@@ -245,8 +246,8 @@ int SSImportHIP2 ( const string &filename, SSObjectVec &stars )
 {
     // Open file; return on failure.
 
-    ifstream file ( filename );
-    if ( ! file )
+    SSLineReader reader ( filename );
+    if ( ! reader.isOpen() )
         return 0;
 
     // Read file line-by-line until we reach end-of-file
@@ -254,7 +255,7 @@ int SSImportHIP2 ( const string &filename, SSObjectVec &stars )
     string line = "";
     int numStars = 0;
     
-    while ( getline ( file, line ) )
+    while ( reader.readLine ( line ) )
     {
         string strHIP = trim ( line.substr ( 0, 6 ) );
         string strRA = trim ( line.substr ( 15, 13 ) );
@@ -363,8 +364,8 @@ int SSImportHIP ( const string &filename, SSIdentifierMap &hrMap, SSIdentifierMa
 {
     // Open file; return on failure.
 
-    ifstream file ( filename );
-    if ( ! file )
+    SSLineReader reader ( filename );
+    if ( ! reader.isOpen() )
         return 0;
 
     // Make mappings of HIP identifiers to object indices
@@ -383,7 +384,7 @@ int SSImportHIP ( const string &filename, SSIdentifierMap &hrMap, SSIdentifierMa
     string line = "";
     int numStars = 0;
     
-    while ( getline ( file, line ) )
+    while ( reader.readLine ( line ) )
     {
         string strHIP = trim ( line.substr ( 8, 6 ) );
         string strRA = trim ( line.substr ( 51, 12 ) );
@@ -554,8 +555,8 @@ int SSImportHIPHRIdentifiers ( const string &filename, SSIdentifierMap &map )
 {
     // Open file; return on failure.
     
-    ifstream file ( filename );
-    if ( ! file )
+    SSLineReader reader ( filename );
+    if ( ! reader.isOpen() )
         return 0;
     
     // Read file line-by-line until we reach end-of-file
@@ -563,7 +564,7 @@ int SSImportHIPHRIdentifiers ( const string &filename, SSIdentifierMap &map )
     string line ( "" );
     int count = 0;
     
-    while ( getline ( file, line ) )
+    while ( reader.readLine ( line ) )
     {
         string strHR = trim ( line.substr ( 0, 6 ) );
         string strHIP = trim ( line.substr ( 7, 6 ) );
@@ -591,8 +592,8 @@ int SSImportHIPBayerIdentifiers ( const string &filename, SSIdentifierMap &map )
 {
     // Open file; return on failure.
 
-    ifstream file ( filename );
-    if ( ! file )
+    SSLineReader reader ( filename );
+    if ( ! reader.isOpen() )
         return 0;
     
     // Read file line-by-line until we reach end-of-file
@@ -600,7 +601,7 @@ int SSImportHIPBayerIdentifiers ( const string &filename, SSIdentifierMap &map )
     string line = "";
     int count = 0;
 
-    while ( getline ( file, line ) )
+    while ( reader.readLine ( line ) )
     {
         string strBF = trim ( line.substr ( 0, 11 ) );
         string strHIP = trim ( line.substr ( 12, 6 ) );
@@ -629,8 +630,8 @@ int SSImportHIPGCVSIdentifiers ( const string &filename, SSIdentifierMap &map )
 {
     // Open file; return on failure.
 
-    ifstream file ( filename );
-    if ( ! file )
+    SSLineReader reader ( filename );
+    if ( ! reader.isOpen() )
         return 0;
     
     // Read file line-by-line until we reach end-of-file
@@ -638,7 +639,7 @@ int SSImportHIPGCVSIdentifiers ( const string &filename, SSIdentifierMap &map )
     string line = "";
     int count = 0;
     
-    while ( getline ( file, line ) )
+    while ( reader.readLine ( line ) )
     {
         string strVar = trim ( line.substr ( 0, 11 ) );
         string strHIP = trim ( line.substr ( 12, 6 ) );
@@ -9,6 +9,7 @@
 
 #include "SSTime.hpp"
 #include "SSImportMPC.hpp"
+#include "SSLineReader.hpp"
 
 // Converts one line of a Minor Planet Center comet orbit export file to an SSPlanet.
 // Returns pointer to newly-allocated SSPlanet if successful or nullptr on failure.
@@ -155,19 +156,23 @@ SSPlanetPtr SSImportMPCAsteroid ( const string &line )
     if ( line.length() < 167 )
         return nullptr;
 
+    // Fields are views into the line, so no strings are allocated for them.
+    
+    string_view view ( line );
+
     // col 9-13: absolute magnitude
     
-    string field = trim ( line.substr ( 8, 5 ) );
+    string_view field = trim_view ( view.substr ( 8, 5 ) );
     float hmag = field.empty() ? INFINITY : strtofloat ( field );
     
     // col 15-19: magnitude slope parameter
     
-    field = trim ( line.substr ( 14, 5 ) );
+    field = trim_view ( view.substr ( 14, 5 ) );
     float gmag = field.empty() ? INFINITY : strtofloat ( field );
     
     // col 21-25: epoch in packed form
     
-    field = line.substr ( 20, 5 );
+    field = view.substr ( 20, 5 );
     int year = 100 * ( 20 + toupper ( field[0] ) - 'K' );  // century
     year += strtoint ( field.substr ( 1, 2 ) );
     
@@ -191,58 +196,58 @@ SSPlanetPtr SSImportMPCAsteroid ( const string &line )
     
     // col 27-35: Mean anomaly in degrees
     
-    field = trim ( line.substr ( 26, 9 ) );
+    field = trim_view ( view.substr ( 26, 9 ) );
     double m = field.empty() ? INFINITY : degtorad ( strtofloat64 ( field ) );
     
     // col 38-46: Argument of perihelion in degrees
     
-    field = trim ( line.substr ( 37, 9 ) );
+    field = trim_view ( view.substr ( 37, 9 ) );
     double w = field.empty() ? INFINITY : degtorad ( strtofloat64 ( field ) );
     
     // col 49-57: Longitude of ascending node in degrees
     
-    field = trim ( line.substr ( 48, 9 ) );
+    field = trim_view ( view.substr ( 48, 9 ) );
     double n = field.empty() ? INFINITY : degtorad ( strtofloat64 ( field ) );
     
     // col 60-68: Inclination in degrees
     
-    field = trim ( line.substr ( 59, 9 ) );
+    field = trim_view ( view.substr ( 59, 9 ) );
     double i = field.empty() ? INFINITY : degtorad ( strtofloat64 ( field ) );
     
     // col 71-79: Eccentricity
     
-    field = trim ( line.substr ( 70, 9 ) );
+    field = trim_view ( view.substr ( 70, 9 ) );
     double e = field.empty() ? INFINITY : strtofloat64 ( field );
     
     // col 81-91: Mean motion in degrees per day
     
-    field = trim ( line.substr ( 80, 11 ) );
+    field = trim_view ( view.substr ( 80, 11 ) );
     double mm = field.empty() ? INFINITY : degtorad ( strtofloat64 ( field ) );
     
     // col 93-103: Semimajor axis in AU.  If not found, compute from mean motion.
     
-    field = trim ( line.substr ( 92, 11 ) );
+    field = trim_view ( view.substr ( 92, 11 ) );
     double a = strtofloat64 ( field );
     if ( a <= 0.0 )
         a = pow ( SSOrbit::kGaussGravHelio / ( mm * mm ), 1.0 / 3.0 );
     
     // col 167-195: (asteroid number) and/or name
     
-    field = trim ( line.substr ( 166, min ( (int) line.length() - 166, 28 ) ) );
+    field = trim_view ( view.substr ( 166, min ( (int) line.length() - 166, 28 ) ) );
     SSIdentifier number;
-    if ( field[0] == '(' )
+    if ( ! field.empty() && field[0] == '(' )
     {
         size_t endparen = field.find ( ')' );
-        if ( endparen != string::npos )
+        if ( endparen != string_view::npos )
         {
-            number = SSIdentifier::fromString ( field.substr ( 0, endparen + 1 ) );
-            field = trim ( field.substr ( endparen + 1, string::npos ) );
+            number = SSIdentifier::fromString ( string ( field.substr ( 0, endparen + 1 ) ) );
+            field = trim_view ( field.substr ( endparen + 1, string_view::npos ) );
         }
     }
     
     vector<string> names;
     if ( ! field.empty() )
-        names.push_back ( field );
+        names.push_back ( string ( field ) );
     
     // Allocate new asteroid object with default values
     
@@ -273,8 +278,8 @@ int SSImportMPCComets ( const string &filename, SSObjectVec &comets )
 {
     // Open file; return on failure.
 
-    ifstream file ( filename );
-    if ( ! file )
+    SSLineReader reader ( filename );
+    if ( ! reader.isOpen() )
         return ( 0 );
 
     // Read file line-by-line until we reach end-of-file
@@ -282,7 +287,7 @@ int SSImportMPCComets ( const string &filename, SSObjectVec &comets )
     string line = "";
     int numLines = 0, numComets = 0;
 
-    while ( getline ( file, line ) )
+    while ( reader.readLine ( line ) )
     {
         numLines++;
         SSPlanetPtr pComet = SSImportMPCComet ( line );
@@ -305,8 +310,8 @@ int SSImportMPCAsteroids ( const string &filename, SSObjectVec &asteroids )
 {
     // Open file; return on failure.
 
-    ifstream file ( filename );
-    if ( ! file )
+    SSLineReader reader ( filename );
+    if ( ! reader.isOpen() )
         return ( 0 );
 
     // Read file line-by-line until we reach end-of-file
@@ -314,7 +319,7 @@ int SSImportMPCAsteroids ( const string &filename, SSObjectVec &asteroids )
     string line = "";
     int numLines = 0, numAsteroids = 0;
 
-    while ( getline ( file, line ) )
+    while ( reader.readLine ( line ) )
     {
         numLines++;
         SSPlanetPtr pAsteroid = SSImportMPCAsteroid ( line );
@@ -9,6 +9,7 @@
 #include "SSCoordinates.hpp"
 #include "SSImportHIP.hpp"
 #include "SSImportNGCIC.hpp"
+#include "SSLineReader.hpp"
 
 #include <algorithm>
 #include <iostream>
@@ -478,8 +479,8 @@ int SSImportNGCIC ( const string &filename, SSIdentifierNameMap &nameMap, SSObje
 {
     // Open file; return on failure.
 
-    ifstream file ( filename );
-    if ( ! file )
+    SSLineReader reader ( filename );
+    if ( ! reader.isOpen() )
         return ( 0 );
 
     // Read file line-by-line until we reach end-of-file
@@ -487,7 +488,7 @@ int SSImportNGCIC ( const string &filename, SSIdentifierNameMap &nameMap, SSObje
     string line = "";
     int numObjects = 0;
 
-    while ( getline ( file, line ) )
+    while ( reader.readLine ( line ) )
     {
         // Split line into tokens separated by tabs.
         // Require at least 27 tokens.
@@ -653,8 +654,8 @@ int SSImportDAML02 ( const string &filename, SSIdentifierNameMap &nameMap, SSObj
 {
     // Open file; return on failure.
 
-    ifstream file ( filename );
-    if ( ! file )
+    SSLineReader reader ( filename );
+    if ( ! reader.isOpen() )
         return ( 0 );
 
     // Read file line-by-line until we reach end-of-file
@@ -662,7 +663,7 @@ int SSImportDAML02 ( const string &filename, SSIdentifierNameMap &nameMap, SSObj
     string line = "";
     int numClusters = 0;
 
-    while ( getline ( file, line ) )
+    while ( reader.readLine ( line ) )
     {
         // Get R.A. and Dec; convert to radians
         
@@ -758,8 +759,8 @@ int SSImportMWGC ( const string &filename, SSIdentifierNameMap &nameMap, SSObjec
 {
     // Open file; return on failure.
 
-    ifstream file ( filename );
-    if ( ! file )
+    SSLineReader reader ( filename );
+    if ( ! reader.isOpen() )
         return ( 0 );
 
     // Read file line-by-line until we reach end-of-file
@@ -767,7 +768,7 @@ int SSImportMWGC ( const string &filename, SSIdentifierNameMap &nameMap, SSObjec
     string line = "";
     int numClusters = 0;
 
-    while ( getline ( file, line ) )
+    while ( reader.readLine ( line ) )
     {
         // Get R.A. and Dec; convert to radians
         
@@ -875,15 +876,15 @@ int SSImportPNG ( const string &main_filename, const string &dist_filename, cons
     // First open distance distance file.
     // If successful create mapping of PNG identifiers to distances.
     
-    ifstream file ( dist_filename );
-    if ( file )
+    SSLineReader reader ( dist_filename );
+    if ( reader.isOpen() )
     {
         int n = 0;
         SSIdentifier lastIdent ( kCatUnknown, 0 );
         
         // Read file line-by-line until we reach end-of-file
         
-        while ( getline ( file, line ) )
+        while ( reader.readLine ( line ) )
         {
             if ( line.length() < 28 )
                 continue;
@@ -923,13 +924,12 @@ int SSImportPNG ( const string &main_filename, const string &dist_filename, cons
     // Close previous file; open diameter file.
     // If successful create mapping of PNG identifiers to angular diameters.
 
-    file.close();
-    file.open ( diam_filename );
-    if ( file )
+    reader.open ( diam_filename );
+    if ( reader.isOpen() )
     {
         // Read file line-by-line until we reach end-of-file
         
-        while ( getline ( file, line ) )
+        while ( reader.readLine ( line ) )
         {
             if ( line.length() < 18 )
                 continue;
@@ -954,13 +954,12 @@ int SSImportPNG ( const string &main_filename, const string &dist_filename, cons
     // Close previous file; open velocity file.
     // If successful create mapping of PNG identifiers to radial velocities.
 
-    file.close();
-    file.open ( vel_filename );
-    if ( file )
+    reader.open ( vel_filename );
+    if ( reader.isOpen() )
     {
         // Read file line-by-line until we reach end-of-file
         
-        while ( getline ( file, line ) )
+        while ( reader.readLine ( line ) )
         {
             if ( line.length() < 18 )
                 continue;
@@ -984,9 +983,8 @@ int SSImportPNG ( const string &main_filename, const string &dist_filename, cons
 
     // Close previous file; open main file and return on failure.
 
-    file.close();
-    file.open ( main_filename );
-    if ( ! file )
+    reader.open ( main_filename );
+    if ( ! reader.isOpen() )
         return 0;
     
     // Set up matrix for precessing B1950 coordinates and proper motion to J2000.
@@ -995,7 +993,7 @@ int SSImportPNG ( const string &main_filename, const string &dist_filename, cons
     SSMatrix precession = SSCoordinates::getPrecessionMatrix ( SSTime::kB1950 ).transpose();
     int numNebulae = 0;
 
-    while ( getline ( file, line ) )
+    while ( reader.readLine ( line ) )
     {
         if ( line.length() < 58 )
             continue;
@@ -7,6 +7,7 @@
 #include "SSCoordinates.hpp"
 #include "SSImportGCVS.hpp"
 #include "SSImportSKY2000.hpp"
+#include "SSLineReader.hpp"
 #include "SSImportWDS.hpp"
 
 #include <algorithm>
@@ -42,10 +43,21 @@ SSStarPtr SSGetMatchingStar ( vector<SSIdentifier> &idents, SSObjectMaps &maps,
     return nullptr;
 }
 
+// As above, but matches the identifiers of a star (pStar), without copying them.
+
 SSStarPtr SSGetMatchingStar ( SSStarPtr pStar, SSObjectMaps &maps, SSObjectVec &stars )
 {
-    SSIdentifierVec idents = pStar->getIdentifiers();
-    return SSGetMatchingStar ( idents, maps, stars );
+    for ( auto it = maps.begin(); it != maps.end(); it++ )
+    {
+        SSIdentifier id = pStar->getIdentifier ( it->first );
+        if ( ! id )
+            continue;
+        SSStarPtr pStar1 = SSGetStarPtr ( SSIdentifierToObject ( id, it->second, stars ) );
+        if ( pStar1 )
+            return pStar1;
+    }
+
+    return nullptr;
 }
 
 // Adds selected data from pStar to pSkyStar.
@@ -126,8 +138,8 @@ int SSImportIAUStarNames ( const string &filename, SSIdentifierNameMap &nameMap
 {
     // Open file; return on failure.
 
-    ifstream file ( filename );
-    if ( ! file )
+    SSLineReader reader ( filename );
+    if ( ! reader.isOpen() )
         return 0;
 
     // Read file line-by-line until we reach end-of-file
@@ -135,7 +147,7 @@ int SSImportIAUStarNames ( const string &filename, SSIdentifierNameMap &nameMap
     string line = "";
     int count = 0;
 
-    while ( getline ( file, line ) )
+    while ( reader.readLine ( line ) )
     {
         if ( line.length() < 96 )
             continue;
@@ -264,8 +276,8 @@ int SSImportSKY2000 ( const string &filename, SSIdentifierNameMap &nameMap, SSOb
 {
     // Open file; return on failure.
 
-    ifstream file ( filename );
-    if ( ! file )
+    SSLineReader reader ( filename );
+    if ( ! reader.isOpen() )
         return 0;
 
     // Make cross-indexes of identifiers in other star vectors.
@@ -280,7 +292,7 @@ int SSImportSKY2000 ( const string &filename, SSIdentifierNameMap &nameMap, SSOb
     string line = "";
     int numStars = 0;
 
-    while ( getline ( file, line ) )
+    while ( reader.readLine ( line ) )
     {
         if ( line.length() < 521 )
             continue;
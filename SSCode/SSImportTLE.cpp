@@ -5,6 +5,7 @@
 // Copyright © 2020 Southern Stars. All rights reserved.
 
 #include "SSImportTLE.hpp"
+#include "SSLineReader.hpp"
 
 // Imports satellites from TLE-formatted text file (filename).
 // Imported satellites are appended to the input vector of SSObjects (satellites).
@@ -52,8 +53,8 @@ int SSImportMcNames ( const string &filename, McNameMap &mcnames )
 {
     // Open file; return on failure.
 
-    FILE *file = fopen ( filename.c_str(), "rb" );
-    if ( ! file )
+    SSLineReader reader ( filename );
+    if ( ! reader.isOpen() )
         return 0;
 
     // Read file line-by-line until we reach end-of-file
@@ -61,7 +62,7 @@ int SSImportMcNames ( const string &filename, McNameMap &mcnames )
     string line = "";
     int nMcNames = 0;
     
-    while ( fgetline ( file, line ) )
+    while ( reader.readLine ( line ) )
     {
         McName mcname = { 0, "", 0.0, 0.0, 0.0, 0.0 };
         
@@ -88,9 +89,8 @@ int SSImportMcNames ( const string &filename, McNameMap &mcnames )
         nMcNames++;
     }
     
-    // Close file. Return number of objects added to object vector.
+    // Return number of McNames imported; file will close automatically.
 
-    fclose ( file );
     return nMcNames;
 }
 
@@ -150,8 +150,8 @@ int SSImportSatelliteFrequencyData ( const string &filename, SatFreqMap &freqmap
 {
     // Open file; return on failure.
 
-    ifstream file ( filename );
-    if ( ! file )
+    SSLineReader reader ( filename );
+    if ( ! reader.isOpen() )
         return 0;
 
     // Read file line-by-line until we reach end-of-file
@@ -160,7 +160,7 @@ int SSImportSatelliteFrequencyData ( const string &filename, SatFreqMap &freqmap
     int nFreqs = 0;
     vector<SSSatellite::FreqData> freqvec;
 
-    while ( getline ( file, line ) )
+    while ( reader.readLine ( line ) )
     {
         vector<string> fields = split ( line, ";" );
         if ( fields.size() < 8 )
@@ -252,8 +252,8 @@ int SSImportN2Data ( const string &filename, N2DataMap &datamap )
 {
     // Open file; return on failure.
 
-    ifstream file ( filename );
-    if ( ! file )
+    SSLineReader reader ( filename );
+    if ( ! reader.isOpen() )
         return 0;
 
     // Read file line-by-line until we reach end-of-file
@@ -261,7 +261,7 @@ int SSImportN2Data ( const string &filename, N2DataMap &datamap )
     string line = "";
     int n = 0;
 
-    while ( getline ( file, line ) )
+    while ( reader.readLine ( line ) )
     {
         vector<string> fields = split_csv ( line );
         if ( fields.size() < 8 )
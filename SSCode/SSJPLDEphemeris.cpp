@@ -5,7 +5,13 @@
 // Copyright © 2020 Southern Stars. All rights reserved.
 
 #include <mutex>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
 #include "SSJPLDEphemeris.hpp"
+#include "SSUtilities.hpp"
 
 // Code is based on "C version software for the JPL planetary ephemerides"
 // by Piotr A. Dybczynski (dybol@amu.edu.pl),
@@ -657,11 +663,243 @@ void constan(char nam[][6], double val[], double sss[], int *n)
 }
 /*************************** THE END ***************************************/
 
+// Memory-mapped copy of the ephemeris file, and its size in bytes;
+// pMap is nullptr if the ephemeris file is not memory-mapped.
+
+static const char *pMap = nullptr;
+static size_t mapsize = 0;
+
+// Initializes interpolation context so that Chebyshev polynomials
+// will be evaluated from scratch on the first interpolation.
+
+SSJPLDEphemerisContext::SSJPLDEphemerisContext ( void )
+{
+    memset ( pc, 0, sizeof ( pc ) );
+    memset ( vc, 0, sizeof ( vc ) );
+    pc[0] = 1.0;
+    vc[1] = 1.0;
+    twot = 0.0;
+    np = 2;
+    nv = 3;
+}
+
+// Reentrant version of interp() above, which keeps Chebyshev polynomials in
+// the caller's context (ctx) instead of static variables. Always interpolates
+// both position and velocity; other parameters are the same as interp().
+
+static void interp_r ( SSJPLDEphemerisContext &ctx, const double coef[], const double t[2], int ncf, int ncm, int na, double posvel[6] )
+{
+    double dna = na, dt1 = 0.0, temp1 = 0.0;
+    modf ( t[0], &dt1 );
+    double temp = dna * t[0];
+    int l = (int) ( temp - dt1 );
+    
+    // Normalized chebyshev time (-1 <= tc <= 1); recompute polynomials if it has changed.
+    
+    double tc = 2.0 * ( modf ( temp, &temp1 ) + dt1 ) - 1.0;
+    if ( tc != ctx.pc[1] )
+    {
+        ctx.np = 2;
+        ctx.nv = 3;
+        ctx.pc[1] = tc;
+        ctx.twot = tc + tc;
+    }
+    
+    if ( ctx.np < ncf )
+    {
+        for ( int i = ctx.np; i < ncf; i++ )
+            ctx.pc[i] = ctx.twot * ctx.pc[i-1] - ctx.pc[i-2];
+        ctx.np = ncf;
+    }
+    
+    ctx.vc[2] = ctx.twot + ctx.twot;
+    if ( ctx.nv < ncf )
+    {
+        for ( int i = ctx.nv; i < ncf; i++ )
+            ctx.vc[i] = ctx.twot * ctx.vc[i-1] + ctx.pc[i-1] + ctx.pc[i-1] - ctx.vc[i-2];
+        ctx.nv = ncf;
+    }
+    
+    // Interpolate position and velocity for each component.
+    
+    double vfac = ( dna + dna ) / t[1];
+    for ( int i = 0; i < ncm; i++ )
+    {
+        const double *pCoef = coef + i * ncf + l * ncf * ncm;
+        double p = 0.0, v = 0.0;
+        
+        for ( int j = ncf - 1; j > 0; j-- )
+        {
+            p += ctx.pc[j] * pCoef[j];
+            v += ctx.vc[j] * pCoef[j];
+        }
+        
+        posvel[i] = p + ctx.pc[0] * pCoef[0];
+        posvel[i + ncm] = v * vfac;
+    }
+}
+
+// Returns pointer to the memory-mapped ephemeris record containing a JED (et),
+// and fractional time within that record (t[0]) and record length in days (t[1]).
+// Returns nullptr if the record is not mapped.
+
+static const double *record_r ( double et, double t[2] )
+{
+    double pjd[4] = { 0.0 };
+    
+    // Find last midnight before epoch (pjd[0]) and remaining fractional part of epoch (pjd[3]), as in state().
+    
+    split ( et - 0.5, &pjd[0] );
+    split ( 0.0, &pjd[2] );
+    pjd[0] = pjd[0] + pjd[2] + 0.5;
+    pjd[1] = pjd[1] + pjd[3];
+    split ( pjd[1], &pjd[2] );
+    pjd[0] = pjd[0] + pjd[2];
+
+    // Calculate record number and relative time in interval; make sure record is mapped.
+    
+    int nr = (int) ( ( pjd[0] - R1.r1.ss[0] ) / R1.r1.ss[2] ) + 2;
+    if ( pjd[0] == R1.r1.ss[1] )
+        nr--;
+    
+    if ( nr < 2 || ( nr + 1 ) * (size_t) RECSIZE > mapsize )
+        return nullptr;
+
+    t[0] = ( pjd[0] - ( ( nr - 2.0 ) * R1.r1.ss[2] + R1.r1.ss[0] ) + pjd[3] ) / R1.r1.ss[2];
+    t[1] = R1.r1.ss[2];
+    return (const double *) ( pMap + nr * (size_t) RECSIZE );
+}
+
+// Reentrant version of pleph() above, which reads Chebyshev coefficients directly
+// from the memory-mapped ephemeris file instead of the static record buffer in state().
+// Only handles target (ntarg) 1 - 11 and center (ncent) 11 or 12, in AU and AU/day.
+// Returns true if successful or false if the record containing the JED (et) is not mapped.
+
+static bool pleph_r ( SSJPLDEphemerisContext &ctx, double et, int ntarg, int ncent, double rrd[6] )
+{
+    double pv[13][6] = { { 0.0 } };
+    int list[10] = { 0 };
+    double t[2] = { 0.0 };
+    
+    const double *buf = record_r ( et, t );
+    if ( buf == nullptr )
+        return false;
+
+    double aufac = 1.0 / R1.r1.au;
+    
+    // Set up list of bodies to interpolate, as in pleph(). Moon needs Earth and vice-versa.
+    
+    for ( int k : { ntarg - 1, ncent - 1 } )
+    {
+        if ( k <= 9 )
+            list[k] = 2;
+        if ( k == 9 )
+            list[2] = 2;
+        if ( k == 2 )
+            list[9] = 2;
+    }
+
+    // Interpolate barycentric Sun, and all requested bodies.
+    
+    interp_r ( ctx, &buf[ R1.r1.ipt[10][0] - 1 ], t, R1.r1.ipt[10][1], 3, R1.r1.ipt[10][2], pv[10] );
+    for ( int j = 0; j < 6; j++ )
+        pv[10][j] *= aufac;
+    
+    for ( int i = 0; i < 10; i++ )
+    {
+        if ( list[i] == 0 )
+            continue;
+        
+        interp_r ( ctx, &buf[ R1.r1.ipt[i][0] - 1 ], t, R1.r1.ipt[i][1], 3, R1.r1.ipt[i][2], pv[i] );
+        for ( int j = 0; j < 6; j++ )
+            pv[i][j] *= aufac;
+    }
+    
+    // Compute Earth from Earth-Moon barycenter, and barycentric Moon from geocentric Moon.
+    
+    if ( list[2] == 2 )
+        for ( int j = 0; j < 6; j++ )
+            pv[2][j] -= pv[9][j] / ( 1.0 + R1.r1.emrat );
+
+    if ( list[9] == 2 )
+        for ( int j = 0; j < 6; j++ )
+            pv[9][j] += pv[2][j];
+
+    // Solar system barycenter is pv[11], which is already zero.
+    
+    for ( int j = 0; j < 6; j++ )
+        rrd[j] = pv[ntarg - 1][j] - pv[ncent - 1][j];
+    
+    return true;
+}
+
+// Evaluates Chebyshev polynomials (pc) and their derivatives (vc)
+// for the first ncf terms at normalized Chebyshev time tc.
+
+static void chebyshev_r ( double tc, int ncf, double pc[], double vc[] )
+{
+    double twot = tc + tc;
+    
+    pc[0] = 1.0;
+    pc[1] = tc;
+    vc[0] = 0.0;
+    vc[1] = 1.0;
+    vc[2] = twot + twot;
+    
+    for ( int i = 2; i < ncf; i++ )
+        pc[i] = twot * pc[i-1] - pc[i-2];
+    
+    for ( int i = 3; i < ncf; i++ )
+        vc[i] = twot * vc[i-1] + pc[i-1] + pc[i-1] - vc[i-2];
+}
+
+// Sums three components of ncf Chebyshev coefficients (coef) with precomputed polynomials
+// (pc) and derivatives (vc) to give position and velocity (posvel), scaled by position
+// and velocity factors (pfac, vfac). Uses AVX2 if the compiler targets it; the scalar version
+// sums in the same order as interp(), so it gives results identical to compute().
+
+static void chebyshev_sum ( const double *coef, int ncf, const double *pc, const double *vc, double pfac, double vfac, double posvel[6] )
+{
+    for ( int i = 0; i < 3; i++, coef += ncf )
+    {
+        double p = 0.0, v = 0.0;
+        int j = ncf - 1;
+
+#ifdef __AVX2__
+        __m256d p4 = _mm256_setzero_pd();
+        __m256d v4 = _mm256_setzero_pd();
+        for ( ; j >= 4; j -= 4 )
+        {
+            __m256d c4 = _mm256_loadu_pd ( coef + j - 3 );
+            p4 = _mm256_add_pd ( p4, _mm256_mul_pd ( _mm256_loadu_pd ( pc + j - 3 ), c4 ) );
+            v4 = _mm256_add_pd ( v4, _mm256_mul_pd ( _mm256_loadu_pd ( vc + j - 3 ), c4 ) );
+        }
+        
+        double ps[4], vs[4];
+        _mm256_storeu_pd ( ps, p4 );
+        _mm256_storeu_pd ( vs, v4 );
+        p = ( ps[3] + ps[2] ) + ( ps[1] + ps[0] );
+        v = ( vs[3] + vs[2] ) + ( vs[1] + vs[0] );
+#endif
+        for ( ; j > 0; j-- )
+        {
+            p += pc[j] * coef[j];
+            v += vc[j] * coef[j];
+        }
+
+        posvel[i] = ( p + pc[0] * coef[0] ) * pfac;
+        posvel[i + 3] = v * vfac * pfac;
+    }
+}
+
 // Opens epheneris file and reads header.
+// If map is true, also memory-maps the entire file so positions can be computed
+// from any number of threads without locking; if mapping fails, the file is still
+// opened and computation falls back to the original (serialized) C code.
 // Returns true if successful or false on failure.
 // Closes any ephemeris file already open.
 
-bool SSJPLDEphemeris::open ( const string &filename )
+bool SSJPLDEphemeris::open ( const string &filename, bool map )
 {
     if ( F1 != NULL )
         close();
@@ -671,6 +909,10 @@ bool SSJPLDEphemeris::open ( const string &filename )
         return false;
     
     constan ( nams, vals , ss, &nvs );
+    
+    if ( map )
+        pMap = (const char *) mapfile ( filename, mapsize );
+    
     return true;
 }
 
@@ -681,6 +923,13 @@ bool SSJPLDEphemeris::isOpen ( void )
     return F1 == NULL;
 }
 
+// Returns true if the ephemeris file is open and memory-mapped.
+
+bool SSJPLDEphemeris::isMapped ( void )
+{
+    return pMap != nullptr;
+}
+
 // Closes any currently-open ephemeris file and resets internal variables to zero.
 // Don't close until you are finished using ephemeris!
 
@@ -692,6 +941,10 @@ void SSJPLDEphemeris::close ( void )
     fclose ( F1 );
     F1 = NULL;
     
+    unmapfile ( pMap, mapsize );
+    pMap = nullptr;
+    mapsize = 0;
+    
     memset ( PVSUN, 0, sizeof ( PVSUN ) );
     memset ( nams, 0, sizeof ( nams ) );
     memset ( ss, 0, sizeof ( ss ) );
@@ -703,13 +956,20 @@ void SSJPLDEphemeris::close ( void )
 // in fundamental J2000 equatorial frame (ICRS) at a given Julian Ephemeris Date (jed),
 // relative to Sun (if bary is false) or to Solar System Barycenter (if bary is true).
 // Object identifier (id) is 1 - 9 for Mercury - Pluto, 0 for Sun, or 10 for Earth's Moon.
-// The underlying code is not thread-safe, so use mutex lock to prevent multiple threads
+// If the ephemeris file is memory-mapped, interpolates with a per-thread context and no locking.
+// Otherwise the underlying code is not thread-safe, so use mutex lock to prevent multiple threads
 // from simultaneously modifying shared resources.
 
 std::mutex eph_mutex;
 
 bool SSJPLDEphemeris::compute ( int id, double jed, bool bary, SSVector &position, SSVector &velocity )
 {
+    if ( pMap != nullptr )
+    {
+        static thread_local SSJPLDEphemerisContext context;
+        return compute ( context, id, jed, bary, position, velocity );
+    }
+    
     if ( F1 == NULL || jed < ss[0] || jed > ss[1] || ::isnan ( jed ) || id < 0 || id > 10 )
         return false;
     
@@ -730,6 +990,158 @@ bool SSJPLDEphemeris::compute ( int id, double jed, bool bary, SSVector &positio
     return true;
 }
 
+// As above, but interpolates memory-mapped ephemeris records using the caller's context,
+// so it is safe to call from multiple threads at once if each thread has its own context.
+// Returns false if the ephemeris file is not memory-mapped.
+
+bool SSJPLDEphemeris::compute ( SSJPLDEphemerisContext &context, int id, double jed, bool bary, SSVector &position, SSVector &velocity )
+{
+    if ( pMap == nullptr || jed < ss[0] || jed > ss[1] || ::isnan ( jed ) || id < 0 || id > 10 )
+        return false;
+    
+    // Sun is 0 in our convention; 11 for JPL.
+    
+    double rrd[6] = { 0.0 };
+    if ( ! pleph_r ( context, jed, id == 0 ? 11 : id, bary ? 12 : 11, rrd ) )
+        return false;
+    
+    position = SSVector ( rrd[0], rrd[1], rrd[2] );
+    velocity = SSVector ( rrd[3], rrd[4], rrd[5] );
+    return true;
+}
+
+// Computes positions and velocities of several objects (ids) at many Julian Ephemeris Dates (jeds),
+// using the same units, frame, origin (bary), and object identifiers as compute() above.
+// On return, position and velocity of the k-th object at the i-th JED are stored in
+// positions[ i * ids.size() + k ] and velocities[ i * ids.size() + k ]; results for any JED
+// outside the ephemeris are zero. Returns number of JEDs for which results were computed.
+// If the ephemeris file is memory-mapped, Chebyshev polynomials are evaluated once per JED
+// and shared by all objects, and the Sun is interpolated only once per JED. Otherwise,
+// this just calls compute() for each object at each JED. Thread-safe if memory-mapped.
+
+int SSJPLDEphemeris::compute ( const vector<int> &ids, const vector<double> &jeds, bool bary, vector<SSVector> &positions, vector<SSVector> &velocities )
+{
+    size_t nids = ids.size(), njeds = jeds.size();
+    int n = 0;
+    
+    positions.assign ( nids * njeds, SSVector() );
+    velocities.assign ( nids * njeds, SSVector() );
+
+    if ( pMap == nullptr )
+    {
+        for ( size_t i = 0; i < njeds; i++ )
+        {
+            bool ok = true;
+            for ( size_t k = 0; k < nids; k++ )
+                ok = compute ( ids[k], jeds[i], bary, positions[ i * nids + k ], velocities[ i * nids + k ] ) && ok;
+            n += ok;
+        }
+        
+        return n;
+    }
+    
+    // Find which JPL series (0-8 = planets or Earth-Moon barycenter, 9 = geocentric Moon, 10 = Sun)
+    // we need to interpolate. Earth and Moon both need Earth-Moon barycenter and geocentric Moon.
+    
+    bool need[11] = { false };
+    need[10] = true;
+    for ( int id : ids )
+    {
+        if ( id == 3 || id == 10 )
+            need[2] = need[9] = true;
+        else if ( id >= 1 && id <= 9 )
+            need[id - 1] = true;
+    }
+    
+    // Group series by number of sub-intervals per record. All series in a group
+    // share the same normalized Chebyshev time, so can share one set of polynomials.
+    
+    int groupNA[11] = { 0 }, groupNCF[11] = { 0 }, seriesGroup[11] = { 0 }, ngroups = 0;
+    for ( int s = 0; s < 11; s++ )
+    {
+        if ( ! need[s] )
+            continue;
+        
+        int g = 0, na = R1.r1.ipt[s][2], ncf = min ( R1.r1.ipt[s][1], 18 );
+        while ( g < ngroups && groupNA[g] != na )
+            g++;
+        
+        if ( g == ngroups )
+            groupNA[ngroups++] = na;
+        
+        groupNCF[g] = max ( groupNCF[g], ncf );
+        seriesGroup[s] = g;
+    }
+    
+    double aufac = 1.0 / R1.r1.au;
+    double pc[11][18], vc[11][18], vfac[11];
+    int sub[11];
+    
+    for ( size_t i = 0; i < njeds; i++ )
+    {
+        double jed = jeds[i], t[2] = { 0.0 };
+        if ( jed < ss[0] || jed > ss[1] || ::isnan ( jed ) )
+            continue;
+        
+        const double *buf = record_r ( jed, t );
+        if ( buf == nullptr )
+            continue;
+        
+        // Get sub-interval number and Chebyshev polynomials for each group, as in interp().
+        
+        for ( int g = 0; g < ngroups; g++ )
+        {
+            double dna = groupNA[g], dt1 = 0.0, temp1 = 0.0;
+            modf ( t[0], &dt1 );
+            double temp = dna * t[0];
+            sub[g] = (int) ( temp - dt1 );
+            vfac[g] = ( dna + dna ) / t[1];
+            chebyshev_r ( 2.0 * ( modf ( temp, &temp1 ) + dt1 ) - 1.0, groupNCF[g], pc[g], vc[g] );
+        }
+        
+        // Interpolate barycentric position and velocity of each series we need.
+        
+        double pv[11][6] = { { 0.0 } };
+        for ( int s = 0; s < 11; s++ )
+        {
+            if ( ! need[s] )
+                continue;
+            
+            int g = seriesGroup[s], ncf = min ( R1.r1.ipt[s][1], 18 );
+            const double *coef = &buf[ R1.r1.ipt[s][0] - 1 + sub[g] * ncf * 3 ];
+            chebyshev_sum ( coef, ncf, pc[g], vc[g], aufac, vfac[g], pv[s] );
+        }
+        
+        // Earth from Earth-Moon barycenter, then barycentric Moon from geocentric Moon.
+        
+        double earth[6] = { 0.0 }, moon[6] = { 0.0 };
+        for ( int j = 0; j < 6; j++ )
+        {
+            earth[j] = pv[2][j] - pv[9][j] / ( 1.0 + R1.r1.emrat );
+            moon[j] = pv[9][j] + earth[j];
+        }
+        
+        for ( size_t k = 0; k < nids; k++ )
+        {
+            int id = ids[k];
+            if ( id < 0 || id > 10 )
+                continue;
+            
+            const double *pBody = id == 0 ? pv[10] : id == 3 ? earth : id == 10 ? moon : pv[id - 1];
+            double rrd[6] = { 0.0 };
+            for ( int j = 0; j < 6; j++ )
+                rrd[j] = pBody[j] - ( bary ? 0.0 : pv[10][j] );
+            
+            positions[ i * nids + k ] = SSVector ( rrd[0], rrd[1], rrd[2] );
+            velocities[ i * nids + k ] = SSVector ( rrd[3], rrd[4], rrd[5] );
+        }
+        
+        n++;
+    }
+    
+    return n;
+}
+
 // Returns ephemeris starting Julian Ephemeris Date
 
 double SSJPLDEphemeris::getStartJED ( void )
@@ -12,17 +12,37 @@
 
 #include <iostream>
 #include <fstream>
+#include <vector>
 
 #include "SSTime.hpp"
 #include "SSAngle.hpp"
 #include "SSVector.hpp"
 
+// Chebyshev polynomial values cached between successive interpolations.
+// The memory-mapped ephemeris path uses one of these per thread (or per call)
+// instead of the original C code's static buffers, so any number of threads
+// may interpolate ephemeris records simultaneously without locking.
+
+struct SSJPLDEphemerisContext
+{
+    double pc[18];      // Chebyshev position polynomial values
+    double vc[18];      // Chebyshev velocity (derivative) polynomial values
+    double twot;        // twice the normalized Chebyshev time at which polynomials were evaluated
+    int np;             // number of position polynomials evaluated so far
+    int nv;             // number of velocity polynomials evaluated so far
+    
+    SSJPLDEphemerisContext ( void );
+};
+
 // CAUTION: This class is a thin C++ wrapper around original C code from:
 // https://apollo.astro.amu.edu.pl/PAD/index.php?n=Dybol.JPLEph
 // This is a singleton class; you should only ever instantiate one of these!
 // It should be thread safe, and is hard-coded to read only the DE43x series
 // in little-endian (Intel) binary format.  It will not read the ASCII format
 // of any ephemeris files, nor the DE43xt series which include time data.
+// By default the ephemeris file is memory-mapped, and positions are computed
+// from the mapped records without locking. If the file can't be mapped,
+// computation falls back to the original C code, serialized by a mutex.
 
 class SSJPLDEphemeris
 {
@@ -30,8 +50,9 @@ public:
     
     // Opens and closes ephemeris file
     
-    static bool open ( const string &filename );
+    static bool open ( const string &filename, bool map = true );
     static bool isOpen ( void );
+    static bool isMapped ( void );
     static void close ( void );
 
     // Gets number of contants, name and value of i-th constant.
@@ -47,8 +68,14 @@ public:
     static double getStep ( void );
 
     // Computes object position and velocity at a given JED.
+    // The second form uses a caller-supplied interpolation context.
     
     static bool compute ( int id, double jde, bool bary, SSVector &position, SSVector &velocity );
+    static bool compute ( SSJPLDEphemerisContext &context, int id, double jde, bool bary, SSVector &position, SSVector &velocity );
+    
+    // Computes positions and velocities of several objects at many JEDs in one call.
+    
+    static int compute ( const vector<int> &ids, const vector<double> &jeds, bool bary, vector<SSVector> &positions, vector<SSVector> &velocities );
 };
 
 #endif /* SSJPLEphemeris_hpp */
@@ -0,0 +1,204 @@
+// SSLineReader.cpp
+// SSCore
+//
+// Created by Tim DeBenedictis on 10/16/26.
+// Copyright © 2026 Southern Stars. All rights reserved.
+//
+// This class reads text files line-by-line much faster than fgetline() or std::getline().
+
+#include <cstring>
+
+#include "SSLineReader.hpp"
+#include "SSUtilities.hpp"
+
+// Constructs a line reader with no file open.
+
+SSLineReader::SSLineReader ( void )
+{
+    _map = nullptr;
+    _mapSize = 0;
+    _file = nullptr;
+    _data = _end = _lf = nullptr;
+    _eof = true;
+    _lines = 0;
+}
+
+// Constructs a line reader and opens a file at the given path.
+// Call isOpen() to see whether the file was opened successfully.
+
+SSLineReader::SSLineReader ( const string &path ) : SSLineReader()
+{
+    open ( path );
+}
+
+// Constructs a line reader which reads lines from a block of memory (data) containing (size) bytes.
+
+SSLineReader::SSLineReader ( const char *data, size_t size ) : SSLineReader()
+{
+    open ( data, size );
+}
+
+// Destructor closes the file if it is open.
+
+SSLineReader::~SSLineReader ( void )
+{
+    close();
+}
+
+// Opens a file at the given path for reading, closing any file already open.
+// The file is memory-mapped if possible; otherwise it is opened for buffered reading.
+// Returns true if successful or false on failure.
+
+bool SSLineReader::open ( const string &path )
+{
+    close();
+
+    _map = (const char *) mapfile ( path, _mapSize );
+    if ( _map != nullptr )
+    {
+        _data = _map;
+        _end = _map + _mapSize;
+        return true;
+    }
+
+    // Memory mapping fails on empty files, too. Those open normally,
+    // and then return no lines.
+
+    _file = fopen ( path.c_str(), "rb" );
+    if ( _file == nullptr )
+        return false;
+
+    _eof = false;
+    return true;
+}
+
+// Reads lines from a block of memory (data) containing (size) bytes, closing any file already open.
+// The memory is not copied or released by this reader; the caller must keep it valid while reading.
+// Returns true if successful or false if (data) is nullptr.
+
+bool SSLineReader::open ( const char *data, size_t size )
+{
+    close();
+
+    if ( data == nullptr )
+        return false;
+
+    _data = data;
+    _end = data + size;
+    return true;
+}
+
+// Closes the file and releases its memory mapping or buffer.
+// Lines returned by readLine() as string_views are no longer valid afterwards.
+
+void SSLineReader::close ( void )
+{
+    if ( _map != nullptr )
+        unmapfile ( _map, _mapSize );
+
+    if ( _file != nullptr )
+        fclose ( _file );
+
+    _map = nullptr;
+    _mapSize = 0;
+    _file = nullptr;
+    _buffer.clear();
+    _buffer.shrink_to_fit();
+    _data = _end = _lf = nullptr;
+    _eof = true;
+    _lines = 0;
+}
+
+// Moves unread data to the start of the buffer, then reads as much of the file as fits into the rest.
+// The buffer doubles in size if it is already full of unread data, so lines may be any length.
+// Returns false if no more data could be read.
+
+bool SSLineReader::fill ( void )
+{
+    if ( _eof || _file == nullptr )
+        return false;
+
+    size_t unread = _end - _data;
+    size_t offset = _buffer.empty() ? 0 : _data - _buffer.data();
+    if ( _buffer.empty() )
+        _buffer.resize ( kBufferSize );
+    else if ( unread == _buffer.size() )
+        _buffer.resize ( _buffer.size() * 2 );
+
+    if ( unread > 0 && offset > 0 )
+        memmove ( _buffer.data(), _buffer.data() + offset, unread );
+
+    size_t bytes = fread ( _buffer.data() + unread, 1, _buffer.size() - unread, _file );
+    if ( bytes < _buffer.size() - unread )
+        _eof = true;
+
+    _data = _buffer.data();
+    _end = _data + unread + bytes;
+    _lf = nullptr;
+    return bytes > 0;
+}
+
+// Reads the next line from the file into a string_view (line), excluding line ending characters.
+// The view points into the file's memory mapping or read buffer, and remains valid only until
+// the next call to readLine() or close(). Returns true if successful or false at end-of-file.
+
+bool SSLineReader::readLine ( string_view &line )
+{
+    while ( true )
+    {
+        // Look for the next line ending: the next LF, unless a CR comes before it. Remember where
+        // the next LF is, so files with CR line endings are not searched to the end for every line.
+        // If we find a line ending, and it is not a CR at the end of the buffer which may be
+        // the first half of a CRLF, return the line before it.
+
+        if ( _lf == nullptr || _lf < _data )
+        {
+            _lf = (const char *) memchr ( _data, '\n', _end - _data );
+            if ( _lf == nullptr )
+                _lf = _end;
+        }
+
+        const char *p = (const char *) memchr ( _data, '\r', _lf - _data );
+        if ( p == nullptr )
+            p = _lf;
+
+        if ( p < _end && ( p + 1 < _end || *p == '\n' || _eof ) )
+        {
+            line = string_view ( _data, p - _data );
+            _data = ( *p == '\r' && p + 1 < _end && p[1] == '\n' ) ? p + 2 : p + 1;
+            _lines++;
+            return true;
+        }
+
+        // Otherwise, read more of the file. At end-of-file, a CR found above ends the line;
+        // otherwise return the last line, if it does not end with a line ending.
+
+        if ( ! fill() )
+        {
+            if ( p < _end )
+                continue;
+
+            if ( _data == _end )
+                return false;
+
+            line = string_view ( _data, _end - _data );
+            _data = _end;
+            _lines++;
+            return true;
+        }
+    }
+}
+
+// Reads the next line from the file into a C++ string (line), excluding line ending characters.
+// Returns true if successful or false at end-of-file.
+
+bool SSLineReader::readLine ( string &line )
+{
+    string_view view;
+
+    if ( ! readLine ( view ) )
+        return false;
+
+    line.assign ( view.data(), view.size() );
+    return true;
+}
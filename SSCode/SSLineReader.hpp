@@ -0,0 +1,61 @@
+// SSLineReader.hpp
+// SSCore
+//
+// Created by Tim DeBenedictis on 10/16/26.
+// Copyright © 2026 Southern Stars. All rights reserved.
+//
+// This class reads text files line-by-line much faster than fgetline() or std::getline().
+// The whole file is memory-mapped when possible; otherwise it is read through a large buffer.
+// Lines are returned as string_views into the mapping or buffer, without copying; each view
+// is valid only until the next call to readLine(). Line endings in LF (Unix/Mac), CRLF (Windows),
+// or CR (Classic MacOS) are all recognized and discarded. Combine with split_csv() to tokenize
+// CSV files without allocating a string per field. Lines can also be read from a block of memory,
+// such as one chunk of a larger mapped file, which the caller owns and must keep valid.
+
+#ifndef SSLineReader_hpp
+#define SSLineReader_hpp
+
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+
+class SSLineReader
+{
+protected:
+
+    const char  *_map;          // start of memory-mapped file; nullptr if file is not mapped
+    size_t      _mapSize;       // size of memory-mapped file in bytes
+    FILE        *_file;         // file being read through buffer, if not memory-mapped
+    vector<char> _buffer;       // buffer holding unread data from file, if not memory-mapped
+    const char  *_data;         // start of data not yet read from mapping or buffer
+    const char  *_end;          // end of data not yet read from mapping or buffer
+    const char  *_lf;           // next LF at or after _data, or _end if none; nullptr if not yet searched
+    bool        _eof;           // true when all of the file's data has been read into mapping or buffer
+    size_t      _lines;         // number of lines read so far
+
+    bool fill ( void );
+
+public:
+
+    static constexpr size_t kBufferSize = 1 << 20;      // default read buffer size in bytes
+
+    SSLineReader ( void );
+    SSLineReader ( const string &path );
+    SSLineReader ( const char *data, size_t size );
+    virtual ~SSLineReader ( void );
+
+    bool open ( const string &path );
+    bool open ( const char *data, size_t size );
+    void close ( void );
+    bool isOpen ( void ) { return _data != nullptr || _file != nullptr; }
+    bool isMapped ( void ) { return _map != nullptr; }
+    size_t lineNumber ( void ) { return _lines; }
+
+    bool readLine ( string_view &line );
+    bool readLine ( string &line );
+};
+
+#endif /* SSLineReader_hpp */
@@ -948,14 +948,14 @@ and velocities with one relatively simple function.
 
 #define DEGREES_TO_RADIANS (PI/180.)
 
-static double an[5], ae[5], ai[5];         // satellite position data
+static thread_local double an[5], ae[5], ai[5];         // satellite position data, per thread
 
 //   OrbitalPosition
 //   Compute basic orbital position data for the satellites.
 
 static void gust86_mean_parameters( const double jde )
 {
-   static double curr_jde_set = -1.;
+   static thread_local double curr_jde_set = -1.;
 
    if( jde != curr_jde_set)
       {
@@ -1825,8 +1825,8 @@ bool jupiterMoonPosition ( int id, double jed, SSVector &pos )
     
     // transform from ecliptic frame of date to J2000 equatorial frame.
     
-    static double matrixJED = 0.0;
-    static SSMatrix matrix;
+    static thread_local double matrixJED = 0.0;
+    static thread_local SSMatrix matrix;
     
     if ( jed != matrixJED )
     {
@@ -9,6 +9,8 @@
 // Meade LX-200/Autostar, Celestron NexStar, and SkyWatcher/Orion SynScan.
 
 #include <thread>
+#include <algorithm>
+#include <cassert>
 #if defined ( __APPLE__ ) || defined ( __linux__ )
 #include <signal.h>
 #endif
@@ -158,6 +160,9 @@ SSMount::SSMount ( SSMountType type, SSCoordinates &coords ) : _coords ( coords
     
     _retries = 1;
     _timeout = 3000;
+    
+    _rxBuffer.resize ( kReceiveBufferSize );
+    _rxStart = _rxCount = 0;
 
     _initLon = _initLat = 0;
     _currLon = _currLat = 0;
@@ -173,12 +178,19 @@ SSMount::SSMount ( SSMountType type, SSCoordinates &coords ) : _coords ( coords
     
     _logFile = NULL;
     _logStart = 0;
+    
+    _asyncExit = false;
+    _asyncStats = { 0 };
+    _asyncLatencyNext = 0;
 }
 
-// Destructor disconnects any open serial or socket connection.
+// Destructor disconnects any open serial or socket connection. The asynchronous command
+// worker must already have been stopped by disconnect() or stopAsyncWorker(), since queued
+// commands call subclass overrides which are destroyed before this destructor runs.
 
 SSMount::~SSMount ( void )
 {
+    assert ( ! _asyncThread.joinable() );
     closeLog();
     disconnect();
 }
@@ -268,10 +280,13 @@ SSMount::Error SSMount::connect ( const string &path, uint16_t port, int baud, i
     return kSuccess;
 }
 
-// Closes serial or socket connection to mount
+// Closes serial or socket connection to mount. First stops the asynchronous command
+// worker, since queued commands can't be sent without a connection.
 
 SSMount::Error SSMount::disconnect ( void )
 {
+    stopAsyncWorker();
+    
     if ( _socket.socketOpen() )
         _socket.closeSocket();
     
@@ -280,10 +295,146 @@ SSMount::Error SSMount::disconnect ( void )
     
     _addr = SSIP();
     _port = 0;
+    _rxStart = _rxCount = 0;
     _connected = false;
     return kSuccess;
 }
 
+// Discards all bytes received from the mount but not yet returned as command output:
+// both those in our receive buffer, and those waiting in the serial port or TCP socket.
+// Returns zero if successful or nonzero error code on failure.
+
+SSMount::Error SSMount::flushInput ( void )
+{
+    _rxStart = _rxCount = 0;
+    
+    // UDP datagrams must be read whole, so read and discard them while any are waiting.
+    // Don't wait for one with a receive timeout; those are rounded up to the system clock tick.
+    
+    if ( ! _serial.portOpen() && _socket.isUDPSocket() )
+    {
+        SSIP sender;
+        while ( _socket.waitSocket ( 0 ) > 0 )
+            if ( _socket.readUDPSocket ( &_rxBuffer[0], (int) _rxBuffer.size(), sender, 1 ) < 0 )
+            {
+#ifndef _MSC_VER    // This is an expected failure on Windows; calling recvfrom() before sendto() will not implicitly bind the socket.
+                return kReadFail;
+#else
+                break;
+#endif
+            }
+        return kSuccess;
+    }
+    
+    int bytes = _serial.portOpen() ? _serial.inputBytes() : _socket.readSocket ( nullptr, 0 );
+    if ( bytes < 0 )
+        return kReadFail;
+    
+    while ( bytes > 0 )
+    {
+        int n = min ( bytes, (int) _rxBuffer.size() );
+        if ( ( _serial.portOpen() ? _serial.readPort ( &_rxBuffer[0], n ) : _socket.readSocket ( &_rxBuffer[0], n ) ) != n )
+            return kReadFail;
+        
+        bytes -= n;
+    }
+    
+    return kSuccess;
+}
+
+// Waits up to (timeout_ms) milliseconds for bytes from the mount's serial port or TCP socket,
+// then reads as many as are available, up to the free space at the end of the receive buffer.
+// Blocks in poll() rather than sleeping, so returns as soon as any bytes arrive.
+// Returns zero if any bytes were read, kTimedOut if none arrived, or kReadFail on failure,
+// including when the TCP connection has been closed.
+
+SSMount::Error SSMount::fillReceiveBuffer ( int timeout_ms )
+{
+    size_t size = _rxBuffer.size();
+    size_t end = ( _rxStart + _rxCount ) % size;
+    int space = (int) min ( size - _rxCount, size - end );
+    if ( space < 1 )
+        return kSuccess;
+    
+    int ready = _serial.portOpen() ? _serial.waitInput ( timeout_ms ) : _socket.waitSocket ( timeout_ms );
+    if ( ready < 0 )
+        return kReadFail;
+    else if ( ready == 0 )
+        return kTimedOut;
+    
+    // Only read the bytes available from a serial port, since reads may otherwise block until
+    // the buffer is full on some platforms. A readable port or socket with no bytes to read
+    // has been disconnected or closed by the mount.
+    
+    int bytes = 0;
+    if ( _serial.portOpen() )
+    {
+        bytes = min ( space, _serial.inputBytes() );
+        if ( bytes > 0 )
+            bytes = _serial.readPort ( &_rxBuffer[ end ], bytes );
+    }
+    else
+    {
+        bytes = _socket.readSocket ( &_rxBuffer[ end ], space );
+    }
+    
+    if ( bytes < 1 )
+        return kReadFail;
+    
+    _rxCount += bytes;
+    return kSuccess;
+}
+
+// Reads bytes received from the mount into (output) until a terminator character (term) is received,
+// (outlen) bytes are read, or (timeout_ms) milliseconds elapse. Scans the receive buffer for the
+// terminator a block at a time; bytes following the terminator are kept in the buffer.
+// Number of bytes actually read is returned in (bytesRead). Returns zero if successful or error code.
+
+SSMount::Error SSMount::readReply ( char *output, int outlen, char term, int timeout_ms, int &bytesRead )
+{
+    Error err = kSuccess;
+    double start = clocksec();
+    
+    bytesRead = 0;
+    while ( true )
+    {
+        // Copy contiguous runs of buffered bytes to output, stopping after any terminator.
+        
+        while ( _rxCount > 0 && bytesRead < outlen )
+        {
+            size_t n = min ( min ( _rxCount, _rxBuffer.size() - _rxStart ), (size_t) ( outlen - bytesRead ) );
+            const char *pStart = &_rxBuffer[ _rxStart ];
+            const char *pTerm = term ? (const char *) memchr ( pStart, term, n ) : nullptr;
+            if ( pTerm )
+                n = pTerm - pStart + 1;
+            
+            memcpy ( output + bytesRead, pStart, n );
+            bytesRead += (int) n;
+            _rxStart = ( _rxStart + n ) % _rxBuffer.size();
+            _rxCount -= n;
+            
+            if ( pTerm )
+                return kSuccess;
+        }
+        
+        if ( bytesRead == outlen )
+            return kSuccess;
+        
+        int remaining = timeout_ms - (int) ( ( clocksec() - start ) * 1000.0 );
+        if ( remaining <= 0 )
+            return kTimedOut;
+        
+        // Reset an empty ring buffer to its start, so the next read can use all of it.
+        
+        if ( _rxCount == 0 )
+            _rxStart = 0;
+        
+        err = fillReceiveBuffer ( remaining );
+        if ( err == kReadFail )
+            return err;
+    }
+}
+
 // Sends data (input) to telescope mount via serial port, and optionally waits for output.
 // If input length (inlen) is zero, will use input string length unless input is null.
 // If input length is zero and input is null, nothing will be sent to mount.
@@ -305,13 +456,8 @@ SSMount::Error SSMount::serialCommand ( const char *input, int inlen, char *outp
     {
         // First clear out any bytes remaining in the serial input buffer
         
-        int bytes = _serial.inputBytes();
-        if ( bytes > 0 )
-        {
-            vector<char> junk ( bytes );
-            if ( _serial.readPort ( &junk[0], bytes ) < bytes )
-                return kReadFail;
-        }
+        if ( flushInput() )
+            return kReadFail;
 
         // Then send command input to the serial port.
         
@@ -330,35 +476,11 @@ SSMount::Error SSMount::serialCommand ( const char *input, int inlen, char *outp
     if ( outlen < 1 || output == nullptr )
         return kSuccess;
 
-    // Otherwise read output data from the serial port, one byte at a time,
-    // until we receieve a terminator character, fill the output buffer, or time out.
+    // Otherwise read output data from the serial port until we receieve
+    // a terminator character, fill the output buffer, or time out.
     
     int bytesRead = 0;
-    double start = clocksec();
-    while ( err == kSuccess )
-    {
-        int bytes = _serial.inputBytes();
-        if ( bytes < 0 )
-        {
-            err = kReadFail;
-            break;
-        }
-        else if ( bytes < 1 )
-        {
-            msleep ( 1 );
-            if ( clocksec() - start > timeout_ms / 1000.0 )
-                err = kTimedOut;
-            continue;
-        }
-
-        bytes = _serial.readPort ( output + bytesRead, 1 );
-        if ( bytes < 1 )
-            err = kReadFail;
-        else
-            bytesRead += bytes;
-        if ( ( term && output[ bytesRead - 1 ] == term ) || bytesRead == outlen )
-            break;
-    }
+    err = readReply ( output, outlen, term, timeout_ms, bytesRead );
     
     // Log what we received, return any error code
     
@@ -392,34 +514,12 @@ SSMount::Error SSMount::socketCommand ( const char *input, int inlen, char *outp
     {
         // First clear out any bytes currently remaining to be received
         
-        int bytes = 0;
-        if ( udp )
-        {
-            SSIP sender;
-            char junk = 0;
-            do
-            {
-                bytes = _socket.readUDPSocket ( &junk, 1, sender, 1 );
-#ifndef _MSC_VER    // This is an expected failure on Windows; calling recvfrom() before sendto() will not implicitly bind the socket.
-                if ( bytes < 0 )
-                    return kReadFail;
-#endif
-            }
-            while ( bytes > 0 );
-        }
-        else
-        {
-            int bytes = _socket.readSocket ( nullptr, 0 );
-            if ( bytes > 0 )
-            {
-                vector<char> junk ( bytes );
-                if ( _socket.readSocket ( &junk[0], bytes ) != bytes )
-                    return kReadFail;
-            }
-        }
+        if ( flushInput() )
+            return kReadFail;
         
         // Now send command input to the TCP or UDP socket
         
+        int bytes = 0;
         if ( udp )
             bytes = _socket.writeUDPSocket ( input, inlen, _addr, _port );
         else
@@ -440,8 +540,8 @@ SSMount::Error SSMount::socketCommand ( const char *input, int inlen, char *outp
     if ( outlen < 1 || output == nullptr )
         return kSuccess;
 
-    // Otherwise read output data from the socket, one byte at a time,
-    // until we receieve a terminator character, fill the output buffer, or time out.
+    // Otherwise read output data from the socket until we receieve
+    // a terminator character, fill the output buffer, or time out.
     
     int bytesRead = 0;
     if ( udp )
@@ -455,31 +555,7 @@ SSMount::Error SSMount::socketCommand ( const char *input, int inlen, char *outp
     }
     else
     {
-        double start = clocksec();
-        while ( err == kSuccess )
-        {
-            int bytes = _socket.readSocket ( nullptr, 0 );
-            if ( bytes < 0 )
-            {
-                err = kReadFail;
-                break;
-            }
-            else if ( bytes < 1 )
-            {
-                msleep ( 1 );
-                if ( clocksec() - start > timeout_ms / 1000.0 )
-                    err = kTimedOut;
-                continue;
-            }
-            
-            bytes = _socket.readSocket ( output + bytesRead, 1 );
-            if ( bytes < 1 )
-                err = kReadFail;
-            else
-                bytesRead += bytes;
-            if ( ( term && output[ bytesRead - 1 ] == term ) || bytesRead == outlen )
-                break;
-        }
+        err = readReply ( output, outlen, term, timeout_ms, bytesRead );
     }
         
     // Log what we received, return any error code
@@ -525,6 +601,91 @@ SSMount::Error SSMount::command ( const string &instr, string &outstr, int outle
     return result;
 }
 
+// Sends several commands (inputs) to the telescope mount at once, without waiting for each reply
+// before sending the next, then reads one reply to each command into (outputs). Each reply is up to
+// (outlen) bytes long and ends with a terminator character (term); over UDP, each is one datagram.
+// A reply identical to its command is taken to be an echo (from mounts whose serial transmit and
+// receive lines are connected together) and skipped. Only use with protocols whose controllers
+// queue commands and answer them in order. Timeout (timeout_ms) applies to each reply.
+// Returns zero if successful or nonzero error code on failure.
+
+SSMount::Error SSMount::pipeline ( const vector<string> &inputs, vector<string> &outputs, int outlen, char term, int timeout_ms )
+{
+    Error err = kInvalidInput;
+    
+    if ( timeout_ms == 0 )
+        timeout_ms = _timeout;
+    
+    vector<char> output ( outlen + 1 );
+    for ( int i = 0; i < _retries && err != kSuccess; i++ )
+    {
+        bool udp = _socket.isUDPSocket();
+        if ( ! _serial.portOpen() && ! _socket.socketOpen() )
+            return kInvalidInput;
+        
+        err = flushInput();
+        if ( err )
+            continue;
+        
+        // Send all commands; over TCP or serial, in a single write.
+        
+        string input;
+        for ( const string &in : inputs )
+        {
+            if ( udp )
+            {
+                if ( _socket.writeUDPSocket ( in.c_str(), (int) in.length(), _addr, _port ) != (int) in.length() )
+                    err = kWriteFail;
+                writeLog ( true, in.c_str(), (int) in.length(), err );
+            }
+            else
+            {
+                input += in;
+            }
+        }
+        
+        if ( ! udp )
+        {
+            int bytes = _serial.portOpen() ? _serial.writePort ( input.c_str(), input.length() ) : _socket.writeSocket ( input.c_str(), (int) input.length() );
+            if ( bytes != (int) input.length() )
+                err = kWriteFail;
+            writeLog ( true, input.c_str(), (int) input.length(), err );
+        }
+        
+        if ( err )
+            continue;
+        
+        // Then read replies in order.
+        
+        outputs.clear();
+        for ( size_t k = 0; k < inputs.size() && err == kSuccess; k++ )
+        {
+            int bytesRead = 0;
+            do
+            {
+                if ( udp )
+                {
+                    SSIP sender;
+                    bytesRead = _socket.readUDPSocket ( &output[0], outlen, sender, timeout_ms );
+                    err = bytesRead < 0 ? kReadFail : bytesRead < 1 ? kTimedOut : kSuccess;
+                }
+                else
+                {
+                    err = readReply ( &output[0], outlen, term, timeout_ms, bytesRead );
+                }
+                
+                writeLog ( false, &output[0], max ( bytesRead, 0 ), err );
+            }
+            while ( err == kSuccess && inputs[k].compare ( 0, string::npos, &output[0], bytesRead ) == 0 );
+            
+            if ( err == kSuccess )
+                outputs.push_back ( string ( &output[0], bytesRead ) );
+        }
+    }
+    
+    return err;
+}
+
 // Sends string (instr) to telescope mount and does not waits for any output.
 // Returns zero if successful or nonzero error code on failure.
 
@@ -859,99 +1020,250 @@ void SSMount::mountToFundamental ( SSAngle lon, SSAngle lat, SSAngle &ra, SSAngl
     ra = lon; dec = lat;
 }
 
-// Aynchronous read command. Launches read() in a background thread,
-// calls callback with error code and userData when command returns.
-// Obtain updated mount RA/Dec with getRA and getDec() accessors.
+// Aynchronous read command. Queues read() for the mount's worker thread, behind any stop, slew,
+// or sync commands; if a read is already queued, this request is merged into it instead.
+// Calls callback with error code and userData when command returns; the returned result also
+// receives the error code. Obtain updated mount RA/Dec with getRA and getDec() accessors.
 
-void SSMount::readAsync ( AsyncCmdCallback callback, void *userData )
+SSMount::AsyncResult SSMount::readAsync ( AsyncCmdCallback callback, void *userData )
 {
-    auto func = [=] ( SSMountPtr pMount )
+    auto func = [this] ( void )
     {
         SSAngle ra, dec;
-        pMount->lockMutex ( true );
-        Error err = pMount->read ( ra, dec );
-        pMount->lockMutex ( false );
-        if ( callback )
-            callback ( pMount, err, userData );
+        return read ( ra, dec );
     };
     
-    thread t = thread ( func, this );
-    t.detach();
+    return queueAsync ( kAsyncRead, func, callback, userData );
 }
 
-// Aynchronous GoTo command. Launches slew() in a background thread,
+// Aynchronous GoTo command. Queues slew() for the mount's worker thread,
 // calls callback with error code and userData when command returns.
 // GoTo target ra and dec are identical to synchronous slew() inputs.
 
-void SSMount::slewAsync ( SSAngle ra, SSAngle dec, AsyncCmdCallback callback, void *userData )
+SSMount::AsyncResult SSMount::slewAsync ( SSAngle ra, SSAngle dec, AsyncCmdCallback callback, void *userData )
 {
-    auto func = [=] ( SSMountPtr pMount )
+    auto func = [this, ra, dec] ( void )
     {
-        pMount->lockMutex ( true );
-        Error err = pMount->slew ( ra, dec );
-        pMount->lockMutex ( false );
-        if ( callback )
-            callback ( pMount, err, userData );
+        return slew ( ra, dec );
     };
-
-    thread t = thread ( func, this );
-    t.detach();
+    
+    return queueAsync ( kAsyncSlew, func, callback, userData );
 }
 
-// Aynchronous slew command. Launches slew() in a background thread,
+// Aynchronous slew command. Queues slew() for the mount's worker thread,
 // calls callback with error code and userData when command returns.
 // Slew axis and rate are identical to synchronous slew() inputs.
 
-void SSMount::slewAsync ( SSSlewAxis axis, int rate, AsyncCmdCallback callback, void *userData )
+SSMount::AsyncResult SSMount::slewAsync ( SSSlewAxis axis, int rate, AsyncCmdCallback callback, void *userData )
 {
-    auto func = [=] ( SSMountPtr pMount )
+    auto func = [this, axis, rate] ( void )
     {
-        pMount->lockMutex ( true );
-        Error err = pMount->slew ( axis, rate );
-        pMount->lockMutex ( false );
-        if ( callback )
-            callback ( pMount, err, userData );
+        return slew ( axis, rate );
     };
-
-    thread t = thread ( func, this );
-    t.detach();
+    
+    return queueAsync ( kAsyncSlew, func, callback, userData );
 }
 
-// Aynchronous stop command. Launches stop() in a background thread,
-// calls callback with error code and userData when command returns.
+// Aynchronous stop command. Queues stop() for the mount's worker thread ahead of all other commands,
+// and cancels any slew commands still queued; calls callback with error code and userData when command returns.
 
-void SSMount::stopAsync ( AsyncCmdCallback callback, void *userData )
+SSMount::AsyncResult SSMount::stopAsync ( AsyncCmdCallback callback, void *userData )
 {
-    auto func = [=] ( SSMountPtr pMount )
+    auto func = [this] ( void )
     {
-        pMount->lockMutex ( true );
-        Error err = pMount->stop();
-        pMount->lockMutex ( false );
-        if ( callback )
-            callback ( pMount, err, userData );
+        return stop();
     };
-
-    thread t = thread ( func, this );
-    t.detach();
+    
+    return queueAsync ( kAsyncStop, func, callback, userData );
 }
 
-// Aynchronous sync command. Launches sync() in a background thread,
+// Aynchronous sync command. Queues sync() for the mount's worker thread,
 // calls callback with error code and userData when command returns.
 // Sync target ra and dec are identical to synchronous sync() inputs.
 
-void SSMount::syncAsync ( SSAngle ra, SSAngle dec, AsyncCmdCallback callback, void *userData )
+SSMount::AsyncResult SSMount::syncAsync ( SSAngle ra, SSAngle dec, AsyncCmdCallback callback, void *userData )
 {
-    auto func = [=] ( SSMountPtr pMount )
+    auto func = [this, ra, dec] ( void )
     {
-        pMount->lockMutex ( true );
-        Error err = pMount->sync ( ra, dec );
-        pMount->lockMutex ( false );
-        if ( callback )
-            callback ( pMount, err, userData );
+        return sync ( ra, dec );
     };
+    
+    return queueAsync ( kAsyncSync, func, callback, userData );
+}
 
-    thread t = thread ( func, this );
-    t.detach();
+// Calls an asynchronous command's callbacks with an error code (err), then stores the error code in its result.
+
+static void completeAsync ( SSMount *pMount, list<pair<SSMount::AsyncCmdCallback,void *>> &callbacks, promise<SSMount::Error> &result, SSMount::Error err )
+{
+    for ( auto &callback : callbacks )
+        callback.first ( pMount, err, callback.second );
+    
+    result.set_value ( err );
+}
+
+// Queues an asynchronous command of the given type, which calls a synchronous command function (func),
+// for the worker thread; starts the worker thread if needed. Commands are queued in order of type
+// priority, then age. A read is merged into any read already queued, and a stop cancels all queued slews.
+// The callback, if not null, is called with the command's error code and (userData) when it completes.
+// Returns the command's result.
+
+SSMount::AsyncResult SSMount::queueAsync ( AsyncCmdType type, function<Error(void)> func, AsyncCmdCallback callback, void *userData )
+{
+    list<AsyncCmd> cancelled;
+    AsyncResult result;
+    
+    unique_lock<mutex> lock ( _asyncMtx );
+    
+    if ( type == kAsyncRead )
+    {
+        for ( AsyncCmd &cmd : _asyncQueue )
+        {
+            if ( cmd.type == kAsyncRead )
+            {
+                if ( callback )
+                    cmd.callbacks.push_back ( { callback, userData } );
+                _asyncStats.coalesced++;
+                return cmd.future;
+            }
+        }
+    }
+    
+    if ( type == kAsyncStop )
+    {
+        for ( auto it = _asyncQueue.begin(); it != _asyncQueue.end(); )
+        {
+            if ( it->type == kAsyncSlew )
+                cancelled.splice ( cancelled.end(), _asyncQueue, it++ );
+            else
+                it++;
+        }
+        
+        _asyncStats.cancelled += cancelled.size();
+    }
+    
+    AsyncCmd cmd;
+    cmd.type = type;
+    cmd.func = func;
+    if ( callback )
+        cmd.callbacks.push_back ( { callback, userData } );
+    cmd.future = cmd.result.get_future().share();
+    cmd.queued = clocksec();
+    result = cmd.future;
+    
+    auto it = find_if ( _asyncQueue.begin(), _asyncQueue.end(), [type] ( const AsyncCmd &cmd ) { return cmd.type > type; } );
+    _asyncQueue.insert ( it, std::move ( cmd ) );
+    _asyncStats.maxQueueDepth = max ( _asyncStats.maxQueueDepth, _asyncQueue.size() );
+    
+    if ( ! _asyncThread.joinable() )
+        _asyncThread = thread ( &SSMount::asyncWorker, this );
+    
+    lock.unlock();
+    _asyncCond.notify_one();
+    
+    for ( AsyncCmd &cmd : cancelled )
+        completeAsync ( this, cmd.callbacks, cmd.result, kCancelled );
+    
+    return result;
+}
+
+// Worker thread function: sends queued asynchronous commands to the mount, one at a time,
+// highest priority first, while holding the command mutex. Records each command's latency
+// from queueing to completion. Exits when stopAsyncWorker() is called.
+
+void SSMount::asyncWorker ( void )
+{
+    while ( true )
+    {
+        unique_lock<mutex> lock ( _asyncMtx );
+        _asyncCond.wait ( lock, [this] { return _asyncExit || ! _asyncQueue.empty(); } );
+        if ( _asyncExit )
+            break;
+        
+        AsyncCmd cmd = std::move ( _asyncQueue.front() );
+        _asyncQueue.pop_front();
+        lock.unlock();
+        
+        _cmdMtx.lock();
+        Error err = cmd.func();
+        _cmdMtx.unlock();
+        
+        double latency = ( clocksec() - cmd.queued ) * 1000.0;
+        lock.lock();
+        _asyncStats.commands++;
+        if ( _asyncLatency.size() < kLatencySamples )
+            _asyncLatency.push_back ( latency );
+        else
+            _asyncLatency[ _asyncLatencyNext ] = latency;
+        _asyncLatencyNext = ( _asyncLatencyNext + 1 ) % kLatencySamples;
+        lock.unlock();
+        
+        completeAsync ( this, cmd.callbacks, cmd.result, err );
+    }
+}
+
+// Stops the asynchronous command worker thread, after it finishes any command in progress.
+// Commands still queued are cancelled. The worker restarts when another command is queued.
+// If called from the worker thread itself, e.g. from a completion callback, the worker can't
+// join itself; so queued commands are cancelled, but the worker keeps running.
+
+void SSMount::stopAsyncWorker ( void )
+{
+    list<AsyncCmd> cancelled;
+    bool worker = this_thread::get_id() == _asyncThread.get_id();
+    
+    unique_lock<mutex> lock ( _asyncMtx );
+    _asyncExit = ! worker;
+    cancelled.splice ( cancelled.end(), _asyncQueue );
+    _asyncStats.cancelled += cancelled.size();
+    lock.unlock();
+    
+    if ( ! worker )
+    {
+        _asyncCond.notify_all();
+        if ( _asyncThread.joinable() )
+            _asyncThread.join();
+        
+        lock.lock();
+        _asyncExit = false;
+        lock.unlock();
+    }
+    
+    for ( AsyncCmd &cmd : cancelled )
+        completeAsync ( this, cmd.callbacks, cmd.result, kCancelled );
+}
+
+// Obtains asynchronous command queue statistics, including current queue depth
+// and percentiles of the most recent command latencies.
+
+void SSMount::getAsyncStatistics ( AsyncStats &stats )
+{
+    unique_lock<mutex> lock ( _asyncMtx );
+    stats = _asyncStats;
+    stats.queueDepth = _asyncQueue.size();
+    vector<double> latency = _asyncLatency;
+    lock.unlock();
+    
+    double percentiles[3] = { 0.5, 0.9, 0.99 };
+    for ( int i = 0; i < 3; i++ )
+    {
+        stats.latency[i] = 0.0;
+        if ( latency.size() > 0 )
+        {
+            auto it = latency.begin() + min ( latency.size() - 1, (size_t) ( percentiles[i] * latency.size() ) );
+            nth_element ( latency.begin(), it, latency.end() );
+            stats.latency[i] = *it;
+        }
+    }
+}
+
+// Resets asynchronous command queue statistics to zero.
+
+void SSMount::resetAsyncStatistics ( void )
+{
+    unique_lock<mutex> lock ( _asyncMtx );
+    _asyncStats = { 0 };
+    _asyncLatency.clear();
+    _asyncLatencyNext = 0;
 }
 
 // Overrides and mount-specific methods for Celestron NexStar and SkyWatcher/Orion SynScan controllers.
@@ -1882,12 +2194,11 @@ SSSyntaMount::SSSyntaMount ( SSMountType type, SSCoordinates &coords ) : SSMount
     _aligned = false;
 }
 
-// Sends 1-byte Synta motor command and listens for response.
-// For RA/Azm motor, axis = 0. For Dec/Alt motor, axis = 1.
-// Payload data associated with command may be zero-length.
-// Returns error code or zero if successful.
+// Formats 1-byte Synta motor command (cmd) with payload data (indata) for an axis:
+// for RA/Azm motor, axis = 0; for Dec/Alt motor, axis = 1. Payload may be zero-length.
+// Note mount expects RA/Azm axis = 1 and Alt/Dec axis = 2!
 
-SSMount::Error SSSyntaMount::motorCommand ( int axis, char cmd, string indata, string &outdata )
+string SSSyntaMount::motorInput ( int axis, char cmd, string indata )
 {
     // If we have input data, swap byte order
     
@@ -1902,19 +2213,14 @@ SSMount::Error SSSyntaMount::motorCommand ( int axis, char cmd, string indata, s
         swap ( indata[1], indata[3] );
     }
 
-    // format and send command, listen for response, return if error.
-    // Note mount expects RA/Azm axis = 1 and Alt/Dec axis = 2!
-    // On most Alt/Az mounts, serial TX and RX lines are connected together
-    // so the command will be echoed before the response.
-    // If we see this, keep reading to get the real response.
-    
-    string output, input = formstr ( ":%c%d%s\r", cmd, axis + 1, indata.c_str() );
-    Error err = command ( input, output, 10, '\r' );
-    if ( err == kSuccess && output.compare ( input ) == 0 )
-        err = command ( "", output, 10, '\r' );
-    if ( err != kSuccess )
-        return err;
+    return formstr ( ":%c%d%s\r", cmd, axis + 1, indata.c_str() );
+}
+
+// Checks Synta motor controller response (output) and extracts its payload data into (outdata).
+// Returns error code or zero if successful.
 
+SSMount::Error SSSyntaMount::motorOutput ( string output, string &outdata )
+{
     // Newer SynScan Wi-Fi link echoes back a CR before the real response;
     // unsure why, but this fixes it.
     
@@ -1943,6 +2249,28 @@ SSMount::Error SSSyntaMount::motorCommand ( int axis, char cmd, string indata, s
     return kSuccess;
 }
 
+// Sends 1-byte Synta motor command and listens for response.
+// For RA/Azm motor, axis = 0. For Dec/Alt motor, axis = 1.
+// Payload data associated with command may be zero-length.
+// Returns error code or zero if successful.
+
+SSMount::Error SSSyntaMount::motorCommand ( int axis, char cmd, string indata, string &outdata )
+{
+    // format and send command, listen for response, return if error.
+    // On most Alt/Az mounts, serial TX and RX lines are connected together
+    // so the command will be echoed before the response.
+    // If we see this, keep reading to get the real response.
+    
+    string output, input = motorInput ( axis, cmd, indata );
+    Error err = command ( input, output, 10, '\r' );
+    if ( err == kSuccess && output.compare ( input ) == 0 )
+        err = command ( "", output, 10, '\r' );
+    if ( err != kSuccess )
+        return err;
+
+    return motorOutput ( output, outdata );
+}
+
 // Opens serial or socket connection to Synta direct motor controller and reads controller firmware version string.
 // If port is zero, path is a serial device file (like "/dev/ttyUSBserial0" on Linux or "\\.\COM3" on Windows)
 // If port is nonzero, path is mount IP address or fully-qualified domain name (like "192.168.4.1")
@@ -2207,6 +2535,43 @@ SSMount::Error SSSyntaMount::mcGetAxisPosition ( int axis, SSAngle &rad )
     return kSuccess;
 }
 
+// Gets positions of both axes. Over TCP or UDP, the Synta controller answers each axis
+// independently, so both position queries are sent before waiting for either reply.
+// Over serial ports, queries are sent one at a time.
+
+SSMount::Error SSSyntaMount::mcGetAxisPositions ( SSAngle &lon, SSAngle &lat )
+{
+    if ( _serial.portOpen() )
+    {
+        Error err = mcGetAxisPosition ( kAzmRAAxis, lon );
+        if ( err == kSuccess )
+            err = mcGetAxisPosition ( kAltDecAxis, lat );
+        return err;
+    }
+    
+    vector<string> inputs = { motorInput ( kAzmRAAxis, 'j', "" ), motorInput ( kAltDecAxis, 'j', "" ) };
+    vector<string> outputs;
+    Error err = pipeline ( inputs, outputs, 10, '\r' );
+    if ( err != kSuccess )
+        return err;
+    
+    for ( int axis = kAzmRAAxis; axis <= kAltDecAxis; axis++ )
+    {
+        string response;
+        err = motorOutput ( outputs[axis], response );
+        if ( err != kSuccess )
+            return err;
+        
+        int iPosition = 0;
+        if ( sscanf ( response.c_str(), "%x", &iPosition ) < 1 )
+            return kInvalidOutput;
+        
+        ( axis == kAzmRAAxis ? lon : lat ) = stepToAngle ( axis, iPosition - 0x00800000 );
+    }
+    
+    return kSuccess;
+}
+
 SSMount::Error SSSyntaMount::mcSetAxisPosition ( int axis, SSAngle rad )
 {
     string response;
@@ -2221,9 +2586,7 @@ SSMount::Error SSSyntaMount::mcSetAxisPosition ( int axis, SSAngle rad )
 
 SSMount::Error SSSyntaMount::read ( SSAngle &ra, SSAngle &dec )
 {
-    Error err = mcGetAxisPosition ( kAzmRAAxis, _currLon );
-    if ( err == kSuccess )
-        err = mcGetAxisPosition ( kAltDecAxis, _currLat );
+    Error err = mcGetAxisPositions ( _currLon, _currLat );
     if ( err )
         return err;
     
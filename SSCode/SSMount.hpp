@@ -15,6 +15,11 @@
 #include <string>
 #include <map>
 #include <mutex>
+#include <list>
+#include <thread>
+#include <future>
+#include <functional>
+#include <condition_variable>
 
 // Important for Windows - must #include "SSSocket.hpp" before "SSSerial.hpp"
 
@@ -76,12 +81,39 @@ public:
         kWriteFail = 7,         // Can't write to serial port or socket connection
         kNotSupported = 8,      // Functionality is not implemented/not supported
         kTimedOut = 9,          // Read/write operation timed out before completion
-        kBadAlignment = 10      // Alignment star could not be added to mount model
+        kBadAlignment = 10,     // Alignment star could not be added to mount model
+        kCancelled = 11         // Asynchronous command was cancelled before it was sent to the mount
     };
 
     // Pointer to completion callback for asynchronouos command methods
     
     typedef void (* AsyncCmdCallback) ( SSMount *pMount, Error error, void *pUserData );
+    
+    // Asynchronous command types, in order of priority: stops are sent before anything else.
+    
+    enum AsyncCmdType
+    {
+        kAsyncStop = 0,         // stop()
+        kAsyncSlew = 1,         // slew() to coordinates or on an axis
+        kAsyncSync = 2,         // sync()
+        kAsyncRead = 3          // read()
+    };
+    
+    // Result of an asynchronous command; get() waits for the command to complete and returns its error code.
+    
+    typedef shared_future<Error> AsyncResult;
+    
+    // Asynchronous command queue statistics
+    
+    struct AsyncStats
+    {
+        size_t  commands;       // number of commands sent to mount
+        size_t  coalesced;      // number of read requests merged into a read already queued
+        size_t  cancelled;      // number of commands cancelled before they were sent
+        size_t  queueDepth;     // number of commands currently queued
+        size_t  maxQueueDepth;  // largest number of commands queued at once
+        double  latency[3];     // 50th, 90th, and 99th percentile of time from queueing to completion, in milliseconds
+    };
 
 protected:
     
@@ -109,17 +141,53 @@ protected:
     string      _version;       // mount controller firmware version string, read from mount during connect()
 
     mutex       _cmdMtx;        // for preventing resource contention with asynchronous command calls
+    
+    // A queued asynchronous command
+    
+    struct AsyncCmd
+    {
+        AsyncCmdType            type;       // command type, which determines priority
+        function<Error(void)>   func;       // calls synchronous command method
+        list<pair<AsyncCmdCallback,void *>> callbacks;     // completion callbacks and user data
+        promise<Error>          result;     // receives command error code
+        AsyncResult             future;     // shared by all requests merged into this command
+        double                  queued;     // time command was queued, in seconds
+    };
+    
+    static constexpr size_t kLatencySamples = 1000;     // number of recent command latencies kept for statistics
+    
+    list<AsyncCmd> _asyncQueue; // asynchronous commands waiting to be sent, in order of priority then age
+    mutex       _asyncMtx;      // guards asynchronous command queue and statistics
+    condition_variable _asyncCond; // signals that a command has been queued, or the worker should exit
+    thread      _asyncThread;   // worker thread which sends asynchronous commands
+    bool        _asyncExit;     // true when worker thread should exit
+    AsyncStats  _asyncStats;    // asynchronous command statistics; latencies are computed on request
+    vector<double> _asyncLatency; // recent command latencies in milliseconds, as a ring buffer
+    size_t      _asyncLatencyNext; // index of next latency to replace in ring buffer
+
     int         _retries;       // maximum number of command attempts before assuming failure
     int         _timeout;       // default command communication response timeout, milliseconds
 
     FILE        *_logFile;      // pointer to open log file; NULL if none
     double      _logStart;      // log file start time, seconds
     
+    static constexpr size_t kReceiveBufferSize = 1024;  // size of ring buffer for bytes received from serial port or TCP socket
+    
+    vector<char> _rxBuffer;     // ring buffer of bytes received from mount, but not yet returned as command output
+    size_t      _rxStart;       // index of first unreturned byte in ring buffer
+    size_t      _rxCount;       // number of unreturned bytes in ring buffer
+    
     virtual Error connect ( const string &path, uint16_t port, int baud, int party, int data, float stop, bool udp = false );
     Error serialCommand ( const char *input, int inlen, char *output, int outlen, char term, int timeout_ms );
     Error socketCommand ( const char *input, int inlen, char *output, int outlen, char term, int timeout_ms );
+    Error flushInput ( void );
+    Error fillReceiveBuffer ( int timeout_ms );
+    Error readReply ( char *output, int outlen, char term, int timeout_ms, int &bytesRead );
     static SSAngle angularRate ( int rate );  // converts integer slew rate identifier to angular rate in radians/second.
     
+    AsyncResult queueAsync ( AsyncCmdType type, function<Error(void)> func, AsyncCmdCallback callback, void *userData );
+    void asyncWorker ( void );
+    
 public:
     // Constructor, destructor
     
@@ -152,6 +220,7 @@ public:
     Error command ( const char *input, int inlen, char *output, int outlen, char term, int timeout_ms = 0 );
     Error command ( const string &input, string &output, int outlen, char term, int timeout_ms = 0 );
     Error command ( const string &input );
+    Error pipeline ( const vector<string> &inputs, vector<string> &outputs, int outlen, char term, int timeout_ms = 0 );
 
     void setRetries ( int attempts ) { _retries = attempts; }
     int  getRetries ( void ) { return _retries; }
@@ -183,13 +252,19 @@ public:
 
     // High-level mount commands, asynchronous versions
     
-    void readAsync ( AsyncCmdCallback callback = nullptr, void *userData = nullptr );
-    void slewAsync ( SSAngle ra, SSAngle dec, AsyncCmdCallback callback = nullptr, void *userData = nullptr );
-    void slewAsync ( SSSlewAxis axis, int rate, AsyncCmdCallback callback = nullptr, void *userData = nullptr );
-    void stopAsync ( AsyncCmdCallback callback = nullptr, void *userData = nullptr );
-    void syncAsync ( SSAngle ra, SSAngle dec, AsyncCmdCallback callback = nullptr, void *userData = nullptr );
+    AsyncResult readAsync ( AsyncCmdCallback callback = nullptr, void *userData = nullptr );
+    AsyncResult slewAsync ( SSAngle ra, SSAngle dec, AsyncCmdCallback callback = nullptr, void *userData = nullptr );
+    AsyncResult slewAsync ( SSSlewAxis axis, int rate, AsyncCmdCallback callback = nullptr, void *userData = nullptr );
+    AsyncResult stopAsync ( AsyncCmdCallback callback = nullptr, void *userData = nullptr );
+    AsyncResult syncAsync ( SSAngle ra, SSAngle dec, AsyncCmdCallback callback = nullptr, void *userData = nullptr );
     void lockMutex ( bool state ) { if ( state ) _cmdMtx.lock(); else _cmdMtx.unlock(); }
     
+    // Asynchronous command queue: statistics, and stopping the worker thread
+    
+    void getAsyncStatistics ( AsyncStats &stats );
+    void resetAsyncStatistics ( void );
+    void stopAsyncWorker ( void );
+    
     // Send date/time and lon/lat from mount's coordinates object reference
     
     Error setTime ( void ) { return setTime ( _coords.getTime() ); }
@@ -297,12 +372,15 @@ protected:
         bool notInitialized;    // MC is not initialized
     };
     
+    string motorInput ( int axis, char cmd, string indata );
+    Error motorOutput ( string output, string &outdata );
     Error motorCommand ( int axis, char cmd, string input, string &output );
     Error mcAxisStop ( int axis, bool instant );
     Error mcAxisSlew ( int axis, double speed );    // speed in radians/sec
     Error mcAxisSlewTo ( int axis, double radians );
     Error mcGetAxisStatus ( int axis, AxisStatus &status );
     Error mcGetAxisPosition ( int axis, SSAngle &radians );
+    Error mcGetAxisPositions ( SSAngle &lon, SSAngle &lat );
     Error mcSetAxisPosition ( int axis, SSAngle radians );
 
     int angleToStep ( int axis, double rad ) { return _countsPerRev[axis] * rad / SSAngle::kTwoPi; }
@@ -0,0 +1,990 @@
+// SSMountSimulator.cpp
+// SSCore
+//
+// Created by Tim DeBenedictis on 10/16/26.
+// Copyright © 2026 Southern Stars. All rights reserved.
+
+#include <math.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <algorithm>
+
+#ifndef _MSC_VER
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+#endif
+
+#include "SSMountSimulator.hpp"
+#include "SSUtilities.hpp"
+
+// Sidereal rate and GoTo slew rate, radians per second
+
+static constexpr double kSiderealRate = SSAngle::kTwoPi / 86164.0905;
+static constexpr double kGotoRate = 5.0 * SSAngle::kRadPerDeg;
+
+// Celestron hand controller and AUX bus fixed slew rates 0-9, radians per second
+
+static const double kCelestronRates[10] =
+{
+    0.0, 0.5 * kSiderealRate, 1.0 * kSiderealRate, 4.0 * kSiderealRate, 8.0 * kSiderealRate,
+    16.0 * kSiderealRate, 64.0 * kSiderealRate, 0.5 * SSAngle::kRadPerDeg, 2.0 * SSAngle::kRadPerDeg, 4.0 * SSAngle::kRadPerDeg
+};
+
+// Simulated Synta motor controller parameters: counts per revolution,
+// stepping timer interrupt frequency, and high speed ratio (EQ6 values).
+
+static const int kSyntaCountsPerRev = 9024000;
+static const int kSyntaTimerFreq = 64935;
+static const int kSyntaHighSpeedRatio = 16;
+
+// Formats an integer (value) as a Synta motor controller hex payload of (digits) characters;
+// 4- and 6-digit payloads are sent least significant byte first.
+
+static string SyntaHex ( uint32_t value, int digits )
+{
+    string hex = formstr ( "%0*X", digits, value & ( ( 1u << ( 4 * digits ) ) - 1 ) );
+    if ( digits == 6 )
+    {
+        swap ( hex[0], hex[4] );
+        swap ( hex[1], hex[5] );
+    }
+    else if ( digits == 4 )
+    {
+        swap ( hex[0], hex[2] );
+        swap ( hex[1], hex[3] );
+    }
+
+    return hex;
+}
+
+// Converts a Synta motor controller hex payload (data) to an integer; inverse of SyntaHex().
+
+static uint32_t SyntaValue ( string data )
+{
+    if ( data.length() == 6 )
+    {
+        swap ( data[0], data[4] );
+        swap ( data[1], data[5] );
+    }
+    else if ( data.length() == 4 )
+    {
+        swap ( data[0], data[2] );
+        swap ( data[1], data[3] );
+    }
+
+    return (uint32_t) strtoul ( data.c_str(), nullptr, 16 );
+}
+
+// Converts angle in radians to 24-bit Celestron AUX position (fraction of a full rotation), and back.
+
+static uint32_t AUXPosition ( double rad )
+{
+    return (uint32_t) (int64_t) floor ( rad / SSAngle::kTwoPi * 0x01000000 + 0.5 ) & 0x00FFFFFF;
+}
+
+static double AUXAngle ( const string &data )
+{
+    int32_t pos = (uint8_t) data[0] << 16 | (uint8_t) data[1] << 8 | (uint8_t) data[2];
+    if ( pos & 0x00800000 )
+        pos -= 0x01000000;
+    return pos * SSAngle::kTwoPi / 0x01000000;
+}
+
+// Constructs a mount simulator which speaks the specified protocol.
+// Call start() to begin answering commands.
+
+SSMountSimulator::SSMountSimulator ( SSMountProtocol protocol ) : _random ( 1 )
+{
+    _protocol = protocol;
+    _transport = kTCP;
+    _port = 0;
+    _ptyMaster = _ptySlave = -1;
+    _exit = false;
+    _latency = _jitter = _dropRate = 0.0;
+    _echo = false;
+    _commands = _dropped = 0;
+
+    _axisAngle[0] = _axisAngle[1] = 0.0;
+    _axisTarget[0] = _axisTarget[1] = 0.0;
+    _axisRate[0] = _axisRate[1] = 0.0;
+    _axisGoto[0] = _axisGoto[1] = false;
+    _updateTime = clocksec();
+    _moveRate = 64.0 * kSiderealRate;
+    _meadeTarget[0] = _meadeTarget[1] = 0.0;
+    _highPrecision = false;
+    _trackMode = 2;
+    _siteLon = _siteLat = _zone = 0.0;
+
+    for ( int axis = 0; axis < 2; axis++ )
+    {
+        _syntaMode[axis] = 0;
+        _syntaPeriod[axis] = 0;
+        _syntaSteps[axis] = 0;
+        _syntaInit[axis] = false;
+    }
+}
+
+// Destructor stops the background thread and closes the simulator's socket or pseudo-terminal.
+
+SSMountSimulator::~SSMountSimulator ( void )
+{
+    stop();
+}
+
+// Opens a TCP or UDP socket on the loopback interface on the specified port, or a pseudo-terminal
+// (port is ignored), then starts answering commands on a background thread. Afterwards, pass path()
+// and port() to the SSMount's connect() method. Returns true if successful or false on failure.
+
+bool SSMountSimulator::start ( Transport transport, uint16_t port )
+{
+    stop();
+
+    _transport = transport;
+    if ( transport == kTCP || transport == kUDP )
+    {
+        SSIP loopback ( "127.0.0.1" );
+        if ( transport == kTCP && ! _server.serverOpenSocket ( loopback, port, 1 ) )
+            return false;
+        if ( transport == kUDP && ! _server.openUDPSocket ( loopback, port ) )
+            return false;
+        _path = loopback.toString();
+        _port = port;
+    }
+    else if ( transport == kPseudoTerminal )
+    {
+#ifdef _MSC_VER
+        return false;
+#else
+        _ptyMaster = posix_openpt ( O_RDWR | O_NOCTTY );
+        if ( _ptyMaster < 0 )
+            return false;
+
+        const char *name = nullptr;
+        if ( grantpt ( _ptyMaster ) == 0 && unlockpt ( _ptyMaster ) == 0 )
+            name = ptsname ( _ptyMaster );
+        if ( name != nullptr )
+            _ptySlave = open ( name, O_RDWR | O_NOCTTY );
+
+        // Put the terminal in raw mode until the client opens it,
+        // so commands it sends early are not echoed or line-buffered.
+
+        struct termios options;
+        if ( _ptySlave < 0 || tcgetattr ( _ptySlave, &options ) != 0 )
+        {
+            stop();
+            return false;
+        }
+
+        cfmakeraw ( &options );
+        tcsetattr ( _ptySlave, TCSANOW, &options );
+        _path = name;
+        _port = 0;
+#endif
+    }
+    else
+    {
+        return false;
+    }
+
+    _exit = false;
+    _thread = thread ( &SSMountSimulator::run, this );
+    return true;
+}
+
+// Stops the background thread, then closes the simulator's socket or pseudo-terminal.
+
+void SSMountSimulator::stop ( void )
+{
+    _exit = true;
+    if ( _thread.joinable() )
+        _thread.join();
+
+    _server.closeSocket();
+#ifndef _MSC_VER
+    if ( _ptySlave >= 0 )
+        close ( _ptySlave );
+    if ( _ptyMaster >= 0 )
+        close ( _ptyMaster );
+#endif
+    _ptyMaster = _ptySlave = -1;
+    _input.clear();
+    _replies.clear();
+}
+
+// Sets the delay before each reply is sent: a fixed latency plus a uniformly-distributed random
+// jitter from zero to jitter_ms, both in milliseconds. Replies are always sent in order.
+
+void SSMountSimulator::setLatency ( double latency_ms, double jitter_ms )
+{
+    lock_guard<mutex> lock ( _mtx );
+    _latency = latency_ms / 1000.0;
+    _jitter = jitter_ms / 1000.0;
+}
+
+// Sets the probability (0.0 - 1.0) that any single reply byte is dropped instead of sent.
+
+void SSMountSimulator::setDropRate ( double rate )
+{
+    lock_guard<mutex> lock ( _mtx );
+    _dropRate = rate;
+}
+
+// If true, Synta and AUX commands are echoed back before each reply, as by mounts whose
+// serial transmit and receive lines are connected together.
+
+void SSMountSimulator::setEcho ( bool echo )
+{
+    _echo = echo;
+}
+
+// Background thread: serves TCP connections one at a time until told to exit,
+// or serves the UDP socket or pseudo-terminal directly.
+
+void SSMountSimulator::run ( void )
+{
+    if ( _transport == kTCP )
+    {
+        while ( ! _exit )
+        {
+            if ( _server.waitSocket ( 50 ) < 1 )
+                continue;
+
+            SSSocket client = _server.serverAcceptConnection();
+            if ( client.socketOpen() )
+                serve ( &client );
+        }
+    }
+    else if ( _transport == kUDP )
+    {
+        serve ( &_server );
+    }
+    else
+    {
+        serve ( nullptr );
+    }
+}
+
+// Answers commands received on a connected TCP socket, UDP socket, or pseudo-terminal (if pSocket is null)
+// until the TCP connection closes or the simulator is stopped. Commands are parsed as they arrive; their replies
+// are queued with a due time, and sent when due. Waits for input no longer than until the next reply is due.
+
+void SSMountSimulator::serve ( SSSocket *pSocket )
+{
+    char data[1024];
+    bool udp = pSocket != nullptr && _transport == kUDP;
+
+    _input.clear();
+    _replies.clear();
+
+    while ( ! _exit )
+    {
+        int timeout_ms = 50;
+        if ( _replies.size() > 0 )
+            timeout_ms = clamp ( (int) ceil ( ( _replies.front().due - clocksec() ) * 1000.0 ), 0, 50 );
+
+        SSIP addr;
+        uint16_t port = 0;
+        int bytes = readInput ( pSocket, data, sizeof ( data ), addr, port, timeout_ms );
+        if ( bytes < 0 )
+            break;
+
+        if ( bytes > 0 )
+        {
+            _input.append ( data, bytes );
+
+            string reply;
+            while ( parseCommand ( reply ) )
+            {
+                _commands++;
+                if ( reply.length() > 0 )
+                    queueReply ( reply, addr, port );
+            }
+
+            // Each UDP datagram holds complete commands; discard any partial command left over.
+
+            if ( udp )
+                _input.clear();
+        }
+
+        writeReplies ( pSocket );
+    }
+}
+
+// Waits up to timeout_ms milliseconds for input from a socket or pseudo-terminal (if pSocket is null),
+// and reads up to (size) bytes into (data). For UDP, returns the sender's address and port.
+// Returns number of bytes read, zero on timeout, or -1 if the connection has closed.
+
+int SSMountSimulator::readInput ( SSSocket *pSocket, char *data, int size, SSIP &addr, uint16_t &port, int timeout_ms )
+{
+    if ( pSocket == nullptr )
+    {
+#ifdef _MSC_VER
+        return -1;
+#else
+        struct pollfd pfd = { _ptyMaster, POLLIN, 0 };
+        int result = poll ( &pfd, 1, timeout_ms );
+        if ( result < 1 )
+            return result < 0 && errno != EINTR ? -1 : 0;
+
+        int bytes = (int) ::read ( _ptyMaster, data, size );
+        return bytes < 0 && errno != EAGAIN && errno != EINTR ? -1 : max ( bytes, 0 );
+#endif
+    }
+
+    int result = pSocket->waitSocket ( timeout_ms );
+    if ( result < 0 )
+        return -1;
+    if ( result == 0 )
+        return 0;
+
+    if ( _transport == kUDP )
+        return max ( pSocket->readUDPSocket ( data, size, addr, port, 1 ), 0 );
+
+    // If the TCP socket is readable but has no bytes available, the client has closed the connection.
+
+    int bytes = pSocket->readSocket ( data, size );
+    return bytes > 0 ? bytes : -1;
+}
+
+// Queues a reply to be sent after the configured latency and jitter, but never before
+// any reply queued earlier. Drops reply bytes at the configured rate.
+
+void SSMountSimulator::queueReply ( const string &reply, SSIP addr, uint16_t port )
+{
+    lock_guard<mutex> lock ( _mtx );
+    uniform_real_distribution<double> uniform ( 0.0, 1.0 );
+
+    Reply r = { string(), clocksec() + _latency + _jitter * uniform ( _random ), addr, port };
+    if ( _replies.size() > 0 )
+        r.due = max ( r.due, _replies.back().due );
+
+    for ( char c : reply )
+    {
+        if ( _dropRate > 0.0 && uniform ( _random ) < _dropRate )
+            _dropped++;
+        else
+            r.data += c;
+    }
+
+    if ( r.data.length() > 0 )
+        _replies.push_back ( r );
+}
+
+// Sends all queued replies which are now due.
+
+void SSMountSimulator::writeReplies ( SSSocket *pSocket )
+{
+    double now = clocksec();
+    while ( _replies.size() > 0 && _replies.front().due <= now )
+    {
+        Reply &r = _replies.front();
+        if ( pSocket == nullptr )
+        {
+#ifndef _MSC_VER
+            if ( ::write ( _ptyMaster, r.data.c_str(), r.data.length() ) < 0 )
+                break;
+#endif
+        }
+        else if ( _transport == kUDP )
+        {
+            pSocket->writeUDPSocket ( r.data.c_str(), (int) r.data.length(), r.addr, r.port );
+        }
+        else
+        {
+            pSocket->writeSocket ( r.data.c_str(), (int) r.data.length() );
+        }
+
+        _replies.pop_front();
+    }
+}
+
+// Advances simulated axis angles to the current time, and ends GoTos which have reached their targets.
+
+void SSMountSimulator::update ( void )
+{
+    double now = clocksec();
+    double dt = now - _updateTime;
+    _updateTime = now;
+
+    for ( int axis = 0; axis < 2; axis++ )
+    {
+        if ( _axisGoto[axis] )
+        {
+            double diff = _axisTarget[axis] - _axisAngle[axis];
+            if ( fabs ( diff ) <= kGotoRate * dt )
+            {
+                _axisAngle[axis] = _axisTarget[axis];
+                _axisGoto[axis] = false;
+            }
+            else
+            {
+                _axisAngle[axis] += diff > 0.0 ? kGotoRate * dt : -kGotoRate * dt;
+            }
+        }
+        else
+        {
+            _axisAngle[axis] += _axisRate[axis] * dt;
+        }
+    }
+}
+
+// Starts a GoTo on an axis to a target angle in radians, taking the shorter way around.
+
+void SSMountSimulator::startGoto ( int axis, double target )
+{
+    update();
+    _axisTarget[axis] = _axisAngle[axis] + modpi ( target - _axisAngle[axis] );
+    _axisRate[axis] = 0.0;
+    _axisGoto[axis] = true;
+}
+
+// Parses one complete command from the front of the input buffer and removes it, skipping any
+// unrecognized bytes before it. Returns the command's reply, which may be empty, in (reply).
+// Returns true if a command was parsed, or false if the input buffer holds no complete command.
+
+bool SSMountSimulator::parseCommand ( string &reply )
+{
+    reply.clear();
+    update();
+
+    if ( _protocol == kMeadeLX200 || _protocol == kMeadeAutostar )
+        return parseMeade ( reply );
+    else if ( _protocol == kCelestronNexStar || _protocol == kSkyWatcherSynScan )
+        return parseCelestron ( reply );
+    else if ( _protocol == kSyntaDirect )
+        return parseSynta ( reply );
+    else if ( _protocol == kCelestronAUX )
+        return parseAUX ( reply );
+
+    _input.clear();
+    return false;
+}
+
+// Parses Meade LX-200 and Autostar commands, which start with ':' and end with '#',
+// plus the single ACK (0x06) byte alignment query.
+
+bool SSMountSimulator::parseMeade ( string &reply )
+{
+    size_t start = _input.find_first_of ( ":\x06" );
+    if ( start == string::npos )
+    {
+        _input.clear();
+        return false;
+    }
+
+    _input.erase ( 0, start );
+    if ( _input[0] == 0x06 )
+    {
+        _input.erase ( 0, 1 );
+        reply = "P";
+        return true;
+    }
+
+    size_t end = _input.find ( '#' );
+    if ( end == string::npos )
+        return false;
+
+    string cmd = _input.substr ( 1, end - 1 );
+    _input.erase ( 0, end + 1 );
+    if ( cmd.length() < 1 )
+        return true;
+
+    int h = 0, m = 0;
+    double s = 0.0;
+    char sign = '+';
+
+    if ( cmd == "GVN" )
+    {
+        reply = _protocol == kMeadeAutostar ? "43Eg#" : "4.2g#";
+    }
+    else if ( cmd == "U" )
+    {
+        _highPrecision = ! _highPrecision;
+    }
+    else if ( cmd == "GR" )
+    {
+        int sec = (int) floor ( mod2pi ( _axisAngle[0] ) / SSAngle::kTwoPi * 86400.0 + 0.5 ) % 86400;
+        if ( _highPrecision )
+            reply = formstr ( "%02d:%02d:%02d#", sec / 3600, sec / 60 % 60, sec % 60 );
+        else
+            reply = formstr ( "%02d:%02d.%d#", sec / 3600, sec / 60 % 60, sec % 60 / 6 );
+    }
+    else if ( cmd == "GD" )
+    {
+        double dec = clamp ( _axisAngle[1], -SSAngle::kHalfPi, SSAngle::kHalfPi );
+        int sec = (int) floor ( fabs ( dec ) / SSAngle::kRadPerDeg * 3600.0 + 0.5 );
+        sign = dec < 0.0 ? '-' : '+';
+        if ( _highPrecision )
+            reply = formstr ( "%c%02d*%02d'%02d#", sign, sec / 3600, sec / 60 % 60, sec % 60 );
+        else
+            reply = formstr ( "%c%02d*%02d#", sign, sec / 3600, sec / 60 % 60 );
+    }
+    else if ( cmd[0] == 'S' && cmd[1] == 'r' )
+    {
+        if ( sscanf ( cmd.c_str() + 2, "%d:%d:%lf", &h, &m, &s ) == 3 )
+            _meadeTarget[0] = ( h + m / 60.0 + s / 3600.0 ) * 15.0 * SSAngle::kRadPerDeg;
+        reply = "1";
+    }
+    else if ( cmd[0] == 'S' && cmd[1] == 'd' )
+    {
+        if ( sscanf ( cmd.c_str() + 2, "%c%d%*c%d:%lf", &sign, &h, &m, &s ) == 4 )
+            _meadeTarget[1] = ( sign == '-' ? -1.0 : 1.0 ) * ( h + m / 60.0 + s / 3600.0 ) * SSAngle::kRadPerDeg;
+        reply = "1";
+    }
+    else if ( cmd == "MS" )
+    {
+        startGoto ( 0, _meadeTarget[0] );
+        startGoto ( 1, _meadeTarget[1] );
+        reply = "0";
+    }
+    else if ( cmd == "CM" )
+    {
+        _axisAngle[0] = _meadeTarget[0];
+        _axisAngle[1] = _meadeTarget[1];
+        reply = "M31 EX GAL MAG 3.5 SZ178.0'#";
+    }
+    else if ( cmd == "Q" )
+    {
+        _axisGoto[0] = _axisGoto[1] = false;
+        _axisRate[0] = _axisRate[1] = 0.0;
+    }
+    else if ( cmd == "Qe" || cmd == "Qw" )
+    {
+        _axisRate[0] = 0.0;
+    }
+    else if ( cmd == "Qn" || cmd == "Qs" )
+    {
+        _axisRate[1] = 0.0;
+    }
+    else if ( cmd == "Me" || cmd == "Mw" )
+    {
+        _axisRate[0] = cmd[1] == 'e' ? _moveRate : -_moveRate;
+    }
+    else if ( cmd == "Mn" || cmd == "Ms" )
+    {
+        _axisRate[1] = cmd[1] == 'n' ? _moveRate : -_moveRate;
+    }
+    else if ( cmd == "RG" || cmd == "RC" || cmd == "RM" || cmd == "RS" )
+    {
+        _moveRate = cmd[1] == 'G' ? 2.0 * kSiderealRate : cmd[1] == 'C' ? 16.0 * kSiderealRate : cmd[1] == 'M' ? 64.0 * kSiderealRate : kGotoRate;
+    }
+    else if ( cmd[0] == 'S' && cmd[1] == 'w' )
+    {
+        _moveRate = strtoint ( cmd.substr ( 2 ) ) * SSAngle::kRadPerDeg;
+        reply = "1";
+    }
+    else if ( cmd[0] == 'S' && cmd[1] == 'g' )
+    {
+        if ( sscanf ( cmd.c_str() + 2, "%d%*c%d", &h, &m ) == 2 )
+            _siteLon = modpi ( -( h + m / 60.0 ) * SSAngle::kRadPerDeg );
+        reply = "1";
+    }
+    else if ( cmd[0] == 'S' && cmd[1] == 't' )
+    {
+        if ( sscanf ( cmd.c_str() + 2, "%c%d%*c%d", &sign, &h, &m ) == 3 )
+            _siteLat = ( sign == '-' ? -1.0 : 1.0 ) * ( h + m / 60.0 ) * SSAngle::kRadPerDeg;
+        reply = "1";
+    }
+    else if ( cmd[0] == 'S' && cmd[1] == 'G' )
+    {
+        _zone = -strtofloat64 ( cmd.substr ( 2 ) );
+        reply = "1";
+    }
+    else if ( cmd[0] == 'S' && cmd[1] == 'L' )
+    {
+        reply = "1";
+    }
+    else if ( cmd[0] == 'S' && cmd[1] == 'C' )
+    {
+        reply = "1Updating Planetary Data#" + string ( 32, ' ' ) + "#";
+    }
+    else if ( cmd == "GG" )
+    {
+        reply = formstr ( "%+05.1f#", -_zone );
+    }
+    else if ( cmd == "GL" || cmd == "GC" )
+    {
+        SSTime time = SSTime::fromSystem();
+        time.zone = _zone;
+        SSDate date ( time );
+        if ( cmd == "GL" )
+            reply = formstr ( "%02hd:%02hd:%02d#", date.hour, date.min, min ( (int) date.sec, 59 ) );
+        else
+            reply = formstr ( "%02hd/%02hd/%02d#", date.month, date.day, date.year % 100 );
+    }
+    else if ( cmd == "Gt" || cmd == "Gg" )
+    {
+        double angle = cmd == "Gt" ? _siteLat : mod2pi ( -_siteLon );
+        int mins = (int) floor ( fabs ( angle ) / SSAngle::kRadPerDeg * 60.0 + 0.5 );
+        if ( cmd == "Gt" )
+            reply = formstr ( "%c%02d*%02d#", angle < 0.0 ? '-' : '+', mins / 60, mins % 60 );
+        else
+            reply = formstr ( "%03d*%02d#", mins / 60 % 360, mins % 60 );
+    }
+    else if ( cmd == "D" )
+    {
+        reply = slewing() ? "\x7f#" : "#";
+    }
+
+    return true;
+}
+
+// Parses Celestron NexStar and SkyWatcher SynScan hand controller commands,
+// which are a single command character followed by a fixed number of binary or ASCII bytes.
+// Stray bytes, like the '#' which SSCelestronMount appends to its version queries, are ignored.
+
+bool SSMountSimulator::parseCelestron ( string &reply )
+{
+    static const map<char,int> lengths =
+    {
+        { 'V', 1 }, { 'e', 1 }, { 'E', 1 }, { 'r', 18 }, { 'R', 10 }, { 's', 18 }, { 'S', 10 },
+        { 'M', 1 }, { 'L', 1 }, { 'J', 1 }, { 't', 1 }, { 'T', 2 }, { 'P', 8 }, { 'H', 9 },
+        { 'W', 9 }, { 'h', 1 }, { 'w', 1 }, { 'K', 2 }, { 'm', 1 }
+    };
+
+    while ( _input.length() > 0 && lengths.count ( _input[0] ) == 0 )
+        _input.erase ( 0, 1 );
+
+    if ( _input.length() < 1 || _input.length() < (size_t) lengths.at ( _input[0] ) )
+        return false;
+
+    string cmd = _input.substr ( 0, lengths.at ( _input[0] ) );
+    _input.erase ( 0, cmd.length() );
+
+    const uint8_t *bytes = (const uint8_t *) cmd.c_str();
+    double scale = cmd[0] == 'r' || cmd[0] == 's' || cmd[0] == 'e' ? 4294967296.0 : 65536.0;
+
+    if ( cmd[0] == 'V' )
+    {
+        if ( _protocol == kSkyWatcherSynScan )
+            reply = "042507#";
+        else
+            reply = string ( { 4, 21, '#' } );
+    }
+    else if ( cmd[0] == 'e' || cmd[0] == 'E' )
+    {
+        uint32_t ra = (uint32_t) (int64_t) floor ( mod2pi ( _axisAngle[0] ) / SSAngle::kTwoPi * scale );
+        uint32_t dec = (uint32_t) (int64_t) floor ( clamp ( _axisAngle[1], -SSAngle::kHalfPi, SSAngle::kHalfPi ) / SSAngle::kTwoPi * scale );
+        if ( cmd[0] == 'e' )
+            reply = formstr ( "%08X,%08X#", ra, dec );
+        else
+            reply = formstr ( "%04X,%04X#", ra & 0xFFFF, dec & 0xFFFF );
+    }
+    else if ( cmd[0] == 'r' || cmd[0] == 'R' || cmd[0] == 's' || cmd[0] == 'S' )
+    {
+        uint32_t ra = 0, dec = 0;
+        if ( sscanf ( cmd.c_str() + 1, "%x,%x", &ra, &dec ) == 2 )
+        {
+            double lon = ra / scale * SSAngle::kTwoPi;
+            double lat = ( scale > 65536.0 ? (int32_t) dec : (int16_t) dec ) / scale * SSAngle::kTwoPi;
+            if ( cmd[0] == 'r' || cmd[0] == 'R' )
+            {
+                startGoto ( 0, lon );
+                startGoto ( 1, lat );
+            }
+            else
+            {
+                _axisAngle[0] = lon;
+                _axisAngle[1] = lat;
+            }
+        }
+        reply = "#";
+    }
+    else if ( cmd[0] == 'M' )
+    {
+        _axisGoto[0] = _axisGoto[1] = false;
+        reply = "#";
+    }
+    else if ( cmd[0] == 'L' )
+    {
+        reply = slewing() ? "1#" : "0#";
+    }
+    else if ( cmd[0] == 'J' )
+    {
+        reply = string ( { 1, '#' } );
+    }
+    else if ( cmd[0] == 't' )
+    {
+        reply = string ( { (char) _trackMode, '#' } );
+    }
+    else if ( cmd[0] == 'T' )
+    {
+        _trackMode = bytes[1];
+        reply = "#";
+    }
+    else if ( cmd[0] == 'P' )
+    {
+        // Fixed-rate (3 bytes) or variable-rate (4 bytes) slew on azimuth/RA (16) or altitude/Dec (17) motor
+
+        int axis = bytes[2] == 17 ? 1 : 0;
+        double rate = 0.0;
+        if ( bytes[1] == 2 )
+            rate = kCelestronRates[ min ( (int) bytes[4], 9 ) ];
+        else if ( bytes[1] == 3 )
+            rate = ( bytes[4] * 256 + bytes[5] ) / 4.0 * SSAngle::kRadPerArcsec;
+
+        if ( bytes[3] == 6 || bytes[3] == 36 )
+            _axisRate[axis] = rate;
+        else if ( bytes[3] == 7 || bytes[3] == 37 )
+            _axisRate[axis] = -rate;
+        reply = "#";
+    }
+    else if ( cmd[0] == 'H' )
+    {
+        _zone = (int8_t) bytes[7];
+        reply = "#";
+    }
+    else if ( cmd[0] == 'W' )
+    {
+        _siteLat = ( bytes[4] ? -1.0 : 1.0 ) * ( bytes[1] + bytes[2] / 60.0 + bytes[3] / 3600.0 ) * SSAngle::kRadPerDeg;
+        _siteLon = ( bytes[8] ? -1.0 : 1.0 ) * ( bytes[5] + bytes[6] / 60.0 + bytes[7] / 3600.0 ) * SSAngle::kRadPerDeg;
+        reply = "#";
+    }
+    else if ( cmd[0] == 'h' )
+    {
+        SSTime time = SSTime::fromSystem();
+        time.zone = _zone;
+        SSDate date ( time );
+        reply = string ( { (char) date.hour, (char) date.min, (char) min ( (int) date.sec, 59 ), (char) date.month,
+                           (char) date.day, (char) ( date.year % 100 ), (char) _zone, 0, '#' } );
+    }
+    else if ( cmd[0] == 'w' )
+    {
+        SSDegMinSec lat = SSAngle ( _siteLat ), lon = SSAngle ( _siteLon );
+        reply = string ( { (char) lat.deg, (char) lat.min, (char) lat.sec, (char) ( lat.sign == '-' ),
+                           (char) lon.deg, (char) lon.min, (char) lon.sec, (char) ( lon.sign == '-' ), '#' } );
+    }
+    else if ( cmd[0] == 'K' )
+    {
+        reply = string ( { cmd[1], '#' } );
+    }
+    else if ( cmd[0] == 'm' )
+    {
+        reply = string ( { 20, '#' } );
+    }
+
+    return true;
+}
+
+// Parses Synta motor controller commands: ':', command character, axis '1' or '2', hex payload, '\r'.
+// Replies are '=', hex payload, '\r' on success; or '!', error code, '\r' on failure.
+
+bool SSMountSimulator::parseSynta ( string &reply )
+{
+    size_t start = _input.find ( ':' );
+    if ( start == string::npos )
+    {
+        _input.clear();
+        return false;
+    }
+
+    _input.erase ( 0, start );
+    size_t end = _input.find ( '\r' );
+    if ( end == string::npos )
+        return false;
+
+    string cmd = _input.substr ( 0, end + 1 );
+    _input.erase ( 0, end + 1 );
+    if ( _echo )
+        reply = cmd;
+
+    int axis = cmd.length() > 3 ? cmd[2] - '1' : -1;
+    if ( axis < 0 || axis > 1 )
+    {
+        reply += "!0\r";
+        return true;
+    }
+
+    string data = cmd.substr ( 3, cmd.length() - 4 ), out;
+    double radPerStep = SSAngle::kTwoPi / kSyntaCountsPerRev;
+
+    switch ( cmd[1] )
+    {
+        case 'e':   // motor board version
+            out = SyntaHex ( 0x000321, 6 );
+            break;
+
+        case 'a':   // counts per revolution
+            out = SyntaHex ( kSyntaCountsPerRev, 6 );
+            break;
+
+        case 'b':   // stepping timer interrupt frequency
+            out = SyntaHex ( kSyntaTimerFreq, 6 );
+            break;
+
+        case 'g':   // high speed ratio
+            out = SyntaHex ( kSyntaHighSpeedRatio, 2 );
+            break;
+
+        case 'F':   // initialization done
+            _syntaInit[axis] = true;
+            break;
+
+        case 'K':   // stop
+        case 'L':   // instant stop
+            _axisRate[axis] = 0.0;
+            _axisGoto[axis] = false;
+            break;
+
+        case 'G':   // motion mode: 0 = high speed goto, 1 = low speed slew, 2 = low speed goto, 3 = high speed slew; then direction
+            if ( data.length() == 2 )
+            {
+                int mode = data[0] - '0';
+                _syntaMode[axis] = ( mode & 1 ) | ( data[1] == '1' ? 2 : 0 ) | ( mode == 0 || mode == 3 ? 4 : 0 );
+            }
+            break;
+
+        case 'I':   // step period
+            _syntaPeriod[axis] = SyntaValue ( data );
+            break;
+
+        case 'H':   // goto target increment
+            _syntaSteps[axis] = SyntaValue ( data );
+            break;
+
+        case 'M':   // break point increment
+            break;
+
+        case 'J':   // start motion
+            if ( _syntaMode[axis] & 1 )
+            {
+                double rate = _syntaPeriod[axis] > 0 ? (double) kSyntaTimerFreq / _syntaPeriod[axis] * radPerStep : 0.0;
+                if ( _syntaMode[axis] & 4 )
+                    rate *= kSyntaHighSpeedRatio;
+                _axisRate[axis] = _syntaMode[axis] & 2 ? -rate : rate;
+                _axisGoto[axis] = false;
+            }
+            else
+            {
+                double steps = _syntaMode[axis] & 2 ? -_syntaSteps[axis] : _syntaSteps[axis];
+                _axisTarget[axis] = _axisAngle[axis] + steps * radPerStep;
+                _axisRate[axis] = 0.0;
+                _axisGoto[axis] = true;
+            }
+            break;
+
+        case 'f':   // status: mode and direction; running; initialized
+            out = formstr ( "%X%X%X", _syntaMode[axis], _axisGoto[axis] || _axisRate[axis] != 0.0, _syntaInit[axis] );
+            break;
+
+        case 'j':   // position, offset by 0x800000
+            out = SyntaHex ( (uint32_t) (int64_t) floor ( _axisAngle[axis] / radPerStep + 0.5 ) + 0x800000, 6 );
+            break;
+
+        case 'E':   // set position
+            _axisAngle[axis] = ( (int) SyntaValue ( data ) - 0x800000 ) * radPerStep;
+            _axisGoto[axis] = false;
+            break;
+
+        default:
+            reply += "!0\r";
+            return true;
+    }
+
+    reply += "=" + out + "\r";
+    return true;
+}
+
+// Parses Celestron AUX bus packets: 0x3b, length, source, destination, command, data, checksum.
+// Only the azimuth and altitude motor controllers are simulated; packets addressed to other devices,
+// or with bad checksums, are ignored, like a real AUX bus.
+
+bool SSMountSimulator::parseAUX ( string &reply )
+{
+    while ( true )
+    {
+        size_t start = _input.find ( (char) 0x3b );
+        if ( start == string::npos )
+        {
+            _input.clear();
+            return false;
+        }
+
+        _input.erase ( 0, start );
+        if ( _input.length() < 2 )
+            return false;
+
+        size_t len = (uint8_t) _input[1];
+        if ( len < 3 )
+        {
+            _input.erase ( 0, 1 );
+            continue;
+        }
+
+        if ( _input.length() < len + 3 )
+            return false;
+
+        string packet = _input.substr ( 0, len + 3 );
+        _input.erase ( 0, len + 3 );
+
+        char checksum = 0;
+        for ( size_t i = 1; i < len + 2; i++ )
+            checksum += packet[i];
+        if ( packet[len + 2] != (char) -checksum )
+            continue;
+
+        uint8_t src = packet[2], dst = packet[3], cmd = packet[4];
+        if ( dst != 0x10 && dst != 0x11 )
+            continue;
+
+        int axis = dst - 0x10;
+        string data = packet.substr ( 5, len - 3 ), out;
+        uint32_t pos = 0;
+
+        switch ( cmd )
+        {
+            case 0x01:  // get position
+                pos = AUXPosition ( _axisAngle[axis] );
+                out = string ( { (char) ( pos >> 16 ), (char) ( pos >> 8 ), (char) pos } );
+                break;
+
+            case 0x02:  // goto fast
+            case 0x17:  // goto slow
+                if ( data.length() >= 3 )
+                    startGoto ( axis, AUXAngle ( data ) );
+                break;
+
+            case 0x04:  // set position
+                if ( data.length() >= 3 )
+                    _axisAngle[axis] = AUXAngle ( data );
+                break;
+
+            case 0x05:  // get model
+                out = string ( { 0x16, (char) 0x87 } );
+                break;
+
+            case 0x13:  // goto done
+                out = string ( 1, _axisGoto[axis] ? 0x00 : (char) 0xff );
+                break;
+
+            case 0x24:  // move positive
+            case 0x25:  // move negative
+                if ( data.length() >= 1 )
+                {
+                    double rate = kCelestronRates[ min ( (int) (uint8_t) data[0], 9 ) ];
+                    _axisRate[axis] = cmd == 0x24 ? rate : -rate;
+                    _axisGoto[axis] = false;
+                }
+                break;
+
+            case 0xfe:  // get version
+                out = string ( { 7, 11, 0x13, (char) 0x89 } );
+                break;
+        }
+
+        if ( _echo )
+            reply = packet;
+
+        string response = { 0x3b, (char) ( out.length() + 3 ), (char) dst, (char) src, (char) cmd };
+        response += out;
+        checksum = 0;
+        for ( size_t i = 1; i < response.length(); i++ )
+            checksum += response[i];
+        response += (char) -checksum;
+
+        reply += response;
+        return true;
+    }
+}
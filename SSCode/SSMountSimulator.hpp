@@ -0,0 +1,131 @@
+// SSMountSimulator.hpp
+// SSCore
+//
+// Created by Tim DeBenedictis on 10/16/26.
+// Copyright © 2026 Southern Stars. All rights reserved.
+//
+// This class simulates a telescope mount controller which speaks the same wire protocols
+// that SSMount implements: Meade LX-200/Autostar, Celestron NexStar, SkyWatcher SynScan,
+// Synta direct motor controllers, and the Celestron AUX bus. It serves one client at a time
+// over a loopback TCP or UDP socket, or over a pseudo-terminal on Linux and MacOS, from
+// a background thread. Replies can be delayed by a fixed latency plus random jitter, and
+// individual reply bytes can be dropped, to exercise SSMount's timeout and retry handling.
+// Slews, GoTos, and syncs move two simulated axes, so read() sees the mount move.
+
+#ifndef SSMountSimulator_hpp
+#define SSMountSimulator_hpp
+
+#include <deque>
+#include <atomic>
+#include <random>
+
+#include "SSMount.hpp"
+
+class SSMountSimulator
+{
+public:
+
+    // Communication channel between the simulator and its client
+
+    enum Transport
+    {
+        kTCP = 0,               // TCP server socket on the loopback interface; one connection at a time
+        kUDP = 1,               // UDP socket on the loopback interface; replies go to each datagram's sender
+        kPseudoTerminal = 2     // pseudo-terminal; client opens path() as a serial port. Not available on Windows.
+    };
+
+protected:
+
+    // A reply waiting to be sent, the time it is due (seconds), and the UDP destination
+
+    struct Reply
+    {
+        string      data;
+        double      due;
+        SSIP        addr;
+        uint16_t    port;
+    };
+
+    SSMountProtocol _protocol;  // wire protocol spoken by this simulator
+    Transport   _transport;     // communication channel; see above
+    string      _path;          // address or device path that clients should connect to
+    uint16_t    _port;          // TCP or UDP port that clients should connect to; zero for pseudo-terminal
+    SSSocket    _server;        // listening TCP socket, or UDP socket
+    int         _ptyMaster;     // pseudo-terminal master file descriptor; -1 if none
+    int         _ptySlave;      // pseudo-terminal slave file descriptor, held open so the master never sees a hangup
+
+    thread      _thread;        // background thread which answers commands; see run()
+    atomic<bool> _exit;         // tells background thread to exit
+    mutex       _mtx;           // guards latency, jitter, and drop rate settings
+    double      _latency;       // fixed reply latency, seconds
+    double      _jitter;        // maximum random additional reply latency, seconds
+    double      _dropRate;      // probability that any reply byte is dropped, 0.0 - 1.0
+    atomic<bool> _echo;         // if true, echo Synta and AUX commands before replying, like a shared serial TX/RX line
+    mt19937     _random;        // random number generator for jitter and dropped bytes
+
+    atomic<size_t> _commands;   // total number of commands answered
+    atomic<size_t> _dropped;    // total number of reply bytes dropped
+
+    string      _input;         // received bytes not yet parsed into complete commands
+    deque<Reply> _replies;      // replies not yet sent, in order
+
+    // Simulated mount state. Axis angles are RA/Dec for Meade and Celestron hand controller protocols;
+    // for Synta and AUX motor controller protocols, they are motor angles from the home position.
+
+    double      _axisAngle[2];  // current axis angles, radians
+    double      _axisTarget[2]; // GoTo target axis angles, radians
+    double      _axisRate[2];   // manual slew rates, radians per second
+    bool        _axisGoto[2];   // true while GoTo is in progress on axis
+    double      _updateTime;    // time when axis angles were last updated, seconds
+    double      _moveRate;      // Meade manual slew rate, radians per second
+    double      _meadeTarget[2];// Meade target RA/Dec from :Sr# and :Sd# commands, radians
+    bool        _highPrecision; // Meade high-precision coordinate format
+    int         _trackMode;     // Celestron tracking mode
+    double      _siteLon;       // site longitude, radians, east positive
+    double      _siteLat;       // site latitude, radians, north positive
+    double      _zone;          // local time zone, hours east of UTC
+
+    int         _syntaMode[2];  // Synta motion mode from 'G' command: bit 0 = slew vs goto, bit 1 = reverse, bit 2 = high speed
+    int         _syntaPeriod[2];// Synta step period from 'I' command
+    int         _syntaSteps[2]; // Synta GoTo increment from 'H' command
+    bool        _syntaInit[2];  // Synta axis initialized with 'F' command
+
+    void run ( void );
+    void serve ( SSSocket *pSocket );
+    int readInput ( SSSocket *pSocket, char *data, int size, SSIP &addr, uint16_t &port, int timeout_ms );
+    void writeReplies ( SSSocket *pSocket );
+    void queueReply ( const string &reply, SSIP addr, uint16_t port );
+
+    void update ( void );
+    void startGoto ( int axis, double target );
+    bool slewing ( void ) { return _axisGoto[0] || _axisGoto[1]; }
+
+    bool parseCommand ( string &reply );
+    bool parseMeade ( string &reply );
+    bool parseCelestron ( string &reply );
+    bool parseSynta ( string &reply );
+    bool parseAUX ( string &reply );
+
+public:
+
+    SSMountSimulator ( SSMountProtocol protocol );
+    virtual ~SSMountSimulator ( void );
+
+    bool start ( Transport transport, uint16_t port );
+    void stop ( void );
+    bool running ( void ) { return _thread.joinable(); }
+
+    // Pass these to SSMount::connect() to connect to this simulator.
+
+    string path ( void ) { return _path; }
+    uint16_t port ( void ) { return _port; }
+
+    void setLatency ( double latency_ms, double jitter_ms );
+    void setDropRate ( double rate );
+    void setEcho ( bool echo );
+
+    size_t commandsAnswered ( void ) { return _commands; }
+    size_t bytesDropped ( void ) { return _dropped; }
+};
+
+#endif /* SSMountSimulator_hpp */
@@ -11,12 +11,15 @@
 #include <iostream>
 #include <fstream>
 #include <map>
+#include <thread>
+#include <atomic>
 
 #include "SSObject.hpp"
 #include "SSPlanet.hpp"
 #include "SSStar.hpp"
 #include "SSFeature.hpp"
 #include "SSConstellation.hpp"
+#include "SSLineReader.hpp"
 
 typedef map<SSObjectType,string> SSTypeStringMap;
 typedef map<string,SSObjectType> SSStringTypeMap;
@@ -106,9 +109,13 @@ string SSObject::typeToCode ( SSObjectType type )
     return _typeStrings[ type ];
 }
 
+// Uses find() rather than operator[], which would insert unknown codes into the map,
+// so this is safe to call from multiple threads at once.
+
 SSObjectType SSObject::codeToType ( string code )
 {
-    return _stringTypes[ code ];
+    auto it = _stringTypes.find ( code );
+    return it == _stringTypes.end() ? kTypeNonexistent : it->second;
 }
 
 SSObject::SSObject ( void ) : SSObject ( kTypeNonexistent )
@@ -119,7 +126,6 @@ SSObject::SSObject ( void ) : SSObject ( kTypeNonexistent )
 SSObject::SSObject ( SSObjectType type )
 {
     _type = type;
-    _names = vector<string> ( 0 );
     _description = "";
     _direction = SSVector ( INFINITY, INFINITY, INFINITY );
     _distance = INFINITY;
@@ -180,6 +186,20 @@ SSSpherical SSObject::computeApparentMotion ( SSCoordinates &coords, SSFrame fra
     return SSSpherical ( INFINITY, INFINITY, INFINITY );
 }
 
+// Deletes all objects in the array and clears it. If the array has an arena,
+// releases all of its memory at once, invalidating any objects allocated from it
+// which were removed from the array without being deleted.
+
+void SSObjectArray::erase ( void )
+{
+    for ( SSObjectPtr pObj : _objects )
+        delete pObj;
+
+    clear();
+    if ( _arena )
+        _arena->reset();
+}
+
 SSObjectPtr SSObjectArray::set ( size_t index, SSObjectPtr pNew )
 {
     if ( index >= 0 && index < size() )
@@ -310,6 +330,7 @@ int SSObjectArray::search ( SSVector center, SSAngle radius, vector<SSObjectPtr>
 // Given a vector of smart pointers to SSObject, creates a mapping of SSIdentifiers
 // in a particular catalog (cat) to index number within the vector.
 // Useful for fast object retrieval by identifier (see SSIdentifierToObject()).
+// If several objects have the same identifier, it maps to the first of them.
 
 SSObjectMap SSMakeObjectMap ( SSObjectVec &objects, SSCatalog cat )
 {
@@ -336,12 +357,12 @@ SSObjectMap SSMakeObjectMap ( SSObjectVec &objects, SSCatalog cat )
 // to the first object in the vector which matches ident.  If the identifier does not map to
 // any object in the vector, this function returns a smart pointer to null!
 
-SSObjectPtr SSIdentifierToObject ( SSIdentifier ident, SSObjectMap &map, SSObjectVec &objects )
+SSObjectPtr SSIdentifierToObject ( SSIdentifier ident, const SSObjectMap &map, SSObjectVec &objects )
 {
-    int k = map[ ident ];
+    auto it = map.find ( ident );
 
-    if ( k > 0 )
-        return objects[ k - 1 ];
+    if ( it != map.end() && it->second > 0 )
+        return objects[ it->second - 1 ];
     else
         return SSObjectPtr ( nullptr );
 }
@@ -458,49 +479,166 @@ int SSExportObjectsToCSV ( const string &filename, SSObjectVec &objects, SSObjec
     return n;
 }
 
+// Creates an object from one line of a CSV-formatted text file (line), splitting it once and
+// handing the fields to the class whose type code is in the first field. Lines containing quotes
+// are split differently by classes which handle quoted fields and classes which don't, so those
+// are passed to each class's fromCSV() in turn. (fields) and (buffer) are scratch storage which
+// can be reused from line to line. Returns nullptr if the line does not describe an object.
+
+static SSObjectPtr SSObjectFromCSV ( string_view line, vector<string_view> &fields, string &buffer )
+{
+    if ( line.find ( '"' ) != string_view::npos )
+    {
+        SSObjectPtr pObject = SSPlanet::fromCSV ( line );
+        if ( pObject == nullptr )
+            pObject = SSStar::fromCSV ( line );
+        if ( pObject == nullptr )
+            pObject = SSFeature::fromCSV ( line );
+        if ( pObject == nullptr )
+            pObject = SSConstellation::fromCSV ( line );
+        return pObject;
+    }
+    
+    split_csv ( line, fields, buffer );
+    if ( fields.size() < 1 )
+        return nullptr;
+    
+    SSObjectType type = SSObject::codeToType ( string ( trim_view ( fields[0] ) ) );
+    if ( type >= kTypePlanet && type <= kTypeComet )
+        return SSPlanet::fromCSV ( fields );
+    else if ( type == kTypeFeature || type == kTypeCity )
+        return SSFeature::fromCSV ( fields );
+    else if ( type == kTypeConstellation || type == kTypeAsterism )
+        return SSConstellation::fromCSV ( fields );
+    else
+        return SSStar::fromCSV ( fields );
+}
+
+// Appends an object (pObject) to a vector of objects (objects) if it passes a filter function (filter),
+// or if the filter is null; otherwise deletes the object. Returns true if the object was appended.
+
+static bool SSAppendFilteredObject ( SSObjectPtr pObject, SSObjectVec &objects, SSObjectFilter filter, void *userData )
+{
+    if ( pObject == nullptr )
+        return false;
+    
+    if ( filter != nullptr && ! filter ( pObject, userData ) )
+    {
+        delete pObject;
+        return false;
+    }
+    
+    objects.append ( pObject );
+    return true;
+}
+
 // Imports objects from CSV-formatted text file (filename).
 // Imported objects are appended to the input vector of SSObjects (objects).
 // If a non-null filter function (filter) is provided, objects are imported
 // only if they pass the filter; optional data pointer (userData) is passed
 // to the filter but not used otherwise.
+// If (nthreads) is greater than one, the file is memory-mapped and split into chunks
+// which start and end on line boundaries, and lines are parsed into objects by (nthreads)
+// threads, including the calling thread; if zero, uses one thread per CPU core.
+// Objects are always appended in the order they appear in the file, and the filter is
+// always called from the calling thread, so the results don't depend on the thread count.
 // Function returns number of objects successfully imported.
 
-int SSImportObjectsFromCSV ( const string &filename, SSObjectVec &objects, SSObjectFilter filter, void *userData )
+int SSImportObjectsFromCSV ( const string &filename, SSObjectVec &objects, SSObjectFilter filter, void *userData, int nthreads )
 {
-    // Open file; return on failure.
+    static constexpr size_t kChunksPerThread = 4;       // chunks per thread, so threads which finish early can take another
+    static constexpr size_t kMinChunkSize = 1 << 16;    // smallest chunk in bytes worth handing to another thread
+    
+    vector<string_view> fields;
+    string buffer;
+    string_view line;
+    int numObjects = 0;
 
-    FILE *file = fopen ( filename.c_str(), "rb" );
-    if ( ! file )
-        return 0;
+    // Allocate objects from the object vector's arena, if it has one. Worker threads must use
+    // the same arena as this thread.
 
-    // Read file line-by-line until we reach end-of-file
+    SSObjectArena::Scope scope ( objects.getArena() );
+    SSObjectArena *pArena = SSObjectArena::current();
 
-    string line = "";
-    int numObjects = 0;
+    if ( nthreads < 1 )
+        nthreads = max ( 1, (int) thread::hardware_concurrency() );
 
-    while ( fgetline ( file, line ) )
+    // If using more than one thread, map the file into memory. If that fails, or we're using one thread,
+    // read the file line-by-line until we reach end-of-file. If an object is created successfully
+    // from a line, and passes the filter, add it to object vector.
+
+    size_t size = 0;
+    const char *data = nthreads > 1 ? (const char *) mapfile ( filename, size ) : nullptr;
+    if ( data == nullptr )
     {
-        // Attempt to create object from CSV file line
-        
-        SSObjectPtr pObject = SSPlanet::fromCSV ( line );
-        if ( pObject == nullptr )
-            pObject = SSStar::fromCSV ( line );
-        if ( pObject == nullptr )
-            pObject = SSFeature::fromCSV ( line );
-        if ( pObject == nullptr )
-            pObject = SSConstellation::fromCSV ( line );
+        SSLineReader reader ( filename );
+        if ( ! reader.isOpen() )
+            return 0;
+
+        while ( reader.readLine ( line ) )
+            numObjects += SSAppendFilteredObject ( SSObjectFromCSV ( line, fields, buffer ), objects, filter, userData );
+
+        return numObjects;
+    }
 
-        // if successful, and object passes filter, add it to object vector.
-            
-        if ( pObject != nullptr && ( filter == nullptr || filter ( pObject, userData ) ) )
+    // Split the mapped file into chunks of roughly equal size. Move the end of each chunk forward
+    // past the next line ending, including both characters of a CRLF, so every line lies entirely
+    // within one chunk.
+
+    size_t numChunks = min ( nthreads * kChunksPerThread, max ( (size_t) 1, size / kMinChunkSize ) );
+    vector<size_t> bounds ( 1, 0 );
+    for ( size_t k = 1; k < numChunks; k++ )
+    {
+        size_t i = max ( bounds.back(), size * k / numChunks );
+        while ( i < size && data[i] != '\n' && data[i] != '\r' )
+            i++;
+        if ( i < size && data[i] == '\r' )
+            i++;
+        if ( i < size && data[i] == '\n' )
+            i++;
+        bounds.push_back ( i );
+    }
+    bounds.push_back ( size );
+
+    // Threads take chunks in turn and parse each chunk's lines into its own vector of objects.
+
+    vector<vector<SSObjectPtr>> chunks ( numChunks );
+    atomic<size_t> next ( 0 );
+
+    auto work = [&] ( void )
+    {
+        SSObjectArena::Scope scope ( pArena );
+        vector<string_view> fields;
+        string buffer;
+        string_view line;
+        
+        for ( size_t k = next++; k < numChunks; k = next++ )
         {
-            objects.append ( pObject );
-            numObjects++;
+            SSLineReader reader ( data + bounds[k], bounds[k + 1] - bounds[k] );
+            while ( reader.readLine ( line ) )
+            {
+                SSObjectPtr pObject = SSObjectFromCSV ( line, fields, buffer );
+                if ( pObject != nullptr )
+                    chunks[k].push_back ( pObject );
+            }
         }
-    }
-    
-    // Close file. Return number of objects added to object vector.
+    };
+
+    vector<thread> workers;
+    for ( size_t i = 1; i < min ( (size_t) nthreads, numChunks ); i++ )
+        workers.push_back ( thread ( work ) );
+
+    work();
+    for ( thread &worker : workers )
+        worker.join();
+
+    unmapfile ( data, size );
+
+    // Filter objects and add them to the object vector in file order.
+
+    for ( vector<SSObjectPtr> &chunk : chunks )
+        for ( SSObjectPtr pObject : chunk )
+            numObjects += SSAppendFilteredObject ( pObject, objects, filter, userData );
 
-    fclose ( file );
     return numObjects;
 }
@@ -21,24 +21,31 @@
 #include <map>
 
 #include "SSCoordinates.hpp"
+#include "SSHashMap.hpp"
 #include "SSIdentifier.hpp"
+#include "SSObjectArena.hpp"
+#include "SSSmallVector.hpp"
 
 using namespace std;
 
 #pragma pack ( push, 1 )
 
+typedef SSSmallVector<string,1> SSNames;    // object name strings; one fits inside the object
+
 // This is the base class for all astronomical objects (planets, stars, deep sky objects, constellations, etc.)
 
 class SSObject
 {
 protected:
     
-    SSObjectType    _type;          // object type code
-    vector<string>  _names;         // vector of name string(s)
+    // Since this class is packed, _type comes last so _names and the strings follow the vtable pointer on 8-byte boundaries.
+    
+    SSNames         _names;         // vector of name string(s)
     string          _description;   // plain-text object description (may be empty)
     SSVector        _direction;     // apparent direction to object as unit vector in fundamental reference frame; infinite if unknown
     double          _distance;      // distance to object in AU; infinite if unknown
     float           _magnitude;     // visual magnitude; infinite if unknown
+    SSObjectType    _type;          // object type code
     
 public:
 
@@ -48,10 +55,15 @@ public:
     SSObject ( SSObjectType type );
     virtual ~SSObject ( void ) {}   // test code: { cout << "~SSObject" << endl; }
 
+    // objects are allocated from the current thread's arena, if any; otherwise from the heap. See SSObjectArena.
+
+    static void *operator new ( size_t size ) { return SSObjectArena::allocateObject ( size ); }
+    static void operator delete ( void *ptr, size_t size ) { SSObjectArena::releaseObject ( ptr, size ); }
+
     // accessors
     
     SSObjectType getType ( void ) { return _type; }
-    vector<string> getNames ( void ) { return _names; }
+    const SSNames &getNames ( void ) { return _names; }
     string getDescription ( void ) { return _description; }
     SSVector getDirection ( void ) { return _direction; }
     double getDistance ( void ) { return _distance; }
@@ -60,7 +72,8 @@ public:
     // modifiers. setType() with caution; _type is used to determine object class.
     
     void setType ( SSObjectType type ) { _type = type; }
-    void setNames ( const vector<string> &names ) { _names = names; }
+    void setNames ( const vector<string> &names ) { _names.assign ( names.begin(), names.end() ); }
+    void setNames ( const SSNames &names ) { _names = names; }
     void setDescription ( const string &desc ) { _description = desc; }
     void setDirection ( SSVector dir ) { _direction = dir; }
     void setDistance ( double dist ) { _distance = dist; }
@@ -98,14 +111,21 @@ public:
 typedef SSObject *SSObjectPtr;
 
 // This class stores a vector of pointers to SSObject, and deletes them when class instance is destroyed.
+// An array constructed with an arena owns it; the importers allocate objects for the array from it,
+// and erase() frees the whole arena at once after deleting the objects. Objects from an array's arena
+// must not outlive the array, or its next erase(), even if they are removed from the array first.
 
 class SSObjectArray
 {
 protected:
     vector<SSObjectPtr> _objects;
+    unique_ptr<SSObjectArena> _arena;   // arena which allocates this array's objects; nullptr if objects are allocated from heap
 
 public:
-    ~SSObjectArray ( void ) { for ( SSObjectPtr pObj : _objects ) delete pObj; }
+    SSObjectArray ( void ) {}
+    explicit SSObjectArray ( bool useArena ) { if ( useArena ) _arena.reset ( new SSObjectArena() ); }
+    ~SSObjectArray ( void ) { erase(); }
+    SSObjectArena *getArena ( void ) { return _arena.get(); }
     SSObjectPtr get ( size_t index ) { return index >= 0 && index < size() ? _objects.at ( index ) : nullptr; }
     SSObjectPtr set ( size_t index, SSObjectPtr pObj );
     SSObjectPtr operator [] ( size_t index ) { return get ( index ); }
@@ -114,7 +134,7 @@ public:
     void remove ( size_t index ) { _objects.erase ( _objects.begin() + index ); }   // DOES NOT actually delete object!!!
     size_t size ( void ) { return _objects.size(); }
     void clear ( void ) { _objects.clear(); }   // empties object vector but DOES NOT delete individual objects!!!
-    void erase ( void ) { for ( SSObjectPtr pObj : _objects ) delete pObj; clear(); }   // deletes all objects AND clears vector.
+    void erase ( void );    // deletes all objects AND clears vector, then frees arena memory, if any.
     void sort ( bool (*cmpfunc) ( const SSObjectPtr &p1, const SSObjectPtr &p2 ) ) { std::sort ( _objects.begin(), _objects.end(), cmpfunc ); }
     int search ( const SSObjectPtr &pKey, bool (*cmpfunc) ( const SSObjectPtr &p1, const SSObjectPtr &p2 ), vector<SSObjectPtr> &results );
     int search ( bool (*testfunc) ( const SSObjectPtr &pObject ), vector<SSObjectPtr> &results );
@@ -125,15 +145,15 @@ public:
 };
 
 typedef SSObjectArray SSObjectVec;          // legacy declaration was typedef vector<SSObjectPtr> SSObjectVec; now we use SSObjectArray class
-typedef map<SSIdentifier,int> SSObjectMap;
+typedef SSHashMap<SSIdentifier,int> SSObjectMap;   // maps identifiers to object index + 1
 
 SSObjectPtr SSNewObject ( SSObjectType type );
 SSObjectPtr SSCloneObject ( SSObject *pObj );
 SSObjectMap SSMakeObjectMap ( SSObjectVec &objects, SSCatalog cat );
-SSObjectPtr SSIdentifierToObject ( SSIdentifier ident, SSObjectMap &map, SSObjectVec &objects );
+SSObjectPtr SSIdentifierToObject ( SSIdentifier ident, const SSObjectMap &map, SSObjectVec &objects );
 
 typedef bool (*SSObjectFilter) ( SSObjectPtr pObject, void *userData );
-int SSImportObjectsFromCSV ( const string &filename, SSObjectVec &objects, SSObjectFilter filter = nullptr, void *userData = nullptr );
+int SSImportObjectsFromCSV ( const string &filename, SSObjectVec &objects, SSObjectFilter filter = nullptr, void *userData = nullptr, int nthreads = 1 );
 int SSExportObjectsToCSV ( const string &filename, SSObjectVec &objects, SSObjectFilter filter = nullptr, void *userData = nullptr );
 
 #pragma pack ( pop )
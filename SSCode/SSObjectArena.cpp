@@ -0,0 +1,193 @@
+// SSObjectArena.cpp
+// SSCore
+//
+// Created by Tim DeBenedictis on 10/16/26.
+// Copyright © 2026 Southern Stars. All rights reserved.
+
+#include <atomic>
+#include <new>
+
+#include "SSObjectArena.hpp"
+
+// The current thread's arena; nullptr if objects are allocated from the heap.
+
+static thread_local SSObjectArena *_current = nullptr;
+
+// Statistics for object and small vector allocations made from the heap, outside any arena.
+
+static atomic<size_t> _heapAllocations ( 0 ), _heapDeallocations ( 0 ), _heapBytes ( 0 );
+
+// Constructs an empty arena which allocates slabs of the given size (slabSize) in bytes.
+// No memory is allocated until the first block is requested.
+
+SSObjectArena::SSObjectArena ( size_t slabSize )
+{
+    _next = _end = nullptr;
+    _slabSize = slabSize;
+    _stats = { 0, 0, 0, 0, 0 };
+}
+
+// Destructor frees all slabs. Objects allocated from this arena must not be used afterwards.
+
+SSObjectArena::~SSObjectArena ( void )
+{
+    reset();
+}
+
+// Rounds a pointer (ptr) up to a multiple of an alignment (align), which must be a power of two.
+
+static char *alignup ( char *ptr, size_t align )
+{
+    return (char *) ( ( (uintptr_t) ptr + align - 1 ) & ~ (uintptr_t) ( align - 1 ) );
+}
+
+// Allocates a block of memory of the given size (bytes) with the given alignment (align), which must
+// be a power of two, by taking it from the current slab. Starts a new slab if the current slab is full.
+// Blocks too large to share a slab get a slab of their own, without abandoning the current one.
+// Throws bad_alloc if a new slab can't be allocated, just like operator new.
+
+void *SSObjectArena::allocate ( size_t bytes, size_t align )
+{
+    lock_guard<mutex> lock ( _mutex );
+
+    auto newSlab = [this] ( size_t size )
+    {
+        char *slab = (char *) ::operator new ( size );
+        _slabs.push_back ( slab );
+        _stats.slabs++;
+        _stats.slabBytes += size;
+        return slab;
+    };
+
+    char *ptr = _next ? alignup ( _next, align ) : nullptr;
+    if ( ptr != nullptr && ptr <= _end && bytes <= (size_t) ( _end - ptr ) )
+    {
+        _next = ptr + bytes;
+    }
+    else if ( bytes + align > _slabSize / 4 )
+    {
+        ptr = alignup ( newSlab ( bytes + align ), align );
+    }
+    else
+    {
+        char *slab = newSlab ( _slabSize );
+        _end = slab + _slabSize;
+        ptr = alignup ( slab, align );
+        _next = ptr + bytes;
+    }
+
+    _stats.allocations++;
+    _stats.bytes += bytes;
+    return ptr;
+}
+
+// Releases a block (ptr) of the given size (bytes) allocated from this arena.
+// This only counts the release; the memory is not reused until the arena is reset.
+
+void SSObjectArena::release ( void *ptr, size_t bytes )
+{
+    lock_guard<mutex> lock ( _mutex );
+    _stats.deallocations++;
+}
+
+// Frees all of this arena's slabs at once. Everything allocated from the arena becomes invalid.
+// Allocation statistics are preserved, except for the numbers of slabs and slab bytes.
+
+void SSObjectArena::reset ( void )
+{
+    lock_guard<mutex> lock ( _mutex );
+
+    for ( char *slab : _slabs )
+        ::operator delete ( slab );
+
+    _slabs.clear();
+    _next = _end = nullptr;
+    _stats.slabs = _stats.slabBytes = 0;
+}
+
+// Returns a copy of this arena's allocation statistics.
+
+SSObjectArenaStats SSObjectArena::getStats ( void )
+{
+    lock_guard<mutex> lock ( _mutex );
+    return _stats;
+}
+
+// Returns the current thread's arena, or nullptr if none.
+
+SSObjectArena *SSObjectArena::current ( void )
+{
+    return _current;
+}
+
+// Makes an arena (pArena) current on the calling thread until this scope object is destroyed,
+// then restores the previously current arena. If pArena is nullptr, the current arena is unchanged;
+// so importers can open a scope for an object array's arena without knowing whether it has one.
+
+SSObjectArena::Scope::Scope ( SSObjectArena *pArena )
+{
+    _previous = _current;
+    if ( pArena != nullptr )
+        _current = pArena;
+}
+
+SSObjectArena::Scope::~Scope ( void )
+{
+    _current = _previous;
+}
+
+// Allocates memory for an object, or for a small vector's elements, of the given size (bytes)
+// from the current thread's arena, or from the heap if there is none. The memory is preceded by a header which points to the arena,
+// so releaseObject() knows where it came from regardless of which arena is current then.
+
+void *SSObjectArena::allocateObject ( size_t bytes )
+{
+    SSObjectArena *pArena = _current;
+    char *ptr = (char *) allocate ( pArena, bytes + kObjectHeaderSize, kObjectHeaderSize );
+    *(SSObjectArena **) ptr = pArena;
+    return ptr + kObjectHeaderSize;
+}
+
+// Releases memory for an object or small vector's elements (ptr) of the given size (bytes) allocated by allocateObject().
+
+void SSObjectArena::releaseObject ( void *ptr, size_t bytes )
+{
+    if ( ptr == nullptr )
+        return;
+
+    char *block = (char *) ptr - kObjectHeaderSize;
+    release ( *(SSObjectArena **) block, block, bytes + kObjectHeaderSize );
+}
+
+// Allocates a block of memory of the given size (bytes) and alignment (align) from an arena (pArena),
+// or from the heap if pArena is nullptr.
+
+void *SSObjectArena::allocate ( SSObjectArena *pArena, size_t bytes, size_t align )
+{
+    if ( pArena != nullptr )
+        return pArena->allocate ( bytes, align );
+
+    _heapAllocations.fetch_add ( 1, memory_order_relaxed );
+    _heapBytes.fetch_add ( bytes, memory_order_relaxed );
+    return ::operator new ( bytes );
+}
+
+// Releases a block of memory (ptr) of the given size (bytes) allocated from an arena (pArena),
+// or frees it if it was allocated from the heap (pArena is nullptr).
+
+void SSObjectArena::release ( SSObjectArena *pArena, void *ptr, size_t bytes )
+{
+    if ( pArena != nullptr )
+        return pArena->release ( ptr, bytes );
+
+    _heapDeallocations.fetch_add ( 1, memory_order_relaxed );
+    ::operator delete ( ptr );
+}
+
+// Returns statistics for all object and small vector allocations made from the heap,
+// outside any arena, since the program started.
+
+SSObjectArenaStats SSObjectArena::heapStats ( void )
+{
+    return { _heapAllocations.load(), _heapDeallocations.load(), _heapBytes.load(), 0, 0 };
+}
@@ -0,0 +1,92 @@
+// SSObjectArena.hpp
+// SSCore
+//
+// Created by Tim DeBenedictis on 10/16/26.
+// Copyright © 2026 Southern Stars. All rights reserved.
+//
+// Region ("arena") allocator for SSObjects. Importing a large catalog creates millions of objects;
+// allocating every one of them individually from the heap, and then freeing them one by one,
+// dominates the cost of loading and unloading HTM regions. An arena instead hands out memory
+// from large slabs by bumping a pointer, and releases all of it at once when reset or destroyed.
+// Objects are allocated from an arena only while it is the current thread's arena, as set
+// by an SSObjectArena::Scope; otherwise they come from the heap as usual.
+// Objects' names and identifiers are stored inside the object, unless there are too many of them;
+// then they come from the arena which is current when they outgrow the object (see SSSmallVector).
+// So don't add names or identifiers to a heap-allocated object while an arena is current.
+// Strings short enough to be stored inside the string object itself (most names and spectral
+// types) need no further allocation; longer strings still come from the heap, and are freed
+// by the object's destructor as usual.
+// Memory released from an arena is not reused until the arena is reset. An object allocated
+// from an arena must not be used after the arena is reset or destroyed; deleting it before then
+// is safe, and counted, but frees nothing.
+
+#ifndef SSObjectArena_hpp
+#define SSObjectArena_hpp
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <mutex>
+#include <vector>
+
+using namespace std;
+
+// Allocation statistics for an arena, or for heap allocations made on behalf of objects outside any arena.
+
+struct SSObjectArenaStats
+{
+    size_t allocations;     // number of blocks allocated
+    size_t deallocations;   // number of blocks released
+    size_t bytes;           // total bytes in blocks allocated
+    size_t slabs;           // number of slabs currently held by arena; zero for heap
+    size_t slabBytes;       // total bytes in slabs currently held by arena; zero for heap
+};
+
+class SSObjectArena
+{
+protected:
+
+    mutex           _mutex;         // guards everything below; objects may be allocated from multiple threads
+    vector<char *>  _slabs;         // slabs allocated from heap
+    char            *_next;         // next free byte in current slab
+    char            *_end;          // end of current slab
+    size_t          _slabSize;      // default size of new slabs in bytes
+    SSObjectArenaStats _stats;      // allocation statistics
+
+public:
+
+    static constexpr size_t kDefaultSlabSize = 1 << 20;     // default slab size in bytes
+    static constexpr size_t kObjectHeaderSize = 8;          // bytes preceding every object, which point to its arena
+
+    SSObjectArena ( size_t slabSize = kDefaultSlabSize );
+    virtual ~SSObjectArena ( void );
+
+    void *allocate ( size_t bytes, size_t align = alignof ( max_align_t ) );
+    void release ( void *ptr, size_t bytes );
+    void reset ( void );
+    SSObjectArenaStats getStats ( void );
+
+    // The current thread's arena, and RAII object which makes an arena current while in scope
+
+    static SSObjectArena *current ( void );
+
+    class Scope
+    {
+        SSObjectArena *_previous;   // arena which was current before this scope
+
+    public:
+
+        Scope ( SSObjectArena *pArena );
+        ~Scope ( void );
+    };
+
+    // Memory for objects and their small vectors, from the current arena or heap; or from an arena (pArena), or heap if nullptr
+
+    static void *allocateObject ( size_t bytes );
+    static void releaseObject ( void *ptr, size_t bytes );
+    static void *allocate ( SSObjectArena *pArena, size_t bytes, size_t align );
+    static void release ( SSObjectArena *pArena, void *ptr, size_t bytes );
+    static SSObjectArenaStats heapStats ( void );
+};
+
+#endif /* SSObjectArena_hpp */
@@ -0,0 +1,756 @@
+// SSObjectBinary.cpp
+// SSCore
+//
+// Created by Tim DeBenedictis on 10/16/26.
+// Copyright © 2026 Southern Stars. All rights reserved.
+
+#include <stdio.h>
+#include <string.h>
+#include <unordered_map>
+
+#include "SSObjectBinary.hpp"
+#include "SSStar.hpp"
+#include "SSPlanet.hpp"
+#include "SSFeature.hpp"
+#include "SSConstellation.hpp"
+#include "SSUtilities.hpp"
+
+static const char kMagic[8] = { 'S', 'S', 'O', 'B', 'J', 'B', 'I', 'N' };
+
+static constexpr uint32_t kNoOrbit = 0xffffffff;    // orbit index of double stars without orbits
+static constexpr int kNumSections = kSectionStrings + 1;
+static constexpr size_t kHeaderSize = 24;
+static constexpr size_t kDirectoryEntrySize = 24;
+
+// Size in bytes of each section's records in the current version, indexed by section identifier.
+
+static constexpr uint32_t kRecordSizes[kNumSections] =
+{
+    0,      // unused
+    12,     // kSectionObjects
+    76,     // kSectionStars
+    24,     // kSectionDoubleStars
+    28,     // kSectionVariableStars
+    12,     // kSectionDeepSky
+    136,    // kSectionPlanets
+    121,    // kSectionSatellites
+    24,     // kSectionFeatures
+    29,     // kSectionCities
+    52,     // kSectionConstellations
+    4,      // kSectionNames
+    8,      // kSectionIdentifiers
+    96,     // kSectionOrbits
+    32,     // kSectionFrequencies
+    24,     // kSectionVectors
+    4,      // kSectionFigures
+    1       // kSectionStrings
+};
+
+// Returns the set of sections in which an object (pObj) has records, as a bit mask with one bit
+// for each section identifier: one for every class in the object's class hierarchy.
+
+static uint32_t objectSections ( SSObjectPtr pObj )
+{
+    uint32_t sections = 1 << kSectionObjects;
+
+    if ( SSGetStarPtr ( pObj ) != nullptr )
+        sections |= 1 << kSectionStars;
+    if ( SSGetDoubleStarPtr ( pObj ) != nullptr )
+        sections |= 1 << kSectionDoubleStars;
+    if ( SSGetVariableStarPtr ( pObj ) != nullptr )
+        sections |= 1 << kSectionVariableStars;
+    if ( SSGetDeepSkyPtr ( pObj ) != nullptr )
+        sections |= 1 << kSectionDeepSky;
+    if ( SSGetPlanetPtr ( pObj ) != nullptr )
+        sections |= 1 << kSectionPlanets;
+    if ( SSGetSatellitePtr ( pObj ) != nullptr )
+        sections |= 1 << kSectionSatellites;
+    if ( SSGetFeaturePtr ( pObj ) != nullptr )
+        sections |= 1 << kSectionFeatures;
+    if ( SSGetCityPtr ( pObj ) != nullptr )
+        sections |= 1 << kSectionCities;
+    if ( SSGetConstellationPtr ( pObj ) != nullptr )
+        sections |= 1 << kSectionConstellations;
+
+    return sections;
+}
+
+// Returns the class of an object whose records are in a set of sections (sections),
+// or zero if the object's class can't be stored.
+
+static int objectClass ( uint32_t sections )
+{
+    if ( sections & 1 << kSectionConstellations )
+        return kClassConstellation;
+    else if ( sections & 1 << kSectionCities )
+        return kClassCity;
+    else if ( sections & 1 << kSectionFeatures )
+        return kClassFeature;
+    else if ( sections & 1 << kSectionSatellites )
+        return kClassSatellite;
+    else if ( sections & 1 << kSectionPlanets )
+        return kClassPlanet;
+    else if ( sections & 1 << kSectionDeepSky )
+        return kClassDeepSky;
+    else if ( ( sections & 1 << kSectionDoubleStars ) && ( sections & 1 << kSectionVariableStars ) )
+        return kClassDoubleVariableStar;
+    else if ( sections & 1 << kSectionDoubleStars )
+        return kClassDoubleStar;
+    else if ( sections & 1 << kSectionVariableStars )
+        return kClassVariableStar;
+    else if ( sections & 1 << kSectionStars )
+        return kClassStar;
+    else
+        return 0;
+}
+
+// Allocates a new object of a class (cls) with a type code (type), or nullptr if the class is unknown.
+// Satellites are constructed from a TLE (tle), which other classes ignore.
+
+static SSObjectPtr newObject ( int cls, SSObjectType type, SSTLE &tle )
+{
+    SSObjectPtr pObj = nullptr;
+
+    if ( cls == kClassStar )
+        pObj = new SSStar;
+    else if ( cls == kClassDoubleStar )
+        pObj = new SSDoubleStar;
+    else if ( cls == kClassVariableStar )
+        pObj = new SSVariableStar;
+    else if ( cls == kClassDoubleVariableStar )
+        pObj = new SSDoubleVariableStar;
+    else if ( cls == kClassDeepSky )
+        pObj = new SSDeepSky ( type );
+    else if ( cls == kClassPlanet )
+        pObj = new SSPlanet ( type );
+    else if ( cls == kClassSatellite )
+        pObj = new SSSatellite ( tle );
+    else if ( cls == kClassFeature )
+        pObj = new SSFeature;
+    else if ( cls == kClassCity )
+        pObj = new SSCity;
+    else if ( cls == kClassConstellation )
+        pObj = new SSConstellation ( type );
+
+    if ( pObj != nullptr )
+        pObj->setType ( type );
+
+    return pObj;
+}
+
+// Appends little-endian values to a section's records while exporting.
+
+struct SSBinarySection
+{
+    vector<uint8_t> data;       // section's records
+    uint64_t count = 0;         // number of records in section
+
+    void put8 ( uint8_t v ) { data.push_back ( v ); }
+    void put16 ( uint16_t v ) { put8 ( v & 0xff ); put8 ( v >> 8 ); }
+    void put32 ( uint32_t v ) { put16 ( v & 0xffff ); put16 ( v >> 16 ); }
+    void put64 ( uint64_t v ) { put32 ( v & 0xffffffff ); put32 ( v >> 32 ); }
+    void putf ( float f ) { uint32_t v; memcpy ( &v, &f, 4 ); put32 ( v ); }
+    void putd ( double d ) { uint64_t v; memcpy ( &v, &d, 8 ); put64 ( v ); }
+    void putv ( SSVector vec ) { putd ( vec.x ); putd ( vec.y ); putd ( vec.z ); }
+};
+
+// Reads little-endian values from a record, advancing the read pointer (p) past each value.
+
+static uint8_t get8 ( const uint8_t *&p ) { return *p++; }
+static uint16_t get16 ( const uint8_t *&p ) { uint16_t v = p[0] | p[1] << 8; p += 2; return v; }
+static uint32_t get32 ( const uint8_t *&p ) { uint32_t v = p[0] | p[1] << 8 | p[2] << 16 | (uint32_t) p[3] << 24; p += 4; return v; }
+static uint64_t get64 ( const uint8_t *&p ) { uint64_t v = get32 ( p ); return v | (uint64_t) get32 ( p ) << 32; }
+static float getf ( const uint8_t *&p ) { uint32_t v = get32 ( p ); float f; memcpy ( &f, &v, 4 ); return f; }
+static double getd ( const uint8_t *&p ) { uint64_t v = get64 ( p ); double d; memcpy ( &d, &v, 8 ); return d; }
+static SSVector getv ( const uint8_t *&p ) { double x = getd ( p ), y = getd ( p ); return SSVector ( x, y, getd ( p ) ); }
+
+static void putOrbit ( SSBinarySection &sec, const SSOrbit &orbit )
+{
+    for ( double d : { orbit.t, orbit.q, orbit.e, orbit.i, orbit.w, orbit.n, orbit.m, orbit.mm, orbit.wrate, orbit.nrate, orbit.polera, orbit.poledec } )
+        sec.putd ( d );
+}
+
+static SSOrbit getOrbit ( const uint8_t *&p )
+{
+    SSOrbit orbit;
+
+    for ( double *d : { &orbit.t, &orbit.q, &orbit.e, &orbit.i, &orbit.w, &orbit.n, &orbit.m, &orbit.mm, &orbit.wrate, &orbit.nrate, &orbit.polera, &orbit.poledec } )
+        *d = getd ( p );
+
+    return orbit;
+}
+
+// Exports a vector of objects (objects) to a binary snapshot file (filename), overwriting it.
+// If a non-null filter function (filter) is provided, objects are exported only if they pass
+// the filter; optional data pointer (userData) is passed to the filter but not used otherwise.
+// Objects which aren't stars, solar system objects, features, or constellations are skipped.
+// Returns the number of objects exported, or zero on failure.
+
+int SSExportObjectsToBinary ( const string &filename, SSObjectVec &objects, SSObjectFilter filter, void *userData )
+{
+    vector<SSBinarySection> sections ( kNumSections );
+    unordered_map<string,uint32_t> pool;
+
+    // Adds a string to the string pool if not already present, and returns its offset.
+
+    SSBinarySection &strings = sections[kSectionStrings];
+    strings.put8 ( 0 );
+    pool[""] = 0;
+
+    auto addString = [&] ( const string &str )
+    {
+        auto it = pool.find ( str );
+        if ( it != pool.end() )
+            return it->second;
+
+        uint32_t offset = (uint32_t) strings.data.size();
+        strings.data.insert ( strings.data.end(), str.c_str(), str.c_str() + str.length() + 1 );
+        pool[str] = offset;
+        return offset;
+    };
+
+    for ( size_t i = 0; i < objects.size(); i++ )
+    {
+        SSObjectPtr pObj = objects[i];
+        if ( pObj == nullptr || ( filter != nullptr && ! filter ( pObj, userData ) ) )
+            continue;
+
+        SSObjectType type = pObj->getType();
+        int cls = objectClass ( objectSections ( pObj ) );
+        if ( type < 0 || type > UINT8_MAX || cls == 0 )
+            continue;
+
+        SSBinarySection &sec = sections[kSectionObjects];
+        const SSNames &names = pObj->getNames();
+        sec.put8 ( type );
+        sec.put8 ( cls );
+        sec.put16 ( (uint16_t) min ( names.size(), (size_t) UINT16_MAX ) );
+        sec.put32 ( (uint32_t) sections[kSectionNames].count );
+        sec.put32 ( addString ( pObj->getDescription() ) );
+        sec.count++;
+
+        for ( size_t n = 0; n < names.size() && n < UINT16_MAX; n++ )
+        {
+            sections[kSectionNames].put32 ( addString ( names[n] ) );
+            sections[kSectionNames].count++;
+        }
+
+        SSStarPtr pStar = SSGetStarPtr ( pObj );
+        if ( pStar != nullptr )
+        {
+            SSBinarySection &sec = sections[kSectionStars];
+            const SSIdentifiers &idents = pStar->getIdents();
+            sec.putv ( pStar->getFundamentalPosition() );
+            sec.putv ( pStar->getFundamentalVelocity() );
+            sec.putf ( pStar->getParallax() );
+            sec.putf ( pStar->getRadVel() );
+            sec.putf ( pStar->getVMagnitude() );
+            sec.putf ( pStar->getBMagnitude() );
+            sec.put32 ( addString ( pStar->getSpectralType() ) );
+            sec.put32 ( (uint32_t) idents.size() );
+            sec.put32 ( (uint32_t) sections[kSectionIdentifiers].count );
+            sec.count++;
+
+            for ( SSIdentifier ident : idents )
+                sections[kSectionIdentifiers].put64 ( ident );
+            sections[kSectionIdentifiers].count += idents.size();
+        }
+
+        SSDoubleStarPtr pDouble = SSGetDoubleStarPtr ( pObj );
+        if ( pDouble != nullptr )
+        {
+            SSBinarySection &sec = sections[kSectionDoubleStars];
+            sec.put32 ( addString ( pDouble->getComponents() ) );
+            sec.putf ( pDouble->getMagnitudeDelta() );
+            sec.putf ( pDouble->getSeparation() );
+            sec.putf ( pDouble->getPositionAngle() );
+            sec.putf ( pDouble->getPositionAngleYear() );
+            sec.put32 ( pDouble->hasOrbit() ? (uint32_t) sections[kSectionOrbits].count : kNoOrbit );
+            sec.count++;
+
+            if ( pDouble->hasOrbit() )
+            {
+                putOrbit ( sections[kSectionOrbits], pDouble->getOrbit() );
+                sections[kSectionOrbits].count++;
+            }
+        }
+
+        SSVariableStarPtr pVariable = SSGetVariableStarPtr ( pObj );
+        if ( pVariable != nullptr )
+        {
+            SSBinarySection &sec = sections[kSectionVariableStars];
+            sec.put32 ( addString ( pVariable->getVariableType() ) );
+            sec.putf ( pVariable->getMaximumMagnitude() );
+            sec.putf ( pVariable->getMinimumMagnitude() );
+            sec.putd ( pVariable->getPeriod() );
+            sec.putd ( pVariable->getEpoch() );
+            sec.count++;
+        }
+
+        SSDeepSkyPtr pDeepSky = SSGetDeepSkyPtr ( pObj );
+        if ( pDeepSky != nullptr )
+        {
+            SSBinarySection &sec = sections[kSectionDeepSky];
+            sec.putf ( pDeepSky->getMajorAxis() );
+            sec.putf ( pDeepSky->getMinorAxis() );
+            sec.putf ( pDeepSky->getPositionAngle() );
+            sec.count++;
+        }
+
+        SSPlanetPtr pPlanet = SSGetPlanetPtr ( pObj );
+        if ( pPlanet != nullptr )
+        {
+            SSBinarySection &sec = sections[kSectionPlanets];
+            sec.put64 ( pPlanet->getIdentifier() );
+            putOrbit ( sec, pPlanet->getOrbit() );
+            sec.putf ( pPlanet->getHMagnitude() );
+            sec.putf ( pPlanet->getGMagnitude() );
+            sec.putf ( pPlanet->getColorIndex() );
+            sec.putf ( pPlanet->getRadius() );
+            sec.putf ( pPlanet->getMass() );
+            sec.putf ( pPlanet->getRotationPeriod() );
+            sec.putf ( pPlanet->getAlbedo() );
+            sec.put32 ( addString ( pPlanet->getTaxonomy() ) );
+            sec.count++;
+        }
+
+        SSSatellitePtr pSat = SSGetSatellitePtr ( pObj );
+        if ( pSat != nullptr )
+        {
+            SSBinarySection &sec = sections[kSectionSatellites];
+            SSTLE tle = pSat->getTLE();
+            vector<SSSatellite::FreqData> freqs = pSat->getRadioFrequencies();
+            sec.put32 ( addString ( tle.name ) );
+            sec.put32 ( addString ( tle.desig ) );
+            sec.put32 ( tle.norad );
+            sec.put32 ( tle.elset );
+            sec.put32 ( tle.revno );
+            for ( double d : { tle.jdepoch, tle.xndt2o, tle.xndd6o, tle.bstar, tle.xincl, tle.xnodeo, tle.eo, tle.omegao, tle.xmo, tle.xno } )
+                sec.putd ( d );
+            sec.put8 ( tle.deep );
+            sec.put32 ( addString ( pSat->getSourceCountry() ) );
+            sec.put32 ( addString ( pSat->getLaunchSite() ) );
+            sec.putf ( pSat->getLaunchDate() );
+            sec.put32 ( (uint32_t) freqs.size() );
+            sec.put32 ( (uint32_t) sections[kSectionFrequencies].count );
+            sec.count++;
+
+            for ( SSSatellite::FreqData &freq : freqs )
+            {
+                SSBinarySection &sec = sections[kSectionFrequencies];
+                sec.put32 ( freq.norad );
+                for ( const string &str : { freq.name, freq.uplink, freq.downlink, freq.beacon, freq.mode, freq.callsign, freq.status } )
+                    sec.put32 ( addString ( str ) );
+                sec.count++;
+            }
+        }
+
+        SSFeaturePtr pFeature = SSGetFeaturePtr ( pObj );
+        if ( pFeature != nullptr )
+        {
+            SSBinarySection &sec = sections[kSectionFeatures];
+            sec.put32 ( addString ( pFeature->getTarget() ) );
+            sec.put32 ( addString ( pFeature->getFeatureTypeCode() ) );
+            sec.put32 ( addString ( pFeature->getOrigin() ) );
+            sec.putf ( pFeature->getDiameter() );
+            sec.putf ( pFeature->getLatitude() );
+            sec.putf ( pFeature->getLongitude() );
+            sec.count++;
+        }
+
+        SSCityPtr pCity = SSGetCityPtr ( pObj );
+        if ( pCity != nullptr )
+        {
+            SSBinarySection &sec = sections[kSectionCities];
+            sec.put32 ( addString ( pCity->getCountryCode() ) );
+            sec.put32 ( addString ( pCity->getAdmin1Code() ) );
+            sec.put32 ( addString ( pCity->getAdmin1Name() ) );
+            sec.put32 ( addString ( pCity->getTimezoneName() ) );
+            sec.putf ( pCity->getElevation() );
+            sec.put32 ( pCity->getPopulation() );
+            sec.put8 ( pCity->getDaylightSaving() );
+            sec.putf ( pCity->getTimezoneRawOffset() );
+            sec.count++;
+        }
+
+        SSConstellationPtr pCon = SSGetConstellationPtr ( pObj );
+        if ( pCon != nullptr )
+        {
+            SSBinarySection &sec = sections[kSectionConstellations];
+            vector<SSVector> bounds = pCon->getBoundary();
+            vector<int> figures = pCon->getFigure();
+            sec.putv ( pCon->getDirection() );
+            sec.putd ( pCon->getArea() );
+            sec.put32 ( pCon->getRank() );
+            sec.put32 ( (uint32_t) bounds.size() );
+            sec.put32 ( (uint32_t) sections[kSectionVectors].count );
+            sec.put32 ( (uint32_t) figures.size() );
+            sec.put32 ( (uint32_t) sections[kSectionFigures].count );
+            sec.count++;
+
+            for ( SSVector &vec : bounds )
+                sections[kSectionVectors].putv ( vec );
+            sections[kSectionVectors].count += bounds.size();
+
+            for ( int hr : figures )
+                sections[kSectionFigures].put32 ( hr );
+            sections[kSectionFigures].count += figures.size();
+        }
+    }
+
+    strings.count = strings.data.size();
+
+    // Write header, then section directory, then each section padded to an 8-byte boundary.
+
+    SSBinarySection header;
+    header.data.insert ( header.data.end(), kMagic, kMagic + sizeof ( kMagic ) );
+    header.put32 ( kSSObjectBinaryVersion );
+    header.put32 ( kNumSections - 1 );
+    header.put64 ( sections[kSectionObjects].count );
+
+    uint64_t offset = kHeaderSize + kDirectoryEntrySize * ( kNumSections - 1 );
+    for ( int id = 1; id < kNumSections; id++ )
+    {
+        offset = ( offset + 7 ) & ~7;
+        header.put32 ( id );
+        header.put32 ( kRecordSizes[id] );
+        header.put64 ( sections[id].count );
+        header.put64 ( offset );
+        offset += sections[id].data.size();
+    }
+
+    FILE *file = fopen ( filename.c_str(), "wb" );
+    if ( file == nullptr )
+        return 0;
+
+    static const uint8_t zeros[8] = { 0 };
+    bool ok = fwrite ( header.data.data(), 1, header.data.size(), file ) == header.data.size();
+    offset = header.data.size();
+    for ( int id = 1; id < kNumSections && ok; id++ )
+    {
+        size_t padding = ( ( offset + 7 ) & ~7 ) - offset;
+        ok = fwrite ( zeros, 1, padding, file ) == padding;
+        if ( ! sections[id].data.empty() )
+            ok = ok && fwrite ( sections[id].data.data(), 1, sections[id].data.size(), file ) == sections[id].data.size();
+        offset += padding + sections[id].data.size();
+    }
+    ok = fclose ( file ) == 0 && ok;
+
+    return ok ? (int) sections[kSectionObjects].count : 0;
+}
+
+// Imports objects from a binary snapshot file (filename) written by SSExportObjectsToBinary().
+// Imported objects are appended to the input vector of SSObjects (objects), in the order
+// they were exported. If a non-null filter function (filter) is provided, objects are
+// imported only if they pass the filter; optional data pointer (userData) is passed
+// to the filter but not used otherwise. The file is memory-mapped, and objects are
+// created directly from its records. Stops at the first invalid record.
+// Function returns number of objects successfully imported.
+
+int SSImportObjectsFromBinary ( const string &filename, SSObjectVec &objects, SSObjectFilter filter, void *userData )
+{
+    SSObjectArena::Scope scope ( objects.getArena() );
+    size_t size = 0;
+    const uint8_t *pData = (const uint8_t *) mapfile ( filename, size );
+    if ( pData == nullptr )
+        return 0;
+
+    // Validate header, then find each section we know about, and make sure it lies within the file.
+
+    struct { const uint8_t *pRecords = nullptr; uint32_t recordSize = 0; uint64_t count = 0; uint64_t next = 0; } sections[kNumSections];
+
+    const uint8_t *p = pData + sizeof ( kMagic );
+    uint32_t version = size >= kHeaderSize ? get32 ( p ) : 0;
+    uint32_t numSections = size >= kHeaderSize ? get32 ( p ) : 0;
+    uint64_t numObjects = size >= kHeaderSize ? get64 ( p ) : 0;
+    bool ok = size >= kHeaderSize && memcmp ( pData, kMagic, sizeof ( kMagic ) ) == 0 && version == kSSObjectBinaryVersion
+           && numSections <= ( size - kHeaderSize ) / kDirectoryEntrySize;
+
+    for ( uint32_t i = 0; ok && i < numSections; i++ )
+    {
+        uint32_t id = get32 ( p );
+        uint32_t recordSize = get32 ( p );
+        uint64_t count = get64 ( p );
+        uint64_t offset = get64 ( p );
+
+        if ( id < 1 || id >= kNumSections )
+            continue;
+
+        ok = recordSize >= kRecordSizes[id] && offset <= size && count <= ( size - offset ) / recordSize;
+        sections[id].pRecords = ok ? pData + offset : nullptr;
+        sections[id].recordSize = recordSize;
+        sections[id].count = count;
+    }
+
+    const char *pStrings = (const char *) sections[kSectionStrings].pRecords;
+    uint64_t stringsSize = sections[kSectionStrings].count;
+    ok = ok && stringsSize > 0 && pStrings[ stringsSize - 1 ] == 0 && sections[kSectionObjects].count == numObjects;
+
+    // Returns pointer to the next record in a section, or nullptr if there are no more.
+    // Returns the string at an offset in the string pool, or an empty string if the offset is invalid.
+    // Returns true if a range of (n) entries starting at (first) lies within a table section (id).
+    // Returns pointer to the i-th entry in a table section (id).
+
+    auto nextRecord = [&] ( int id )
+    {
+        auto &sec = sections[id];
+        return sec.next < sec.count ? sec.pRecords + sec.recordSize * sec.next++ : nullptr;
+    };
+
+    auto getString = [&] ( const uint8_t *&p )
+    {
+        uint32_t offset = get32 ( p );
+        return offset < stringsSize ? string ( pStrings + offset ) : string();
+    };
+
+    auto inTable = [&] ( int id, uint64_t first, uint64_t n )
+    {
+        return first <= sections[id].count && n <= sections[id].count - first;
+    };
+
+    auto tableEntry = [&] ( int id, uint64_t i )
+    {
+        return sections[id].pRecords + sections[id].recordSize * i;
+    };
+
+    // Create objects from records, in order. Each object takes its next record from the
+    // section of every class in its class hierarchy. Satellites must be constructed from their TLE,
+    // so their satellite records are read first, up to the end of the TLE.
+
+    int numImported = 0;
+    uint32_t classSections[256] = { 0 };
+
+    for ( uint64_t i = 0; ok && i < numObjects; i++ )
+    {
+        const uint8_t *p = nextRecord ( kSectionObjects );
+        SSObjectType type = (SSObjectType) get8 ( p );
+        int cls = get8 ( p );
+        uint16_t numNames = get16 ( p );
+        uint32_t firstName = get32 ( p );
+        string desc = getString ( p );
+
+        const uint8_t *pSatRecord = nullptr;
+        SSTLE tle;
+        if ( cls == kClassSatellite )
+        {
+            p = nextRecord ( kSectionSatellites );
+            if ( p != nullptr )
+            {
+                tle.name = getString ( p );
+                tle.desig = getString ( p );
+                tle.norad = get32 ( p );
+                tle.elset = get32 ( p );
+                tle.revno = get32 ( p );
+                for ( double *d : { &tle.jdepoch, &tle.xndt2o, &tle.xndd6o, &tle.bstar, &tle.xincl, &tle.xnodeo, &tle.eo, &tle.omegao, &tle.xmo, &tle.xno } )
+                    *d = getd ( p );
+                tle.deep = get8 ( p );
+                pSatRecord = p;
+            }
+        }
+
+        SSObjectPtr pObj = cls != kClassSatellite || pSatRecord != nullptr ? newObject ( cls, type, tle ) : nullptr;
+        if ( pObj == nullptr || ! inTable ( kSectionNames, firstName, numNames ) )
+        {
+            delete pObj;
+            break;
+        }
+
+        if ( classSections[cls] == 0 )
+            classSections[cls] = objectSections ( pObj );
+
+        SSNames names;
+        names.reserve ( numNames );
+        for ( int n = 0; n < numNames; n++ )
+        {
+            const uint8_t *p = tableEntry ( kSectionNames, (uint64_t) firstName + n );
+            names.push_back ( getString ( p ) );
+        }
+
+        pObj->setNames ( names );
+        pObj->setDescription ( desc );
+
+        // For every other class in the object's hierarchy, read the class's next record; stop if it's missing.
+
+        uint32_t needed = classSections[cls] & ~( 1 << kSectionObjects | 1 << kSectionSatellites );
+        for ( int id = 0; id < kNumSections && ok; id++ )
+            if ( ( needed & 1 << id ) && sections[id].next >= sections[id].count )
+                ok = false;
+
+        SSStarPtr pStar = SSGetStarPtr ( pObj );
+        if ( ok && pStar != nullptr )
+        {
+            const uint8_t *p = nextRecord ( kSectionStars );
+            pStar->setFundamentalPosition ( getv ( p ) );
+            pStar->setFundamentalVelocity ( getv ( p ) );
+            pStar->setParallax ( getf ( p ) );
+            pStar->setRadVel ( getf ( p ) );
+            pStar->setVMagnitude ( getf ( p ) );
+            pStar->setBMagnitude ( getf ( p ) );
+            pStar->setSpectralType ( getString ( p ) );
+
+            uint32_t numIdents = get32 ( p );
+            uint32_t firstIdent = get32 ( p );
+            ok = numIdents <= UINT16_MAX && inTable ( kSectionIdentifiers, firstIdent, numIdents );
+
+            SSIdentifiers idents;
+            idents.reserve ( ok ? numIdents : 0 );
+            for ( uint32_t n = 0; ok && n < numIdents; n++ )
+            {
+                const uint8_t *p = tableEntry ( kSectionIdentifiers, (uint64_t) firstIdent + n );
+                idents.push_back ( SSIdentifier ( get64 ( p ) ) );
+            }
+            pStar->setIdentifiers ( idents );
+        }
+
+        SSDoubleStarPtr pDouble = SSGetDoubleStarPtr ( pObj );
+        if ( ok && pDouble != nullptr )
+        {
+            const uint8_t *p = nextRecord ( kSectionDoubleStars );
+            pDouble->setComponents ( getString ( p ) );
+            pDouble->setMagnitudeDelta ( getf ( p ) );
+            pDouble->setSeparation ( getf ( p ) );
+            pDouble->setPositionAngle ( getf ( p ) );
+            pDouble->setPositionAngleYear ( getf ( p ) );
+
+            uint32_t orbit = get32 ( p );
+            if ( orbit != kNoOrbit && inTable ( kSectionOrbits, orbit, 1 ) )
+            {
+                const uint8_t *p = tableEntry ( kSectionOrbits, orbit );
+                pDouble->setOrbit ( getOrbit ( p ) );
+            }
+        }
+
+        SSVariableStarPtr pVariable = SSGetVariableStarPtr ( pObj );
+        if ( ok && pVariable != nullptr )
+        {
+            const uint8_t *p = nextRecord ( kSectionVariableStars );
+            pVariable->setVariableType ( getString ( p ) );
+            pVariable->setMaximumMagnitude ( getf ( p ) );
+            pVariable->setMinimumMagnitude ( getf ( p ) );
+            pVariable->setPeriod ( getd ( p ) );
+            pVariable->setEpoch ( getd ( p ) );
+        }
+
+        SSDeepSkyPtr pDeepSky = SSGetDeepSkyPtr ( pObj );
+        if ( ok && pDeepSky != nullptr )
+        {
+            const uint8_t *p = nextRecord ( kSectionDeepSky );
+            pDeepSky->setMajorAxis ( getf ( p ) );
+            pDeepSky->setMinorAxis ( getf ( p ) );
+            pDeepSky->setPositionAngle ( getf ( p ) );
+        }
+
+        SSPlanetPtr pPlanet = SSGetPlanetPtr ( pObj );
+        if ( ok && pPlanet != nullptr )
+        {
+            const uint8_t *p = nextRecord ( kSectionPlanets );
+            pPlanet->setIdentifier ( SSIdentifier ( get64 ( p ) ) );
+            pPlanet->setOrbit ( getOrbit ( p ) );
+            pPlanet->setHMagnitude ( getf ( p ) );
+            pPlanet->setGMagnitude ( getf ( p ) );
+            pPlanet->setColorIndex ( getf ( p ) );
+            pPlanet->setRadius ( getf ( p ) );
+            pPlanet->setMass ( getf ( p ) );
+            pPlanet->setRotationPeriod ( getf ( p ) );
+            pPlanet->setAlbedo ( getf ( p ) );
+            pPlanet->setTaxonomy ( getString ( p ) );
+        }
+
+        SSSatellitePtr pSat = SSGetSatellitePtr ( pObj );
+        if ( ok && pSat != nullptr )
+        {
+            const uint8_t *p = pSatRecord;
+            pSat->setSourceCountry ( getString ( p ) );
+            pSat->setLaunchSite ( getString ( p ) );
+            pSat->setLaunchDate ( getf ( p ) );
+
+            uint32_t numFreqs = get32 ( p );
+            uint32_t firstFreq = get32 ( p );
+            ok = inTable ( kSectionFrequencies, firstFreq, numFreqs );
+
+            vector<SSSatellite::FreqData> freqs ( ok ? numFreqs : 0 );
+            for ( size_t n = 0; n < freqs.size(); n++ )
+            {
+                const uint8_t *p = tableEntry ( kSectionFrequencies, (uint64_t) firstFreq + n );
+                SSSatellite::FreqData &freq = freqs[n];
+                freq.norad = get32 ( p );
+                for ( string *str : { &freq.name, &freq.uplink, &freq.downlink, &freq.beacon, &freq.mode, &freq.callsign, &freq.status } )
+                    *str = getString ( p );
+            }
+            pSat->setRadioFrequencies ( freqs );
+        }
+
+        SSFeaturePtr pFeature = SSGetFeaturePtr ( pObj );
+        if ( ok && pFeature != nullptr )
+        {
+            const uint8_t *p = nextRecord ( kSectionFeatures );
+            pFeature->setTarget ( getString ( p ) );
+            pFeature->setFeatureTypeCode ( getString ( p ) );
+            pFeature->setOrigin ( getString ( p ) );
+            pFeature->setDiameter ( getf ( p ) );
+            pFeature->setLatitude ( getf ( p ) );
+            pFeature->setLongitude ( getf ( p ) );
+        }
+
+        SSCityPtr pCity = SSGetCityPtr ( pObj );
+        if ( ok && pCity != nullptr )
+        {
+            const uint8_t *p = nextRecord ( kSectionCities );
+            pCity->setCountryCode ( getString ( p ) );
+            pCity->setAdmin1Code ( getString ( p ) );
+            pCity->setAdmin1Name ( getString ( p ) );
+            pCity->setTimezoneName ( getString ( p ) );
+            pCity->setElevation ( getf ( p ) );
+            pCity->setPopulation ( get32 ( p ) );
+            pCity->setDaylightSaving ( get8 ( p ) );
+            pCity->setTimezoneRawOffset ( getf ( p ) );
+        }
+
+        SSConstellationPtr pCon = SSGetConstellationPtr ( pObj );
+        if ( ok && pCon != nullptr )
+        {
+            const uint8_t *p = nextRecord ( kSectionConstellations );
+            pCon->setDirection ( getv ( p ) );
+            pCon->setArea ( getd ( p ) );
+            pCon->setRank ( get32 ( p ) );
+
+            uint32_t numBounds = get32 ( p );
+            uint32_t firstBound = get32 ( p );
+            uint32_t numFigures = get32 ( p );
+            uint32_t firstFigure = get32 ( p );
+            ok = inTable ( kSectionVectors, firstBound, numBounds ) && inTable ( kSectionFigures, firstFigure, numFigures );
+
+            vector<SSVector> bounds ( ok ? numBounds : 0 );
+            for ( size_t n = 0; n < bounds.size(); n++ )
+            {
+                const uint8_t *p = tableEntry ( kSectionVectors, (uint64_t) firstBound + n );
+                bounds[n] = getv ( p );
+            }
+
+            vector<int> figures ( ok ? numFigures : 0 );
+            for ( size_t n = 0; n < figures.size(); n++ )
+            {
+                const uint8_t *p = tableEntry ( kSectionFigures, (uint64_t) firstFigure + n );
+                figures[n] = get32 ( p );
+            }
+
+            pCon->setBoundary ( bounds );
+            pCon->setFigure ( figures );
+        }
+
+        // If the object is complete and passes the filter, add it to the object vector.
+
+        if ( ok && ( filter == nullptr || filter ( pObj, userData ) ) )
+        {
+            objects.append ( pObj );
+            numImported++;
+        }
+        else
+        {
+            delete pObj;
+        }
+    }
+
+    unmapfile ( pData, size );
+    return numImported;
+}
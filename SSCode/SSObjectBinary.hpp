@@ -0,0 +1,88 @@
+// SSObjectBinary.hpp
+// SSCore
+//
+// Created by Tim DeBenedictis on 10/16/26.
+// Copyright © 2026 Southern Stars. All rights reserved.
+//
+// Binary snapshot files for entire object arrays, as a much faster alternative to CSV files.
+// A snapshot holds any mix of stars, deep sky objects, solar system objects, satellites,
+// planetary surface features, cities, and constellations, and reproduces them exactly:
+// every imported object's toCSV() string is identical to the exported object's.
+//
+// File layout: a header, then a directory of sections, then the sections themselves, each starting
+// on an 8-byte boundary. Every section is an array of fixed-size records. The objects section has one
+// record per object, in array order, with its type code, class, names, and description. The class is
+// stored separately from the type because they don't always match: SSStar::fromCSV() creates some
+// stars as SSDeepSky objects, which must be read back the same way. Each class in an
+// object's class hierarchy then contributes one record to that class's section, in the same order;
+// for example, a double variable star has a record in the stars, double stars, and variable stars
+// sections. Variable-length data (identifiers, double star orbits, satellite radio frequencies,
+// constellation boundaries and figures) are stored in shared tables which records refer to by index.
+// All strings are stored once each in a pool of NUL-terminated strings, which records refer to
+// by byte offset; offset zero is the empty string. Identifiers are stored as packed uint64 values.
+// All multi-byte values are little-endian, regardless of the host's native byte order.
+// Compatible additions to the format append fields to records or add sections; readers step through
+// records by the record size in each section's directory entry, so they skip fields they don't know
+// about, and ignore sections they don't know about. Incompatible changes increment the version.
+
+#ifndef SSObjectBinary_hpp
+#define SSObjectBinary_hpp
+
+#include "SSObject.hpp"
+
+// File header: always the first 24 bytes of the file, followed by the section directory.
+//   char     magic[8];         // "SSOBJBIN"
+//   uint32_t version;          // file format version; currently kSSObjectBinaryVersion
+//   uint32_t numSections;      // number of section directory entries following the header
+//   uint64_t numObjects;       // number of objects in the file
+
+// Section directory entry: 24 bytes each.
+//   uint32_t id;               // section identifier (SSObjectBinarySection)
+//   uint32_t recordSize;       // size of each record in bytes
+//   uint64_t numRecords;       // number of records in section
+//   uint64_t offset;           // offset of section's first record from start of file
+
+constexpr uint32_t kSSObjectBinaryVersion = 1;
+
+enum SSObjectBinarySection
+{
+    kSectionObjects = 1,        // one per object: type (u8), class (u8), name count (u16), first name (u32), description string (u32)
+    kSectionStars = 2,          // position & velocity (3 x f64 each), parallax, radvel, Vmag, Bmag (f32), spectrum string, identifier count, first identifier (u32)
+    kSectionDoubleStars = 3,    // components string (u32), magDelta, separation, PA, PA year (f32), orbit index or 0xffffffff (u32)
+    kSectionVariableStars = 4,  // variable type string (u32), max & min magnitudes (f32), period & epoch (f64)
+    kSectionDeepSky = 5,        // major axis, minor axis, PA (f32)
+    kSectionPlanets = 6,        // identifier (u64), orbit (12 x f64), H, G, B-V, radius, mass, rotation period, albedo (f32), taxonomy string (u32)
+    kSectionSatellites = 7,     // TLE name & designation strings (u32), NORAD number, element set, rev number (i32), TLE epoch and elements (10 x f64),
+                                // deep space flag (u8), source country & launch site strings (u32), launch date (f32), frequency count, first frequency (u32)
+    kSectionFeatures = 8,       // target, type code, origin strings (u32), diameter, latitude, longitude (f32)
+    kSectionCities = 9,         // country code, admin1 code, admin1 name, time zone name strings (u32), elevation (f32), population (i32), DST flag (u8), raw offset (f32)
+    kSectionConstellations = 10,// direction (3 x f64), area (f64), rank (i32), boundary vertex count, first vertex, figure count, first figure (u32)
+    kSectionNames = 11,         // name strings (u32), referred to by object records
+    kSectionIdentifiers = 12,   // packed identifiers (u64), referred to by star records
+    kSectionOrbits = 13,        // double star orbits (12 x f64, in SSOrbit member order)
+    kSectionFrequencies = 14,   // satellite radio frequencies: NORAD number (i32), name, uplink, downlink, beacon, mode, callsign, status strings (u32)
+    kSectionVectors = 15,       // constellation boundary vertices (3 x f64)
+    kSectionFigures = 16,       // constellation figure HR numbers (i32)
+    kSectionStrings = 17,       // string pool: NUL-terminated strings, starting with the empty string
+};
+
+// Classes of objects, as stored in object records.
+
+enum SSObjectBinaryClass
+{
+    kClassStar = 1,
+    kClassDoubleStar = 2,
+    kClassVariableStar = 3,
+    kClassDoubleVariableStar = 4,
+    kClassDeepSky = 5,
+    kClassPlanet = 6,
+    kClassSatellite = 7,
+    kClassFeature = 8,
+    kClassCity = 9,
+    kClassConstellation = 10,
+};
+
+int SSExportObjectsToBinary ( const string &filename, SSObjectVec &objects, SSObjectFilter filter = nullptr, void *userData = nullptr );
+int SSImportObjectsFromBinary ( const string &filename, SSObjectVec &objects, SSObjectFilter filter = nullptr, void *userData = nullptr );
+
+#endif /* SSObjectBinary_hpp */
@@ -0,0 +1,546 @@
+// SSPassPredictor.cpp
+// SSCore
+//
+// Created by Tim DeBenedictis on 10/16/26.
+// Copyright © 2026 Southern Stars. All rights reserved.
+
+#include "SSPassPredictor.hpp"
+#include "SSUtilities.hpp"
+
+// Angular margin added to each revolution's visibility cone. Covers the difference
+// between geodetic and geocentric zenith, and orbit plane drift during one revolution.
+
+static constexpr double kConeMargin = 1.0 * SSAngle::kRadPerDeg;
+
+// Constructs a pass predictor for an observer at a geodetic longitude, latitude [radians]
+// and height above the geoid [km] in (site), with minimum pass altitude (minAlt) in radians.
+
+SSPassPredictor::SSPassPredictor ( SSSpherical site, double minAlt ) : SSPassPredictor ( vector<SSSpherical> { site }, minAlt )
+{
+}
+
+// Constructs a pass predictor for any number of observing sites, each given as in the
+// single-site constructor above, with minimum pass altitude (minAlt) in radians.
+
+SSPassPredictor::SSPassPredictor ( const vector<SSSpherical> &sites, double minAlt )
+{
+    for ( const SSSpherical &site : sites )
+    {
+        Site s;
+        double cl = cos ( site.lon ), sl = sin ( site.lon );
+        double cp = cos ( site.lat ), sp = sin ( site.lat );
+
+        s.lon = site.lon;
+        s.pos = SSCoordinates::toGeocentricPosition ( site, SSCoordinates::kKmPerEarthRadii, SSCoordinates::kEarthFlattening );
+        s.dir = s.pos.normalize();
+        s.zenith = SSVector ( cp * cl, cp * sl, sp );
+        s.north = SSVector ( -sp * cl, -sp * sl, cp );
+        s.east = SSVector ( -sl, cl, 0.0 );
+        _sites.push_back ( s );
+    }
+
+    _minAlt = minAlt;
+    _jd0 = _gmst0 = 0.0;
+    _evaluations = 0;
+}
+
+// Returns Greenwich mean sidereal time in radians at Julian Date (jd), extrapolated linearly
+// from the value computed at the start of the current search. Over a search spanning weeks,
+// this differs from SSTime::getSiderealTime() by a few microseconds of time.
+
+double SSPassPredictor::siderealTime ( double jd )
+{
+    return _gmst0 + kEarthRotation * ( jd - _jd0 );
+}
+
+// Computes satellite (pSat) Earth-fixed position (fixed) in km at Julian Date (jd).
+// The satellite's geocentric TEME position is rotated into the Earth-fixed frame by sidereal time alone.
+// Returns false if the satellite's position cannot be computed, e.g. if its orbit has decayed.
+
+bool SSPassPredictor::position ( SSSatellitePtr pSat, double jd, SSVector &fixed )
+{
+    SSVector pos, vel;
+
+    pSat->computeGeocentricPositionVelocity ( jd, pos, vel );
+    _evaluations++;
+    if ( pos.isnan() )
+        return false;
+
+    double theta = siderealTime ( jd );
+    double c = cos ( theta ), s = sin ( theta );
+    fixed = SSVector ( pos.x * c + pos.y * s, pos.y * c - pos.x * s, pos.z );
+    return true;
+}
+
+// Computes altitude, horizon components, and range of a satellite at Earth-fixed position (fixed)
+// at Julian Date (jd), as seen from a site whose index is (site).
+
+void SSPassPredictor::observe ( int site, double jd, SSVector &fixed, Sample &sample )
+{
+    Site &s = _sites[site];
+    SSVector dir = fixed - s.pos;
+
+    sample.jd = jd;
+    sample.range = dir.magnitude();
+    sample.alt = asin ( clamp ( dir * s.zenith / sample.range, -1.0, 1.0 ) );
+    sample.north = dir * s.north;
+    sample.east = dir * s.east;
+    sample.psi = acos ( clamp ( fixed * s.dir / fixed.magnitude(), -1.0, 1.0 ) );
+}
+
+// Computes satellite (pSat) altitude, horizon components, and range from one site at Julian Date (jd).
+// Returns false if the satellite's position cannot be computed.
+
+bool SSPassPredictor::evaluate ( SSSatellitePtr pSat, int site, double jd, Sample &sample )
+{
+    SSVector fixed;
+
+    if ( ! position ( pSat, jd, fixed ) )
+        return false;
+
+    observe ( site, jd, fixed, sample );
+    return true;
+}
+
+// Converts a sample to event circumstances in time zone (zone). Azimuth is only computed here,
+// since most samples never become events.
+
+SSRTS SSPassPredictor::toRTS ( Sample &sample, double zone )
+{
+    SSRTS rts;
+
+    rts.time = SSTime ( sample.jd, zone );
+    rts.azm = mod2pi ( atan2 ( sample.east, sample.north ) );
+    rts.alt = sample.alt;
+
+    return rts;
+}
+
+// Computes osculating orbit geometry for the satellite revolution starting at Julian Date (jd).
+// Returns false if the satellite's position cannot be computed, or its orbit is not elliptical.
+
+bool SSPassPredictor::startRevolution ( SSSatellitePtr pSat, double jd, Revolution &rev )
+{
+    SSVector pos, vel;
+
+    pSat->computeGeocentricPositionVelocity ( jd, pos, vel );
+    _evaluations++;
+    if ( pos.isnan() || vel.isnan() )
+        return false;
+
+    double r = pos.magnitude(), v = vel.magnitude();
+    double a = 1.0 / ( 2.0 / r - v * v / kEarthGM );
+    if ( ! ( a > 0.0 ) )
+        return false;
+
+    SSVector h = pos.crossProduct ( vel );
+    double hmag = h.magnitude();
+    double e = sqrt ( max ( 0.0, 1.0 - hmag * hmag / ( kEarthGM * a ) ) );
+    double peri = a * ( 1.0 - e ), apo = a * ( 1.0 + e );
+    double omega = kEarthRotation / SSTime::kSecondsPerDay;
+
+    // Satellite can only be above the minimum altitude when within this angle of an observer, as seen from Earth's center.
+    // Earth's polar radius gives the widest angle for any observer on or above the geoid.
+
+    double ratio = SSCoordinates::kKmPerEarthRadii * ( 1.0 - SSCoordinates::kEarthFlattening ) * cos ( _minAlt ) / apo;
+    rev.cone = ( ratio < 1.0 ? acos ( ratio ) - _minAlt : 0.0 ) + kConeMargin;
+
+    // Satellite moves fastest at perigee; observer is carried around by Earth's rotation.
+
+    rev.start = jd;
+    rev.end = jd + SSAngle::kTwoPi * sqrt ( a * a * a / kEarthGM ) / SSTime::kSecondsPerDay;
+    rev.normal = h / hmag;
+    rev.psiRate = ( hmag / ( peri * peri ) + omega ) * SSTime::kSecondsPerDay;
+    rev.speed = ( hmag / peri + omega * apo ) * SSTime::kSecondsPerDay;
+
+    return true;
+}
+
+// Returns false if the observer at site index (site) stays too far from the orbit plane to see the satellite at
+// any time during revolution (rev). The observer's angular distance from the orbit plane is
+// asin ( n . s ), where n is the orbit normal and s is the observer's geocentric direction.
+// As Earth rotates, n . s = A + B cos ( x ), with x advancing at Earth's rotation rate,
+// so its range over the revolution can be bounded without computing any positions.
+
+bool SSPassPredictor::visible ( int site, Revolution &rev )
+{
+    if ( rev.cone >= SSAngle::kHalfPi )
+        return true;
+
+    Site &s = _sites[site];
+    SSVector n = rev.normal;
+    double nxy = sqrt ( n.x * n.x + n.y * n.y );
+    double sxy = sqrt ( s.dir.x * s.dir.x + s.dir.y * s.dir.y );
+    double a = n.z * s.dir.z;
+    double b = nxy * sxy;
+    double x0 = siderealTime ( rev.start ) + s.lon - atan2 ( n.y, n.x );
+    double x1 = x0 + kEarthRotation * ( rev.end - rev.start );
+
+    // Find minimum and maximum of cos ( x ) on [ x0, x1 ]: the endpoints,
+    // unless the interval contains a multiple of 2 pi or an odd multiple of pi.
+
+    double cmin = min ( cos ( x0 ), cos ( x1 ) ), cmax = max ( cos ( x0 ), cos ( x1 ) );
+    if ( ceil ( x0 / SSAngle::kTwoPi ) * SSAngle::kTwoPi <= x1 )
+        cmax = 1.0;
+    if ( ceil ( ( x0 - SSAngle::kPi ) / SSAngle::kTwoPi ) * SSAngle::kTwoPi + SSAngle::kPi <= x1 )
+        cmin = -1.0;
+
+    double lo = a + b * cmin, hi = a + b * cmax;
+    double dist = lo <= 0.0 && hi >= 0.0 ? 0.0 : min ( fabs ( lo ), fabs ( hi ) );
+
+    return dist <= sin ( rev.cone );
+}
+
+// Returns the longest time step [days] after (sample) during which the satellite cannot
+// reach the minimum altitude. That is the larger of two bounds: the time needed to close its
+// geocentric angular distance to the visibility cone, and the time needed to change altitude
+// by its distance from the minimum at the revolution's maximum speed relative to the observer.
+// Each step is therefore scaled by the orbit's period: long for high orbits, short for low ones.
+
+double SSPassPredictor::safeStep ( Sample &sample, Revolution &rev )
+{
+    double coneStep = ( sample.psi - rev.cone ) / rev.psiRate;
+    double altStep = sample.range * ( 1.0 - exp ( -fabs ( sample.alt - _minAlt ) ) ) / rev.speed;
+
+    return max ( kMinStep, max ( coneStep, altStep ) );
+}
+
+// Refines the time between samples (s0) and (s1) where satellite altitude seen from site index (site) crosses the minimum,
+// using regula falsi with the Illinois modification. Samples must be in time order, and their
+// altitudes on opposite sides of the minimum. Returns the crossing sample in (crossing).
+
+bool SSPassPredictor::findCrossing ( SSSatellitePtr pSat, int site, Sample s0, Sample s1, Sample &crossing )
+{
+    double f0 = s0.alt - _minAlt, f1 = s1.alt - _minAlt;
+    double jd = INFINITY;
+    int side = 0;
+
+    crossing = fabs ( f0 ) < fabs ( f1 ) ? s0 : s1;
+    for ( int i = 0; i < 50 && s1.jd - s0.jd > kPrecision; i++ )
+    {
+        double last = jd;
+        jd = ( s0.jd * f1 - s1.jd * f0 ) / ( f1 - f0 );
+        if ( ! evaluate ( pSat, site, jd, crossing ) )
+            return false;
+
+        double f = crossing.alt - _minAlt;
+        if ( f == 0.0 || fabs ( jd - last ) < kPrecision )
+            break;
+
+        if ( ( f < 0.0 ) == ( f0 < 0.0 ) )
+        {
+            s0 = crossing;
+            f0 = f;
+            if ( side == -1 )
+                f1 /= 2.0;
+            side = -1;
+        }
+        else
+        {
+            s1 = crossing;
+            f1 = f;
+            if ( side == 1 )
+                f0 /= 2.0;
+            side = 1;
+        }
+    }
+
+    return true;
+}
+
+// Finds the time of maximum satellite altitude seen from site index (site), given three samples in time order (s0, s1, s2)
+// where the middle one is highest. Uses successive parabolic interpolation, falling back to a golden-section
+// step when the parabola's vertex falls outside the bracket. Returns the maximum-altitude sample in (peak).
+
+bool SSPassPredictor::findPeak ( SSSatellitePtr pSat, int site, Sample s0, Sample s1, Sample s2, Sample &peak )
+{
+    static const double g = ( 3.0 - sqrt ( 5.0 ) ) / 2.0;
+    Sample s;
+
+    for ( int i = 0; i < 50 && s2.jd - s0.jd > kPrecision; i++ )
+    {
+        double d0 = s1.jd - s0.jd, d2 = s1.jd - s2.jd;
+        double p = d0 * d0 * ( s1.alt - s2.alt ) - d2 * d2 * ( s1.alt - s0.alt );
+        double q = d0 * ( s1.alt - s2.alt ) - d2 * ( s1.alt - s0.alt );
+        double jd = q == 0.0 ? INFINITY : s1.jd - 0.5 * p / q;
+
+        if ( jd > s0.jd && jd < s2.jd )
+        {
+            if ( fabs ( jd - s1.jd ) < kPrecision )
+                break;
+        }
+        else
+        {
+            jd = d0 > -d2 ? s1.jd - g * d0 : s1.jd - g * d2;
+        }
+
+        if ( ! evaluate ( pSat, site, jd, s ) )
+            return false;
+
+        if ( s.alt > s1.alt )
+        {
+            if ( jd < s1.jd )
+                s2 = s1;
+            else
+                s0 = s1;
+            s1 = s;
+        }
+        else
+        {
+            if ( jd < s1.jd )
+                s0 = s;
+            else
+                s2 = s;
+        }
+    }
+
+    peak = s1;
+    return true;
+}
+
+// Updates the search at site index (site) after its current sample has advanced one step:
+// refines rising and setting when the satellite crosses the minimum altitude, tracks the
+// highest sample while it is above, and appends each complete pass to (passes).
+// Marks the search done when it has found (maxPasses), when it is past the end (stop) of the
+// search for risings, or when the satellite has not set within one day after rising.
+// Returns false if the satellite's position cannot be computed.
+
+bool SSPassPredictor::advance ( SSSatellitePtr pSat, int site, Search &search, SSTime &start, SSTime &stop, vector<SSPass> &passes, int maxPasses )
+{
+    if ( ! search.up && search.curr.alt >= _minAlt )
+    {
+        // Satellite has risen. Refine rising time; start tracking highest sample.
+
+        if ( ! findCrossing ( pSat, site, search.prev, search.curr, search.rise ) )
+            return false;
+
+        search.up = true;
+        if ( search.rise.jd > stop.jd )
+        {
+            search.done = true;
+            return true;
+        }
+
+        search.risen = true;
+        search.before = search.rise;
+        search.peak = search.curr;
+        search.haveAfter = false;
+    }
+    else if ( search.up && search.curr.alt < _minAlt )
+    {
+        // Satellite has set. If we saw it rise, refine setting time, find transit
+        // between the samples bracketing the highest one, and save the pass.
+
+        if ( search.risen )
+        {
+            Sample set, peak;
+
+            if ( ! findCrossing ( pSat, site, search.prev, search.curr, set ) )
+                return false;
+            if ( ! findPeak ( pSat, site, search.before, search.peak, search.haveAfter ? search.after : set, peak ) )
+                return false;
+
+            SSPass pass;
+
+            pass.rising = toRTS ( search.rise, start.zone );
+            pass.transit = toRTS ( peak, start.zone );
+            pass.setting = toRTS ( set, start.zone );
+            passes.push_back ( pass );
+        }
+
+        search.up = search.risen = false;
+    }
+    else if ( search.risen )
+    {
+        if ( search.curr.alt > search.peak.alt )
+        {
+            search.before = search.prev;
+            search.peak = search.curr;
+            search.haveAfter = false;
+        }
+        else if ( ! search.haveAfter )
+        {
+            search.after = search.curr;
+            search.haveAfter = true;
+        }
+    }
+
+    if ( (int) passes.size() >= maxPasses || ( search.risen ? search.curr.jd > search.rise.jd + 1.0 : search.curr.jd >= stop.jd ) )
+        search.done = true;
+
+    return true;
+}
+
+// Finds satellite (pSat) passes over every site which rise between times (start) and (stop).
+// Passes over each site are appended to the corresponding vector in (passes), which is resized
+// to the number of sites, until it contains (maxPasses) entries. Same rules as
+// SSEvent::findSatellitePasses(): a pass in progress at (start) is ignored, and the search
+// at a site ends if the satellite does not set within one day after rising.
+// Each site is observed when its own safe step has elapsed, or up to half a step early when
+// another site needs a satellite position; observing a site early is always safe. So one
+// satellite position serves as many sites as possible.
+
+void SSPassPredictor::findPasses ( SSSatellitePtr pSat, SSTime start, SSTime stop, vector<vector<SSPass>> &passes, int maxPasses )
+{
+    int nsites = (int) _sites.size();
+    vector<Search> searches ( nsites );
+    vector<double> due ( nsites ), early ( nsites );
+    Revolution rev;
+    SSVector fixed;
+
+    passes.resize ( nsites );
+    _jd0 = start.jd;
+    _gmst0 = start.getSiderealTime ( 0.0 );
+    if ( ! startRevolution ( pSat, start.jd, rev ) || ! position ( pSat, start.jd, fixed ) )
+        return;
+
+    // Observe satellite from all sites at start. Each site's next observation is due at the end of
+    // its safe step, and may be made from the midpoint of that step; both are infinite when done.
+
+    for ( int i = 0; i < nsites; i++ )
+    {
+        Search &search = searches[i];
+        observe ( i, start.jd, fixed, search.curr );
+        search.up = search.curr.alt >= _minAlt;
+        search.risen = search.haveAfter = false;
+        search.done = (int) passes[i].size() >= maxPasses || start.jd >= stop.jd;
+
+        double step = safeStep ( search.curr, rev );
+        due[i] = search.done ? INFINITY : min ( start.jd + step, stop.jd );
+        early[i] = due[i] - step / 2.0;
+    }
+
+    double jd = start.jd, next = *min_element ( due.begin(), due.end() );
+    while ( next < INFINITY )
+    {
+        // At the start of each revolution, recompute orbit geometry. Any site below the satellite which stays
+        // too far from the orbit plane to see it anywhere on this revolution need not be observed until it ends.
+        // If the search for risings ends during that revolution, the search at that site is done.
+
+        if ( jd >= rev.end )
+        {
+            if ( ! startRevolution ( pSat, jd, rev ) )
+                break;
+
+            for ( int i = 0; i < nsites; i++ )
+            {
+                Search &search = searches[i];
+                if ( search.done || search.up || visible ( i, rev ) )
+                    continue;
+
+                search.done = rev.end >= stop.jd;
+                due[i] = search.done ? INFINITY : max ( due[i], rev.end );
+                early[i] = max ( early[i], rev.end );
+            }
+
+            next = *min_element ( due.begin(), due.end() );
+            continue;
+        }
+
+        // Step to the earliest time any site that is still searching must be observed, but not past the end
+        // of the revolution. Observe the satellite from every site which may be observed then, and schedule
+        // its next observation. Quit when no site is still searching.
+
+        if ( next > rev.end )
+        {
+            jd = rev.end;
+            continue;
+        }
+
+        jd = next;
+        if ( ! position ( pSat, jd, fixed ) )
+            break;
+
+        bool ok = true;
+        next = INFINITY;
+        for ( int i = 0; i < nsites && ok; i++ )
+        {
+            if ( early[i] <= jd )
+            {
+                Search &search = searches[i];
+                search.prev = search.curr;
+                observe ( i, jd, fixed, search.curr );
+                ok = advance ( pSat, i, search, start, stop, passes[i], maxPasses );
+
+                double step = safeStep ( search.curr, rev );
+                due[i] = search.done ? INFINITY : search.risen ? jd + step : min ( jd + step, stop.jd );
+                early[i] = due[i] - step / 2.0;
+            }
+
+            next = min ( next, due[i] );
+        }
+
+        if ( ! ok )
+            break;
+    }
+}
+
+// Finds satellite (pSat) passes over the first site which rise between times (start) and (stop), and appends
+// them to (passes) until it contains (maxPasses) entries. Same rules as SSEvent::findSatellitePasses().
+// Returns the total number of passes in the vector, which is left unchanged if this predictor has no sites.
+
+int SSPassPredictor::findPasses ( SSSatellitePtr pSat, SSTime start, SSTime stop, vector<SSPass> &passes, int maxPasses )
+{
+    if ( _sites.empty() )
+        return (int) passes.size();
+
+    vector<vector<SSPass>> sitePasses ( _sites.size() );
+
+    sitePasses[0].swap ( passes );
+    findPasses ( pSat, start, stop, sitePasses, maxPasses );
+    passes.swap ( sitePasses[0] );
+
+    return (int) passes.size();
+}
+
+// Finds all passes of all satellites in an object array (objects) over every site, which rise between
+// times (start) and (stop), and appends them to (passes), ordered by satellite, then site, then time.
+// Objects which are not satellites are skipped. Satellites are handed out one at a time to (nthreads)
+// threads, including the calling thread; if zero, uses one thread per CPU core. Each thread searches
+// with its own copy of this predictor, so satellites are never shared between threads.
+// Returns the total number of passes in the vector.
+
+int SSPassPredictor::findPasses ( SSObjectArray &objects, SSTime start, SSTime stop, vector<SSSatellitePass> &passes, int nthreads )
+{
+    if ( nthreads < 1 )
+        nthreads = max ( 1, (int) thread::hardware_concurrency() );
+
+    vector<vector<SSSatellitePass>> results ( objects.size() );
+    atomic<size_t> next ( 0 ), evaluations ( 0 );
+
+    auto work = [&] ( void )
+    {
+        SSPassPredictor predictor ( *this );
+        vector<vector<SSPass>> sitePasses;
+
+        predictor._evaluations = 0;
+        for ( size_t i = next++; i < objects.size(); i = next++ )
+        {
+            SSSatellitePtr pSat = SSGetSatellitePtr ( objects[i] );
+            if ( pSat == nullptr )
+                continue;
+
+            sitePasses.assign ( _sites.size(), vector<SSPass>() );
+            predictor.findPasses ( pSat, start, stop, sitePasses, INT_MAX );
+            for ( int j = 0; j < (int) sitePasses.size(); j++ )
+                for ( SSPass &pass : sitePasses[j] )
+                    results[i].push_back ( { (int) i, j, pass } );
+        }
+
+        evaluations += predictor._evaluations;
+    };
+
+    vector<thread> workers;
+    for ( int i = 1; i < nthreads; i++ )
+        workers.push_back ( thread ( work ) );
+
+    work();
+    for ( thread &worker : workers )
+        worker.join();
+
+    _evaluations += evaluations;
+    for ( vector<SSSatellitePass> &result : results )
+        passes.insert ( passes.end(), result.begin(), result.end() );
+
+    return (int) passes.size();
+}
@@ -0,0 +1,131 @@
+// SSPassPredictor.hpp
+// SSCore
+//
+// Created by Tim DeBenedictis on 10/16/26.
+// Copyright © 2026 Southern Stars. All rights reserved.
+//
+// This class predicts Earth satellite passes over an observing site much faster than
+// SSEvent's generic event finders. It works directly with the SGP4/SDP4 geocentric state
+// vectors and rotates the site through sidereal time, instead of recomputing the full
+// SSCoordinates precession/nutation/aberration transformation at each step. Whole revolutions
+// where the site lies too far from the orbit plane to see the satellite are skipped, the search
+// steps as far ahead as the orbit's geometry allows the satellite to rise, and rising, setting,
+// and transit times are refined by root-finding and parabolic interpolation on altitude.
+// Geometry is purely geometric, in the TLE's true equator, mean equinox frame; refraction,
+// light time, and aberration are ignored, which changes event times by a fraction of a second.
+// One predictor can search any number of observing sites at once: each satellite position is
+// computed once per step and shared by all sites, and each step is the shortest any site needs.
+// Many satellites are searched in parallel, one satellite per thread at a time.
+
+#ifndef SSPassPredictor_hpp
+#define SSPassPredictor_hpp
+
+#include <atomic>
+#include <climits>
+#include <thread>
+
+#include "SSEvent.hpp"
+#include "SSPlanet.hpp"
+
+// Describes one pass of a satellite over one site, found by a multi-satellite, multi-site search
+
+struct SSSatellitePass
+{
+    int     satellite;      // index of satellite in searched object array
+    int     site;           // index of observing site
+    SSPass  pass;           // circumstances of pass
+};
+
+class SSPassPredictor
+{
+protected:
+
+    // Satellite state and horizon coordinates at one instant
+
+    struct Sample
+    {
+        double      jd;         // Julian Date in civil time (UTC)
+        double      alt;        // altitude above observer's horizon [radians]
+        double      north;      // northward component of direction from observer [km]
+        double      east;       // eastward component of direction from observer [km]
+        double      range;      // distance from observer [km]
+        double      psi;        // geocentric angle between observer and satellite [radians]
+    };
+
+    // Geometry of one satellite revolution, from osculating elements at its start
+
+    struct Revolution
+    {
+        double      start;      // Julian Date at which revolution starts
+        double      end;        // Julian Date at which revolution ends
+        SSVector    normal;     // unit vector normal to orbit plane, in TEME frame
+        double      cone;       // largest geocentric angle (psi) at which satellite can be above minimum altitude [radians]
+        double      psiRate;    // upper bound on rate of change of psi [radians per day]
+        double      speed;      // upper bound on satellite's speed relative to observer [km per day]
+    };
+
+    // Observing site geometry
+
+    struct Site
+    {
+        double      lon;        // observer's geodetic longitude [radians]
+        SSVector    pos;        // observer's Earth-fixed position [km]
+        SSVector    dir;        // unit vector from Earth's center toward observer, Earth-fixed
+        SSVector    zenith;     // observer's zenith unit vector, Earth-fixed
+        SSVector    north;      // observer's north horizon unit vector, Earth-fixed
+        SSVector    east;       // observer's east horizon unit vector, Earth-fixed
+    };
+
+    // State of the pass search at one site
+
+    struct Search
+    {
+        Sample      prev;       // sample at previous step
+        Sample      curr;       // sample at current step
+        Sample      rise;       // refined rising of pass in progress
+        Sample      peak;       // highest sample of pass in progress
+        Sample      before;     // sample before highest sample
+        Sample      after;      // sample after highest sample
+        bool        haveAfter;  // true once sample after highest sample is known
+        bool        up;         // true if satellite is above minimum altitude
+        bool        risen;      // true if we saw the satellite rise in the current pass
+        bool        done;       // true when search at this site has ended
+    };
+
+    vector<Site> _sites;        // observing sites
+    double      _minAlt;        // minimum altitude of pass [radians]
+    double      _jd0;           // Julian Date at which Greenwich sidereal time was last computed
+    double      _gmst0;         // Greenwich mean sidereal time at _jd0 [radians]
+    size_t      _evaluations;   // number of satellite positions computed
+
+    double siderealTime ( double jd );
+    bool position ( SSSatellitePtr pSat, double jd, SSVector &fixed );
+    void observe ( int site, double jd, SSVector &fixed, Sample &sample );
+    bool evaluate ( SSSatellitePtr pSat, int site, double jd, Sample &sample );
+    SSRTS toRTS ( Sample &sample, double zone );
+    bool startRevolution ( SSSatellitePtr pSat, double jd, Revolution &rev );
+    bool visible ( int site, Revolution &rev );
+    double safeStep ( Sample &sample, Revolution &rev );
+    bool findCrossing ( SSSatellitePtr pSat, int site, Sample s0, Sample s1, Sample &crossing );
+    bool findPeak ( SSSatellitePtr pSat, int site, Sample s0, Sample s1, Sample s2, Sample &peak );
+    bool advance ( SSSatellitePtr pSat, int site, Search &search, SSTime &start, SSTime &stop, vector<SSPass> &passes, int maxPasses );
+
+public:
+
+    static constexpr double kEarthRotation = 360.98564736629 * SSAngle::kRadPerDeg;    // Earth's sidereal rotation rate [radians per day]
+    static constexpr double kEarthGM = 398600.4418;                                     // Earth's gravitational parameter [km^3/sec^2]
+    static constexpr double kMinStep = 1.0 / SSTime::kSecondsPerDay;                    // smallest search step [days]
+    static constexpr double kPrecision = 0.01 / SSTime::kSecondsPerDay;                 // precision of refined event times [days]
+
+    SSPassPredictor ( SSSpherical site, double minAlt );
+    SSPassPredictor ( const vector<SSSpherical> &sites, double minAlt );
+
+    int getNumSites ( void ) { return (int) _sites.size(); }
+    size_t getEvaluations ( void ) { return _evaluations; }
+
+    int findPasses ( SSSatellitePtr pSat, SSTime start, SSTime stop, vector<SSPass> &passes, int maxPasses );
+    void findPasses ( SSSatellitePtr pSat, SSTime start, SSTime stop, vector<vector<SSPass>> &passes, int maxPasses );
+    int findPasses ( SSObjectArray &objects, SSTime start, SSTime stop, vector<SSSatellitePass> &passes, int nthreads = 0 );
+};
+
+#endif /* SSPassPredictor_hpp */
@@ -4,8 +4,6 @@
 // Created by Tim DeBenedictis on 3/15/20.
 // Copyright © 2020 Southern Stars. All rights reserved.
 
-#include <mutex>
-
 #include "SSPlanet.hpp"
 #include "SSPSEphemeris.hpp"
 #include "SSJPLDEphemeris.hpp"
@@ -33,11 +31,47 @@
 #if USE_VSOP_ELP
 #include "VSOP2013.hpp"
 #include "ELPMPP02.hpp"
+#include "SSChebyshevEphemeris.hpp"
 static bool _useVSOPELP = true;
 static VSOP2013 _vsop;
 static ELPMPP02 _elp;
+
+// Source ephemeris for the VSOP/ELP Chebyshev cache. Identifiers 0-9 are heliocentric
+// Sun through Pluto, where Earth (3) is the Earth-Moon barycenter; identifier 10 is the
+// geocentric Moon. The barycenter and Moon are cached separately because both are much
+// smoother than the Earth itself, which is recombined from them as needed.
+
+static void computeVSOPELP ( int id, double jed, SSVector &pos, SSVector &vel )
+{
+    if ( id == 10 )
+        _elp.computePositionVelocity ( jed, pos, vel );
+    else
+        _vsop.computePositionVelocity ( id, jed, pos, vel );
+}
+
+// Initial cache window lengths in days for Sun, Mercury ... Pluto, Moon.
+
+static bool _useEphemerisCache = false;
+static SSChebyshevEphemeris _ephemCache ( computeVSOPELP, { 1024, 16, 32, 32, 64, 64, 64, 64, 64, 256, 4 } );
 #endif
 
+// Constructs an ephemeris context with empty caches.
+
+SSEphemerisContext::SSEphemerisContext ( void )
+{
+    orbMatJED = earthJED = deltaT = 0.0;
+    for ( int i = 0; i < 10; i++ )
+        primaryJED[i] = 0.0;
+}
+
+// Returns the calling thread's default ephemeris context, used by methods which don't take one.
+
+SSEphemerisContext &SSEphemerisContext::threadContext ( void )
+{
+    static thread_local SSEphemerisContext context;
+    return context;
+}
+
 SSPlanet::SSPlanet ( SSObjectType type ) : SSObject ( type )
 {
     _id = SSIdentifier();
@@ -132,18 +166,25 @@ SSIdentifier SSPlanet::getIdentifier ( SSCatalog cat )
 // Returned position (pos) and velocity (vel) vectors are both in fundamental J2000 equatorial frame.
 
 void SSPlanet::computePositionVelocity ( double jed, double lt, SSVector &pos, SSVector &vel )
+{
+    computePositionVelocity ( jed, lt, pos, vel, SSEphemerisContext::threadContext() );
+}
+
+// As above, but uses the provided ephemeris context (context) instead of the calling thread's.
+
+void SSPlanet::computePositionVelocity ( double jed, double lt, SSVector &pos, SSVector &vel, SSEphemerisContext &context )
 {
     if ( _type == kTypePlanet )
-        computeMajorPlanetPositionVelocity ( (int) _id.identifier(), jed, lt, pos, vel );
+        computeMajorPlanetPositionVelocity ( (int) _id.identifier(), jed, lt, pos, vel, context );
     else if ( _type == kTypeMoon )
-        computeMoonPositionVelocity ( jed, lt, pos, vel );
+        computeMoonPositionVelocity ( jed, lt, pos, vel, context );
     else if ( _type == kTypeAsteroid || _type == kTypeComet )
         computeMinorPlanetPositionVelocity ( jed, lt, pos, vel );
     else if ( _type == kTypeSatellite )
     {
         SSSatellite *pSat = dynamic_cast<SSSatellite *> ( this );
         if ( pSat )
-            pSat->computePositionVelocity ( jed, lt, pos, vel );
+            pSat->computePositionVelocity ( jed, lt, pos, vel, context );
     }
 }
 
@@ -161,6 +202,13 @@ void SSPlanet::computePositionVelocity  ( SSCoordinates &coords, SSVector &pos,
 // Returned position (pos) and velocity (vel) vectors are both in fundamental J2000 equatorial frame.
 
 void SSPlanet::computeMajorPlanetPositionVelocity ( int id, double jed, double lt, SSVector &pos, SSVector &vel )
+{
+    computeMajorPlanetPositionVelocity ( id, jed, lt, pos, vel, SSEphemerisContext::threadContext() );
+}
+
+// As above, but uses the provided ephemeris context (context) instead of the calling thread's.
+
+void SSPlanet::computeMajorPlanetPositionVelocity ( int id, double jed, double lt, SSVector &pos, SSVector &vel, SSEphemerisContext &context )
 {
     // When planets or the Moon are more than 1 light day away, don't use JPL DE 408; VSOP/ELP is much faster in this case.
 
@@ -173,7 +221,8 @@ void SSPlanet::computeMajorPlanetPositionVelocity ( int id, double jed, double l
     double y = fabs ( jed - lt - SSTime::kJ2000 ) / 365.25;
     if ( _useVSOPELP && y < 6000.0 )
     {
-        _vsop.computePositionVelocity ( id, jed - lt, pos, vel );
+        if ( ! _useEphemerisCache || ! _ephemCache.compute ( id, jed - lt, pos, vel ) )
+            _vsop.computePositionVelocity ( id, jed - lt, pos, vel );
         
         // ELPMPP02 is valid within 3000 years of J2000; apply Earth-Moon barycenter correction
         // if within that range. If outside it, user is not likely to care about this small correction.
@@ -181,33 +230,31 @@ void SSPlanet::computeMajorPlanetPositionVelocity ( int id, double jed, double l
         if ( id == kEarth && y < 3000.0 )
         {
             SSVector mpos, mvel;
-            _elp.computePositionVelocity ( jed - lt, mpos, mvel );
+            if ( ! _useEphemerisCache || ! _ephemCache.compute ( 10, jed - lt, mpos, mvel ) )
+                _elp.computePositionVelocity ( jed - lt, mpos, mvel );
             pos -= mpos * _elp.kMoonEarthMassRatio;
             vel -= mvel * _elp.kMoonEarthMassRatio;
         }
     }
     else
     {
-        computePSPlanetMoonPositionVelocity ( id, jed, lt, pos, vel );
+        computePSPlanetMoonPositionVelocity ( id, jed, lt, pos, vel, context );
     }
 #elif USE_VPEPHEMERIS
     SSVPEphemeris::fundamentalPositionVelocity ( id, jed - lt, pos, vel );
 #else
-    computePSPlanetMoonPositionVelocity ( id, jed, lt, pos, vel );
+    computePSPlanetMoonPositionVelocity ( id, jed, lt, pos, vel, context );
 #endif
 }
 
-void SSPlanet::computePSPlanetMoonPositionVelocity ( int id, double jed, double lt, SSVector &pos, SSVector &vel )
+void SSPlanet::computePSPlanetMoonPositionVelocity ( int id, double jed, double lt, SSVector &pos, SSVector &vel, SSEphemerisContext &context )
 {
-    static double orbMatJED = 0.0;
-    static SSMatrix orbMat;
-    
-    if ( jed != orbMatJED )
+    if ( jed != context.orbMatJED )
     {
         SSMatrix eclMat = SSCoordinates::getEclipticMatrix ( SSCoordinates::getObliquity ( jed ) );
         SSMatrix preMat = SSCoordinates::getPrecessionMatrix ( jed ).transpose();
-        orbMat = preMat * eclMat;
-        orbMatJED = jed;
+        context.orbMat = preMat * eclMat;
+        context.orbMatJED = jed;
     }
 
     SSSpherical ecl;
@@ -247,8 +294,8 @@ void SSPlanet::computePSPlanetMoonPositionVelocity ( int id, double jed, double
         vel *= SSCoordinates::kKmPerEarthRadii / SSCoordinates::kKmPerAU;
     }
     
-    pos = orbMat * pos;
-    vel = orbMat * vel;
+    pos = context.orbMat * pos;
+    vel = context.orbMat * vel;
 }
 
 // Computes asteroid or comet's heliocentric position and velocity vectors in AU and AU/day.
@@ -269,13 +316,8 @@ void SSPlanet::computeMinorPlanetPositionVelocity ( double jed, double lt, SSVec
 // Light travel time to moon (lt) is in days; may be zero for first approximation.
 // Returned position (pos) and velocity (vel) vectors are both in fundamental J2000 equatorial frame.
 
-mutex moon_mutex;
-
-void SSPlanet::computeMoonPositionVelocity ( double jed, double lt, SSVector &pos, SSVector &vel )
+void SSPlanet::computeMoonPositionVelocity ( double jed, double lt, SSVector &pos, SSVector &vel, SSEphemerisContext &context )
 {
-    static SSVector primaryPos[10], primaryVel[10];
-    static double primaryJED[10] = { 0.0 };
-
     // Get moon and primary planet identifier.
     
     int m = (int) _id.identifier();
@@ -298,15 +340,18 @@ void SSPlanet::computeMoonPositionVelocity ( double jed, double lt, SSVector &po
 #if USE_VSOP_ELP
         double y = fabs ( jed - lt - SSTime::kJ2000 ) / 365.25;
         if ( _useVSOPELP && y < 3000.0 )
-            _elp.computePositionVelocity ( jed - lt, pos, vel );
+        {
+            if ( ! _useEphemerisCache || ! _ephemCache.compute ( 10, jed - lt, pos, vel ) )
+                _elp.computePositionVelocity ( jed - lt, pos, vel );
+        }
         else
-            computePSPlanetMoonPositionVelocity ( kLuna, jed, lt, pos, vel );
+            computePSPlanetMoonPositionVelocity ( kLuna, jed, lt, pos, vel, context );
 #elif USE_VPEPHEMERIS
         SSVPEphemeris::fundamentalPositionVelocity ( 10, jed - lt, pos, vel );
         pos *= SSCoordinates::kKmPerEarthRadii / SSCoordinates::kKmPerAU;
         vel *= SSCoordinates::kKmPerEarthRadii / SSCoordinates::kKmPerAU;
 #else
-        computePSPlanetMoonPositionVelocity ( kLuna, jed, lt, pos, vel );
+        computePSPlanetMoonPositionVelocity ( kLuna, jed, lt, pos, vel, context );
 #endif
     }
     else
@@ -359,30 +404,29 @@ void SSPlanet::computeMoonPositionVelocity ( double jed, double lt, SSVector &po
     // If JED has changed since last time we computed primary's position and velocity, recompute them.
     // Add primary's position (antedated for light time) and velocity to moon's position and velocity.
     // If light time is less than 1 day, assume primary's velocity is constant over light time duration.
-    // Mutex lock prevents multiple threads from modifying these shared resources simultaneously.
+    // These are cached in the ephemeris context, which is only used by one thread at a time, so no locking.
     
-    moon_mutex.lock();
+    SSVector &primaryPos = context.primaryPos[p], &primaryVel = context.primaryVel[p];
     if ( lt < 1.0 )
     {
-        if ( primaryJED[p] != jed )
+        if ( context.primaryJED[p] != jed )
         {
-            computeMajorPlanetPositionVelocity ( p, jed, 0.0, primaryPos[p], primaryVel[p] );
-            primaryJED[p] = jed;
+            computeMajorPlanetPositionVelocity ( p, jed, 0.0, primaryPos, primaryVel, context );
+            context.primaryJED[p] = jed;
         }
-        pos += primaryPos[p] - primaryVel[p] * lt;
-        vel += primaryVel[p];
+        pos += primaryPos - primaryVel * lt;
+        vel += primaryVel;
     }
     else
     {
-        if ( primaryJED[p] != ( jed - lt ) )
+        if ( context.primaryJED[p] != ( jed - lt ) )
         {
-            computeMajorPlanetPositionVelocity ( p, jed, lt, primaryPos[p], primaryVel[p] );
-            primaryJED[p] = jed - lt;
+            computeMajorPlanetPositionVelocity ( p, jed, lt, primaryPos, primaryVel, context );
+            context.primaryJED[p] = jed - lt;
         }
-        pos += primaryPos[p];
-        vel += primaryVel[p];
+        pos += primaryPos;
+        vel += primaryVel;
     }
-    moon_mutex.unlock();
 }
 
 // Given a point at planetographic longituade (lon) and latitude (lat) in radians,
@@ -582,13 +626,21 @@ float SSPlanet::computeCometMagnitude ( double rad, double dist, double h, doubl
 // The current Julian Ephemeris Date and observer position are input in the SSCoordinates object (coords).
 
 void SSPlanet::computeEphemeris ( SSCoordinates &coords )
+{
+    computeEphemeris ( coords, SSEphemerisContext::threadContext() );
+}
+
+// As above, but uses the provided ephemeris context (context) instead of the calling thread's.
+// The coordinates object is not modified, so it may be shared by threads computing different objects.
+
+void SSPlanet::computeEphemeris ( SSCoordinates &coords, SSEphemerisContext &context )
 {
     // Compute planet's heliocentric position and velocity at current JED.
     // Compute distance and light time to planet.
     
     double lt = 0.0;
     double jed = coords.getJED();
-    computePositionVelocity ( jed, lt, _position, _velocity );
+    computePositionVelocity ( jed, lt, _position, _velocity, context );
 
     // If desired, recompute planet's position and velocity antedated for light time.
     // In theory we should iterate but in practice this gets us sub-arcsecond precision!
@@ -596,7 +648,7 @@ void SSPlanet::computeEphemeris ( SSCoordinates &coords )
     if ( coords.getLightTime() )
     {
         lt = ( _position - coords.getObserverPosition() ).magnitude() / coords.kLightAUPerDay;
-        computePositionVelocity ( jed, lt, _position, _velocity );
+        computePositionVelocity ( jed, lt, _position, _velocity, context );
     }
 
     // We may fail to compute satellite position if TLE is significantly out of date.
@@ -708,15 +760,26 @@ string SSPlanet::toCSV ( void )
 // Allocates a new SSPlanet and initializes it from a CSV-formatted string.
 // Returns nullptr on error (invalid CSV string, heap allocation failure, etc.)
 
-SSObjectPtr SSPlanet::fromCSV ( string csv )
+SSObjectPtr SSPlanet::fromCSV ( string_view csv )
+{
+    // Split string into fields, then parse them.
+    
+    vector<string_view> fields;
+    split ( csv, ",", fields );
+    return fromCSV ( fields );
+}
+
+// Creates a planet, moon, asteroid, or comet from fields split from a CSV-format text line
+// at every comma. Fields are not trimmed. Returns nullptr if the fields do not describe one.
+
+SSObjectPtr SSPlanet::fromCSV ( vector<string_view> &fields )
 {
-    // Split string into fields. Eliminate lines with insufficient fields, or header lines
+    // Eliminate lines with insufficient fields, or header lines
     
-    vector<string> fields = split ( csv, "," );
-    if ( fields.size() < 21 || strncmp ( fields[0].c_str(), "Type", 4) == 0 )
+    if ( fields.size() < 21 || fields[0].substr ( 0, 4 ) == "Type" )
         return nullptr;
 
-    SSObjectType type = SSObject::codeToType ( fields[0] );
+    SSObjectType type = SSObject::codeToType ( string ( fields[0] ) );
     if ( type < kTypePlanet || type > kTypeComet )
         return nullptr;
     
@@ -749,11 +812,11 @@ SSObjectPtr SSPlanet::fromCSV ( string csv )
     if ( type == kTypePlanet || type == kTypeMoon )
         ident = SSIdentifier ( kCatJPLanet, strtoint ( fields[19] ) );
     else
-        ident = SSIdentifier::fromString ( fields[19] );
+        ident = SSIdentifier::fromString ( string ( fields[19] ) );
 
     vector<string> names;
     for ( int i = 20; i < fields.size(); i++ )
-        names.push_back ( trim ( fields[i] ) );
+        names.push_back ( string ( trim_view ( fields[i] ) ) );
     
 	SSObjectPtr pObject = SSNewObject ( type );
     SSPlanetPtr pPlanet = SSGetPlanetPtr ( pObject );
@@ -818,6 +881,27 @@ float SSSatellite::computeMagnitude ( double rad, double dist, double phase )
     return computeSatelliteMagnitude ( dist * SSCoordinates::kKmPerAU, phase, _Hmag );
 }
 
+// Computes Earth satellite's position and velocity relative to Earth's center in kilometers and km/sec,
+// in the true equator, mean equinox of date frame its TLE orbit models use, at Julian Date (jd) in civil time (UTC).
+// If within 30 days of the TLE epoch, uses the full-precision SGP4/SDP4 orbit models.
+// Otherwise uses the satellite's Keplerian elements, updated for secular variation according to the SGP orbit model.
+
+void SSSatellite::computeGeocentricPositionVelocity ( double jd, SSVector &pos, SSVector &vel )
+{
+    double tsince = ( jd - _tle.jdepoch ) * SSTime::kMinutesPerDay;
+    if ( fabs ( tsince ) < 30 * SSTime::kMinutesPerDay )
+    {
+        _tle.toPositionVelocity ( jd, pos, vel );
+    }
+    else
+    {
+        // Output position and velocity vectors are in Earth-radii and Earth-radii/min; convert to km and km/sec.
+        _tle.toOrbit ( tsince ).toPositionVelocity ( jd, pos, vel );
+        pos *= SSCoordinates::kKmPerEarthRadii;
+        vel *= SSCoordinates::kKmPerEarthRadii / 60.0;
+    }
+}
+
 // Computes Earth satellite's heliocentric position and velocity vectors in AU and AU/day.
 // Current time (jed) is Julian Ephemeris Date in dynamic time (TDT), not civil time (UTC).
 // Light travel time to satellite (lt) is in days; may be zero for first approximation.
@@ -825,50 +909,27 @@ float SSSatellite::computeMagnitude ( double rad, double dist, double phase )
 // Also computes satellite's "planetographic" orientation matrix, which describes how the
 // satellite is oriented relative to the Earth's J2000 mean equatorial (fundamental) frame.
 
-mutex sat_mutex;
-
-void SSSatellite::computePositionVelocity ( double jed, double lt, SSVector &pos, SSVector &vel )
+void SSSatellite::computePositionVelocity ( double jed, double lt, SSVector &pos, SSVector &vel, SSEphemerisContext &context )
 {
-    static SSVector earthPos, earthVel;
-    static SSMatrix earthMat;
-    static double earthJED = 0.0, deltaT = 0.0;
-    
     // Recompute Earth's position and velocity relative to Sun if JED has changed.
     // Asssume Earth's velocity is constant over light time duration.
-    // Sat mutex prevents multiple threads from modifying these shared resources simultaneously.
+    // These are cached in the ephemeris context, which is only used by one thread at a time, so no locking.
     
-    sat_mutex.lock();
-    if ( jed != earthJED )
+    if ( jed != context.earthJED )
     {
-        computeMajorPlanetPositionVelocity ( kEarth, jed, 0.0, earthPos, earthVel );
-        earthJED = jed;
-        deltaT = SSTime ( jed ).getDeltaT() / SSTime::kSecondsPerDay;
-        earthMat = SSCoordinates::getPrecessionMatrix ( jed ).transpose();
+        computeMajorPlanetPositionVelocity ( kEarth, jed, 0.0, context.earthPos, context.earthVel, context );
+        context.earthJED = jed;
+        context.deltaT = SSTime ( jed ).getDeltaT() / SSTime::kSecondsPerDay;
+        context.earthMat = SSCoordinates::getPrecessionMatrix ( jed ).transpose();
     }
-    sat_mutex.unlock();
     
     // Compute satellite position & velocity relative to Earth, antedated for light time.
     // Satellite's orbit epoch is Julian Date, not JED, so subtract Delta T.
-    // If within 30 days of the epoch, use the full-precision SGP4/SDP4
-    // orbit models to compute the satellite's position.
-    // Otherwise compute the satellite's position using its Keplerian elements,
-    // updated for secular variation according to the SGP orbit model.
+    // Convert from km and km/sec to AU and AU/day.
     
-    double tsince = ( jed - deltaT - lt - _tle.jdepoch ) * SSTime::kMinutesPerDay;
-    if ( fabs ( tsince ) < 30 * SSTime::kMinutesPerDay )
-    {
-        // Output position and velocity vectors are in km and km/sec; convert to AU and AU/day;
-        _tle.toPositionVelocity ( jed - deltaT - lt, pos, vel );
-        pos /= SSCoordinates::kKmPerAU;
-        vel /= SSCoordinates::kKmPerAU / SSTime::kSecondsPerDay;
-    }
-    else
-    {
-        // Output position and velocity vectors are in Earth-radii and Earth-radii/min; convert to AU and AU/day;
-        _tle.toOrbit ( tsince ).toPositionVelocity ( jed - deltaT - lt, pos, vel );
-        pos *= SSCoordinates::kKmPerEarthRadii / SSCoordinates::kKmPerAU;
-        vel *= SSCoordinates::kKmPerEarthRadii / SSCoordinates::kKmPerAU / SSTime::kMinutesPerDay;
-    }
+    computeGeocentricPositionVelocity ( jed - context.deltaT - lt, pos, vel );
+    pos /= SSCoordinates::kKmPerAU;
+    vel /= SSCoordinates::kKmPerAU / SSTime::kSecondsPerDay;
     
     if ( pos.isnan() || vel.isnan() )
         return;
@@ -876,8 +937,8 @@ void SSSatellite::computePositionVelocity ( double jed, double lt, SSVector &pos
     // Satellite orbit elements are referred to current equator, not J2000 equator,
     // so transform output position and velocity from current to J2000 equatorial frame.
   
-    pos = earthMat * pos;
-    vel = earthMat * vel;
+    pos = context.earthMat * pos;
+    vel = context.earthMat * vel;
     
     // Set up orientation matrix so satellite's +Z axis points in orbit plane away from Earth's center,
     // +Y axis is perpendicular to orbit plane, +X axis points in orbit plane in direction of motion.
@@ -900,8 +961,8 @@ void SSSatellite::computePositionVelocity ( double jed, double lt, SSVector &pos
     
     // Add Earth's position (antedated for light time) and velocity to satellite position and velocity.
     
-    pos += earthPos - earthVel * lt;
-    vel += earthVel;
+    pos += context.earthPos - context.earthVel * lt;
+    vel += context.earthVel;
 }
 
 #if USE_VSOP_ELP
@@ -916,6 +977,18 @@ bool SSPlanet::useVSOPELP ( void )
     return _useVSOPELP;
 }
 
+void SSPlanet::useEphemerisCache ( bool use )
+{
+    _useEphemerisCache = use;
+    if ( ! use )
+        _ephemCache.clear();
+}
+
+bool SSPlanet::useEphemerisCache ( void )
+{
+    return _useEphemerisCache;
+}
+
 #else
 
 void SSPlanet::useVSOPELP ( bool use )
@@ -927,6 +1000,15 @@ bool SSPlanet::useVSOPELP ( void )
     return false;
 }
 
+void SSPlanet::useEphemerisCache ( bool use )
+{
+}
+
+bool SSPlanet::useEphemerisCache ( void )
+{
+    return false;
+}
+
 #endif
 
 // Calculates planet's rotational elements at the specified Julian Ephemeris Date (jed).
@@ -112,6 +112,29 @@ enum SSPlanetID
     kStyx = 905
 };
 
+// Caches of intermediate results used while computing solar system object positions and velocities.
+// Formerly these were function-level statics shared by all threads, guarded by mutexes.
+// Each thread should use its own context, so ephemerides may be computed from many threads
+// simultaneously without locking; methods which don't take a context use the calling thread's.
+// A context may be reused for any number of objects and times, on one thread at a time.
+
+struct SSEphemerisContext
+{
+    double      orbMatJED;          // JED at which orbMat was computed
+    SSMatrix    orbMat;             // transforms PS ephemeris from ecliptic of date to fundamental frame
+    double      primaryJED[10];     // JEDs at which primary planets' positions and velocities were computed
+    SSVector    primaryPos[10];     // primary planets' heliocentric positions for moons, in AU
+    SSVector    primaryVel[10];     // primary planets' heliocentric velocities for moons, in AU per day
+    double      earthJED;           // JED at which Earth's position, velocity, and matrix were computed for satellites
+    double      deltaT;             // Delta T at earthJED, in days
+    SSVector    earthPos;           // Earth's heliocentric position for satellites, in AU
+    SSVector    earthVel;           // Earth's heliocentric velocity for satellites, in AU per day
+    SSMatrix    earthMat;           // transforms from equator of date to fundamental frame at earthJED
+
+    SSEphemerisContext ( void );
+    static SSEphemerisContext &threadContext ( void );
+};
+
 // This subclass of SSObject stores data for all solar system objects:
 // major planets, moons, asteroids, comets, and artificial satellites,
 // with a special subclass SSSatellite for the latter.
@@ -135,8 +158,8 @@ protected:
     SSMatrix    _pmatrix;       // transforms from planetographic to fundamental J2000 mean equatorial frame.
     
     void computeMinorPlanetPositionVelocity ( double jed, double lt, SSVector &pos, SSVector &vel );
-    void computeMoonPositionVelocity ( double jed, double lt, SSVector &pos, SSVector &vel );
-    static void computePSPlanetMoonPositionVelocity ( int id, double jed, double lt, SSVector &pos, SSVector &vel );
+    void computeMoonPositionVelocity ( double jed, double lt, SSVector &pos, SSVector &vel, SSEphemerisContext &context );
+    static void computePSPlanetMoonPositionVelocity ( int id, double jed, double lt, SSVector &pos, SSVector &vel, SSEphemerisContext &context );
 
     float computeAsteroidMagnitude ( double rad, double dist, double phase, double hmag, double gmag );
     float computeCometMagnitude ( double rad, double dist, double hmag, double kmag );
@@ -225,11 +248,21 @@ public:
     static void useVSOPELP ( bool use );
     static bool useVSOPELP ( void );
 
+    // Sets whether to answer VSOP/ELP ephemeris requests from a lazily-built cache of Chebyshev
+    // polynomial fits, which is much faster when many nearby times are computed (as in event searches).
+    // Disabling the cache discards all cached fits. Has no effect if USE_VSOP_ELP is not #defined as 1.
+
+    static void useEphemerisCache ( bool use );
+    static bool useEphemerisCache ( void );
+
     static void computeMajorPlanetPositionVelocity ( int id, double jed, double lt, SSVector &pos, SSVector &vel );
+    static void computeMajorPlanetPositionVelocity ( int id, double jed, double lt, SSVector &pos, SSVector &vel, SSEphemerisContext &context );
     virtual void computePositionVelocity ( double jed, double lt, SSVector &pos, SSVector &vel );
+    virtual void computePositionVelocity ( double jed, double lt, SSVector &pos, SSVector &vel, SSEphemerisContext &context );
     virtual void computePositionVelocity  ( SSCoordinates &coords, SSVector &pos, SSVector &vel );
     virtual float computeMagnitude ( double rad, double dist, double phase );
     virtual void computeEphemeris ( SSCoordinates &coords );
+    virtual void computeEphemeris ( SSCoordinates &coords, SSEphemerisContext &context );
     SSSpherical computeApparentMotion ( SSCoordinates &coords, SSFrame frame = kFundamental );
 
     double umbraLength ( float s = 1.0f );
@@ -243,9 +276,10 @@ public:
     bool isEarth ( void ) { return _type == kTypePlanet && _id.identifier() == kEarth; }
     bool isSmallMoon ( void );
     
-    // imports/exports from/to CSV-format text string
+    // imports/exports from/to CSV-format text string, or from fields already split from one
     
-    static SSObjectPtr fromCSV ( string csv );
+    static SSObjectPtr fromCSV ( string_view csv );
+    static SSObjectPtr fromCSV ( vector<string_view> &fields );
     string toCSV ( void );
 };
 
@@ -283,7 +317,10 @@ public:
     
     SSTLE getTLE ( void ) { return _tle; }
 
-    virtual void  computePositionVelocity ( double jed, double lt, SSVector &pos, SSVector &vel );
+    void computeGeocentricPositionVelocity ( double jd, SSVector &pos, SSVector &vel );
+    
+    using SSPlanet::computePositionVelocity;
+    virtual void  computePositionVelocity ( double jed, double lt, SSVector &pos, SSVector &vel, SSEphemerisContext &context );
     virtual float computeMagnitude ( double rad, double dist, double phase );
     static  float computeSatelliteMagnitude ( double dist, double phase, double stdmag );
     
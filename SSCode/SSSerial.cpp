@@ -198,6 +198,27 @@ int SSSerial::inputBytes ( void ) const
 	return comstat.cbInQue;
 }
 
+// SSSerial::waitInput() blocks until bytes are available to read from the serial port,
+// or a timeout in milliseconds (timeout_ms) elapses. Windows has no readiness test for
+// ports opened without overlapped I/O, so this checks the input queue once per millisecond.
+// Returns 1 if bytes are available, 0 on timeout, or -1 on error.
+
+int SSSerial::waitInput ( int timeout_ms ) const
+{
+    ULONGLONG start = GetTickCount64();
+    while ( true )
+    {
+        int bytes = inputBytes();
+        if ( bytes != 0 )
+            return bytes > 0 ? 1 : -1;
+        
+        if ( timeout_ms >= 0 && GetTickCount64() - start >= (ULONGLONG) timeout_ms )
+            return 0;
+        
+        Sleep ( 1 );
+    }
+}
+
 // SSSerial::outputBytes()
 
 int SSSerial::outputBytes ( void )
@@ -218,6 +239,9 @@ int SSSerial::outputBytes ( void )
 #include <string.h>
 #include <unistd.h>
 #include <fcntl.h>
+#include <poll.h>
+#include <errno.h>
+#include <time.h>
 #include <termios.h>
 
 #if defined (__APPLE__)
@@ -465,6 +489,37 @@ int SSSerial::inputBytes () const {
     return bytes;
 }
 
+// SSSerial::waitInput() blocks in poll() until bytes are available to read from the serial port,
+// or a timeout in milliseconds (timeout_ms) elapses; a negative timeout waits forever.
+// Returns 1 if bytes are available, 0 on timeout, or -1 on error.
+
+int SSSerial::waitInput ( int timeout_ms ) const
+{
+    struct pollfd pfd = { _port, POLLIN, 0 };
+    struct timespec start = { 0 }, now = { 0 };
+    clock_gettime ( CLOCK_MONOTONIC, &start );
+    
+    while ( true )
+    {
+        int result = poll ( &pfd, 1, timeout_ms );
+        if ( result >= 0 )
+            return result > 0 ? 1 : 0;
+        
+        // If a signal interrupted poll(), resume waiting for the remaining time.
+        
+        if ( errno != EINTR )
+            return -1;
+        
+        if ( timeout_ms >= 0 )
+        {
+            clock_gettime ( CLOCK_MONOTONIC, &now );
+            int elapsed = (int) ( ( now.tv_sec - start.tv_sec ) * 1000 + ( now.tv_nsec - start.tv_nsec ) / 1000000 );
+            timeout_ms = timeout_ms > elapsed ? timeout_ms - elapsed : 0;
+            start = now;
+        }
+    }
+}
+
 // SSSerial::outputBytes() returns the number of bytes remaining to be written to serial port,
 // or -1 on error.
 
@@ -81,6 +81,7 @@ public:
     int writePort ( const void *data, size_t size ) const;
     int readPort ( void *data, size_t size ) const;
     int inputBytes () const;
+    int waitInput ( int timeout_ms ) const;
     int outputBytes ( void );
     bool getPortConfig ( int &baud, int &parity, int &data, float &stop );
     bool setPortConfig ( int baud, int parity, int data, float stop );
@@ -0,0 +1,200 @@
+// SSSmallVector.hpp
+// SSCore
+//
+// Created by Tim DeBenedictis on 10/16/26.
+// Copyright © 2026 Southern Stars. All rights reserved.
+//
+// A vector which stores up to N elements inside itself, and only allocates memory when it grows
+// beyond that. Stars store their names and identifiers in these: most have at most one name
+// and a few identifiers, so they need no memory beyond the star object itself.
+// Elements are stored contiguously, and iterators are plain pointers, so std::sort(), std::find(),
+// range-based for loops, etc. work as they do with std::vector. Unlike std::vector, a small vector
+// holds at most 65535 elements.
+// Memory for more than N elements comes from the current thread's SSObjectArena, if any,
+// like the object which contains the vector; otherwise it comes from the heap.
+
+#ifndef SSSmallVector_hpp
+#define SSSmallVector_hpp
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <initializer_list>
+#include <iterator>
+#include <new>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "SSObjectArena.hpp"
+
+using namespace std;
+
+template <class T, uint16_t N> class SSSmallVector
+{
+protected:
+
+    uint16_t    _size;                          // number of elements
+    uint16_t    _capacity;                      // number of elements which fit in storage; N if stored inside this vector
+    union
+    {
+        T       *_pHeap;                        // elements allocated outside this vector, if capacity > N
+        alignas ( T ) char _inline[ N * sizeof ( T ) ];     // elements stored inside this vector, if capacity == N
+    };
+
+    // Moves elements to new storage for (n) elements; n must be at least size().
+
+    void reallocate ( size_t n )
+    {
+        if ( n > UINT16_MAX )
+            throw length_error ( "SSSmallVector" );
+
+        T *pOld = data();
+        T *pNew = n > N ? (T *) SSObjectArena::allocateObject ( n * sizeof ( T ) ) : (T *) _inline;
+        if ( pNew == pOld )
+            return;
+
+        for ( size_t i = 0; i < _size; i++ )
+        {
+            new ( pNew + i ) T ( std::move ( pOld[i] ) );
+            pOld[i].~T();
+        }
+
+        if ( _capacity > N )
+            SSObjectArena::releaseObject ( pOld, _capacity * sizeof ( T ) );
+
+        if ( n > N )
+            _pHeap = pNew;
+
+        _capacity = n > N ? n : N;
+    }
+
+public:
+
+    typedef T value_type;
+    typedef T *iterator;
+    typedef const T *const_iterator;
+
+    // constructors, destructor, and assignment
+
+    SSSmallVector ( void ) : _size ( 0 ), _capacity ( N ) {}
+    SSSmallVector ( const SSSmallVector &other ) : SSSmallVector() { assign ( other.begin(), other.end() ); }
+    SSSmallVector ( SSSmallVector &&other ) : SSSmallVector() { *this = std::move ( other ); }
+    SSSmallVector ( initializer_list<T> list ) : SSSmallVector() { assign ( list.begin(), list.end() ); }
+    template <class Iter> SSSmallVector ( Iter first, Iter last ) : SSSmallVector() { assign ( first, last ); }
+    ~SSSmallVector ( void ) { clear(); reallocate ( 0 ); }
+
+    SSSmallVector &operator = ( const SSSmallVector &other )
+    {
+        if ( this != &other )
+            assign ( other.begin(), other.end() );
+        return *this;
+    }
+
+    // Takes over another vector's heap storage, if any, rather than moving its elements.
+
+    SSSmallVector &operator = ( SSSmallVector &&other )
+    {
+        if ( this == &other )
+            return *this;
+
+        clear();
+        if ( other._capacity > N )
+        {
+            reallocate ( 0 );
+            _pHeap = other._pHeap;
+            _size = other._size;
+            _capacity = other._capacity;
+            other._size = 0;
+            other._capacity = N;
+        }
+        else
+        {
+            assign ( make_move_iterator ( other.begin() ), make_move_iterator ( other.end() ) );
+            other.clear();
+        }
+
+        return *this;
+    }
+
+    // Copies elements into a std::vector, for compatibility with code which expects one.
+
+    operator vector<T> ( void ) const { return vector<T> ( begin(), end() ); }
+
+    // element access
+
+    T *data ( void ) { return _capacity > N ? _pHeap : (T *) _inline; }
+    const T *data ( void ) const { return _capacity > N ? _pHeap : (const T *) _inline; }
+    T &operator [] ( size_t i ) { return data()[i]; }
+    const T &operator [] ( size_t i ) const { return data()[i]; }
+    T &front ( void ) { return data()[0]; }
+    T &back ( void ) { return data()[_size - 1]; }
+
+    iterator begin ( void ) { return data(); }
+    iterator end ( void ) { return data() + _size; }
+    const_iterator begin ( void ) const { return data(); }
+    const_iterator end ( void ) const { return data() + _size; }
+
+    size_t size ( void ) const { return _size; }
+    size_t capacity ( void ) const { return _capacity; }
+    size_t allocatedBytes ( void ) const { return _capacity > N ? _capacity * sizeof ( T ) : 0; }     // bytes allocated outside this vector
+    bool empty ( void ) const { return _size == 0; }
+
+    // modifiers
+
+    void reserve ( size_t n )
+    {
+        if ( n > _capacity )
+            reallocate ( n );
+    }
+
+    // Constructs a new element at the end. If there is no room, the new element is constructed
+    // before the others move, in case its arguments refer to one of them.
+
+    template <class... Args> T &emplace_back ( Args&&... args )
+    {
+        if ( _size < _capacity )
+            return *new ( data() + _size++ ) T ( std::forward<Args> ( args )... );
+
+        T elem ( std::forward<Args> ( args )... );
+        reallocate ( max ( (size_t) _size + 1, min ( (size_t) _capacity * 2, (size_t) UINT16_MAX ) ) );
+        return *new ( data() + _size++ ) T ( std::move ( elem ) );
+    }
+
+    void push_back ( const T &elem ) { emplace_back ( elem ); }
+    void push_back ( T &&elem ) { emplace_back ( std::move ( elem ) ); }
+    void pop_back ( void ) { data()[--_size].~T(); }
+
+    void resize ( size_t n )
+    {
+        while ( _size > n )
+            pop_back();
+
+        reserve ( n );
+        while ( _size < n )
+            new ( data() + _size++ ) T();
+    }
+
+    void clear ( void )
+    {
+        resize ( 0 );
+    }
+
+    template <class Iter> void assign ( Iter first, Iter last )
+    {
+        clear();
+        reserve ( distance ( first, last ) );
+        for ( ; first != last; first++ )
+            new ( data() + _size++ ) T ( *first );
+    }
+
+    void assign ( size_t n, const T &elem )
+    {
+        clear();
+        reserve ( n );
+        while ( _size < n )
+            new ( data() + _size++ ) T ( elem );
+    }
+};
+
+#endif /* SSSmallVector_hpp */
@@ -77,10 +77,13 @@ void SSSocket::finalize ( void )
 #include <sys/time.h>
 #include <unistd.h>
 #include <net/if.h>
+#include <poll.h>
 
 #define ioctlsocket(s,p,o) ioctl(s,p,o)
 #define closesocket(s) close(s)
 #define SOCKET_ERROR -1
+#define WSAPoll(f,n,t) poll(f,n,t)
+typedef pollfd WSAPOLLFD;
 
 bool SSSocket::initialize ( void )
 {
@@ -636,6 +639,42 @@ int SSSocket::readSocket ( void *data, int size )
     return nResult == SOCKET_ERROR ? SOCKET_ERROR : nBytesRead;
 }
 
+// Blocks until data is available to read from this socket, the remote peer closes the connection,
+// or a timeout in milliseconds (timeout_ms) elapses; a negative timeout waits forever.
+// Returns 1 if the socket is readable (including when closed by the peer; readSocket()
+// will then return zero bytes), 0 if the timeout elapsed, or SOCKET_ERROR on failure.
+
+int SSSocket::waitSocket ( int timeout_ms )
+{
+    WSAPOLLFD pfd = { 0 };
+    pfd.fd = _socket;
+    pfd.events = POLLIN;
+    
+    int nResult = 0;
+    double start = clocksec();
+    while ( ( nResult = WSAPoll ( &pfd, 1, timeout_ms ) ) == SOCKET_ERROR )
+    {
+        // On POSIX systems, a signal can interrupt poll() before the timeout; resume with the remaining time.
+
+#ifndef _WIN32
+        if ( errno != EINTR )
+            break;
+        if ( timeout_ms >= 0 )
+        {
+            timeout_ms = max ( 0, timeout_ms - (int) ( clocksec_since ( start ) * 1000.0 ) );
+            start = clocksec();
+        }
+#else
+        break;
+#endif
+    }
+    
+    if ( nResult == SOCKET_ERROR )
+        return SOCKET_ERROR;
+    
+    return nResult > 0 ? 1 : 0;
+}
+
 // Closes a socket connection and frees associated resources, and invalidates
 // this SSSocket object's native socket handle/file descriptor.
 // If ths is a TCP socket, the peer on the remote end of the connection
@@ -829,6 +868,15 @@ int SSSocket::writeUDPSocket ( const void *lpvData, int lLength, SSIP destIP, ui
 // that extra data will be discarded.
 
 int SSSocket::readUDPSocket ( void *lpvData, int lLength, SSIP &senderIP, int timeout_ms )
+{
+    uint16_t senderPort = 0;
+    return readUDPSocket ( lpvData, lLength, senderIP, senderPort, timeout_ms );
+}
+
+// As above, but also returns the UDP port the remote sender transmitted from in (senderPort),
+// so a server can reply to a client whose socket was bound to an arbitrary local port.
+
+int SSSocket::readUDPSocket ( void *lpvData, int lLength, SSIP &senderIP, uint16_t &senderPort, int timeout_ms )
 {
     int             nResult;
     timeval         tv = { 0 };
@@ -871,9 +919,15 @@ int SSSocket::readUDPSocket ( void *lpvData, int lLength, SSIP &senderIP, int ti
     }
     
     if ( senderIP.ipv6 )
+    {
         senderIP = add6.sin6_addr;
+        senderPort = ntohs ( add6.sin6_port );
+    }
     else
+    {
         senderIP = addr.sin_addr;
+        senderPort = ntohs ( addr.sin_port );
+    }
     
     return nResult;
 }
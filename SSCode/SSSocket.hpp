@@ -101,6 +101,7 @@ public:
     bool socketOpen ( void );
     int writeSocket ( const void *data, int size );
     int readSocket ( void *data, int size );
+    int waitSocket ( int timeout_ms );
     void closeSocket ( void );
     bool getRemoteIP ( SSIP &peerIP );
 
@@ -115,6 +116,7 @@ public:
     bool openUDPSocket ( SSIP localIP, unsigned short localPort );
     int writeUDPSocket ( const void *data, int size, SSIP destIP, unsigned short destPort );
     int readUDPSocket ( void *data, int size, SSIP &senderIP, int timeout_ms );
+    int readUDPSocket ( void *data, int size, SSIP &senderIP, unsigned short &senderPort, int timeout_ms );
     bool isUDPSocket ( void );
 };
 
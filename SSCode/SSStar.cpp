@@ -230,9 +230,6 @@ static vector<SSStar::SpecInfo> _specinfo =
 
 SSStar::SSStar ( SSObjectType type ) : SSObject ( type )
 {
-    _names = vector<string> ( 0 );
-    _idents = vector<SSIdentifier> ( 0 );
-
     _parallax = 0.0;
     _radvel = INFINITY;
     _position = _velocity = SSVector ( INFINITY, INFINITY, INFINITY );
@@ -326,12 +323,25 @@ SSIdentifier SSStar::getIdentifier ( int i )
 
 SSIdentifier SSStar::getIdentifier ( SSCatalog cat )
 {
-    return SSGetIdentifier ( cat, _idents );
+    for ( SSIdentifier ident : _idents )
+        if ( ident.catalog() == cat )
+            return ident;
+
+    return SSIdentifier();
 }
 
+// Adds an identifier to this star, if the identifier is valid and not already present.
+// Returns true if identifier was added, false otherwise.
+
 bool SSStar::addIdentifier ( SSIdentifier ident )
 {
-    return SSAddIdentifier ( ident, _idents );
+    if ( ident && find ( _idents.begin(), _idents.end(), ident ) == _idents.end() )
+    {
+        _idents.push_back ( ident );
+        return true;
+    }
+
+    return false;
 }
 
 void SSStar::sortIdentifiers ( void )
@@ -1437,21 +1447,30 @@ string SSDeepSky::toCSV ( void )
 // Allocates a new SSStar and initializes it from a CSV-formatted string.
 // Returns nullptr on error (invalid CSV string, heap allocation failure, etc.)
 
-SSObjectPtr SSStar::fromCSV ( string csv )
+SSObjectPtr SSStar::fromCSV ( string_view csv )
 {
-    // split string into comma-delimited fields,
-    // remove leading & trailing whitespace from each field.
+    // split string into comma-delimited fields, then parse them.
     
-    vector<string> fields = split_csv ( csv );
+    vector<string_view> fields;
+    string buffer;
+    split_csv ( csv, fields, buffer );
+    return fromCSV ( fields );
+}
+
+// Creates a star or deep sky object from fields split from a CSV-format text line by split_csv().
+// Fields are trimmed in place. Returns nullptr if the fields do not describe one.
+
+SSObjectPtr SSStar::fromCSV ( vector<string_view> &fields )
+{
     for ( int i = 0; i < fields.size(); i++ )
-        fields[i] = trim ( fields[i] );
+        fields[i] = trim_view ( fields[i] );
     
     // Eliminate lines with insifficient fields, or header lines
     
-    if ( fields.size() < 10 || strncmp ( fields[0].c_str(), "Type", 4) == 0 )
+    if ( fields.size() < 10 || fields[0].substr ( 0, 4 ) == "Type" )
         return nullptr;
     
-    SSObjectType type = SSObject::codeToType ( fields[0] );
+    SSObjectType type = SSObject::codeToType ( string ( fields[0] ) );
     if ( type < kTypeStar || type > kTypeGalaxy )
         if ( type != kTypeNonexistent )
             return nullptr;
@@ -1508,7 +1527,7 @@ SSObjectPtr SSStar::fromCSV ( string csv )
     
     float dist = fields[7].empty() ? INFINITY : strtofloat ( fields[7] ) * SSCoordinates::kLYPerParsec;
     float radvel = fields[8].empty() ? INFINITY : strtofloat ( fields[8] ) / SSCoordinates::kLightKmPerSec;
-    string spec = trim ( fields[9] );
+    string spec ( fields[9] );
     
     // Store common parameters
     
@@ -1524,7 +1543,7 @@ SSObjectPtr SSStar::fromCSV ( string csv )
     
     if ( pDoubleStar )
     {
-        string comps = fields[10];
+        string comps ( fields[10] );
         float dmag = fields[11].empty() ? INFINITY : strtofloat ( fields[11] );
         float sep = fields[12].empty() ? INFINITY : strtofloat ( fields[12] ) / SSAngle::kArcsecPerRad;
         float pa = fields[13].empty() ? INFINITY : strtofloat ( fields[13] ) / SSAngle::kDegPerRad;
@@ -1561,7 +1580,7 @@ SSObjectPtr SSStar::fromCSV ( string csv )
     {
         int fv = 22;
             
-        string vtype = fields[fv];
+        string vtype ( fields[fv] );
         float vmin = fields[fv+1].empty() ? INFINITY : strtofloat ( fields[fv+1] );
         float vmax = fields[fv+2].empty() ? INFINITY : strtofloat ( fields[fv+2] );
         float vper = fields[fv+3].empty() ? INFINITY : strtofloat ( fields[fv+3] );
@@ -1590,7 +1609,7 @@ SSObjectPtr SSStar::fromCSV ( string csv )
     // Parse semicolon-delimited identifiers from the ID field and add to the identifier vector
     
     vector<SSIdentifier> ids;
-    vector<string> idents = split ( fields[fid], ";" );
+    vector<string> idents = split ( string ( fields[fid] ), ";" );
     for ( int i = 0; i < idents.size(); i++ )
     {
         trim ( idents[i] );
@@ -1608,7 +1627,7 @@ SSObjectPtr SSStar::fromCSV ( string csv )
     vector<string> names;
     if ( fields.size() > fid + 1 )
     {
-        names = split ( fields[fid+1], ";" );
+        names = split ( string ( fields[fid+1] ), ";" );
         for ( int i = 0; i < names.size(); i++ )
         {
             trim ( names[i] );
@@ -19,6 +19,8 @@
 
 #pragma pack ( push, 1 )
 
+typedef SSSmallVector<SSIdentifier,4> SSIdentifiers;    // star catalog identifiers; up to four fit inside the star
+
 // This subclass of SSObject stores basic data for stars.
 // Its subclasses store double and variable star data,
 // and deep sky object data.
@@ -27,7 +29,7 @@ class SSStar : public SSObject
 {
 protected:
     
-    vector<SSIdentifier> _idents;
+    SSIdentifiers _idents;  // catalog identifiers
     
     SSVector _position;     // heliocentric position unit vector in fundamental frame at epoch J2000
     SSVector _velocity;     // heliocentric space velocity vector in fundamental frame at epoch J2000 in distance units per Julian year; infinite if unknown
@@ -50,7 +52,8 @@ public:
     
     SSStar ( void );
     
-    void setIdentifiers ( const vector<SSIdentifier> &idents ) { _idents = idents; }
+    void setIdentifiers ( const vector<SSIdentifier> &idents ) { _idents.assign ( idents.begin(), idents.end() ); }
+    void setIdentifiers ( const SSIdentifiers &idents ) { _idents = idents; }
     void setFundamentalPosition ( SSVector pos ) { _position = pos; }
     void setFundamentalVelocity ( SSVector vel ) { _velocity = vel; }
     void setFundamentalCoords ( SSSpherical coords );
@@ -64,7 +67,8 @@ public:
     bool addIdentifier ( SSIdentifier ident );
     SSIdentifier getIdentifier ( SSCatalog cat );
     SSIdentifier getIdentifier ( int i );
-    vector<SSIdentifier> getIdentifiers ( void ) { return _idents; }
+    vector<SSIdentifier> getIdentifiers ( void ) { return vector<SSIdentifier> ( _idents.begin(), _idents.end() ); }
+    const SSIdentifiers &getIdents ( void ) { return _idents; }   // like getIdentifiers(), but returns a reference instead of a copy
     void sortIdentifiers ( void );
     
     SSVector getFundamentalPosition ( void ) { return _position; }
@@ -81,9 +85,10 @@ public:
     void computePositionVelocity ( SSCoordinates &coords, SSVector &pos, SSVector &vel );
     SSSpherical computeApparentMotion ( SSCoordinates &coords, SSFrame frame = kFundamental );
 
-    // imports/exports from/to CSV-format text string
+    // imports/exports from/to CSV-format text string, or from fields already split from one
     
-    static SSObjectPtr fromCSV ( string csv );
+    static SSObjectPtr fromCSV ( string_view csv );
+    static SSObjectPtr fromCSV ( vector<string_view> &fields );
     virtual string toCSV ( void );
     
     // magnitude and color conversion utilities
@@ -0,0 +1,298 @@
+// SSStarArray.cpp
+// SSCore
+//
+// Created by Tim DeBenedictis on 10/16/26.
+// Copyright © 2026 Southern Stars. All rights reserved.
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+#include "SSStarArray.hpp"
+
+// Observer-dependent quantities shared by all stars in one call to computeEphemeris().
+
+struct StarKernelParams
+{
+    double dt;                  // days since J2000 if applying stellar space motion, otherwise zero
+    double ox, oy, oz;          // observer heliocentric position if applying parallax, otherwise zero
+    bool aberration;            // true if applying aberration
+    double ax, ay, az;          // observer velocity as fraction of light speed
+    double beta;                // sqrt ( 1 - v^2 ) for aberration
+};
+
+// Returns log10 ( delta ). When delta is close to one, as it is for nearly all stars,
+// uses a series for log ( 1 + e ) whose truncation error is far below double precision.
+
+static inline double log10delta ( double delta )
+{
+    double e = delta - 1.0;
+    if ( fabs ( e ) < 1.0e-3 )
+        return e * ( 1.0 - e * ( 1.0 / 2.0 - e * ( 1.0 / 3.0 - e * ( 1.0 / 4.0 - e * ( 1.0 / 5.0 - e / 6.0 ) ) ) ) ) / M_LN10;
+    else
+        return log10 ( delta );
+}
+
+// Appends a star (pStar) to this array. Double stars whose ephemeris depends on another star
+// (i.e. have an orbit relative to a primary) are not appended; returns false for them.
+
+bool SSStarArray::append ( SSStar *pStar )
+{
+    SSDoubleStarPtr pDouble = SSGetDoubleStarPtr ( pStar );
+    if ( pStar == nullptr || ( pDouble && pDouble->hasOrbit() && pDouble->getPrimary() && pDouble->getPrimary() != pDouble ) )
+        return false;
+
+    SSVector pos = pStar->getFundamentalPosition();
+    SSVector vel = pStar->getFundamentalVelocity();
+    if ( vel.isinf() || vel.isnan() )
+        vel = SSVector ( 0.0, 0.0, 0.0 );
+
+    float vmag = pStar->getVMagnitude();
+    float plx = pStar->getParallax();
+
+    _stars.push_back ( pStar );
+    _px.push_back ( pos.x );
+    _py.push_back ( pos.y );
+    _pz.push_back ( pos.z );
+    _vx.push_back ( vel.x );
+    _vy.push_back ( vel.y );
+    _vz.push_back ( vel.z );
+    _plx.push_back ( plx > 0.0 ? plx : 0.0 );
+    _mag0.push_back ( vmag < INFINITY ? vmag : pStar->getBMagnitude() );
+    return true;
+}
+
+// Appends all stars, and all other objects derived from SSStar, in an object array (objects).
+// Returns the number of objects appended.
+
+int SSStarArray::append ( SSObjectArray &objects )
+{
+    int n = 0;
+
+    reserve ( size() + objects.size() );
+    for ( size_t i = 0; i < objects.size(); i++ )
+        n += append ( SSGetStarPtr ( objects[i] ) );
+
+    return n;
+}
+
+// Reserves memory for a total number of stars (n).
+
+void SSStarArray::reserve ( size_t n )
+{
+    _stars.reserve ( n );
+    for ( vector<double> *pCol : { &_px, &_py, &_pz, &_vx, &_vy, &_vz, &_plx, &_mag0 } )
+        pCol->reserve ( n );
+}
+
+// Removes all stars from this array. Does not delete the stars themselves.
+
+void SSStarArray::clear ( void )
+{
+    _stars.clear();
+    for ( vector<double> *pCol : { &_px, &_py, &_pz, &_vx, &_vy, &_vz, &_plx, &_mag0, &_dx, &_dy, &_dz, &_dist } )
+        pCol->clear();
+    _mag.clear();
+}
+
+// Computes apparent direction and distance of the i-th star, and returns its distance ratio (delta).
+// Performs the same operations as SSStar::computeEphemeris(), in the same order.
+
+static inline double computeStar ( const StarKernelParams &k, size_t i, const double *px, const double *py, const double *pz,
+                                   const double *vx, const double *vy, const double *vz, const double *plx,
+                                   double *dx, double *dy, double *dz, double *dist )
+{
+    double x = px[i] + vx[i] * k.dt / SSTime::kDaysPerJulianYear;
+    double y = py[i] + vy[i] * k.dt / SSTime::kDaysPerJulianYear;
+    double z = pz[i] + vz[i] * k.dt / SSTime::kDaysPerJulianYear;
+
+    double f = plx[i] / SSCoordinates::kAUPerParsec;
+    x -= k.ox * f;
+    y -= k.oy * f;
+    z -= k.oz * f;
+
+    double delta = 1.0;
+    if ( x != px[i] || y != py[i] || z != pz[i] )
+    {
+        delta = sqrt ( x * x + y * y + z * z );
+        x /= delta;
+        y /= delta;
+        z /= delta;
+    }
+
+    dist[i] = plx[i] > 0.0 ? delta * SSCoordinates::kAUPerParsec / plx[i] : INFINITY;
+
+    if ( k.aberration )
+    {
+        double dot = k.ax * x + k.ay * y + k.az * z;
+        double s = 1.0 + dot / ( 1.0 + k.beta );
+        double n = 1.0 + dot;
+        x = ( x * k.beta + k.ax * s ) / n;
+        y = ( y * k.beta + k.ay * s ) / n;
+        z = ( z * k.beta + k.az * s ) / n;
+    }
+
+    dx[i] = x;
+    dy[i] = y;
+    dz[i] = z;
+    return delta;
+}
+
+// Computes apparent directions, distances, and magnitudes of all stars in this array
+// as seen from an observer's location and time (coords), applying stellar space motion,
+// parallax, and aberration as specified in the coordinates. Results are stored in this
+// array, not in the source stars.
+
+void SSStarArray::computeEphemeris ( SSCoordinates &coords )
+{
+    size_t n = size();
+    _dx.resize ( n );
+    _dy.resize ( n );
+    _dz.resize ( n );
+    _dist.resize ( n );
+    _mag.resize ( n );
+
+    StarKernelParams k = { 0.0 };
+    SSVector obsPos = coords.getObserverPosition();
+    SSVector v = coords.getObserverVelocity() / coords.kLightAUPerDay;
+
+    k.dt = coords.getStarMotion() ? coords.getJED() - SSTime::kJ2000 : 0.0;
+    if ( coords.getStarParallax() )
+    {
+        k.ox = obsPos.x;
+        k.oy = obsPos.y;
+        k.oz = obsPos.z;
+    }
+
+    k.aberration = coords.getAberration();
+    k.ax = v.x;
+    k.ay = v.y;
+    k.az = v.z;
+    k.beta = sqrt ( 1.0 - v * v );
+
+    const double *px = _px.data(), *py = _py.data(), *pz = _pz.data();
+    const double *vx = _vx.data(), *vy = _vy.data(), *vz = _vz.data();
+    const double *plx = _plx.data(), *mag0 = _mag0.data();
+    double *dx = _dx.data(), *dy = _dy.data(), *dz = _dz.data(), *dist = _dist.data();
+    float *mag = _mag.data();
+    size_t i = 0;
+
+#if defined(__AVX2__)
+    __m256d dt = _mm256_set1_pd ( k.dt ), year = _mm256_set1_pd ( SSTime::kDaysPerJulianYear );
+    __m256d ox = _mm256_set1_pd ( k.ox ), oy = _mm256_set1_pd ( k.oy ), oz = _mm256_set1_pd ( k.oz );
+    __m256d ax = _mm256_set1_pd ( k.ax ), ay = _mm256_set1_pd ( k.ay ), az = _mm256_set1_pd ( k.az );
+    __m256d beta = _mm256_set1_pd ( k.beta ), one = _mm256_set1_pd ( 1.0 ), onebeta = _mm256_set1_pd ( 1.0 + k.beta );
+    __m256d aupc = _mm256_set1_pd ( SSCoordinates::kAUPerParsec ), inf = _mm256_set1_pd ( INFINITY ), zero = _mm256_setzero_pd();
+
+    for ( ; i + 4 <= n; i += 4 )
+    {
+        __m256d x0 = _mm256_loadu_pd ( px + i ), y0 = _mm256_loadu_pd ( py + i ), z0 = _mm256_loadu_pd ( pz + i );
+        __m256d x = _mm256_add_pd ( x0, _mm256_div_pd ( _mm256_mul_pd ( _mm256_loadu_pd ( vx + i ), dt ), year ) );
+        __m256d y = _mm256_add_pd ( y0, _mm256_div_pd ( _mm256_mul_pd ( _mm256_loadu_pd ( vy + i ), dt ), year ) );
+        __m256d z = _mm256_add_pd ( z0, _mm256_div_pd ( _mm256_mul_pd ( _mm256_loadu_pd ( vz + i ), dt ), year ) );
+
+        __m256d p = _mm256_loadu_pd ( plx + i ), f = _mm256_div_pd ( p, aupc );
+        x = _mm256_sub_pd ( x, _mm256_mul_pd ( ox, f ) );
+        y = _mm256_sub_pd ( y, _mm256_mul_pd ( oy, f ) );
+        z = _mm256_sub_pd ( z, _mm256_mul_pd ( oz, f ) );
+
+        __m256d same = _mm256_and_pd ( _mm256_and_pd ( _mm256_cmp_pd ( x, x0, _CMP_EQ_OQ ), _mm256_cmp_pd ( y, y0, _CMP_EQ_OQ ) ), _mm256_cmp_pd ( z, z0, _CMP_EQ_OQ ) );
+        __m256d delta = _mm256_sqrt_pd ( _mm256_add_pd ( _mm256_add_pd ( _mm256_mul_pd ( x, x ), _mm256_mul_pd ( y, y ) ), _mm256_mul_pd ( z, z ) ) );
+        delta = _mm256_blendv_pd ( delta, one, same );
+        x = _mm256_div_pd ( x, delta );
+        y = _mm256_div_pd ( y, delta );
+        z = _mm256_div_pd ( z, delta );
+
+        __m256d d = _mm256_div_pd ( _mm256_mul_pd ( delta, aupc ), p );
+        _mm256_storeu_pd ( dist + i, _mm256_blendv_pd ( inf, d, _mm256_cmp_pd ( p, zero, _CMP_GT_OQ ) ) );
+
+        if ( k.aberration )
+        {
+            __m256d dot = _mm256_add_pd ( _mm256_add_pd ( _mm256_mul_pd ( ax, x ), _mm256_mul_pd ( ay, y ) ), _mm256_mul_pd ( az, z ) );
+            __m256d s = _mm256_add_pd ( one, _mm256_div_pd ( dot, onebeta ) );
+            __m256d nn = _mm256_add_pd ( one, dot );
+            x = _mm256_div_pd ( _mm256_add_pd ( _mm256_mul_pd ( x, beta ), _mm256_mul_pd ( ax, s ) ), nn );
+            y = _mm256_div_pd ( _mm256_add_pd ( _mm256_mul_pd ( y, beta ), _mm256_mul_pd ( ay, s ) ), nn );
+            z = _mm256_div_pd ( _mm256_add_pd ( _mm256_mul_pd ( z, beta ), _mm256_mul_pd ( az, s ) ), nn );
+        }
+
+        _mm256_storeu_pd ( dx + i, x );
+        _mm256_storeu_pd ( dy + i, y );
+        _mm256_storeu_pd ( dz + i, z );
+
+        double deltas[4];
+        _mm256_storeu_pd ( deltas, delta );
+        for ( int j = 0; j < 4; j++ )
+            mag[i + j] = mag0[i + j] + 5.0 * log10delta ( deltas[j] );
+    }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    float64x2_t dt = vdupq_n_f64 ( k.dt ), year = vdupq_n_f64 ( SSTime::kDaysPerJulianYear );
+    float64x2_t ox = vdupq_n_f64 ( k.ox ), oy = vdupq_n_f64 ( k.oy ), oz = vdupq_n_f64 ( k.oz );
+    float64x2_t ax = vdupq_n_f64 ( k.ax ), ay = vdupq_n_f64 ( k.ay ), az = vdupq_n_f64 ( k.az );
+    float64x2_t beta = vdupq_n_f64 ( k.beta ), one = vdupq_n_f64 ( 1.0 ), onebeta = vdupq_n_f64 ( 1.0 + k.beta );
+    float64x2_t aupc = vdupq_n_f64 ( SSCoordinates::kAUPerParsec ), inf = vdupq_n_f64 ( INFINITY ), zero = vdupq_n_f64 ( 0.0 );
+
+    for ( ; i + 2 <= n; i += 2 )
+    {
+        float64x2_t x0 = vld1q_f64 ( px + i ), y0 = vld1q_f64 ( py + i ), z0 = vld1q_f64 ( pz + i );
+        float64x2_t x = vaddq_f64 ( x0, vdivq_f64 ( vmulq_f64 ( vld1q_f64 ( vx + i ), dt ), year ) );
+        float64x2_t y = vaddq_f64 ( y0, vdivq_f64 ( vmulq_f64 ( vld1q_f64 ( vy + i ), dt ), year ) );
+        float64x2_t z = vaddq_f64 ( z0, vdivq_f64 ( vmulq_f64 ( vld1q_f64 ( vz + i ), dt ), year ) );
+
+        float64x2_t p = vld1q_f64 ( plx + i ), f = vdivq_f64 ( p, aupc );
+        x = vsubq_f64 ( x, vmulq_f64 ( ox, f ) );
+        y = vsubq_f64 ( y, vmulq_f64 ( oy, f ) );
+        z = vsubq_f64 ( z, vmulq_f64 ( oz, f ) );
+
+        uint64x2_t same = vandq_u64 ( vandq_u64 ( vceqq_f64 ( x, x0 ), vceqq_f64 ( y, y0 ) ), vceqq_f64 ( z, z0 ) );
+        float64x2_t delta = vsqrtq_f64 ( vaddq_f64 ( vaddq_f64 ( vmulq_f64 ( x, x ), vmulq_f64 ( y, y ) ), vmulq_f64 ( z, z ) ) );
+        delta = vbslq_f64 ( same, one, delta );
+        x = vdivq_f64 ( x, delta );
+        y = vdivq_f64 ( y, delta );
+        z = vdivq_f64 ( z, delta );
+
+        float64x2_t d = vdivq_f64 ( vmulq_f64 ( delta, aupc ), p );
+        vst1q_f64 ( dist + i, vbslq_f64 ( vcgtq_f64 ( p, zero ), d, inf ) );
+
+        if ( k.aberration )
+        {
+            float64x2_t dot = vaddq_f64 ( vaddq_f64 ( vmulq_f64 ( ax, x ), vmulq_f64 ( ay, y ) ), vmulq_f64 ( az, z ) );
+            float64x2_t s = vaddq_f64 ( one, vdivq_f64 ( dot, onebeta ) );
+            float64x2_t nn = vaddq_f64 ( one, dot );
+            x = vdivq_f64 ( vaddq_f64 ( vmulq_f64 ( x, beta ), vmulq_f64 ( ax, s ) ), nn );
+            y = vdivq_f64 ( vaddq_f64 ( vmulq_f64 ( y, beta ), vmulq_f64 ( ay, s ) ), nn );
+            z = vdivq_f64 ( vaddq_f64 ( vmulq_f64 ( z, beta ), vmulq_f64 ( az, s ) ), nn );
+        }
+
+        vst1q_f64 ( dx + i, x );
+        vst1q_f64 ( dy + i, y );
+        vst1q_f64 ( dz + i, z );
+
+        double deltas[2];
+        vst1q_f64 ( deltas, delta );
+        for ( int j = 0; j < 2; j++ )
+            mag[i + j] = mag0[i + j] + 5.0 * log10delta ( deltas[j] );
+    }
+#endif
+
+    for ( ; i < n; i++ )
+    {
+        double delta = computeStar ( k, i, px, py, pz, vx, vy, vz, plx, dx, dy, dz, dist );
+        mag[i] = mag0[i] + 5.0 * log10delta ( delta );
+    }
+}
+
+// Copies apparent directions, distances, and magnitudes computed by the last call
+// to computeEphemeris() into the source stars.
+
+void SSStarArray::update ( void )
+{
+    for ( size_t i = 0; i < _mag.size(); i++ )
+    {
+        _stars[i]->setDirection ( SSVector ( _dx[i], _dy[i], _dz[i] ) );
+        _stars[i]->setDistance ( _dist[i] );
+        _stars[i]->setMagnitude ( _mag[i] );
+    }
+}
@@ -0,0 +1,64 @@
+// SSStarArray.hpp
+// SSCore
+//
+// Created by Tim DeBenedictis on 10/16/26.
+// Copyright © 2026 Southern Stars. All rights reserved.
+//
+// A columnar companion to an array of SSStar objects, for computing apparent directions,
+// distances, and magnitudes of millions of stars at once. J2000 positions, space velocities,
+// parallaxes, and magnitudes are copied into contiguous arrays, one per component, so that
+// computeEphemeris() can process several stars per instruction. Uses AVX2 or NEON if the
+// compiler targets them; the scalar version performs the same operations in the same order.
+// Results agree with SSStar::computeEphemeris() to within rounding error. The source stars
+// are not modified unless you call update(). Stars can be appended from any SSObjectArray,
+// including the object arrays that SSHTM stores for each region.
+
+#ifndef SSStarArray_hpp
+#define SSStarArray_hpp
+
+#include "SSStar.hpp"
+#include "SSCoordinates.hpp"
+
+class SSStarArray
+{
+protected:
+
+    vector<SSStar *> _stars;                // source stars; not owned by this array
+    vector<double> _px, _py, _pz;           // J2000 heliocentric position unit vectors
+    vector<double> _vx, _vy, _vz;           // space velocities in distance units per Julian year; zero if unknown
+    vector<double> _plx;                    // parallaxes in arcseconds; zero if unknown
+    vector<double> _mag0;                   // J2000 visual magnitudes (or blue if visual unknown)
+
+    vector<double> _dx, _dy, _dz;           // apparent direction unit vectors
+    vector<double> _dist;                   // distances in AU; infinite if unknown
+    vector<float> _mag;                     // apparent magnitudes
+
+public:
+
+    SSStarArray ( void ) {}
+
+    size_t size ( void ) { return _stars.size(); }
+    void reserve ( size_t n );
+    void clear ( void );
+
+    bool append ( SSStar *pStar );
+    int append ( SSObjectArray &objects );
+
+    void computeEphemeris ( SSCoordinates &coords );
+    void update ( void );
+
+    SSStar *getStar ( size_t i ) { return _stars[i]; }
+    SSVector getDirection ( size_t i ) { return SSVector ( _dx[i], _dy[i], _dz[i] ); }
+    double getDistance ( size_t i ) { return _dist[i]; }
+    float getMagnitude ( size_t i ) { return _mag[i]; }
+
+    // direct access to computed columns, for renderers
+
+    const double *getDirectionsX ( void ) { return _dx.data(); }
+    const double *getDirectionsY ( void ) { return _dy.data(); }
+    const double *getDirectionsZ ( void ) { return _dz.data(); }
+    const double *getDistances ( void ) { return _dist.data(); }
+    const float *getMagnitudes ( void ) { return _mag.data(); }
+};
+
+#endif /* SSStarArray_hpp */
@@ -20,6 +20,8 @@
 #include <errno.h>
 #include <glob.h>
 #include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
 #endif
 
 #include "SSUtilities.hpp"
@@ -80,29 +82,38 @@ bool islink ( const string &path )
 // Reads into a C++ string (line) from a C FILE pointer (file) opened for reading in binary mode.
 // Handles lines endings in LF (Unix/Mac), CRLF (Windows), or CR (Classic MacOS). In all cases,
 // dicards line ending characters. Returns true if successful or false on failure (end-of-file, etc.)
+// Reads characters from the FILE's own buffer without locking it for each one; don't read the
+// same FILE from other threads at the same time. For large files, SSLineReader is much faster.
+
+#ifdef _MSC_VER
+#define getc_unlocked _getc_nolock
+#define ungetc_unlocked _ungetc_nolock
+#else
+#define ungetc_unlocked ungetc
+#endif
 
 bool fgetline ( FILE *file, string &line )
 {
-    line = "";
-    char c = 0;
+    line.clear();
+    int c = 0;
 
-    while ( true )
+    while ( ( c = getc_unlocked ( file ) ) != EOF )
     {
-        if ( fread ( &c, 1, 1, file ) != 1 )
-            return line.empty() ? false : true;
-        
         if ( c == '\n' )
             return true;
 
         if ( c == '\r' )
         {
-            if ( fread ( &c, 1, 1, file ) == 1 && c != '\n' )
-                fseek ( file, -1, SEEK_CUR );
+            c = getc_unlocked ( file );
+            if ( c != '\n' && c != EOF )
+                ungetc_unlocked ( c, file );
             return true;
         }
         
-        line += c;
+        line += (char) c;
     }
+    
+    return line.empty() ? false : true;
 }
 
 // Returns a C++ string which has leading and trailing whitespace
@@ -119,6 +130,20 @@ string trim ( string str )
         return str.substr ( start, ( end - start ) + 1 );
 }
 
+// Returns a view of the input string_view with leading and trailing whitespace
+// trimmed, without copying. The view points into the same characters as the input.
+
+string_view trim_view ( string_view str )
+{
+    auto start = str.find_first_not_of ( " \t\r\n" );
+    auto end = str.find_last_not_of ( " \t\r\n" );
+
+    if ( start == string_view::npos )
+        return string_view();
+    else
+        return str.substr ( start, ( end - start ) + 1 );
+}
+
 // Returns C++ string constructed from printf()-style input arguments.
 
 string formstr ( const char *fmt, ... )
@@ -430,6 +455,25 @@ vector<string> split ( string str, string delim )
     return tokens;
 }
 
+// Splits a string_view (str) into a vector of token views (tokens) separated by the specified delimiter,
+// exactly like split() above, but without copying. Token views point into the input characters.
+
+void split ( string_view str, string_view delim, vector<string_view> &tokens )
+{
+    tokens.clear();
+    
+    size_t start = 0;
+    size_t end = str.find ( delim );
+    while ( end != string_view::npos )
+    {
+        tokens.push_back ( str.substr ( start, end - start ) );
+        start = end + delim.length();
+        end = str.find ( delim, start );
+    }
+
+    tokens.push_back ( str.substr ( start, end ) );
+}
+
 // Splits a string into a vector of token strings separated by the specified delimiter.
 // Adjacent delimiters are ignored so tokens can never be empty (as with C's strtok()).
 // The original string is not modified.
@@ -463,96 +507,151 @@ enum CSVState
 
 vector<string> split_csv ( const string &csv )
 {
-    CSVState state = kCSVUnquotedField;
-    vector<string> fields {""};
-    size_t i = 0; // index of the current field
+    vector<string_view> views;
+    string buffer;
     
-    for ( char c : csv )
+    split_csv ( csv, views, buffer );
+    return vector<string> ( views.begin(), views.end() );
+}
+
+// Splits a string_view (csv) containing comma-separated values into a vector of field views (fields),
+// exactly like split_csv() above, but without allocating a string per field. Fields without quotes
+// are views into the input; quoted fields are unescaped into a buffer (buffer), whose contents are
+// replaced. Field views are valid as long as the input characters and buffer are not modified.
+
+void split_csv ( string_view csv, vector<string_view> &fields, string &buffer )
+{
+    // Reserve enough buffer for every field, so it is never reallocated under earlier field views.
+    
+    fields.clear();
+    buffer.clear();
+    buffer.reserve ( csv.size() );
+
+    size_t i = 0, n = csv.size();
+    while ( true )
     {
-        switch ( state )
+        // Find the end of the field. If we reach it without finding a quote, the field is a view of the input.
+
+        size_t start = i;
+        while ( i < n && csv[i] != ',' && csv[i] != '"' )
+            i++;
+        
+        if ( i == n || csv[i] == ',' )
+        {
+            fields.push_back ( csv.substr ( start, i - start ) );
+        }
+        else
         {
-            case kCSVUnquotedField:
-                switch ( c )
+            // Otherwise, copy the field into the buffer, and parse the rest of it with the same
+            // state machine as above.
+            
+            size_t begin = buffer.size();
+            buffer.append ( csv.data() + start, i - start );
+            
+            CSVState state = kCSVUnquotedField;
+            for ( ; i < n; i++ )
+            {
+                char c = csv[i];
+                if ( state == kCSVUnquotedField )
                 {
-                    case ',': // end of field
-                        fields.push_back("");
-                        i++;
+                    if ( c == ',' )
                         break;
-                    case '"':
+                    else if ( c == '"' )
                         state = kCSVQuotedField;
-                        break;
-                    default:
-                        fields[i].push_back(c);
-                        break;
+                    else
+                        buffer.push_back ( c );
                 }
-                break;
-            case kCSVQuotedField:
-                switch ( c )
+                else if ( state == kCSVQuotedField )
                 {
-                    case '"':
+                    if ( c == '"' )
                         state = kCSVQuotedQuote;
-                        break;
-                    default:
-                        fields[i].push_back(c);
-                        break;
+                    else
+                        buffer.push_back ( c );
                 }
-                break;
-            case kCSVQuotedQuote:
-                switch ( c )
+                else
                 {
-                    case ',': // , after closing quote
-                        fields.push_back(""); i++;
-                        state = kCSVUnquotedField;
+                    if ( c == ',' )         // , after closing quote
                         break;
-                    case '"': // "" -> "
-                        fields[i].push_back('"');
+                    else if ( c == '"' )    // "" -> "
+                    {
+                        buffer.push_back ( '"' );
                         state = kCSVQuotedField;
-                        break;
-                    default:  // end of quote
+                    }
+                    else                    // end of quote
                         state = kCSVUnquotedField;
-                        break;
                 }
-                break;
+            }
+            
+            fields.push_back ( string_view ( buffer.data() + begin, buffer.size() - begin ) );
         }
+        
+        // Skip the comma after the field; stop at the end of the input.
+        
+        if ( i >= n )
+            break;
+        i++;
+    }
+}
+
+// Copies a string_view (str) into a null-terminated character buffer (buf) of the given size,
+// so it can be passed to C library number parsers without allocating a string. Views that
+// don't fit are copied into a temporary string (temp) instead. Returns pointer to the copy.
+
+static const char *numstr ( string_view str, char *buf, size_t size, string &temp )
+{
+    if ( str.size() < size )
+    {
+        memcpy ( buf, str.data(), str.size() );
+        buf[ str.size() ] = '\0';
+        return buf;
     }
     
-    return fields;
+    temp = string ( str );
+    return temp.c_str();
 }
 
 // Converts string to 32-bit signed integer.
 // Avoids throwing exceptions, unlike stoi().
 // Returns zero if string cannot be converted.
 
-int strtoint ( string str )
+int strtoint ( string_view str )
 {
-    return atoi ( str.c_str() );
+    char buf[64];
+    string temp;
+    return atoi ( numstr ( str, buf, sizeof buf, temp ) );
 }
 
 // Converts string to 64-bit signed integer.
 // Avoids throwing exceptions, unlike stoll().
 // Returns zero if string cannot be converted.
 
-int64_t strtoint64 ( string str )
+int64_t strtoint64 ( string_view str )
 {
-    return atoll ( str.c_str() );
+    char buf[64];
+    string temp;
+    return atoll ( numstr ( str, buf, sizeof buf, temp ) );
 }
 
 // Converts string to 32-bit single precision floating point value.
 // Avoids throwing exceptions, unlike stof().
 // Returns zero if string cannot be converted.
 
-float strtofloat ( string str )
+float strtofloat ( string_view str )
 {
-    return strtof ( str.c_str(), nullptr );
+    char buf[64];
+    string temp;
+    return strtof ( numstr ( str, buf, sizeof buf, temp ), nullptr );
 }
 
 // Converts string to 64-bit double precision floating point value.
 // Avoids throwing exceptions, unlike stod().
 // Returns zero if string cannot be converted.
 
-double strtofloat64 ( string str )
+double strtofloat64 ( string_view str )
 {
-    return strtod ( str.c_str(), nullptr );
+    char buf[64];
+    string temp;
+    return strtod ( numstr ( str, buf, sizeof buf, temp ), nullptr );
 }
 
 // Converts hexadecimal string to binary data.
@@ -597,26 +696,49 @@ string hexstring ( const void *data, size_t size )
 // Assumes leading whitespace has been removed from string!
 // Returns INFINITY if string cannot be parsed as an angle.
 
-double strtodeg ( string str )
+double strtodeg ( string_view str )
 {
     bool valid = false;
-    double deg = INFINITY, min = 0.0, sec = 0.0;
-    vector<string> tokens = tokenize ( str, " " );
+    double value[3] = { INFINITY, 0.0, 0.0 };
+    char buf[64];
+    string temp;
+    const char *p = numstr ( str, buf, sizeof buf, temp );
 
-    if ( tokens.size() > 0 )
-        valid = sscanf ( tokens[0].c_str(), "%lf", &deg );
-    
-    if ( tokens.size() > 1 )
-        valid = sscanf ( tokens[1].c_str(), "%lf", &min ) && valid;
+    // Parse up to three space-delimited tokens. Like sscanf(), strtod() reads the number at the start
+    // of each token, and the whole conversion is invalid if any token does not start with a number.
+    // Skip other whitespace ourselves, so strtod() can't skip into the next token; as with sscanf(),
+    // a token which is all whitespace leaves its value unchanged but does not invalidate it.
+
+    for ( int i = 0; i < 3; i++ )
+    {
+        while ( *p == ' ' )
+            p++;
+
+        if ( *p == '\0' )
+            break;
 
-    if ( tokens.size() > 2 )
-        valid = sscanf ( tokens[2].c_str(), "%lf", &sec ) && valid;
+        while ( isspace ( (unsigned char) *p ) && *p != ' ' )
+            p++;
+
+        char *end = (char *) p;
+        if ( *p != ' ' && *p != '\0' )
+        {
+            double v = strtod ( p, &end );
+            if ( end > p )
+                value[i] = v;
+        }
+
+        bool ok = end > p || *p == ' ' || *p == '\0';
+        valid = ok && ( valid || i == 0 );
+        while ( *p != '\0' && *p != ' ' )
+            p++;
+    }
     
     if ( ! valid )
         return INFINITY;
     
-    deg = fabs ( deg ) + min / 60.0 + sec / 3600.0;
-    return str[0] == '-' ? -deg : deg;
+    double deg = fabs ( value[0] ) + value[1] / 60.0 + value[2] / 3600.0;
+    return ! str.empty() && str[0] == '-' ? -deg : deg;
 }
 
 // Converts angle in degrees to radians.
@@ -912,6 +1034,72 @@ time_t filetime ( const string &path )
         return 0;
 }
 
+// Maps an entire file (path) read-only into memory. Returns pointer to the first byte
+// of the mapped file, and file size in bytes (size); or nullptr on failure, including
+// when the file is empty or the platform does not support memory mapping.
+// Pages are loaded on demand by the OS, and may be shared between any number of threads.
+// Release the mapping with unmapfile() when no longer needed.
+
+const void *mapfile ( const string &path, size_t &size )
+{
+    const void *addr = nullptr;
+    size = 0;
+    
+#ifdef _MSC_VER
+    HANDLE hFile = CreateFileA ( path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL );
+    if ( hFile == INVALID_HANDLE_VALUE )
+        return nullptr;
+    
+    LARGE_INTEGER fsize = { 0 };
+    if ( GetFileSizeEx ( hFile, &fsize ) && fsize.QuadPart > 0 )
+    {
+        HANDLE hMap = CreateFileMappingA ( hFile, NULL, PAGE_READONLY, 0, 0, NULL );
+        if ( hMap != NULL )
+        {
+            addr = MapViewOfFile ( hMap, FILE_MAP_READ, 0, 0, 0 );
+            if ( addr != nullptr )
+                size = (size_t) fsize.QuadPart;
+            CloseHandle ( hMap );
+        }
+    }
+    
+    CloseHandle ( hFile );
+#else
+    int fd = ::open ( path.c_str(), O_RDONLY );
+    if ( fd < 0 )
+        return nullptr;
+    
+    struct stat st;
+    if ( fstat ( fd, &st ) == 0 && st.st_size > 0 )
+    {
+        void *p = mmap ( NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0 );
+        if ( p != MAP_FAILED )
+        {
+            addr = p;
+            size = st.st_size;
+        }
+    }
+    
+    ::close ( fd );
+#endif
+    
+    return addr;
+}
+
+// Releases a file mapping (addr) of the given size in bytes, obtained from mapfile().
+
+void unmapfile ( const void *addr, size_t size )
+{
+    if ( addr == nullptr )
+        return;
+    
+#ifdef _MSC_VER
+    UnmapViewOfFile ( addr );
+#else
+    munmap ( (void *) addr, size );
+#endif
+}
+
 // Returns a string which is the URL-encoded form of the source string (src).
 // See https://stackoverflow.com/questions/154536/encode-decode-urls-in-c
 
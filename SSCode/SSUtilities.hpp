@@ -16,6 +16,7 @@
 #include <cstdint>
 #include <cstring>
 #include <string>
+#include <string_view>
 #include <vector>
 #if !defined(_MSC_VER)
 #include <sys/stat.h>
@@ -59,10 +60,13 @@ bool islink ( const string &file );
 bool fgetline ( FILE *infile, string &line );
 
 string trim ( string str );
+string_view trim_view ( string_view str );
 string formstr ( const char *fmt, ... );
 vector<string> split ( string str, string delim );
+void split ( string_view str, string_view delim, vector<string_view> &tokens );
 vector<string> tokenize ( string str, string delim );
 vector<string> split_csv ( const string &csv );
+void split_csv ( string_view csv, vector<string_view> &fields, string &buffer );
 
 int compare ( const string &str1, const string &str2, size_t n, bool casesens = true );
 
@@ -84,16 +88,16 @@ int listDirectory ( const string &path, vector<string> &contents, bool prefixPat
 int listWildcardFiles ( const string &pattern, vector<string> &paths );
 string sanitizeFilename ( const string &filename );
 
-int strtoint ( string str );
-int64_t strtoint64 ( string str );
-float strtofloat ( string str );
-double strtofloat64 ( string str );
+int strtoint ( string_view str );
+int64_t strtoint64 ( string_view str );
+float strtofloat ( string_view str );
+double strtofloat64 ( string_view str );
 
 void hexstring_to_binary ( const std::string &source, uint8_t *destination, size_t length );
 void binary_to_hexstring ( const uint8_t *source, size_t length, std::string& destination );
 string hexstring ( const void *source, size_t length );
 
-double strtodeg ( string str );
+double strtodeg ( string_view str );
 double degtorad ( double deg );
 double radtodeg ( double rad );
 double sindeg ( double deg );
@@ -135,6 +139,9 @@ void set_timezonename ( string zonename );
 size_t filesize ( const string &path );
 time_t filetime ( const string &path );
 
+const void *mapfile ( const string &path, size_t &size );
+void unmapfile ( const void *addr, size_t size );
+
 string urlEncode ( const string &src );
 string urlDecode ( const string &src );
 
@@ -10,6 +10,7 @@
 #include <iostream>
 #include <fstream>
 #include <string>
+#include <mutex>
 
 #include "SSCoordinates.hpp"
 #include "ELPMPP02.hpp"
@@ -4370,13 +4371,17 @@ bool setup_Elp_series ()
 }
 
 // Copies data from ELPMPP02 series embedded in this C++ source code
-// into Kam's main and perturbation series arrays. Only do this once!
+// into Kam's main and perturbation series arrays. Only do this once,
+// even if the first computations are requested from several threads at once!
 
 bool ELPMPP02::initSeries ( void )
 {
-    if ( ! _init )
+    static once_flag once;
+    call_once ( once, [] ( void )
+    {
         if ( setup_Elp_series() )
             _init = true;
+    } );
 
     return _init;
 }
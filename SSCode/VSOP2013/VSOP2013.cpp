@@ -86,6 +86,8 @@ int VSOP2013::readFile ( const string &filename, int iplanet )
         planets[iplanet-1].push_back ( ser );
     }
 
+    plans[iplanet-1].build ( { &planets[iplanet-1] } );
+
 #if PRINT_SERIES
     ofstream outfile ( filename + ".cpp" );
     if ( outfile )
@@ -203,7 +205,7 @@ double VSOP2013::evalSeries ( double t, const VSOP2013Series &ser, double ll[17]
     double ta = pow ( t, ser.it );
     double sum = 0.0;
     
-    for ( VSOP2013Term term : ser.terms )
+    for ( const VSOP2013Term &term : ser.terms )
     {
         double phi = 0.0;
         for ( int i = 0; i < 17; i++ )
@@ -222,29 +224,26 @@ double VSOP2013::evalSeries ( double t, const VSOP2013Series &ser, double ll[17]
 
 SSOrbit VSOP2013::getOrbit ( int iplanet, double jed )
 {
-    double a = 0.0, l = 0.0, k = 0.0, h = 0.0, q = 0.0, p = 0.0;
+    if ( iplanet < 1 || iplanet > 9 )
+        return SSOrbit();
+    
+    return evalPlan ( iplanet, jed, plans[iplanet - 1] );
+}
+
+// Returns J2000 ecliptic orbital elements for a planet (iplanet)
+// 1 = Mercury .... 9 = Pluto at a specific Julian Ephemeris Date (jed),
+// computed from a compiled evaluation plan of that planet's series.
+
+SSOrbit VSOP2013::evalPlan ( int iplanet, double jed, const VSOP2013Plan &plan )
+{
     double t = ( jed - 2451545.0 ) / 365250.0;
     double ll[17] = { 0 };
+    double alkhqp[6] = { 0 };
     
     evalLongitudes ( t, ll );
-    vector<VSOP2013Series> &series = planets[iplanet - 1];
-    for ( VSOP2013Series ser : series )
-    {
-        double sum = evalSeries ( t, ser, ll );
-        if ( ser.iv == 1 )
-            a += sum;
-        else if ( ser.iv == 2 )
-            l += sum;
-        else if ( ser.iv == 3 )
-            k += sum;
-        else if ( ser.iv == 4 )
-            h += sum;
-        else if ( ser.iv == 5 )
-            q += sum;
-        else if ( ser.iv == 6 )
-            p += sum;
-    }
+    plan.evaluate ( t, ll, alkhqp );
     
+    double a = alkhqp[0], l = alkhqp[1], k = alkhqp[2], h = alkhqp[3], q = alkhqp[4], p = alkhqp[5];
     double e = sqrt ( k * k + h * h );  // eccentricity
     double w = atan2 ( h, k );          // longitude of perihelion
     double n = atan2 ( p, q );          // longitude of ascending node
@@ -253,6 +252,146 @@ SSOrbit VSOP2013::getOrbit ( int iplanet, double jed )
     return SSOrbit ( jed, a * ( 1.0 - e ), e, i, mod2pi ( w - n ), mod2pi ( n ), mod2pi ( l - w ), mm );
 }
 
+// Constructs an empty evaluation plan, which evaluates to zero.
+
+VSOP2013Plan::VSOP2013Plan ( void )
+{
+    build ( { } );
+}
+
+// Constructs an evaluation plan from all series in a set of vectors
+// of VSOP2013 series (planet) which all belong to the same planet.
+
+VSOP2013Plan::VSOP2013Plan ( const vector<const vector<VSOP2013Series> *> &planet )
+{
+    build ( planet );
+}
+
+// Builds this evaluation plan from all series in a set of vectors of
+// VSOP2013 series (planet), replacing any previous contents of the plan.
+
+void VSOP2013Plan::build ( const vector<const vector<VSOP2013Series> *> &planet )
+{
+    int maxMult[17] = { 0 };
+    
+    seriesVar.clear();
+    seriesPower.clear();
+    seriesEnd.clear();
+    termEnd.clear();
+    termSin.clear();
+    termCos.clear();
+    argIndex.clear();
+    argMult.clear();
+    
+    for ( const vector<VSOP2013Series> *pSeries : planet )
+    {
+        for ( const VSOP2013Series &ser : *pSeries )
+        {
+            if ( ser.iv < 1 || ser.iv > 6 )
+                continue;
+            
+            for ( const VSOP2013Term &term : ser.terms )
+            {
+                for ( int i = 0; i < 17; i++ )
+                {
+                    if ( term.iphi[i] == 0 )
+                        continue;
+                    
+                    argIndex.push_back ( i );
+                    argMult.push_back ( term.iphi[i] );
+                    maxMult[i] = max ( maxMult[i], abs ( term.iphi[i] ) );
+                }
+                
+                termEnd.push_back ( (int) argIndex.size() );
+                termSin.push_back ( term.s );
+                termCos.push_back ( term.c );
+            }
+            
+            seriesVar.push_back ( ser.iv );
+            seriesPower.push_back ( ser.it );
+            seriesEnd.push_back ( (int) termSin.size() );
+        }
+    }
+    
+    // Each argument's table holds cosine and sine of multiples 0 ... maxMult.
+    
+    tableSize = 0;
+    for ( int i = 0; i < 17; i++ )
+    {
+        argOffset[i] = tableSize;
+        tableSize += maxMult[i] + 1;
+    }
+}
+
+// Evaluates this plan at time (t) in Julian millenia of 365250 days from J2000 (JD 2451545.0).
+// Seventeen fundamental longitude arguments in radians (ll) must have been previously computed
+// for time t using VSOP2013::evalLongitudes(). The six VSOP2013 elements a, l, k, h, q, p are
+// returned in the alkhqp array. Thread-safe.
+
+void VSOP2013Plan::evaluate ( double t, const double ll[17], double alkhqp[6] ) const
+{
+    static thread_local vector<double> cosk, sink;
+    if ( cosk.size() < (size_t) tableSize )
+    {
+        cosk.resize ( tableSize );
+        sink.resize ( tableSize );
+    }
+    
+    // Build tables of cos(k*ll) and sin(k*ll) for each argument by repeated rotation,
+    // re-seeding from the exact values every 64 multiples to keep rounding error bounded.
+    
+    for ( int i = 0; i < 17; i++ )
+    {
+        int first = argOffset[i], size = ( i < 16 ? argOffset[i + 1] : tableSize ) - first;
+        double *pCos = &cosk[first], *pSin = &sink[first];
+        double c1 = cos ( ll[i] ), s1 = sin ( ll[i] );
+        
+        for ( int k = 0; k < size; k++ )
+        {
+            if ( k % 64 == 0 )
+            {
+                pCos[k] = cos ( k * ll[i] );
+                pSin[k] = sin ( k * ll[i] );
+            }
+            else
+            {
+                pCos[k] = pCos[k - 1] * c1 - pSin[k - 1] * s1;
+                pSin[k] = pSin[k - 1] * c1 + pCos[k - 1] * s1;
+            }
+        }
+    }
+    
+    // Sum each series. Each term's argument is a sum of integer multiples of fundamental
+    // arguments, so its cosine and sine come from complex products of table entries.
+    
+    for ( int v = 0; v < 6; v++ )
+        alkhqp[v] = 0.0;
+    
+    int term = 0, arg = 0;
+    for ( size_t s = 0; s < seriesEnd.size(); s++ )
+    {
+        double sum = 0.0;
+        
+        for ( ; term < seriesEnd[s]; term++ )
+        {
+            double c = 1.0, sn = 0.0;
+            
+            for ( ; arg < termEnd[term]; arg++ )
+            {
+                int k = argMult[arg], j = argOffset[ argIndex[arg] ] + abs ( k );
+                double ck = cosk[j], sk = k < 0 ? -sink[j] : sink[j];
+                double cc = c * ck - sn * sk;
+                sn = sn * ck + c * sk;
+                c = cc;
+            }
+            
+            sum += termSin[term] * sn + termCos[term] * c;
+        }
+        
+        alkhqp[ seriesVar[s] - 1 ] += pow ( t, seriesPower[s] ) * sum;
+    }
+}
+
 // Returns mean motion in radians per day for a planet (iplanet)
 // 1 = Mercury .... 9 = Pluto with orbital semimajor axis (a) in AU.
 
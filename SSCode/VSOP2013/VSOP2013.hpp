@@ -43,6 +43,33 @@ struct VSOP2013Series
     vector<VSOP2013Term> terms;
 };
 
+// Stores a planet's VSOP2013 series in a compact structure-of-arrays form
+// which is built once, then evaluated much faster than the original series.
+// Only the non-zero argument multipliers of each term are kept; sines and cosines
+// of integer multiples of the arguments come from a table built by recurrence,
+// so no trig functions are called per term. Immutable once built, so one plan
+// may be evaluated from any number of threads at once.
+
+struct VSOP2013Plan
+{
+    vector<int> seriesVar;          // variable index of each series: 1 = a, 2 = l, 3 = k, 4 = h, 5 = q, 6 = p
+    vector<int> seriesPower;        // time power (alpha) of each series
+    vector<int> seriesEnd;          // index of first term after end of each series
+    vector<int> termEnd;            // index of first argument after end of each term
+    vector<double> termSin;         // coefficients of sine of each term's argument
+    vector<double> termCos;         // coefficients of cosine of each term's argument
+    vector<uint8_t> argIndex;       // index (0-16) of each non-zero fundamental longitude argument
+    vector<int> argMult;            // integer multiplier of each non-zero argument
+    int argOffset[17];              // offset of each fundamental argument's multiple table
+    int tableSize;                  // total size of all multiple tables
+    
+    VSOP2013Plan ( void );
+    VSOP2013Plan ( const vector<const vector<VSOP2013Series> *> &planet );
+
+    void build ( const vector<const vector<VSOP2013Series> *> &planet );
+    void evaluate ( double t, const double ll[17], double alkhqp[6] ) const;
+};
+
 #ifndef VSOP2013_EMBED_SERIES
 #define VSOP2013_EMBED_SERIES 1   // 1 to include embedded series; 0 to use external data files only
 #endif
@@ -54,10 +81,12 @@ class VSOP2013
 {
 protected:
     vector<VSOP2013Series> planets[9];      // series for each planet 0 = Mercury ... 8 = Pluto
+    VSOP2013Plan plans[9];                  // compiled evaluation plans for each planet's series
     
 public:
     void evalLongitudes ( double t, double ll[17] );
     double evalSeries ( double t, const VSOP2013Series &ser, double ll[17] );
+    SSOrbit evalPlan ( int iplanet, double jed, const VSOP2013Plan &plan );
     void printSeries ( ostream &out, const vector<VSOP2013Series> &planet );
     int readFile ( const string &filename, int iplanet );
     SSOrbit getOrbit ( int iplanet, double jed );
@@ -3020,37 +3020,8 @@ static vector<VSOP2013Series> _p = {
 
 SSOrbit VSOP2013::earthOrbit ( double jed )
 {
-    double a = 0.0, l = 0.0, k = 0.0, h = 0.0, q = 0.0, p = 0.0;
-    double t = ( jed - 2451545.0 ) / 365250.0;
-    double ll[17] = { 0 };
-    
-    evalLongitudes ( t, ll );
-
-    for ( VSOP2013Series &series : _a )
-        a += evalSeries ( t, series, ll );
-    
-    for ( VSOP2013Series &series : _l )
-        l += evalSeries ( t, series, ll );
-    
-    for ( VSOP2013Series &series : _k )
-        k += evalSeries ( t, series, ll );
-    
-    for ( VSOP2013Series &series : _h )
-        h += evalSeries ( t, series, ll );
-    
-    for ( VSOP2013Series &series : _q )
-        q += evalSeries ( t, series, ll );
-    
-    for ( VSOP2013Series &series : _p )
-        p += evalSeries ( t, series, ll );
-
-    double e = sqrt ( k * k + h * h );  // eccentricity
-    double w = atan2 ( h, k );          // longitude of perihelion
-    double n = atan2 ( p, q );          // longitude of ascending node
-    double i = 2.0 * asin ( sqrt ( q * q + p * p ) ); // inclination
-    double mm = getMeanMotion ( 3, a );
-    
-    return SSOrbit ( jed, a * ( 1.0 - e ), e, i, mod2pi ( w - n ), mod2pi ( n ), mod2pi ( l - w ), mm );
+    static VSOP2013Plan plan ( { &_a, &_l, &_k, &_h, &_q, &_p } );
+    return evalPlan ( 3, jed, plan );
 }
 
 #endif // VSOP2013_EMBED_SERIES
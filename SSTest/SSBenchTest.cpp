@@ -0,0 +1,2129 @@
+//  SSBenchTest.cpp
+//
+//  Created by Tim DeBenedictis on 10/16/26.
+//  Copyright © 2026 Southern Stars. All rights reserved.
+//
+//  Performance benchmarks for SSCore. Each benchmark prints its timings
+//  to standard output; none of them modify any input files.
+
+#include <iostream>
+#include <climits>
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <algorithm>
+#include <random>
+
+#include "SSUtilities.hpp"
+#include "SSLineReader.hpp"
+#include "SSJPLDEphemeris.hpp"
+#include "SSPlanet.hpp"
+#include "SSChebyshevEphemeris.hpp"
+#include "SSEvent.hpp"
+#include "SSPassPredictor.hpp"
+#include "SSEphemerisEngine.hpp"
+#include "SSImportMPC.hpp"
+#include "SSImportTLE.hpp"
+#include "SSImportTYC.hpp"
+#include "SSImportGAIADR3.hpp"
+#include "SSStarArray.hpp"
+#include "SSHTMRegionFile.hpp"
+#include "SSObjectBinary.hpp"
+#include "SSConstellation.hpp"
+#include "SSMountSimulator.hpp"
+
+// Runs a function (func) on the given number of threads (nthreads) simultaneously.
+// Each thread receives its index (0 to nthreads - 1). Returns elapsed wall-clock seconds.
+
+template <typename Func> double RunThreads ( int nthreads, Func func )
+{
+    vector<thread> threads;
+    double start = clocksec();
+
+    for ( int i = 0; i < nthreads; i++ )
+        threads.push_back ( thread ( func, i ) );
+
+    for ( thread &t : threads )
+        t.join();
+
+    return clocksec_since ( start );
+}
+
+// Measures JPL DE ephemeris throughput from 1, 4, and 16 threads, first with the
+// original serialized C code path, then with the memory-mapped lock-free path.
+// Each thread computes all 11 bodies at widely-spaced epochs, so that successive
+// calls from different threads need different ephemeris records.
+
+void BenchJPLDEphemeris ( const string &ephemFile )
+{
+    cout << "Benchmarking JPL DE ephemeris...\n";
+
+    const int kCallsPerThread = 200000;
+
+    for ( bool map : { false, true } )
+    {
+        if ( ! SSJPLDEphemeris::open ( ephemFile, map ) )
+        {
+            cout << "Failed to open " << ephemFile << endl << endl;
+            return;
+        }
+
+        double jed0 = SSJPLDEphemeris::getStartJED();
+        double span = SSJPLDEphemeris::getStopJED() - jed0;
+
+        for ( int nthreads : { 1, 4, 16 } )
+        {
+            double secs = RunThreads ( nthreads, [=] ( int ithread )
+            {
+                SSVector pos, vel;
+                for ( int i = 0; i < kCallsPerThread; i++ )
+                {
+                    double jed = jed0 + fmod ( ( i / 11 ) * 37.3 + ithread * span / nthreads, span );
+                    SSJPLDEphemeris::compute ( i % 11, jed, false, pos, vel );
+                }
+            } );
+
+            double rate = nthreads * kCallsPerThread / secs;
+            cout << formstr ( "%s path, %2d threads: %.3f sec, %.0f computations/sec", SSJPLDEphemeris::isMapped() ? "mapped" : "locked", nthreads, secs, rate ) << endl;
+        }
+
+        SSJPLDEphemeris::close();
+    }
+
+    cout << endl;
+}
+
+// Compares computing all 11 bodies at a million epochs one call at a time,
+// versus the batch compute() method which shares Chebyshev polynomials across bodies.
+
+void BenchJPLDEphemerisBatch ( const string &ephemFile )
+{
+    cout << "Benchmarking JPL DE ephemeris batch computation...\n";
+
+    if ( ! SSJPLDEphemeris::open ( ephemFile ) )
+    {
+        cout << "Failed to open " << ephemFile << endl << endl;
+        return;
+    }
+
+    const int kNumJEDs = 1000000;
+    double jed0 = SSJPLDEphemeris::getStartJED();
+    double step = ( SSJPLDEphemeris::getStopJED() - jed0 ) / kNumJEDs;
+
+    vector<int> ids = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 };
+    vector<double> jeds ( kNumJEDs );
+    for ( int i = 0; i < kNumJEDs; i++ )
+        jeds[i] = jed0 + i * step;
+
+    SSVector pos, vel;
+    double start = clocksec();
+    for ( double jed : jeds )
+        for ( int id : ids )
+            SSJPLDEphemeris::compute ( id, jed, false, pos, vel );
+    double secs = clocksec_since ( start );
+    cout << formstr ( "single calls: %.3f sec", secs ) << endl;
+
+    vector<SSVector> positions, velocities;
+    start = clocksec();
+    SSJPLDEphemeris::compute ( ids, jeds, false, positions, velocities );
+    secs = clocksec_since ( start );
+    cout << formstr ( "batch call:   %.3f sec", secs ) << endl;
+
+    SSJPLDEphemeris::close();
+    cout << endl;
+}
+
+// Searches for a century of Jupiter-Saturn conjunctions, new moons, and full moons
+// using VSOP/ELP ephemeris (not JPL DE), first without and then with the Chebyshev
+// ephemeris cache. Events found both ways are matched by time. Near a minimum or maximum
+// the separation is so flat that the cache's tiny errors can move the event by a few
+// seconds, so matching events must instead agree in separation, to within the cache
+// tolerance. The Jupiter-Saturn separation also has several shallow minima a day apart,
+// and either search may find one the other steps over; each event found only with the
+// cache must be a true minimum or maximum of the uncached separation.
+
+void BenchEventCache ( const string &inpath )
+{
+    cout << "Benchmarking century event searches with VSOP/ELP ephemeris cache...\n";
+
+    SSObjectVec planets;
+    if ( SSImportObjectsFromCSV ( inpath + "/SolarSystem/Planets.csv", planets ) < 11 )
+    {
+        cout << "Failed to import planets from " << inpath << endl << endl;
+        return;
+    }
+
+    SSObjectPtr pSun = planets[0], pJup = planets[5], pSat = planets[6], pMoon = planets[10];
+    SSTime start ( SSTime::kJ2000 ), stop ( SSTime::kJ2000 + 36525.0 );
+    SSCoordinates coords ( start, SSSpherical ( 0.0, 0.0, 0.0 ) );
+
+    struct Search { SSObjectPtr pObj1, pObj2; bool min; vector<SSEventTime> events[2]; };
+    Search searches[3] = { { pJup, pSat, true }, { pSun, pMoon, true }, { pSun, pMoon, false } };
+
+    SSJPLDEphemeris::close();
+    for ( bool cache : { false, true } )
+    {
+        SSPlanet::useEphemerisCache ( cache );
+        int n = 0;
+        double secs = clocksec();
+        for ( Search &search : searches )
+        {
+            if ( search.min )
+                SSEvent::findConjunctions ( coords, search.pObj1, search.pObj2, start, stop, search.events[cache], INT_MAX );
+            else
+                SSEvent::findOppositions ( coords, search.pObj1, search.pObj2, start, stop, search.events[cache], INT_MAX );
+            n += (int) search.events[cache].size();
+        }
+        secs = clocksec_since ( secs );
+        cout << formstr ( "cache %-3s: %.3f sec, %d events", cache ? "on" : "off", secs, n ) << endl;
+    }
+
+    // Returns the uncached separation between a search's objects at a Julian Date (jd).
+
+    SSPlanet::useEphemerisCache ( false );
+    auto separation = [&coords] ( Search &search, double jd )
+    {
+        coords.setTime ( SSTime ( jd ) );
+        search.pObj1->computeEphemeris ( coords );
+        search.pObj2->computeEphemeris ( coords );
+        return search.pObj1->getDirection().angularSeparation ( search.pObj2->getDirection() );
+    };
+
+    double maxdiff = 0.0, maxsep = 0.0, maxerr = SSChebyshevEphemeris::kDefaultTolerance;
+    int unmatched = 0, failed = 0;
+    for ( Search &search : searches )
+    {
+        for ( SSEventTime &event : search.events[1] )
+        {
+            SSEventTime *pMatch = nullptr;
+            for ( SSEventTime &other : search.events[0] )
+                if ( pMatch == nullptr || fabs ( event.time - other.time ) < fabs ( event.time - pMatch->time ) )
+                    pMatch = &other;
+
+            if ( pMatch != nullptr && fabs ( event.time - pMatch->time ) * SSTime::kSecondsPerDay < 60.0 )
+            {
+                maxdiff = max ( maxdiff, fabs ( event.time - pMatch->time ) );
+                maxsep = max ( maxsep, fabs ( event.value - pMatch->value ) );
+                failed += fabs ( event.value - pMatch->value ) > maxerr;
+                continue;
+            }
+
+            double sep = separation ( search, event.time ), dt = 0.01;
+            double before = separation ( search, event.time - dt ), after = separation ( search, event.time + dt );
+            unmatched++;
+            failed += search.min ? before <= sep || after <= sep : before >= sep || after >= sep;
+        }
+    }
+
+    cout << formstr ( "max event time difference: %.3f sec, max separation difference %.1e rad, %d unmatched events: %s",
+                      maxdiff * SSTime::kSecondsPerDay, maxsep, unmatched, failed ? "FAILED" : "OK" ) << endl;
+    cout << endl;
+}
+
+// Computes ephemerides of the planets and their moons for many observer times, from 1, 4, and 16
+// threads. Each thread has its own copies of the objects, coordinates, and ephemeris context,
+// so no thread waits on another. Uses VSOP/ELP and moon theories, not JPL DE.
+
+void BenchPlanetThreads ( const string &inpath )
+{
+    cout << "Benchmarking parallel planet and moon ephemeris computation...\n";
+
+    const int kTimesPerThread = 200;
+    SSJPLDEphemeris::close();
+
+    for ( int nthreads : { 1, 4, 16 } )
+    {
+        vector<SSObjectVec> objects ( nthreads );
+        for ( int i = 0; i < nthreads; i++ )
+        {
+            SSImportObjectsFromCSV ( inpath + "/SolarSystem/Planets.csv", objects[i] );
+            SSImportObjectsFromCSV ( inpath + "/SolarSystem/Moons.csv", objects[i] );
+        }
+
+        if ( objects[0].size() == 0 )
+        {
+            cout << "Failed to import planets and moons from " << inpath << endl << endl;
+            return;
+        }
+
+        double secs = RunThreads ( nthreads, [&] ( int ithread )
+        {
+            SSEphemerisContext context;
+            SSCoordinates coords ( SSTime ( SSTime::kJ2000 ), SSSpherical ( 0.0, 0.0, 0.0 ) );
+            for ( int i = 0; i < kTimesPerThread; i++ )
+            {
+                coords.setTime ( SSTime ( SSTime::kJ2000 + ithread * 1000.0 + i * 0.37 ) );
+                for ( int j = 0; j < objects[ithread].size(); j++ )
+                    SSGetPlanetPtr ( objects[ithread][j] )->computeEphemeris ( coords, context );
+            }
+        } );
+
+        double rate = nthreads * kTimesPerThread * objects[0].size() / secs;
+        cout << formstr ( "%2d threads: %.3f sec, %.0f ephemerides/sec", nthreads, secs, rate ) << endl;
+    }
+
+    cout << endl;
+}
+
+// Computes ephemerides of a mixed array of asteroids, satellites, and stars, repeated several times
+// over, first one object at a time on this thread, then with the parallel ephemeris engine using
+// 1, 2, 4, 8, and 16 threads. Checks that every thread count gives exactly the same results as
+// the serial loop, and reports how many chunks were stolen between threads.
+
+void BenchEphemerisEngine ( const string &inpath )
+{
+    cout << "Benchmarking parallel ephemeris engine...\n";
+
+    const int kCopies = 4, kPasses = 5;
+    SSObjectArray source, objects;
+
+    SSImportMPCAsteroids ( inpath + "/SolarSystem/Asteroids.txt", source );
+    SSImportSatellitesFromTLE ( inpath + "/SolarSystem/Satellites/visual.txt", source );
+    SSImportSatellitesFromTLE ( inpath + "/SolarSystem/Satellites/brightest.txt", source );
+    SSImportObjectsFromCSV ( inpath + "/Stars/Brightest.csv", source );
+    if ( source.size() == 0 )
+    {
+        cout << "Failed to import asteroids, satellites, and stars from " << inpath << endl << endl;
+        return;
+    }
+
+    for ( int i = 0; i < kCopies; i++ )
+        for ( int j = 0; j < source.size(); j++ )
+            objects.append ( SSCloneObject ( source[j] ) );
+
+    SSJPLDEphemeris::close();
+    SSCoordinates coords ( SSTime ( SSTime::kJ2000 + 8766.0 ), SSSpherical ( SSAngle::fromDegrees ( -122.0 ), SSAngle::fromDegrees ( 37.0 ), 0.0 ) );
+
+    double secs = clocksec();
+    for ( int pass = 0; pass < kPasses; pass++ )
+        for ( int i = 0; i < objects.size(); i++ )
+            objects[i]->computeEphemeris ( coords );
+    secs = clocksec_since ( secs ) / kPasses;
+    cout << formstr ( "serial loop: %.3f sec, %.0f ephemerides/sec (%d objects)", secs, objects.size() / secs, (int) objects.size() ) << endl;
+
+    vector<SSVector> directions ( objects.size() );
+    for ( int i = 0; i < objects.size(); i++ )
+        directions[i] = objects[i]->getDirection();
+
+    for ( int nthreads : { 1, 2, 4, 8, 16 } )
+    {
+        SSEphemerisEngine engine ( nthreads );
+        for ( int i = 0; i < objects.size(); i++ )
+            objects[i]->setDirection ( SSVector() );
+
+        secs = clocksec();
+        for ( int pass = 0; pass < kPasses; pass++ )
+            engine.computeEphemeris ( objects, coords );
+        secs = clocksec_since ( secs ) / kPasses;
+
+        int mismatches = 0;
+        for ( int i = 0; i < objects.size(); i++ )
+            if ( ! ( objects[i]->getDirection() == directions[i] ) )
+                mismatches++;
+
+        vector<size_t> counts;
+        size_t steals = 0;
+        engine.getStatistics ( counts, steals );
+        cout << formstr ( "%2d threads: %.3f sec, %.0f ephemerides/sec, %d chunks stolen, %d mismatches", nthreads, secs, objects.size() / secs, (int) steals, mismatches ) << endl;
+    }
+
+    objects.erase();
+    source.erase();
+    cout << endl;
+}
+
+// Predicts a week of passes of the visual satellites over one site, first with the generic
+// one-minute event search, then with SSPassPredictor. Checks both against risings found by
+// scanning each satellite's altitude every thirty seconds, then times SSPassPredictor alone on
+// all of the satellites. Passes only if SSPassPredictor finds every scanned rising.
+
+void BenchSatellitePasses ( const string &inpath )
+{
+    cout << "Benchmarking satellite pass prediction...\n";
+
+    const int kCompare = 5;
+    const double kScanStep = 30.0 / SSTime::kSecondsPerDay;
+    SSObjectArray satellites;
+    
+    SSImportSatellitesFromTLE ( inpath + "/SolarSystem/Satellites/visual.txt", satellites );
+    if ( satellites.size() == 0 )
+    {
+        cout << "Failed to import satellites from " << inpath << endl << endl;
+        return;
+    }
+
+    SSTime start ( SSGetSatellitePtr ( satellites[0] )->getTLE().jdepoch ), stop = start + 7.0;
+    SSSpherical site ( SSAngle::fromDegrees ( -122.0 ), SSAngle::fromDegrees ( 37.0 ), 0.0 );
+    SSCoordinates coords ( start, site );
+    double minAlt = SSAngle::fromDegrees ( 10.0 );
+    int ncompare = min ( kCompare, (int) satellites.size() );
+
+    // Reference rising times from brute-force altitude scan
+
+    vector<vector<double>> risings ( ncompare );
+    int nrisings = 0;
+    for ( int i = 0; i < ncompare; i++ )
+    {
+        bool up = true;
+        for ( double jd = start.jd; jd < stop.jd; jd += kScanStep )
+        {
+            coords.setTime ( SSTime ( jd ) );
+            satellites[i]->computeEphemeris ( coords );
+            SSSpherical hor = coords.transform ( kFundamental, kHorizon, satellites[i]->getDirection() );
+            if ( hor.lat >= minAlt && ! up )
+                risings[i].push_back ( jd );
+            up = hor.lat >= minAlt;
+        }
+        nrisings += risings[i].size();
+    }
+
+    for ( int fast = 0; fast < 2; fast++ )
+    {
+        int npasses = 0, nmissed = 0;
+        double secs = 0.0;
+
+        for ( int i = 0; i < ncompare; i++ )
+        {
+            vector<SSPass> passes;
+            double start_secs = clocksec();
+            if ( fast )
+                SSEvent::findSatellitePasses ( coords, satellites[i], start, stop, minAlt, passes, INT_MAX );
+            else
+                SSEvent::findObjectPasses ( coords, satellites[i], start, stop, minAlt, passes, INT_MAX );
+            secs += clocksec_since ( start_secs );
+            npasses += passes.size();
+
+            for ( double jd : risings[i] )
+            {
+                double diff = INFINITY;
+                for ( SSPass &pass : passes )
+                    diff = min ( diff, fabs ( pass.rising.time - jd ) );
+                if ( diff > kScanStep )
+                    nmissed++;
+            }
+        }
+
+        const char *verdict = fast ? ( nmissed == 0 ? ": OK" : ": FAILED" ) : "";
+        cout << formstr ( "%-14s: %.3f sec, %d passes of %d satellites, %d of %d scanned risings missed%s",
+                          fast ? "pass predictor" : "event search", secs, npasses, ncompare, nmissed, nrisings, verdict ) << endl;
+    }
+
+    SSPassPredictor predictor ( site, minAlt );
+    vector<vector<SSPass>> satPasses ( satellites.size() );
+    int npasses = 0, nmissed = 0;
+    double secs = clocksec();
+    for ( int i = 0; i < satellites.size(); i++ )
+        npasses += predictor.findPasses ( SSGetSatellitePtr ( satellites[i] ), start, stop, satPasses[i], INT_MAX );
+    secs = clocksec_since ( secs );
+
+    for ( int i = 0; i < ncompare; i++ )
+    {
+        for ( double jd : risings[i] )
+        {
+            double diff = INFINITY;
+            for ( SSPass &pass : satPasses[i] )
+                diff = min ( diff, fabs ( pass.rising.time - jd ) );
+            if ( diff > kScanStep )
+                nmissed++;
+        }
+    }
+
+    cout << formstr ( "all %d satellites: %.3f sec, %d passes, %.0f positions per satellite-day, %d of %d scanned risings missed: %s",
+                      (int) satellites.size(), secs, npasses, predictor.getEvaluations() / ( satellites.size() * 7.0 ),
+                      nmissed, nrisings, nmissed == 0 ? "OK" : "FAILED" ) << endl;
+
+    satellites.erase();
+    cout << endl;
+}
+
+// Predicts one day of passes of the visual and brightest satellites over 40 sites spread
+// around the world, first with a separate single-site search for every satellite and site,
+// then with one multi-site search per satellite on 1 and 4 threads. Checks that every method
+// finds the same passes, and reports how many satellite positions each one computed.
+
+void BenchMultiSitePasses ( const string &inpath )
+{
+    cout << "Benchmarking multi-satellite, multi-site pass prediction...\n";
+
+    SSObjectArray satellites;
+    SSImportSatellitesFromTLE ( inpath + "/SolarSystem/Satellites/visual.txt", satellites );
+    SSImportSatellitesFromTLE ( inpath + "/SolarSystem/Satellites/brightest.txt", satellites );
+    if ( satellites.size() == 0 )
+    {
+        cout << "Failed to import satellites from " << inpath << endl << endl;
+        return;
+    }
+
+    vector<SSSpherical> sites;
+    for ( int i = 0; i < 40; i++ )
+        sites.push_back ( SSSpherical ( SSAngle::fromDegrees ( i * 47.0 - 180.0 ), SSAngle::fromDegrees ( ( i % 9 ) * 15.0 - 60.0 ), 0.0 ) );
+
+    SSTime start ( SSGetSatellitePtr ( satellites[0] )->getTLE().jdepoch ), stop = start + 1.0;
+    double minAlt = SSAngle::fromDegrees ( 10.0 );
+
+    vector<SSSatellitePass> reference;
+    size_t evaluations = 0;
+    double secs = clocksec();
+    for ( int i = 0; i < satellites.size(); i++ )
+    {
+        for ( int j = 0; j < sites.size(); j++ )
+        {
+            SSPassPredictor predictor ( sites[j], minAlt );
+            vector<SSPass> passes;
+            predictor.findPasses ( SSGetSatellitePtr ( satellites[i] ), start, stop, passes, INT_MAX );
+            for ( SSPass &pass : passes )
+                reference.push_back ( { i, j, pass } );
+            evaluations += predictor.getEvaluations();
+        }
+    }
+    secs = clocksec_since ( secs );
+    cout << formstr ( "single-site searches: %.3f sec, %d passes, %.1fM positions", secs, (int) reference.size(), evaluations / 1.0e6 ) << endl;
+
+    for ( int nthreads : { 1, 4 } )
+    {
+        SSPassPredictor predictor ( sites, minAlt );
+        vector<SSSatellitePass> passes;
+
+        secs = clocksec();
+        predictor.findPasses ( satellites, start, stop, passes, nthreads );
+        secs = clocksec_since ( secs );
+
+        double maxdiff = 0.0;
+        int mismatches = passes.size() == reference.size() ? 0 : (int) max ( passes.size(), reference.size() );
+        for ( int i = 0; i < passes.size() && mismatches == 0; i++ )
+        {
+            if ( passes[i].satellite != reference[i].satellite || passes[i].site != reference[i].site )
+                mismatches++;
+            maxdiff = max ( maxdiff, fabs ( passes[i].pass.rising.time - reference[i].pass.rising.time ) );
+            maxdiff = max ( maxdiff, fabs ( passes[i].pass.setting.time - reference[i].pass.setting.time ) );
+        }
+
+        cout << formstr ( "multi-site, %d threads: %.3f sec, %d passes, %.1fM positions, %d mismatches, max time difference %.3f sec: %s",
+                          nthreads, secs, (int) passes.size(), predictor.getEvaluations() / 1.0e6, mismatches, maxdiff * SSTime::kSecondsPerDay,
+                          mismatches == 0 ? "OK" : "FAILED" ) << endl;
+    }
+
+    satellites.erase();
+    cout << endl;
+}
+
+// Computes apparent directions, distances, and magnitudes of the brightest and nearest stars,
+// cloned to a million stars, one star at a time with SSStar::computeEphemeris(), then all at once
+// with the columnar SSStarArray kernel. Uses an epoch two centuries from J2000 so that
+// nearby stars move appreciably. Reports the largest differences between the two.
+
+void BenchStarArray ( const string &inpath )
+{
+    cout << "Benchmarking columnar star ephemeris kernel...\n";
+
+    const int kNumStars = 1000000, kPasses = 5;
+    SSObjectArray source, stars;
+
+    SSImportObjectsFromCSV ( inpath + "/Stars/Brightest.csv", source );
+    SSImportObjectsFromCSV ( inpath + "/Stars/Nearest.csv", source );
+    if ( source.size() == 0 )
+    {
+        cout << "Failed to import stars from " << inpath << endl << endl;
+        return;
+    }
+
+    for ( int i = 0; i < kNumStars; i++ )
+        stars.append ( SSCloneObject ( source[ i % source.size() ] ) );
+
+    SSCoordinates coords ( SSTime ( SSTime::kJ2000 + 73050.0 ), SSSpherical ( 0.0, 0.0, 0.0 ) );
+
+    double secs = clocksec();
+    for ( int pass = 0; pass < kPasses; pass++ )
+        for ( int i = 0; i < stars.size(); i++ )
+            stars[i]->computeEphemeris ( coords );
+    secs = clocksec_since ( secs ) / kPasses;
+    cout << formstr ( "SSStar::computeEphemeris(): %.3f sec, %.0f stars/sec", secs, stars.size() / secs ) << endl;
+
+    SSStarArray array;
+    double build = clocksec();
+    array.append ( stars );
+    build = clocksec_since ( build );
+
+    secs = clocksec();
+    for ( int pass = 0; pass < kPasses; pass++ )
+        array.computeEphemeris ( coords );
+    secs = clocksec_since ( secs ) / kPasses;
+    cout << formstr ( "SSStarArray::computeEphemeris(): %.3f sec, %.0f stars/sec (%.3f sec to build)", secs, array.size() / secs, build ) << endl;
+
+    double maxdir = 0.0, maxdist = 0.0, maxmag = 0.0;
+    for ( int i = 0; i < array.size(); i++ )
+    {
+        SSStar *pStar = array.getStar ( i );
+        maxdir = max ( maxdir, ( array.getDirection ( i ) - pStar->getDirection() ).magnitude() );
+        if ( ::isfinite ( pStar->getDistance() ) )
+            maxdist = max ( maxdist, fabs ( array.getDistance ( i ) / pStar->getDistance() - 1.0 ) );
+        maxmag = max ( maxmag, (double) fabs ( array.getMagnitude ( i ) - pStar->getMagnitude() ) );
+    }
+
+    cout << formstr ( "max direction difference %.2e, relative distance difference %.2e, magnitude difference %.2e", maxdir, maxdist, maxmag ) << endl;
+    stars.erase();
+    source.erase();
+    cout << endl;
+}
+
+// Magnitude levels of the HTM built by BenchHTMRegionFiles(), and used by later HTM benchmarks.
+
+static const vector<float> kBenchMagLevels = { 6.0, 7.5, 9.0, 10.0 };
+
+// Builds an HTM of stars cloned from the brightest-star catalog at pseudo-random positions
+// and magnitudes (with star counts increasing by a factor of 2.5 per magnitude, like the real sky), saves its regions as CSV files in an output directory (outpath), and converts
+// them to binary region files. Then times loading all regions from the CSV files, loading them
+// from the binary files, and reading magnitudes directly from the memory-mapped binary files.
+// Checks that stars loaded from both kinds of files have the same positions and magnitudes.
+
+void BenchHTMRegionFiles ( const string &inpath, const string &outpath )
+{
+    cout << "Benchmarking HTM CSV versus binary region files...\n";
+
+    const int kNumStars = 200000;
+    vector<float> magLevels = kBenchMagLevels;
+    SSObjectArray source, stars;
+
+    if ( SSImportObjectsFromCSV ( inpath + "/Stars/Brightest.csv", source ) == 0 )
+    {
+        cout << "Failed to import stars from " << inpath << endl << endl;
+        return;
+    }
+
+    srand ( 1 );
+    for ( int i = 0; i < kNumStars; i++ )
+    {
+        SSStarPtr pStar = SSGetStarPtr ( SSCloneObject ( source[ i % source.size() ] ) );
+        SSVector pos ( rand() - RAND_MAX / 2.0, rand() - RAND_MAX / 2.0, rand() - RAND_MAX / 2.0 );
+        pStar->setFundamentalPosition ( pos.normalize() );
+        pStar->setVMagnitude ( 10.0 + 2.5 * log10 ( ( rand() + 1.0 ) / ( RAND_MAX + 1.0 ) ) );
+        pStar->setParallax ( 0.0 );
+        stars.append ( pStar );
+    }
+
+    SSHTM htm ( magLevels, outpath );
+    htm.store ( stars );
+    htm.saveRegions();
+    htm.clearRegions();
+
+    double secs = clocksec();
+    int nregions = SSHTMRegionFile::convertRegions ( htm );
+    secs = clocksec_since ( secs );
+    cout << formstr ( "converted %d regions to binary: %.3f sec", nregions, secs ) << endl;
+
+    SSHTM csvHTM ( magLevels, outpath );
+    secs = clocksec();
+    csvHTM.loadRegions();
+    secs = clocksec_since ( secs );
+    cout << formstr ( "CSV load:    %.3f sec, %d stars", secs, csvHTM.countStars() ) << endl;
+
+    SSHTM binHTM ( magLevels, outpath );
+    binHTM.setDataFileReadFunc ( SSHTMRegionFile::readRegion );
+    secs = clocksec();
+    binHTM.loadRegions();
+    secs = clocksec_since ( secs );
+    cout << formstr ( "binary load: %.3f sec, %d stars", secs, binHTM.countStars() ) << endl;
+
+    // Read magnitudes straight from the mapped files, without creating any objects.
+
+    vector<uint64_t> ids = { 0 };
+    for ( int i = 0; i < ids.size(); i++ )
+        for ( uint64_t id : binHTM.subRegionIDs ( ids[i] ) )
+            ids.push_back ( id );
+
+    double sum = 0.0;
+    int nmapped = 0;
+    secs = clocksec();
+    for ( uint64_t id : ids )
+    {
+        SSHTMRegionFile file;
+        if ( file.open ( binHTM.rootPath() + binHTM.ID2name ( id ) + ".bin" ) )
+            for ( size_t i = 0; i < file.size(); i++, nmapped++ )
+                sum += file.getRecord ( i ).Vmag;
+    }
+    secs = clocksec_since ( secs );
+    cout << formstr ( "mapped read: %.3f sec, %d stars, mean magnitude %.3f", secs, nmapped, sum / nmapped ) << endl;
+
+    int mismatches = 0;
+    for ( uint64_t id : ids )
+    {
+        SSObjectVec *pCSV = csvHTM.getObjects ( id ), *pBin = binHTM.getObjects ( id );
+        if ( pCSV == nullptr || pBin == nullptr )
+        {
+            mismatches += pCSV != pBin;
+            continue;
+        }
+
+        mismatches += pCSV->size() != pBin->size();
+        for ( int i = 0; i < min ( pCSV->size(), pBin->size() ); i++ )
+        {
+            SSStarPtr p1 = SSGetStarPtr ( pCSV->get ( i ) ), p2 = SSGetStarPtr ( pBin->get ( i ) );
+            if ( ! ( p1->getFundamentalPosition() == p2->getFundamentalPosition() ) || p1->getVMagnitude() != p2->getVMagnitude() || p1->getName ( 0 ) != p2->getName ( 0 ) )
+                mismatches++;
+        }
+    }
+
+    cout << formstr ( "%d mismatches between CSV and binary regions", mismatches ) << endl;
+    stars.erase();
+    source.erase();
+    cout << endl;
+}
+
+// Writes star CSV and MPCORB files of about a million lines each to the output directory (outpath), by
+// repeating the bundled star and asteroid files. Times reading their lines with fgetline() and SSLineReader,
+// splitting the star file's lines into CSV fields as strings and as views, and importing both files.
+// Checks that both readers and both tokenizers see the same lines and fields. Deletes the files afterwards.
+
+void BenchImport ( const string &inpath, const string &outpath )
+{
+    cout << "Benchmarking line reader, CSV tokenizer, and importers...\n";
+
+    const int kCopies = 100;
+    string starpath = outpath + "/BenchStars.csv", mpcpath = outpath + "/BenchMPCORB.txt";
+    vector<string> sources = { inpath + "/Stars/Brightest.csv", inpath + "/SolarSystem/Asteroids.txt" };
+    vector<string> paths = { starpath, mpcpath };
+
+    for ( int f = 0; f < 2; f++ )
+    {
+        size_t size = 0;
+        const void *data = mapfile ( sources[f], size );
+        FILE *file = fopen ( paths[f].c_str(), "wb" );
+        if ( data == nullptr || file == nullptr )
+        {
+            cout << "Failed to copy " << sources[f] << " to " << paths[f] << endl << endl;
+            unmapfile ( data, size );
+            if ( file )
+                fclose ( file );
+            return;
+        }
+
+        for ( int i = 0; i < kCopies; i++ )
+            fwrite ( data, 1, size, file );
+        fclose ( file );
+        unmapfile ( data, size );
+    }
+
+    // Read lines from the star file with fgetline(), then with SSLineReader.
+
+    size_t nlines[2] = { 0 }, nbytes[2] = { 0 };
+    string line;
+    double secs = clocksec();
+    FILE *file = fopen ( starpath.c_str(), "rb" );
+    while ( file && fgetline ( file, line ) )
+    {
+        nlines[0]++;
+        nbytes[0] += line.length();
+    }
+    if ( file )
+        fclose ( file );
+    secs = clocksec_since ( secs );
+    cout << formstr ( "fgetline():   %.3f sec, %zu lines, %zu bytes", secs, nlines[0], nbytes[0] ) << endl;
+
+    string_view view;
+    secs = clocksec();
+    SSLineReader reader ( starpath );
+    while ( reader.readLine ( view ) )
+    {
+        nlines[1]++;
+        nbytes[1] += view.length();
+    }
+    secs = clocksec_since ( secs );
+    cout << formstr ( "SSLineReader: %.3f sec, %zu lines, %zu bytes%s", secs, nlines[1], nbytes[1], nlines[0] == nlines[1] && nbytes[0] == nbytes[1] ? "" : " MISMATCH" ) << endl;
+
+    // Split every line into fields as strings, then as views. Compare their total lengths.
+
+    size_t nfields[2] = { 0 }, nchars[2] = { 0 };
+    secs = clocksec();
+    reader.open ( starpath );
+    while ( reader.readLine ( view ) )
+        for ( const string &field : split_csv ( string ( view ) ) )
+        {
+            nfields[0]++;
+            nchars[0] += field.length();
+        }
+    secs = clocksec_since ( secs );
+    cout << formstr ( "split_csv() into strings: %.3f sec, %zu fields, %zu chars", secs, nfields[0], nchars[0] ) << endl;
+
+    vector<string_view> fields;
+    string buffer;
+    secs = clocksec();
+    reader.open ( starpath );
+    while ( reader.readLine ( view ) )
+    {
+        split_csv ( view, fields, buffer );
+        nfields[1] += fields.size();
+        for ( string_view field : fields )
+            nchars[1] += field.length();
+    }
+    secs = clocksec_since ( secs );
+    cout << formstr ( "split_csv() into views:   %.3f sec, %zu fields, %zu chars%s", secs, nfields[1], nchars[1], nfields[0] == nfields[1] && nchars[0] == nchars[1] ? "" : " MISMATCH" ) << endl;
+    reader.close();
+
+    // Import both files.
+
+    SSObjectArray objects;
+    secs = clocksec();
+    int n = SSImportObjectsFromCSV ( starpath, objects );
+    secs = clocksec_since ( secs );
+    cout << formstr ( "SSImportObjectsFromCSV(): %.3f sec, %d stars", secs, n ) << endl;
+    objects.erase();
+
+    secs = clocksec();
+    n = SSImportMPCAsteroids ( mpcpath, objects );
+    secs = clocksec_since ( secs );
+    cout << formstr ( "SSImportMPCAsteroids():   %.3f sec, %d asteroids", secs, n ) << endl;
+    objects.erase();
+
+    remove ( starpath.c_str() );
+    remove ( mpcpath.c_str() );
+    cout << endl;
+}
+
+// Imports the CSV files loaded at startup with 1, 2, 4, and one thread per CPU core,
+// and checks that every thread count imports identical objects in identical order.
+
+void BenchParallelImport ( const string &inpath )
+{
+    cout << "Benchmarking parallel CSV import...\n";
+
+    vector<string> paths =
+    {
+        inpath + "/Stars/Brightest.csv",
+        inpath + "/DeepSky/MCNGCIC.csv",
+        inpath + "/SolarSystem/Features.csv",
+        inpath + "/SolarSystem/Cities.csv",
+        inpath + "/SolarSystem/JPLComets.csv"
+    };
+
+    vector<int> threads = { 1, 2, 4, (int) thread::hardware_concurrency() };
+    string reference;
+
+    for ( int nthreads : threads )
+    {
+        SSObjectArray objects;
+        double secs = clocksec();
+        for ( const string &path : paths )
+            SSImportObjectsFromCSV ( path, objects, nullptr, nullptr, nthreads );
+        secs = clocksec_since ( secs );
+
+        string csv;
+        for ( int i = 0; i < objects.size(); i++ )
+            csv += objects[i]->toCSV() + "\n";
+
+        if ( reference.empty() )
+            reference = csv;
+
+        cout << formstr ( "%2d threads: %.3f sec, %zu objects%s", nthreads, secs, objects.size(), csv == reference ? "" : " MISMATCH" ) << endl;
+    }
+
+    // The MPC asteroid and comet files are not CSV; time them for comparison.
+
+    SSObjectArray objects;
+    double secs = clocksec();
+    int n = SSImportMPCAsteroids ( inpath + "/SolarSystem/Asteroids.txt", objects );
+    n += SSImportMPCComets ( inpath + "/SolarSystem/Comets.txt", objects );
+    secs = clocksec_since ( secs );
+    cout << formstr ( "MPC asteroids and comets: %.3f sec, %d objects", secs, n ) << endl << endl;
+}
+
+// Imports the brightest star and deep sky catalogs several times over, into an ordinary object array
+// and then into an arena-backed one, and times import and teardown of each. Reports heap allocations
+// made for objects and their containers, arena statistics, and checks that both arrays are identical.
+
+void BenchObjectArena ( const string &inpath )
+{
+    cout << "Benchmarking arena-allocated object arrays...\n";
+
+    const int kCopies = 10;
+    vector<string> paths = { inpath + "/Stars/Brightest.csv", inpath + "/DeepSky/MCNGCIC.csv" };
+    string reference;
+
+    for ( int arena = 0; arena < 2; arena++ )
+    {
+        SSObjectArray *pObjects = new SSObjectArray ( arena );
+        SSObjectArenaStats heap0 = SSObjectArena::heapStats();
+        double secs = clocksec();
+        for ( int i = 0; i < kCopies; i++ )
+            for ( const string &path : paths )
+                SSImportObjectsFromCSV ( path, *pObjects );
+        secs = clocksec_since ( secs );
+        SSObjectArenaStats heap1 = SSObjectArena::heapStats();
+
+        string csv;
+        for ( int i = 0; i < pObjects->size(); i++ )
+            csv += pObjects->get ( i )->toCSV() + "\n";
+        if ( reference.empty() )
+            reference = csv;
+
+        SSObjectArenaStats stats = { 0 };
+        if ( pObjects->getArena() )
+            stats = pObjects->getArena()->getStats();
+
+        size_t n = pObjects->size();
+        double teardown = clocksec();
+        delete pObjects;
+        teardown = clocksec_since ( teardown );
+        SSObjectArenaStats heap2 = SSObjectArena::heapStats();
+
+        cout << formstr ( "%s: import %.3f sec, teardown %.3f sec, %zu objects%s", arena ? "Arena" : "Heap ", secs, teardown, n, csv == reference ? "" : " MISMATCH" ) << endl;
+        cout << formstr ( "       heap allocations %zu (%.1f MB), heap frees %zu", heap1.allocations - heap0.allocations, ( heap1.bytes - heap0.bytes ) / 1048576.0, heap2.deallocations - heap1.deallocations ) << endl;
+        if ( arena )
+            cout << formstr ( "       arena allocations %zu (%.1f MB), releases %zu, slabs %zu (%.1f MB)", stats.allocations, stats.bytes / 1048576.0, stats.deallocations, stats.slabs, stats.slabBytes / 1048576.0 ) << endl;
+    }
+
+    cout << endl;
+}
+
+// Writes a synthetic Tycho-2 main catalog file of pseudo-random stars in the catalog's fixed-width format
+// to the output directory (outpath), plus a matching Tycho-1 star array in which every fourth star has HD and BD
+// identifiers, then imports it with SSImportTYC2() and reports time, heap allocations, and memory per star.
+// Then times building a TYC identifier map, and scanning every star's names and identifiers.
+
+void BenchTycho2Import ( const string &outpath )
+{
+    cout << "Benchmarking Tycho-2 import and star identifier storage...\n";
+
+    const int kStars = 250000;
+    string path = outpath + "/BenchTycho2.dat";
+    FILE *file = fopen ( path.c_str(), "wb" );
+    if ( file == nullptr )
+    {
+        cout << "Failed to create " << path << endl << endl;
+        return;
+    }
+
+    SSObjectArray tyc1Stars, wdsStars;
+    mt19937 rng ( 2 );
+    uniform_real_distribution<double> uni ( 0.0, 1.0 );
+    for ( int i = 0; i < kStars; i++ )
+    {
+        string tyc = formstr ( "%04d %05d 1", i % 9537 + 1, i / 9537 + 1 );
+        string line ( 206, ' ' );
+        auto put = [&line] ( size_t col, const string &s ) { line.replace ( col, s.length(), s ); };
+
+        put ( 0, tyc );
+        put ( 15, formstr ( "%12.8f", uni ( rng ) * 360.0 ) );
+        put ( 28, formstr ( "%+12.8f", asin ( uni ( rng ) * 2.0 - 1.0 ) * 180.0 / M_PI ) );
+        put ( 41, formstr ( "%+7.1f", uni ( rng ) * 100.0 - 50.0 ) );
+        put ( 49, formstr ( "%+7.1f", uni ( rng ) * 100.0 - 50.0 ) );
+        put ( 110, formstr ( "%6.3f", 9.0 + uni ( rng ) * 3.0 ) );
+        put ( 123, formstr ( "%6.3f", 8.5 + uni ( rng ) * 3.0 ) );
+        if ( i % 4 == 0 )
+        {
+            put ( 140, "T" );
+            SSStarPtr pStar1 = SSGetStarPtr ( SSNewObject ( kTypeStar ) );
+            pStar1->addIdentifier ( SSIdentifier::fromString ( "TYC " + tyc ) );
+            pStar1->addIdentifier ( SSIdentifier ( kCatHD, i / 4 + 1 ) );
+            pStar1->addIdentifier ( SSIdentifier::fromString ( formstr ( "BD +%02d %d", i % 90, i / 4 + 1 ) ) );
+            tyc1Stars.append ( pStar1 );
+        }
+        fputs ( ( line + "\n" ).c_str(), file );
+    }
+    fclose ( file );
+
+    SSObjectArray stars;
+    SSObjectArenaStats heap0 = SSObjectArena::heapStats();
+    double secs = clocksec();
+    int n = SSImportTYC2 ( path, tyc1Stars, wdsStars, stars );
+    secs = clocksec_since ( secs );
+    SSObjectArenaStats heap1 = SSObjectArena::heapStats();
+    size_t allocs = heap1.allocations - heap0.allocations, bytes = heap1.bytes - heap0.bytes;
+    cout << formstr ( "SSImportTYC2(): %.3f sec, %d stars, %.2f heap allocations and %.1f bytes per star (sizeof SSStar %zu)", secs, n, (double) allocs / n, (double) bytes / n, sizeof ( SSStar ) ) << endl;
+
+    secs = clocksec();
+    SSObjectMap map = SSMakeObjectMap ( stars, kCatTYC );
+    secs = clocksec_since ( secs );
+    cout << formstr ( "SSMakeObjectMap(): %.3f sec, %zu identifiers", secs, map.size() ) << endl;
+
+    size_t numNames = 0, numIdents = 0;
+    secs = clocksec();
+    for ( int k = 0; k < 10; k++ )
+    {
+        for ( size_t i = 0; i < stars.size(); i++ )
+        {
+            SSStarPtr pStar = SSGetStarPtr ( stars[i] );
+            for ( const string &name : pStar->getNames() )
+                numNames += name.empty() ? 0 : 1;
+            for ( SSIdentifier ident : pStar->getIdents() )
+                numIdents += ident ? 1 : 0;
+        }
+    }
+    secs = clocksec_since ( secs );
+    cout << formstr ( "Scan names and identifiers x10: %.3f sec, %zu names, %zu identifiers", secs, numNames, numIdents ) << endl;
+
+    remove ( path.c_str() );
+    cout << endl;
+}
+
+// Builds GAIA cross-match tables of map type M (hipCM, tycCM) from synthetic GAIA source IDs (sourceIDs)
+// and Tycho-2 identifiers (tycIDs), in which every tenth Tycho-2 star is a Hipparcos star. Then looks up
+// every GAIA source in both tables, as SSExportGAIADR3StarData() does, and returns the resulting GAIA
+// records (gaiaRecs). Returns the time taken in seconds.
+
+template <class M> double BenchCrossMatchTables ( const vector<uint64_t> &sourceIDs, const vector<uint64_t> &tycIDs, M &hipCM, M &tycCM, vector<SSGAIARec> &gaiaRecs )
+{
+    double secs = clocksec();
+    for ( size_t i = 0; i < tycIDs.size(); i++ )
+    {
+        SSGAIACrossMatchRecord record;
+        record.source_id = sourceIDs[i];
+        record.ext_source_id = i % 10 ? tycIDs[i] : i / 10 + 1;
+        if ( i % 10 )
+            tycCM[ record.source_id ] = record;
+        else
+            hipCM[ record.source_id ] = record;
+    }
+
+    gaiaRecs = vector<SSGAIARec> ( sourceIDs.size() );
+    for ( size_t i = 0; i < sourceIDs.size(); i++ )
+    {
+        SSGAIARec &rec = gaiaRecs[i];
+        rec.source_id = sourceIDs[i];
+
+        auto it = hipCM.find ( rec.source_id );
+        if ( it != hipCM.end() )
+            rec.hip_source_id = (uint32_t) it->second.ext_source_id;
+
+        it = tycCM.find ( rec.source_id );
+        if ( it != tycCM.end() )
+            rec.tyc_source_id = it->second.ext_source_id;
+
+        rec.phot_g_mean_mmag = rec.hip_source_id || rec.tyc_source_id ? 10000 : 15000;
+    }
+
+    return clocksec_since ( secs );
+}
+
+// Builds a map of type M from identifiers in a catalog (cat) to indexes + 1 of objects in an array (objects),
+// the same way SSMakeObjectMap() does. The SSObjectMap overload calls SSMakeObjectMap() itself.
+
+template <class M> void BenchMakeObjectMap ( SSObjectVec &objects, SSCatalog cat, M &map )
+{
+    for ( int i = 0; i < objects.size(); i++ )
+    {
+        SSIdentifier ident = objects[i] ? objects[i]->getIdentifier ( cat ) : SSIdentifier();
+        if ( ident )
+            map.insert ( { ident, i + 1 } );
+    }
+}
+
+void BenchMakeObjectMap ( SSObjectVec &objects, SSCatalog cat, SSObjectMap &map )
+{
+    map = SSMakeObjectMap ( objects, cat );
+}
+
+// Times building HIP, TYC, and GAIA identifier maps of type M (named label) for a star array (stars),
+// then looking up every star's identifiers in them. The object index + 1 which each identifier maps to,
+// or zero if none, is returned in (results).
+
+template <class M> void BenchObjectMaps ( SSObjectVec &stars, const char *label, vector<int> &results )
+{
+    M hipMap, tycMap, gaiaMap;
+    double secs = clocksec();
+    BenchMakeObjectMap ( stars, kCatHIP, hipMap );
+    BenchMakeObjectMap ( stars, kCatTYC, tycMap );
+    BenchMakeObjectMap ( stars, kCatGAIA, gaiaMap );
+    secs = clocksec_since ( secs );
+    cout << formstr ( "%s identifier maps x3: %.3f sec, %zu HIP, %zu TYC, %zu GAIA identifiers", label, secs, hipMap.size(), tycMap.size(), gaiaMap.size() ) << endl;
+
+    size_t found = 0;
+    results.clear();
+    secs = clocksec();
+    for ( size_t i = 0; i < stars.size(); i++ )
+    {
+        SSStarPtr pStar = SSGetStarPtr ( stars[i] );
+        for ( SSIdentifier ident : pStar->getIdents() )
+        {
+            M &map = ident.catalog() == kCatHIP ? hipMap : ident.catalog() == kCatTYC ? tycMap : gaiaMap;
+            auto it = map.find ( ident );
+            results.push_back ( it != map.end() ? it->second : 0 );
+            found += results.back() == i + 1;
+        }
+    }
+    secs = clocksec_since ( secs );
+    cout << formstr ( "%s identifier lookups: %.3f sec, %zu lookups, %zu found", label, secs, results.size(), found ) << endl;
+}
+
+// Times the HIP + Tycho-2 + GAIA catalog merge on synthetic data in an output directory (outpath):
+// importing a Tycho-2 file into an array of Hipparcos stars, building GAIA cross-match tables
+// and looking up every GAIA source in them, then merging the resulting GAIA stars into the array.
+// Also times building identifier maps of the merged array and looking up every star in them.
+// Cross-match tables and identifier maps are timed as std::map and as SSHashMap, and must match.
+
+void BenchCrossMatch ( const string &outpath )
+{
+    cout << "Benchmarking HIP + TYC + GAIA cross-match merge...\n";
+
+    const int kHIPStars = 100000, kTYCStars = 1000000, kGAIAOnly = 500000;
+    string tycPath = outpath + "/BenchCrossMatchTYC.dat";
+    string gaiaPath = outpath + "/BenchCrossMatchGAIA.dat";
+    FILE *file = fopen ( tycPath.c_str(), "wb" );
+    if ( file == nullptr )
+    {
+        cout << "Failed to create " << tycPath << endl << endl;
+        return;
+    }
+
+    // Hipparcos stars, and a Tycho-2 file in which every tenth star is a Hipparcos star
+    // and every fourth star is a Tycho-1 star.
+
+    mt19937 rng ( 3 );
+    uniform_real_distribution<double> uni ( 0.0, 1.0 );
+    SSObjectArray stars, tyc1Stars, wdsStars;
+    for ( int i = 0; i < kHIPStars; i++ )
+    {
+        SSStarPtr pStar = SSGetStarPtr ( SSNewObject ( kTypeStar ) );
+        pStar->addIdentifier ( SSIdentifier ( kCatHIP, i + 1 ) );
+        pStar->setFundamentalMotion ( SSSpherical ( uni ( rng ) * SSAngle::kTwoPi, asin ( uni ( rng ) * 2.0 - 1.0 ), INFINITY ), SSSpherical ( 0.0, 0.0, INFINITY ) );
+        pStar->setVMagnitude ( 6.0 + uni ( rng ) * 3.0 );
+        stars.append ( pStar );
+    }
+
+    vector<uint64_t> tycIDs ( kTYCStars );
+    for ( int i = 0; i < kTYCStars; i++ )
+    {
+        string tyc = formstr ( "%04d %05d 1", i % 9537 + 1, i / 9537 + 1 );
+        string line ( 206, ' ' );
+        auto put = [&line] ( size_t col, const string &s ) { line.replace ( col, s.length(), s ); };
+
+        put ( 0, tyc );
+        put ( 15, formstr ( "%12.8f", uni ( rng ) * 360.0 ) );
+        put ( 28, formstr ( "%+12.8f", asin ( uni ( rng ) * 2.0 - 1.0 ) * 180.0 / M_PI ) );
+        put ( 110, formstr ( "%6.3f", 9.0 + uni ( rng ) * 3.0 ) );
+        put ( 123, formstr ( "%6.3f", 8.5 + uni ( rng ) * 3.0 ) );
+        if ( i % 4 == 0 )
+        {
+            put ( 140, "T" );
+            SSStarPtr pStar1 = SSGetStarPtr ( SSNewObject ( kTypeStar ) );
+            pStar1->addIdentifier ( SSIdentifier::fromString ( "TYC " + tyc ) );
+            pStar1->addIdentifier ( SSIdentifier ( kCatHD, i / 4 + 1 ) );
+            tyc1Stars.append ( pStar1 );
+        }
+        if ( i % 10 == 0 )
+            put ( 142, formstr ( "%6d", i / 10 + 1 ) );
+        fputs ( ( line + "\n" ).c_str(), file );
+        tycIDs[i] = SSIdentifier::fromString ( "TYC " + tyc ).identifier();
+    }
+    fclose ( file );
+
+    double total = clocksec();
+    double secs = clocksec();
+    int nTYC = SSImportTYC2 ( tycPath, tyc1Stars, wdsStars, stars );
+    secs = clocksec_since ( secs );
+    cout << formstr ( "SSImportTYC2(): %.3f sec, %d stars, %zu in merged array", secs, nTYC, stars.size() ) << endl;
+
+    // GAIA cross-match tables: one GAIA source per Hipparcos star, one per non-Hipparcos Tycho-2 star,
+    // plus GAIA-only sources. Then look up every GAIA source in both tables, as SSExportGAIADR3StarData() does.
+
+    vector<uint64_t> sourceIDs ( kTYCStars + kGAIAOnly );
+    for ( uint64_t &id : sourceIDs )
+        id = rng() * (uint64_t) rng() % 6000000000000000000ULL + 1;
+
+    map<uint64_t,SSGAIACrossMatchRecord> hipStdCM, tycStdCM;
+    vector<SSGAIARec> stdRecs;
+    double stdSecs = BenchCrossMatchTables ( sourceIDs, tycIDs, hipStdCM, tycStdCM, stdRecs );
+    cout << formstr ( "std::map cross-match tables: %.3f sec, %zu HIP and %zu TYC records, %zu sources looked up", stdSecs, hipStdCM.size(), tycStdCM.size(), stdRecs.size() ) << endl;
+
+    SSGAIACrossMatch hipCM, tycCM;
+    vector<SSGAIARec> gaiaRecs;
+    secs = BenchCrossMatchTables ( sourceIDs, tycIDs, hipCM, tycCM, gaiaRecs );
+    cout << formstr ( "SSHashMap cross-match tables: %.3f sec, %zu HIP and %zu TYC records, %zu sources looked up", secs, hipCM.size(), tycCM.size(), gaiaRecs.size() ) << endl;
+
+    int mismatches = 0;
+    for ( size_t i = 0; i < gaiaRecs.size(); i++ )
+        mismatches += gaiaRecs[i].hip_source_id != stdRecs[i].hip_source_id || gaiaRecs[i].tyc_source_id != stdRecs[i].tyc_source_id;
+    cout << formstr ( "cross-match tables: %d mismatches: %s", mismatches, mismatches == 0 ? "OK" : "FAILED" ) << endl;
+
+    for ( SSGAIARec &rec : gaiaRecs )
+        rec.parallax = 1.0 + uni ( rng ) * 10.0;
+
+    file = fopen ( gaiaPath.c_str(), "wb" );
+    if ( file == nullptr )
+    {
+        cout << "Failed to create " << gaiaPath << endl << endl;
+        remove ( tycPath.c_str() );
+        return;
+    }
+    fwrite ( gaiaRecs.data(), sizeof ( SSGAIARec ), gaiaRecs.size(), file );
+    fclose ( file );
+
+    secs = clocksec();
+    int nGAIA = SSImportGAIA17 ( gaiaPath, stars, 0.0, 12.0 );
+    secs = clocksec_since ( secs );
+    total = clocksec_since ( total ) - stdSecs;
+    cout << formstr ( "SSImportGAIA17(): %.3f sec, %d GAIA stars merged", secs, nGAIA ) << endl;
+    cout << formstr ( "Total merge (excluding std::map tables): %.3f sec", total ) << endl;
+
+    // Identifier maps of the merged array, and lookups of every star's identifiers.
+
+    vector<int> stdResults, hashResults;
+    BenchObjectMaps<map<SSIdentifier,int>> ( stars, "std::map", stdResults );
+    BenchObjectMaps<SSObjectMap> ( stars, "SSHashMap", hashResults );
+    cout << formstr ( "identifier maps: %s", stdResults == hashResults ? "OK" : "FAILED" ) << endl;
+
+    remove ( tycPath.c_str() );
+    remove ( gaiaPath.c_str() );
+    cout << endl;
+}
+
+// Imports the startup data set from CSV and MPC text files, exports it as a binary snapshot,
+// then times importing the snapshot and checks that it reproduces every object's CSV exactly.
+
+void BenchBinarySnapshot ( const string &inpath, const string &outpath )
+{
+    cout << "Benchmarking binary object snapshots...\n";
+
+    vector<string> paths =
+    {
+        inpath + "/Stars/Brightest.csv",
+        inpath + "/DeepSky/MCNGCIC.csv",
+        inpath + "/SolarSystem/Planets.csv",
+        inpath + "/SolarSystem/Moons.csv",
+        inpath + "/SolarSystem/Features.csv",
+        inpath + "/SolarSystem/Cities.csv",
+        inpath + "/SolarSystem/JPLComets.csv"
+    };
+
+    SSObjectArray objects;
+    double secs = clocksec();
+    for ( const string &path : paths )
+        SSImportObjectsFromCSV ( path, objects );
+    SSImportMPCAsteroids ( inpath + "/SolarSystem/Asteroids.txt", objects );
+    SSImportMPCComets ( inpath + "/SolarSystem/Comets.txt", objects );
+    SSImportSatellitesFromTLE ( inpath + "/SolarSystem/Satellites/visual.txt", objects );
+    SSImportConstellations ( inpath + "/Constellations/Constellations.csv", objects );
+    secs = clocksec_since ( secs );
+    cout << formstr ( "CSV and text import: %.3f sec, %zu objects", secs, objects.size() ) << endl;
+
+    string snappath = outpath + "/BenchSnapshot.bin";
+    secs = clocksec();
+    int n = SSExportObjectsToBinary ( snappath, objects );
+    secs = clocksec_since ( secs );
+    cout << formstr ( "SSExportObjectsToBinary():   %.3f sec, %d objects", secs, n ) << endl;
+
+    SSObjectArray snapshot;
+    secs = clocksec();
+    n = SSImportObjectsFromBinary ( snappath, snapshot );
+    secs = clocksec_since ( secs );
+
+    int mismatches = 0;
+    for ( int i = 0; i < objects.size() && i < snapshot.size(); i++ )
+        if ( objects[i]->toCSV() != snapshot[i]->toCSV() )
+            mismatches++;
+
+    cout << formstr ( "SSImportObjectsFromBinary(): %.3f sec, %d objects, %d mismatches%s", secs, n, mismatches, snapshot.size() == objects.size() && mismatches == 0 ? "" : " FAILED" ) << endl;
+    remove ( snappath.c_str() );
+    cout << endl;
+}
+
+// Simulates a long planetarium session over the binary region files written by BenchHTMRegionFiles(),
+// panning across the sky and requesting regions asynchronously every 2 msec frame with a memory budget.
+// Reports cache statistics and checks that memory used never exceeds the budget by more than one
+// region per loading thread, plus the most recently used region. Then requests one region from many threads at once, which should load it only once.
+
+void BenchHTMCache ( const string &outpath )
+{
+    cout << "Benchmarking HTM region cache...\n";
+
+    const int kFrames = 1000, kRegionsPerFrame = 16, kMaxObjects = 20000;
+    SSHTM htm ( kBenchMagLevels, outpath );
+    htm.setDataFileReadFunc ( SSHTMRegionFile::readRegion );
+    htm.setMemoryBudget ( kMaxObjects, 0 );
+
+    vector<uint64_t> ids = { 0 };
+    for ( int i = 0; i < ids.size(); i++ )
+        for ( uint64_t id : htm.subRegionIDs ( ids[i] ) )
+            ids.push_back ( id );
+
+    size_t peakObjects = 0, numObjects = 0, numBytes = 0, largest = 0;
+    for ( uint64_t id : ids )
+    {
+        SSHTMRegionFile file;
+        if ( file.open ( htm.rootPath() + htm.ID2name ( id ) + ".bin" ) )
+            largest = max ( largest, file.size() );
+    }
+
+    double secs = clocksec();
+    for ( int frame = 0; frame < kFrames; frame++ )
+    {
+        for ( int k = 0; k < kRegionsPerFrame; k++ )
+            htm.loadRegion ( ids[ ( frame / 20 + k ) % ids.size() ], false );
+
+        htm.getMemoryUsed ( numObjects, numBytes );
+        peakObjects = max ( peakObjects, numObjects );
+        this_thread::sleep_for ( chrono::milliseconds ( 2 ) );
+    }
+    secs = clocksec_since ( secs );
+
+    size_t hits = 0, misses = 0, evictions = 0;
+    htm.getStatistics ( hits, misses, evictions );
+    cout << formstr ( "%d frames: %.3f sec, %d hits, %d misses, %d evictions", kFrames, secs, (int) hits, (int) misses, (int) evictions ) << endl;
+    cout << formstr ( "peak %d objects in memory, budget %d, largest region %d objects: %s", (int) peakObjects, kMaxObjects, (int) largest, peakObjects <= kMaxObjects + ( htm.getLoadThreads() + 1 ) * largest ? "OK" : "FAILED" ) << endl;
+
+    htm.dumpRegions();
+    htm.resetStatistics();
+    RunThreads ( 16, [&] ( int ithread ) { htm.loadRegion ( ids.back(), ithread % 2 == 0 ); } );
+    htm.loadRegion ( ids.back(), true );
+    htm.getStatistics ( hits, misses, evictions );
+    cout << formstr ( "16 threads requesting one region: %d loads: %s", (int) misses, misses == 1 ? "OK" : "FAILED" ) << endl;
+    cout << endl;
+}
+
+// Pans a 30-degree gnomonic view around the celestial equator at 100 degrees per second, and counts
+// how many of the HTM regions which become visible in each frame are already loaded from CSV files in
+// an output directory (outpath) when they first appear. Compares requesting only the visible regions
+// with loadRegion(), against prefetchRegions(), which also loads regions ahead of the view as it pans.
+// Also checks that no visible region is missed, by sampling the view on a fine grid.
+
+void BenchHTMPrefetch ( const string &outpath )
+{
+    cout << "Benchmarking HTM view-driven region prefetching...\n";
+
+    const int kFrames = 360;
+    const double kFrameSecs = 0.01, kDegPerFrame = 1.0;
+    SSView view ( kGnomonic, SSAngle::fromDegrees ( 30.0 ), 800.0, 600.0, 400.0, 300.0 );
+    float limMag = kBenchMagLevels.back();
+
+    for ( int prefetch = 0; prefetch < 2; prefetch++ )
+    {
+        SSHTM htm ( kBenchMagLevels, outpath );
+        set<uint64_t> visible;
+        int appeared = 0, ready = 0, missed = 0;
+        double secs = clocksec();
+
+        for ( int frame = 0; frame < kFrames; frame++ )
+        {
+            view.setCenter ( SSAngle::fromDegrees ( frame * kDegPerFrame ), SSAngle ( 0.0 ) );
+            vector<uint64_t> ids;
+            htm.viewRegions ( view, limMag, ids );
+
+            for ( uint64_t id : ids )
+                if ( visible.count ( id ) == 0 )
+                {
+                    appeared++;
+                    if ( htm.regionLoaded ( id ) && htm.getObjects ( id ) )
+                        ready++;
+                }
+            visible = set<uint64_t> ( ids.begin(), ids.end() );
+
+            if ( prefetch )
+                htm.prefetchRegions ( view, limMag, frame * kFrameSecs );
+            else
+                for ( uint64_t id : ids )
+                    htm.loadRegion ( id, false );
+
+            // Every 30 frames, make sure the centers of all cells of a 40 x 30 grid
+            // in the view lie in one of the visible regions at every level.
+
+            if ( frame % 30 == 0 )
+                for ( int i = 0; i < 40; i++ )
+                    for ( int j = 0; j < 30; j++ )
+                    {
+                        SSVector v = view.unproject ( SSVector ( view.getLeft() + ( i + 0.5 ) * view.getWidth() / 40, view.getTop() + ( j + 0.5 ) * view.getHeight() / 30, 0.0 ) );
+                        for ( int level = 1; level < kBenchMagLevels.size(); level++ )
+                            if ( visible.count ( htm.vector2ID ( v, level - 1 ) ) == 0 )
+                                missed++;
+                    }
+
+            this_thread::sleep_for ( chrono::microseconds ( (int) ( kFrameSecs * 1.0e6 ) ) );
+        }
+
+        secs = clocksec_since ( secs );
+        cout << formstr ( "%s: %d frames in %.3f sec, %d of %d newly visible regions ready (%.1f%%), %d grid points missed: %s",
+                          prefetch ? "prefetchRegions()" : "loadRegion()     ", kFrames, secs, ready, appeared, 100.0 * ready / appeared, missed, missed == 0 ? "OK" : "FAILED" ) << endl;
+    }
+
+    cout << endl;
+}
+
+// The original recursive HTM cone search, for comparison with SSHTM::search(). Converts each
+// region's ID to a name string and parses it back into triangle vertices, then tests every object
+// in every region whose bounding circle overlaps the search circle, using angular separations.
+
+static int RecursiveSearch ( SSHTM &htm, uint64_t htmID, SSVector center, SSAngle rad, vector<SSObjectPtr> &results )
+{
+    if ( htmID > 0 )
+    {
+        SSVector v0, v1, v2;
+        htm.name2Triangle ( htm.ID2name ( htmID ), v0, v1, v2 );
+        SSVector vC = ( v0 + v1 + v2 ) / 3.0;
+        SSAngle r = vC.angularSeparation ( v0 );
+        if ( center.angularSeparation ( vC ) > r + rad )
+            return 0;
+    }
+
+    SSObjectVec *pObjects = htm.getObjects ( htmID );
+    int n = pObjects ? pObjects->search ( center, rad, results ) : 0;
+
+    for ( uint64_t subID : htm.subRegionIDs ( htmID ) )
+        n += RecursiveSearch ( htm, subID, center, rad, results );
+
+    return n;
+}
+
+// Returns a pseudo-random unit vector.
+
+static SSVector RandomVector ( void )
+{
+    SSVector v ( rand() - RAND_MAX / 2.0, rand() - RAND_MAX / 2.0, rand() - RAND_MAX / 2.0 );
+    return v.normalize();
+}
+
+// Loads all binary HTM region files in an output directory (outpath), then times small "near the
+// cursor" cone searches, and large cone searches, with the original recursive search and with
+// SSHTM::search(). Checks that cone and polygon searches find the same objects as testing every
+// star, and that triangles computed from HTM IDs match those computed from HTM names.
+
+void BenchHTMSearch ( const string &outpath )
+{
+    cout << "Benchmarking HTM cone and polygon search...\n";
+
+    SSHTM htm ( kBenchMagLevels, outpath );
+    htm.setDataFileReadFunc ( SSHTMRegionFile::readRegion );
+    htm.loadRegions();
+
+    int mismatches = 0;
+    for ( uint64_t id = 8; id < 16 << 14; id++ )
+    {
+        SSVector v0, v1, v2, w0, w1, w2;
+        if ( htm.ID2Triangle ( id, v0, v1, v2 ) )
+        {
+            htm.name2Triangle ( htm.ID2name ( id ), w0, w1, w2 );
+            if ( v0 != w0 || v1 != w1 || v2 != w2 )
+                mismatches++;
+        }
+    }
+    cout << formstr ( "ID2Triangle() versus name2Triangle() through level 8: %d mismatches: %s", mismatches, mismatches ? "FAILED" : "OK" ) << endl;
+
+    vector<SSObjectPtr> all, found, expected;
+    htm.search ( SSHTM::Convex(), all );
+
+    const int kSearches[2] = { 5000, 500 };
+    const double kRadii[2] = { 0.5, 10.0 };
+
+    for ( int k = 0; k < 2; k++ )
+    {
+        vector<SSVector> centers;
+        srand ( 2 );
+        for ( int i = 0; i < kSearches[k]; i++ )
+            centers.push_back ( RandomVector() );
+
+        SSAngle rad = SSAngle::fromDegrees ( kRadii[k] );
+        vector<SSObjectPtr> oldResults, newResults;
+        size_t nfound = 0;
+
+        double oldSecs = clocksec();
+        for ( SSVector &center : centers )
+        {
+            oldResults.clear();
+            RecursiveSearch ( htm, 0, center, rad, oldResults );
+        }
+        oldSecs = clocksec_since ( oldSecs );
+
+        double newSecs = clocksec();
+        for ( SSVector &center : centers )
+        {
+            newResults.clear();
+            nfound += htm.search ( 0, center, rad, newResults );
+        }
+        newSecs = clocksec_since ( newSecs );
+
+        // Check the first 200 searches against testing every star. Count objects
+        // which the recursive search misses, since its bounding circles are too small.
+
+        int missed = 0;
+        mismatches = 0;
+        for ( int i = 0; i < 200; i++ )
+        {
+            oldResults.clear();
+            newResults.clear();
+            expected.clear();
+            RecursiveSearch ( htm, 0, centers[i], rad, oldResults );
+            htm.search ( 0, centers[i], rad, newResults );
+            for ( SSObjectPtr pObj : all )
+                if ( centers[i].angularSeparation ( SSGetStarPtr ( pObj )->getFundamentalPosition() ) < rad )
+                    expected.push_back ( pObj );
+
+            sort ( newResults.begin(), newResults.end() );
+            sort ( expected.begin(), expected.end() );
+            if ( newResults != expected )
+                mismatches++;
+            missed += expected.size() - oldResults.size();
+        }
+
+        cout << formstr ( "%d cone searches of %.1f deg: recursive %.3f sec, SSHTM::search() %.3f sec (%.1fx), %.1f objects per search",
+                          kSearches[k], kRadii[k], oldSecs, newSecs, oldSecs / newSecs, (double) nfound / kSearches[k] ) << endl;
+        cout << formstr ( "200 of them versus testing all stars: %d mismatches: %s; recursive search missed %d objects", mismatches, mismatches ? "FAILED" : "OK", missed ) << endl;
+    }
+
+    // Compare 100 polygon searches, using quadrilaterals around random centers, to testing every star.
+
+    mismatches = 0;
+    for ( int i = 0; i < 100; i++ )
+    {
+        SSVector c = RandomVector(), u = c.crossProduct ( RandomVector() ).normalize(), w = c.crossProduct ( u );
+        double a = 0.05 + 0.2 * rand() / RAND_MAX, b = 0.05 + 0.2 * rand() / RAND_MAX;
+        SSHTM::Convex convex = SSHTM::makePolygon ( { c + u * a, c + w * b, c - u * a, c - w * b * 0.5 } );
+
+        found.clear();
+        expected.clear();
+        htm.search ( convex, found );
+        for ( SSObjectPtr pObj : all )
+            if ( SSHTM::inConvex ( convex, SSGetStarPtr ( pObj )->getFundamentalPosition() ) )
+                expected.push_back ( pObj );
+
+        sort ( found.begin(), found.end() );
+        sort ( expected.begin(), expected.end() );
+        if ( found != expected )
+            mismatches++;
+    }
+
+    cout << formstr ( "100 polygon searches versus testing all %d stars: %d mismatches: %s", (int) all.size(), mismatches, mismatches ? "FAILED" : "OK" ) << endl;
+    cout << endl;
+}
+
+// Times converting pseudo-random cones, polygons, and fields of view to HTM ID ranges at level 10
+// (about 0.1 degree triangles), and checks that the HTM ID of every point sampled inside each one is
+// in its ranges. Reports the average number of ranges, and the fraction of covered points sampled around
+// each region which lie outside it, a measure of how tightly the ranges fit.
+
+void BenchHTMCoverage ( void )
+{
+    cout << "Benchmarking HTM range coverage...\n";
+
+    const int kLevel = 10, kRegions = 1000, kSamples = 200;
+    const char *kShapes[3] = { "cone", "polygon", "view" };
+    srand ( 3 );
+
+    for ( int shape = 0; shape < 3; shape++ )
+    {
+        vector<SSHTM::Convex> convexes;
+        vector<SSView> views;
+        vector<SSVector> centers;
+        vector<double> radii;
+        for ( int i = 0; i < kRegions; i++ )
+        {
+            SSVector c = RandomVector(), u = c.crossProduct ( RandomVector() ).normalize(), w = c.crossProduct ( u );
+            double a = SSAngle::fromDegrees ( 0.1 + 9.9 * rand() / RAND_MAX ), b = SSAngle::fromDegrees ( 0.1 + 9.9 * rand() / RAND_MAX );
+            centers.push_back ( c );
+            radii.push_back ( 2.0 * max ( a, b ) );
+            if ( shape == 0 )
+                convexes.push_back ( { SSHTM::makeCap ( c, a ) } );
+            else if ( shape == 1 )
+                convexes.push_back ( SSHTM::makePolygon ( { c + u * a, c + w * b, c - u * a, c - w * b * 0.5 } ) );
+            else
+            {
+                SSView view ( i % 2 ? kGnomonic : kStereographic, SSAngle ( 2.0 * a ), 800.0, 600.0, 400.0, 300.0 );
+                SSSpherical sph ( c );
+                view.setCenter ( sph.lon, sph.lat );
+                views.push_back ( view );
+            }
+        }
+
+        vector<vector<SSHTM::IDRange>> ranges ( kRegions );
+        size_t nranges = 0;
+        double secs = clocksec();
+        for ( int i = 0; i < kRegions; i++ )
+            nranges += shape < 2 ? SSHTM::coverRanges ( convexes[i], kLevel, ranges[i] ) : SSHTM::coverRanges ( views[i], kLevel, ranges[i] );
+        secs = clocksec_since ( secs );
+
+        // Sample points within twice each region's size of its center; count points inside the region
+        // which are missing from its ranges, and points outside the region which are in its ranges.
+
+        SSHTM htm;
+        int missed = 0, inside = 0, extra = 0;
+        for ( int i = 0; i < kRegions; i++ )
+        {
+            for ( int j = 0; j < kSamples; j++ )
+            {
+                SSVector p = ( centers[i] + RandomVector() * radii[i] * ( (double) rand() / RAND_MAX ) ).normalize();
+                bool in = false;
+                if ( shape < 2 )
+                    in = SSHTM::inConvex ( convexes[i], p );
+                else
+                {
+                    SSVector v = views[i].project ( p );
+                    in = isfinite ( v.x ) && isfinite ( v.y ) && views[i].inBoundRect ( v.x, v.y );
+                }
+
+                bool covered = SSHTM::inRanges ( ranges[i], htm.vector2ID ( p, kLevel - 1 ) );
+                if ( in )
+                    inside++;
+                if ( in && ! covered )
+                    missed++;
+                if ( ! in && covered )
+                    extra++;
+            }
+        }
+
+        cout << formstr ( "%d %ss at level %d: %.3f sec, %.1f ranges each, %d of %d inside points missed: %s, %.1f%% extra points covered",
+                          kRegions, kShapes[shape], kLevel, secs, (double) nranges / kRegions, missed, inside, missed ? "FAILED" : "OK", 100.0 * extra / ( inside + extra ) ) << endl;
+    }
+
+    cout << endl;
+}
+
+// Computes HTM IDs of 10 million pseudo-random unit vectors at depth 7 (about 0.5 degree triangles),
+// one at a time with SSHTM::vector2ID(), then all at once with SSHTM::vector2IDs() on one thread and
+// on all cores. Checks that the batch IDs are identical to the one-at-a-time IDs.
+
+void BenchHTMVector2IDs ( void )
+{
+    cout << "Benchmarking HTM batch vector2IDs...\n";
+
+    const size_t kPoints = 10000000;
+    const int kDepth = 7;
+    vector<double> x ( kPoints ), y ( kPoints ), z ( kPoints );
+    vector<uint64_t> ids ( kPoints ), batchIDs ( kPoints );
+
+    srand ( 4 );
+    for ( size_t i = 0; i < kPoints; i++ )
+    {
+        SSVector v = RandomVector();
+        x[i] = v.x;
+        y[i] = v.y;
+        z[i] = v.z;
+    }
+
+    SSHTM htm;
+    double secs = clocksec();
+    for ( size_t i = 0; i < kPoints; i++ )
+        ids[i] = htm.vector2ID ( SSVector ( x[i], y[i], z[i] ), kDepth );
+    double oneSecs = clocksec_since ( secs );
+    cout << formstr ( "vector2ID():              %.3f sec, %.1f million points/sec", oneSecs, kPoints / oneSecs / 1.0e6 ) << endl;
+
+    int nthreads[2] = { 1, (int) max ( 1u, thread::hardware_concurrency() ) };
+    for ( int k = 0; k < 2; k++ )
+    {
+        fill ( batchIDs.begin(), batchIDs.end(), 0 );
+        secs = clocksec();
+        SSHTM::vector2IDs ( x.data(), y.data(), z.data(), kPoints, kDepth, batchIDs.data(), nthreads[k] );
+        secs = clocksec_since ( secs );
+
+        size_t mismatches = 0;
+        for ( size_t i = 0; i < kPoints; i++ )
+            if ( batchIDs[i] != ids[i] )
+                mismatches++;
+
+        cout << formstr ( "vector2IDs(), %2d threads: %.3f sec, %.1f million points/sec (%.1fx), %d mismatches: %s",
+                          nthreads[k], secs, kPoints / secs / 1.0e6, oneSecs / secs, (int) mismatches, mismatches ? "FAILED" : "OK" ) << endl;
+    }
+
+    cout << endl;
+}
+
+// Builds a name index of synthetic object names in an output directory (outpath), then times loading
+// it from the CSV index file versus the memory-mapped binary name index file, and times case-insensitive
+// "begins-with" (type-ahead) and whole-name searches with the name index versus brute-force searching
+// of the name map. Checks that both kinds of searches find the same objects.
+
+void BenchHTMNameIndex ( const string &outpath )
+{
+    cout << "Benchmarking HTM name index...\n";
+
+    const int kNames = 300000, kQueries = 200;
+    const char *prefixes[] = { "HD", "HIP", "SAO", "Gliese", "Kepler", "TYC", "Alpha", "NGC" };
+    SSHTM htm ( kBenchMagLevels, outpath );
+    mkdir_p ( ( htm.rootPath() + "index" ).c_str(), 0777 );
+
+    SSHTM::NameMap nameMap;
+    vector<string> names;
+    srand ( 1 );
+    for ( int i = 0; i < kNames; i++ )
+    {
+        string name = formstr ( "%s %d", prefixes[ rand() % 8 ], rand() % 100000 );
+        if ( rand() % 2 )
+            transform ( name.begin(), name.end(), name.begin(), ::toupper );
+        nameMap.insert ( { name, { (uint64_t) 32 + rand() % 32, (size_t) rand() % 1000 } } );
+        names.push_back ( name );
+    }
+
+    htm._nameIndex[kCatUnknown] = nameMap;
+    size_t n = htm.saveObjectMap ( kCatUnknown );
+    string binpath = htm.rootPath() + "index/Name.bin";
+
+    SSHTM csvHTM ( kBenchMagLevels, outpath ), binHTM ( kBenchMagLevels, outpath );
+    rename ( binpath.c_str(), ( binpath + ".tmp" ).c_str() );
+    double csvSecs = clocksec();
+    size_t nCSV = csvHTM.loadObjectMap ( kCatUnknown );
+    csvSecs = clocksec_since ( csvSecs );
+    rename ( ( binpath + ".tmp" ).c_str(), binpath.c_str() );
+    double binSecs = clocksec();
+    size_t nBin = binHTM.loadObjectMap ( kCatUnknown );
+    binSecs = clocksec_since ( binSecs );
+    cout << formstr ( "load %d names: CSV %.3f sec, binary %.6f sec (%.0fx): %s", (int) n, csvSecs, binSecs, csvSecs / binSecs,
+                      nCSV == n && nBin == n ? "OK" : "FAILED" ) << endl;
+
+    // Type-ahead queries are the first 1 to 5 characters of random names, in random case;
+    // whole-name queries are random names in lower case.
+
+    for ( int begins = 1; begins >= 0; begins-- )
+    {
+        vector<string> queries;
+        for ( int i = 0; i < kQueries; i++ )
+        {
+            string name = names[ rand() % names.size() ];
+            if ( ! begins )
+                transform ( name.begin(), name.end(), name.begin(), ::tolower );
+            queries.push_back ( begins ? name.substr ( 0, 1 + rand() % 5 ) : name );
+        }
+
+        size_t found = 0, mismatches = 0;
+        vector<SSHTM::ObjectLoc> locs;
+        double bruteSecs = clocksec();
+        vector<size_t> counts;
+        for ( const string &query : queries )
+        {
+            size_t count = 0;
+            for ( auto it = nameMap.begin(); it != nameMap.end(); it++ )
+                if ( compare ( it->first, query, begins ? query.length() : 0, false ) == 0 )
+                    count++;
+            counts.push_back ( count );
+        }
+        bruteSecs = clocksec_since ( bruteSecs );
+
+        double indexSecs = clocksec();
+        for ( int i = 0; i < kQueries; i++ )
+        {
+            locs.clear();
+            found += binHTM.findObjectLocs ( queries[i], locs, false, begins );
+            mismatches += locs.size() != counts[i];
+        }
+        indexSecs = clocksec_since ( indexSecs );
+
+        cout << formstr ( "%d %s searches, %d found: brute force %.3f sec, name index %.4f sec (%.0fx), %d mismatches: %s",
+                          kQueries, begins ? "begins-with" : "whole-name", (int) found, bruteSecs, indexSecs, bruteSecs / indexSecs,
+                          (int) mismatches, mismatches ? "FAILED" : "OK" ) << endl;
+    }
+
+    vector<string> completions;
+    binHTM.completeObjectNames ( "alpha 1234", completions, 10 );
+    cout << formstr ( "completions of \"alpha 1234\": %d, first \"%s\"", (int) completions.size(), completions.empty() ? "" : completions[0].c_str() ) << endl;
+    cout << endl;
+}
+
+// Builds a GAIA identifier index of pseudo-random identifiers in an output directory (outpath),
+// then times loading it from the CSV index file versus the memory-mapped binary index file, and
+// times identifier lookups in the multimap versus the binary index. Checks that both find the same objects.
+
+void BenchHTMIdentIndex ( const string &outpath )
+{
+    cout << "Benchmarking HTM identifier index...\n";
+
+    const int kIdents = 1000000, kQueries = 1000000;
+    SSHTM htm ( kBenchMagLevels, outpath );
+    mkdir_p ( ( htm.rootPath() + "index" ).c_str(), 0777 );
+
+    SSHTM::IdentMap identMap;
+    vector<SSIdentifier> idents;
+    mt19937_64 rng ( 1 );
+    for ( int i = 0; i < kIdents; i++ )
+    {
+        SSIdentifier ident ( kCatGAIA, rng() % 6000000000000000000ULL );
+        identMap.insert ( { ident, { (uint64_t) 32 + rng() % 32, (size_t) ( rng() % 1000 ) } } );
+        idents.push_back ( ident );
+    }
+
+    htm._identIndex[kCatGAIA] = identMap;
+    size_t n = htm.saveObjectMap ( kCatGAIA );
+    string binpath = htm.rootPath() + "index/" + catalog_to_string ( kCatGAIA ) + ".bin";
+
+    SSHTM csvHTM ( kBenchMagLevels, outpath ), binHTM ( kBenchMagLevels, outpath );
+    rename ( binpath.c_str(), ( binpath + ".tmp" ).c_str() );
+    double csvSecs = clocksec();
+    size_t nCSV = csvHTM.loadObjectMap ( kCatGAIA );
+    csvSecs = clocksec_since ( csvSecs );
+    rename ( ( binpath + ".tmp" ).c_str(), binpath.c_str() );
+    double binSecs = clocksec();
+    size_t nBin = binHTM.loadObjectMap ( kCatGAIA );
+    binSecs = clocksec_since ( binSecs );
+    cout << formstr ( "load %d identifiers: CSV %.3f sec, binary %.6f sec (%.0fx): %s", (int) n, csvSecs, binSecs, csvSecs / binSecs,
+                      nCSV == n && nBin == n ? "OK" : "FAILED" ) << endl;
+
+    // Half of the queries are identifiers in the index; the others are probably not.
+
+    vector<SSIdentifier> queries;
+    for ( int i = 0; i < kQueries; i++ )
+        queries.push_back ( i % 2 ? idents[ rng() % idents.size() ] : SSIdentifier ( kCatGAIA, rng() % 6000000000000000000ULL ) );
+
+    vector<SSHTM::ObjectLoc> mapLocs, binLocs;
+    double mapSecs = clocksec();
+    for ( SSIdentifier ident : queries )
+        csvHTM.findObjectLocs ( ident, mapLocs );
+    mapSecs = clocksec_since ( mapSecs );
+
+    binSecs = clocksec();
+    for ( SSIdentifier ident : queries )
+        binHTM.findObjectLocs ( ident, binLocs );
+    binSecs = clocksec_since ( binSecs );
+
+    size_t mismatches = mapLocs.size() != binLocs.size();
+    for ( size_t i = 0; i < mapLocs.size() && i < binLocs.size(); i++ )
+        mismatches += mapLocs[i].region != binLocs[i].region || mapLocs[i].offset != binLocs[i].offset;
+
+    cout << formstr ( "%d lookups, %d found: multimap %.3f sec, binary index %.3f sec (%.1fx), %d mismatches: %s",
+                      kQueries, (int) binLocs.size(), mapSecs, binSecs, mapSecs / binSecs, (int) mismatches, mismatches ? "FAILED" : "OK" ) << endl;
+
+    size_t mapSize = binHTM.getIdentMap ( kCatGAIA ).size();
+    cout << formstr ( "identifier map view of binary index: %d entries: %s", (int) mapSize, mapSize == n ? "OK" : "FAILED" ) << endl;
+    cout << endl;
+}
+
+// Loopback port for mount simulators. SSSyntaMount only uses UDP on this port, like SynScan Wi-Fi.
+
+static const unsigned short kSimulatorPort = 11880;
+
+// Sends a command (input) to a TCP socket (socket) and reads its reply into (output), one byte
+// at a time with a 1 millisecond sleep whenever no bytes are ready, as SSMount did originally.
+
+static int PollingSocketCommand ( SSSocket &socket, const string &input, char *output, int outlen, char term, int timeout_ms )
+{
+    socket.writeSocket ( input.c_str(), (int) input.length() );
+
+    int bytesRead = 0;
+    double start = clocksec();
+    while ( bytesRead < outlen )
+    {
+        int bytes = socket.readSocket ( nullptr, 0 );
+        if ( bytes < 0 )
+            return -1;
+        else if ( bytes < 1 )
+        {
+            msleep ( 1 );
+            if ( clocksec() - start > timeout_ms / 1000.0 )
+                return -1;
+            continue;
+        }
+
+        if ( socket.readSocket ( output + bytesRead, 1 ) < 1 )
+            return -1;
+        if ( output[ bytesRead++ ] == term )
+            break;
+    }
+
+    return bytesRead;
+}
+
+// Times LX200 position queries (":GR#" and ":GD#") sent to a loopback mount simulator,
+// first with the original byte-at-a-time polling loop, then through SSMeadeMount,
+// which waits for replies with poll() and reads them into a ring buffer.
+
+void BenchMountLatency ( void )
+{
+    cout << "Benchmarking mount command latency...\n";
+
+    const int kQueries = 1000;
+    SSMountSimulator simulator ( kMeadeLX200 );
+    if ( ! simulator.start ( SSMountSimulator::kTCP, kSimulatorPort ) )
+    {
+        cout << "Can't start mount simulator: FAILED" << endl << endl;
+        return;
+    }
+
+    // Original polling loop. Switch the simulator to high-precision coordinates first.
+
+    SSSocket socket;
+    socket.openSocket ( SSIP ( simulator.path() ), simulator.port(), 1000 );
+    socket.writeSocket ( ":U#", 3 );
+    char output[16] = { 0 };
+    int failures = 0;
+    double pollSecs = clocksec();
+    for ( int i = 0; i < kQueries; i++ )
+    {
+        failures += PollingSocketCommand ( socket, ":GR#", output, 10, '#', 1000 ) != 9;
+        failures += PollingSocketCommand ( socket, ":GD#", output, 11, '#', 1000 ) != 10;
+    }
+    pollSecs = clocksec_since ( pollSecs );
+    socket.closeSocket();
+    cout << formstr ( "%d queries, byte-at-a-time polling: %.3f sec, %.3f ms per command, %d failures", kQueries, pollSecs, pollSecs * 1000.0 / ( 2 * kQueries ), failures ) << endl;
+
+    // SSMeadeMount with poll() and ring buffer.
+
+    SSCoordinates coords ( SSTime::fromSystem(), SSSpherical ( 0.0, 0.0, 0.0 ) );
+    SSMeadeMount mount ( kEquatorialGotoMount, kMeadeLX200, coords );
+    SSMount::Error err = mount.connect ( simulator.path(), simulator.port() );
+    SSAngle ra, dec;
+    failures = err != SSMount::kSuccess;
+    double mountSecs = clocksec();
+    for ( int i = 0; i < kQueries && ! err; i++ )
+        failures += mount.read ( ra, dec ) != SSMount::kSuccess;
+    mountSecs = clocksec_since ( mountSecs );
+    mount.disconnect();
+    simulator.stop();
+
+    cout << formstr ( "%d queries, poll() and ring buffer: %.3f sec, %.3f ms per command (%.1fx), %d failures: %s", kQueries, mountSecs,
+                      mountSecs * 1000.0 / ( 2 * kQueries ), pollSecs / mountSecs, failures, failures ? "FAILED" : "OK" ) << endl;
+    cout << endl;
+}
+
+// Records the order in which asynchronous mount commands complete; userData points to the command's name.
+
+static vector<string> _asyncOrder;
+
+static void AsyncOrderCallback ( SSMount *pMount, SSMount::Error err, void *userData )
+{
+    _asyncOrder.push_back ( string ( (const char *) userData ) + ( err == SSMount::kCancelled ? " (cancelled)" : "" ) );
+}
+
+// Compares polling a loopback LX200 mount simulator with one thread per read() call, as SSMount's
+// asynchronous commands did originally, against SSMount's persistent worker and command queue,
+// which merges reads requested while another read is queued. Then checks that a stop command
+// is sent ahead of queued commands and cancels a queued slew, and reports queue statistics.
+
+void BenchMountAsync ( void )
+{
+    cout << "Benchmarking asynchronous mount command queue...\n";
+
+    const int kReads = 500;
+    SSMountSimulator simulator ( kMeadeLX200 );
+    if ( ! simulator.start ( SSMountSimulator::kTCP, kSimulatorPort + 1 ) )
+    {
+        cout << "Can't start mount simulator: FAILED" << endl << endl;
+        return;
+    }
+
+    SSCoordinates coords ( SSTime::fromSystem(), SSSpherical ( 0.0, 0.0, 0.0 ) );
+    SSMeadeMount mount ( kEquatorialGotoMount, kMeadeLX200, coords );
+    if ( mount.connect ( simulator.path(), simulator.port() ) != SSMount::kSuccess )
+    {
+        cout << "Can't connect to mount simulator: FAILED" << endl << endl;
+        return;
+    }
+
+    // One thread per read, serialized on the mount's command mutex.
+
+    atomic<int> failures ( 0 );
+    double threadSecs = clocksec();
+    vector<thread> threads;
+    for ( int i = 0; i < kReads; i++ )
+    {
+        threads.push_back ( thread ( [&] ( void )
+        {
+            SSAngle ra, dec;
+            mount.lockMutex ( true );
+            failures += mount.read ( ra, dec ) != SSMount::kSuccess;
+            mount.lockMutex ( false );
+        } ) );
+    }
+    for ( thread &t : threads )
+        t.join();
+    threadSecs = clocksec_since ( threadSecs );
+    cout << formstr ( "%d reads, thread per call: %.3f sec, %d sent, %d failures", kReads, threadSecs, kReads, (int) failures ) << endl;
+
+    // Persistent worker thread; reads requested while one is queued are merged.
+
+    SSMount::AsyncResult result;
+    double queueSecs = clocksec();
+    for ( int i = 0; i < kReads; i++ )
+        result = mount.readAsync();
+    SSMount::Error err = result.get();
+    queueSecs = clocksec_since ( queueSecs );
+
+    SSMount::AsyncStats stats;
+    mount.getAsyncStatistics ( stats );
+    cout << formstr ( "%d reads, command queue: %.3f sec, %d sent, %d merged, last %s", kReads, queueSecs, (int) stats.commands,
+                      (int) stats.coalesced, err ? "FAILED" : "OK" ) << endl;
+
+    // While the worker waits for the mount, queue a read, a slew, and a stop; the stop should
+    // be sent before the read, and cancel the slew. Keep the mutex locked until all are queued.
+
+    mount.lockMutex ( true );
+    SSMount::AsyncResult busy = mount.readAsync ( AsyncOrderCallback, (void *) "read 1" );
+    msleep ( 10 );
+    mount.readAsync ( AsyncOrderCallback, (void *) "read 2" );
+    SSMount::AsyncResult slew = mount.slewAsync ( kAzmRAAxis, 1, AsyncOrderCallback, (void *) "slew" );
+    SSMount::AsyncResult stop = mount.stopAsync ( AsyncOrderCallback, (void *) "stop" );
+    mount.lockMutex ( false );
+    mount.readAsync().get();
+
+    string order;
+    for ( string &name : _asyncOrder )
+        order += ( order.empty() ? "" : ", " ) + name;
+    bool ok = _asyncOrder.size() == 4 && _asyncOrder[0] == "slew (cancelled)" && _asyncOrder[1] == "read 1" && _asyncOrder[2] == "stop" && _asyncOrder[3] == "read 2";
+    cout << formstr ( "completion order: %s: %s", order.c_str(), ok && slew.get() == SSMount::kCancelled ? "OK" : "FAILED" ) << endl;
+
+    mount.getAsyncStatistics ( stats );
+    cout << formstr ( "queue statistics: %d sent, %d merged, %d cancelled, max depth %d, latency p50 %.3f ms, p90 %.3f ms, p99 %.3f ms",
+                      (int) stats.commands, (int) stats.coalesced, (int) stats.cancelled, (int) stats.maxQueueDepth,
+                      stats.latency[0], stats.latency[1], stats.latency[2] ) << endl;
+
+    mount.disconnect();
+    cout << endl;
+}
+
+// Connects each SSMount protocol to a loopback mount simulator, over TCP, UDP (Synta Direct, as SynScan Wi-Fi),
+// and a pseudo-terminal (as a serial port), then times repeated read() calls with no added latency, then with
+// 2 ms latency and 1 ms jitter per reply. Reports commands per second and p50/p99 read() latency; then slews
+// 2 degrees and checks that read() returns the target. Finally, drops reply bytes and counts read() failures
+// remaining after SSMount's timeouts and retries.
+
+void BenchMountSimulator ( void )
+{
+    cout << "Benchmarking mount protocols with simulated mounts...\n";
+
+    struct Config
+    {
+        SSMountProtocol protocol;
+        SSMountSimulator::Transport transport;
+        bool echo;
+        const char *name;
+    };
+
+    const Config configs[] =
+    {
+        { kMeadeLX200, SSMountSimulator::kTCP, false, "Meade LX200 (TCP)" },
+        { kMeadeAutostar, SSMountSimulator::kTCP, false, "Meade Autostar (TCP)" },
+        { kCelestronNexStar, SSMountSimulator::kTCP, false, "Celestron NexStar (TCP)" },
+        { kSkyWatcherSynScan, SSMountSimulator::kTCP, false, "SkyWatcher SynScan (TCP)" },
+        { kSyntaDirect, SSMountSimulator::kUDP, false, "Synta Direct (UDP)" },
+        { kCelestronAUX, SSMountSimulator::kTCP, false, "Celestron AUX (TCP)" },
+        { kCelestronNexStar, SSMountSimulator::kPseudoTerminal, false, "Celestron NexStar (serial)" },
+        { kSyntaDirect, SSMountSimulator::kPseudoTerminal, true, "Synta Direct (serial, echo)" }
+    };
+
+    const int kReads = 200;
+    const double kLatency[2][2] = { { 0.0, 0.0 }, { 2.0, 1.0 } };
+    unsigned short port = kSimulatorPort + 2;
+    SSCoordinates coords ( SSTime::fromSystem(), SSSpherical ( 0.0, 0.0, 0.0 ) );
+
+    for ( const Config &config : configs )
+    {
+        for ( int l = 0; l < 2; l++ )
+        {
+            // Synta Direct uses UDP only on the SynScan Wi-Fi port; use a new TCP port for every
+            // other simulator, so we never wait for a recently-closed one to become available.
+
+            SSMountSimulator simulator ( config.protocol );
+            simulator.setLatency ( kLatency[l][0], kLatency[l][1] );
+            simulator.setEcho ( config.echo );
+            if ( ! simulator.start ( config.transport, config.transport == SSMountSimulator::kUDP ? kSimulatorPort : port++ ) )
+            {
+                cout << formstr ( "%-28s can't start simulator: %s", config.name, config.transport == SSMountSimulator::kPseudoTerminal ? "SKIPPED" : "FAILED" ) << endl;
+                break;
+            }
+
+            SSMountPtr pMount = SSNewMount ( kEquatorialGotoMount, config.protocol, coords );
+            SSMount::Error err = pMount->connect ( simulator.path(), simulator.port() );
+            if ( err != SSMount::kSuccess )
+            {
+                cout << formstr ( "%-28s can't connect, error %d: FAILED", config.name, err ) << endl;
+                delete pMount;
+                continue;
+            }
+
+            SSAngle ra, dec;
+            vector<double> times ( kReads );
+            size_t commands = simulator.commandsAnswered();
+            int failures = 0;
+            double secs = clocksec();
+            for ( int i = 0; i < kReads; i++ )
+            {
+                double start = clocksec();
+                failures += pMount->read ( ra, dec ) != SSMount::kSuccess;
+                times[i] = clocksec_since ( start ) * 1000.0;
+            }
+            secs = clocksec_since ( secs );
+            commands = simulator.commandsAnswered() - commands;
+            sort ( times.begin(), times.end() );
+
+            // Slew 2 degrees north-east from the current position, wait until done, and compare.
+            // LX200 mounts report done within 1 degree of the target, so allow time to finish.
+
+            string gotoResult = "";
+            if ( l == 0 )
+            {
+                SSAngle ra0 = ra + SSAngle::fromDegrees ( 2.0 ), dec0 = dec + SSAngle::fromDegrees ( 2.0 );
+                bool slewing = true;
+                err = pMount->slew ( ra0, dec0 );
+                for ( int i = 0; i < 100 && slewing && err == SSMount::kSuccess; i++ )
+                {
+                    msleep ( 20 );
+                    err = pMount->read ( ra, dec );
+                    if ( err == SSMount::kSuccess )
+                        err = pMount->slewing ( slewing );
+                }
+
+                msleep ( 250 );
+                if ( err == SSMount::kSuccess )
+                    err = pMount->read ( ra, dec );
+
+                double sep = SSSpherical ( ra, dec ).angularSeparation ( SSSpherical ( ra0, dec0 ) );
+                gotoResult = formstr ( ", goto error %.1f\"", SSAngle ( sep ).toArcsec() );
+                failures += err != SSMount::kSuccess || sep > SSAngle::fromDegrees ( 0.1 );
+            }
+
+            cout << formstr ( "%-28s %.0f ms latency: %6.0f commands/sec, p50 %.3f ms, p99 %.3f ms, %d failures%s: %s", config.name, kLatency[l][0],
+                              commands / secs, times[kReads / 2], times[kReads * 99 / 100], failures, gotoResult.c_str(), failures ? "FAILED" : "OK" ) << endl;
+
+            pMount->disconnect();
+            delete pMount;
+        }
+    }
+
+    // Drop one reply byte in 500; with a short timeout and retries, most reads should still succeed.
+
+    SSMountSimulator simulator ( kCelestronNexStar );
+    simulator.setDropRate ( 0.002 );
+    if ( simulator.start ( SSMountSimulator::kTCP, port++ ) )
+    {
+        SSCelestronMount mount ( kEquatorialGotoMount, kCelestronNexStar, coords );
+        mount.setTimeout ( 50 );
+        mount.setRetries ( 3 );
+        int failures = mount.connect ( simulator.path(), simulator.port() ) != SSMount::kSuccess;
+        SSAngle ra, dec;
+        for ( int i = 0; i < kReads * 5; i++ )
+            failures += mount.read ( ra, dec ) != SSMount::kSuccess;
+        cout << formstr ( "Celestron NexStar, 0.2%% bytes dropped: %d reads, %d bytes dropped, %d reads failed with %d attempts per command", kReads * 5,
+                          (int) simulator.bytesDropped(), failures, mount.getRetries() ) << endl;
+        mount.disconnect();
+    }
+
+    cout << endl;
+}
+
+int main ( int argc, const char *argv[] )
+{
+    if ( argc < 2 )
+    {
+        cout << "Usage: SSBenchTest <inpath> [ephemfile] [outpath]" << endl;
+        cout << "inpath: path to SSData directory" << endl;
+        cout << "ephemfile: path to JPL DE43x binary ephemeris file" << endl;
+        cout << "outpath: path to existing directory for HTM region files; HTM and import benchmarks are skipped if omitted" << endl;
+        exit ( -1 );
+    }
+
+    string inpath ( argv[1] );
+    string ephemFile = argc > 2 ? string ( argv[2] ) : inpath + "/SolarSystem/DE438/1950_2050.438";
+
+    BenchJPLDEphemeris ( ephemFile );
+    BenchJPLDEphemerisBatch ( ephemFile );
+    BenchEventCache ( inpath );
+    BenchPlanetThreads ( inpath );
+    BenchEphemerisEngine ( inpath );
+    BenchSatellitePasses ( inpath );
+    BenchMultiSitePasses ( inpath );
+    BenchStarArray ( inpath );
+    BenchParallelImport ( inpath );
+    BenchObjectArena ( inpath );
+    BenchHTMCoverage();
+    BenchHTMVector2IDs();
+    BenchMountLatency();
+    BenchMountAsync();
+    BenchMountSimulator();
+
+    if ( argc > 3 )
+    {
+        BenchImport ( inpath, string ( argv[3] ) );
+        BenchBinarySnapshot ( inpath, string ( argv[3] ) );
+        BenchTycho2Import ( string ( argv[3] ) );
+        BenchCrossMatch ( string ( argv[3] ) );
+        BenchHTMRegionFiles ( inpath, string ( argv[3] ) );
+        BenchHTMCache ( string ( argv[3] ) );
+        BenchHTMPrefetch ( string ( argv[3] ) );
+        BenchHTMSearch ( string ( argv[3] ) );
+        BenchHTMNameIndex ( string ( argv[3] ) );
+        BenchHTMIdentIndex ( string ( argv[3] ) );
+    }
+
+    return 0;
+}